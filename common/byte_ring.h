@@ -0,0 +1,261 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <span>
+
+#include "macros.h"
+#include "types.h"
+#include "huge_pages.h"
+
+namespace Common {
+
+  // Single Producer Single Consumer ring of variable-length records, e.g.
+  // raw WebSocket frames handed from a network thread to a parser thread.
+  //
+  // Each record is a 16-byte header followed by the payload, padded to 16
+  // bytes, so payloads are always 16-byte aligned. A record never wraps:
+  // when it doesn't fit before the end of the ring the producer writes a
+  // padding record over the tail and starts again at offset 0. Payloads
+  // are NUL-terminated so text parsers can run on them in place.
+  //
+  // Writing happens in place: reserve() a contiguous span, fill it and
+  // commit(), or append() fragments as they arrive and commitPending().
+  // Nothing is visible to the consumer until the commit.
+  template<std::size_t CapacityBytes>
+  class SPSCByteRing final {
+    static_assert((CapacityBytes & (CapacityBytes - 1)) == 0,
+                  "CapacityBytes must be power of 2");
+    static_assert(CapacityBytes >= 4096, "CapacityBytes must be at least 4KB");
+
+  public:
+    struct RecordHeader {
+      std::uint32_t length;        // Payload bytes, excluding the NUL
+      std::uint32_t tag;           // Caller-defined, PAD_TAG is reserved
+      std::uint64_t timestamp_ns;  // Caller-defined, typically receive time
+    };
+    static_assert(sizeof(RecordHeader) == 16);
+
+    struct Record {
+      std::span<const char> data;
+      std::uint32_t tag;
+      std::uint64_t timestamp_ns;
+
+      auto empty() const noexcept -> bool { return data.data() == nullptr; }
+    };
+
+    static constexpr std::size_t RECORD_ALIGN = 16;
+    static constexpr std::uint32_t PAD_TAG = ~std::uint32_t{0};
+    // Largest payload that fits regardless of where the ring currently wraps
+    static constexpr std::size_t MAX_RECORD = CapacityBytes / 2 - sizeof(RecordHeader) - RECORD_ALIGN;
+
+    SPSCByteRing() {
+      // AUDIT_IGNORE: Init-time only
+      mem_ = HugePageAllocator::allocate(CapacityBytes);
+      if (!mem_) {
+        std::cerr << "FATAL: Failed to allocate memory for SPSCByteRing\n";
+        std::abort();  // Cannot recover from memory allocation failure at init
+      }
+      buffer_ = static_cast<char*>(mem_.ptr);
+    }
+
+    ~SPSCByteRing() {
+      HugePageAllocator::deallocate(mem_);
+    }
+
+    // Producer side - reserve len payload bytes (contiguous). Returns an
+    // empty span if the ring is too full; any pending record is discarded.
+    auto reserve(std::size_t len) noexcept -> std::span<char> {
+      pending_len_ = 0;
+      const auto pos = place(len);
+      if (UNLIKELY(pos == NO_SPACE)) {
+        return {};
+      }
+      pending_pos_ = pos;
+      pending_len_ = len;
+      pending_ = true;
+      return {payloadAt(pos), len};
+    }
+
+    // Grow the pending record by a fragment, starting one if none is
+    // pending. If the grown record no longer fits before the ring end it
+    // is moved to offset 0 - one extra copy, only on the wrapping frame.
+    auto append(const void* data, std::size_t len) noexcept -> bool {
+      if (!pending_) {
+        const auto span = reserve(len);
+        if (span.data() == nullptr) {
+          return false;
+        }
+        std::memcpy(span.data(), data, len);
+        return true;
+      }
+
+      const auto new_len = pending_len_ + len;
+      const auto pos = place(new_len);
+      if (UNLIKELY(pos == NO_SPACE)) {
+        abort();
+        return false;
+      }
+      if (pos != pending_pos_) {
+        std::memmove(payloadAt(pos), payloadAt(pending_pos_), pending_len_);
+        pending_pos_ = pos;
+      }
+      std::memcpy(payloadAt(pos) + pending_len_, data, len);
+      pending_len_ = new_len;
+      return true;
+    }
+
+    // Publish the pending record. length may shrink what was reserved.
+    auto commit(std::size_t length, std::uint32_t tag, std::uint64_t timestamp_ns = 0) noexcept -> void {
+      ASSERT(pending_ && length <= pending_len_, "commit() without a matching reservation");
+      ASSERT(tag != PAD_TAG, "PAD_TAG is reserved");
+      auto* header = headerAt(pending_pos_);
+      header->length = static_cast<std::uint32_t>(length);
+      header->tag = tag;
+      header->timestamp_ns = timestamp_ns;
+      payloadAt(pending_pos_)[length] = '\0';
+
+      pending_ = false;
+      write_pos_.value.store(pending_pos_ + recordSize(length), std::memory_order_release);
+    }
+
+    // Commit everything appended so far
+    auto commitPending(std::uint32_t tag, std::uint64_t timestamp_ns = 0) noexcept -> void {
+      commit(pending_len_, tag, timestamp_ns);
+    }
+
+    // Drop the pending record; nothing was published
+    auto abort() noexcept -> void {
+      pending_ = false;
+      pending_len_ = 0;
+    }
+
+    auto hasPending() const noexcept -> bool { return pending_; }
+    auto pendingLength() const noexcept -> std::size_t { return pending_len_; }
+
+    // Copy a whole record in one call
+    auto tryWrite(const void* data, std::size_t len, std::uint32_t tag,
+                  std::uint64_t timestamp_ns = 0) noexcept -> bool {
+      const auto span = reserve(len);
+      if (span.data() == nullptr) {
+        return false;
+      }
+      std::memcpy(span.data(), data, len);
+      commit(len, tag, timestamp_ns);
+      return true;
+    }
+
+    // Consumer side - view the next record in place, or an empty Record.
+    // The view stays valid until release().
+    auto peek() noexcept -> Record {
+      for (;;) {
+        const auto read_pos = read_pos_.value.load(std::memory_order_relaxed);
+        if (read_pos == write_pos_cache_) {
+          write_pos_cache_ = write_pos_.value.load(std::memory_order_acquire);
+          if (read_pos == write_pos_cache_) {
+            return {};
+          }
+        }
+        const auto* header = headerAt(read_pos);
+        if (UNLIKELY(header->tag == PAD_TAG)) {
+          // Skip the tail of the ring
+          read_pos_.value.store(read_pos + header->length, std::memory_order_release);
+          continue;
+        }
+        return {{payloadAt(read_pos), header->length}, header->tag, header->timestamp_ns};
+      }
+    }
+
+    // Hand the record returned by the last peek() back to the producer
+    auto release() noexcept -> void {
+      const auto read_pos = read_pos_.value.load(std::memory_order_relaxed);
+      const auto* header = headerAt(read_pos);
+      read_pos_.value.store(read_pos + recordSize(header->length), std::memory_order_release);
+    }
+
+    // Bytes in use, including headers and padding
+    auto size() const noexcept -> std::size_t {
+      return write_pos_.value.load(std::memory_order_acquire) -
+             read_pos_.value.load(std::memory_order_acquire);
+    }
+
+    auto empty() const noexcept -> bool { return size() == 0; }
+    auto capacity() const noexcept -> std::size_t { return CapacityBytes; }
+
+    // Cache line the producer writes on commit - UMONITOR target for waiters
+    auto producerCursorAddress() const noexcept -> const volatile void* {
+      return &write_pos_.value;
+    }
+
+    // Deleted copy & move constructors and assignment-operators
+    SPSCByteRing(const SPSCByteRing&) = delete;
+    SPSCByteRing(SPSCByteRing&&) = delete;
+    SPSCByteRing& operator=(const SPSCByteRing&) = delete;
+    SPSCByteRing& operator=(SPSCByteRing&&) = delete;
+
+  private:
+    static constexpr std::uint64_t NO_SPACE = ~std::uint64_t{0};
+    static constexpr std::uint64_t MASK = CapacityBytes - 1;
+
+    // Header + payload + NUL, rounded to the record alignment
+    static constexpr auto recordSize(std::size_t len) noexcept -> std::uint64_t {
+      return (sizeof(RecordHeader) + len + 1 + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
+    }
+
+    auto headerAt(std::uint64_t pos) const noexcept -> RecordHeader* {
+      return reinterpret_cast<RecordHeader*>(buffer_ + (pos & MASK));
+    }
+
+    auto payloadAt(std::uint64_t pos) const noexcept -> char* {
+      return buffer_ + (pos & MASK) + sizeof(RecordHeader);
+    }
+
+    // Find where a record of len bytes starts, writing a padding record
+    // over the ring tail if needed. Only called by the producer; nothing
+    // is published, so the padding is harmless if the record is abandoned.
+    auto place(std::size_t len) noexcept -> std::uint64_t {
+      if (UNLIKELY(len > MAX_RECORD)) {
+        return NO_SPACE;
+      }
+      const auto write_pos = write_pos_.value.load(std::memory_order_relaxed);
+      const auto need = recordSize(len);
+      const auto tail = CapacityBytes - (write_pos & MASK);
+      const auto total = need <= tail ? need : tail + need;
+
+      if (CapacityBytes - (write_pos - read_pos_cache_) < total) {
+        read_pos_cache_ = read_pos_.value.load(std::memory_order_acquire);
+        if (CapacityBytes - (write_pos - read_pos_cache_) < total) {
+          return NO_SPACE;
+        }
+      }
+      if (need <= tail) {
+        return write_pos;
+      }
+      auto* pad = headerAt(write_pos);
+      pad->length = static_cast<std::uint32_t>(tail);
+      pad->tag = PAD_TAG;
+      return write_pos + tail;
+    }
+
+    PageAllocation mem_;
+    char* buffer_;
+
+    // Producer's record under construction (not yet visible)
+    std::uint64_t pending_pos_ = 0;
+    std::size_t pending_len_ = 0;
+    bool pending_ = false;
+
+    // Positions grow monotonically in bytes and are masked on access
+    alignas(CACHE_LINE_SIZE) CacheAligned<std::atomic<std::uint64_t>> write_pos_{0};
+    alignas(CACHE_LINE_SIZE) std::uint64_t read_pos_cache_ = 0;   // Producer's view of read_pos_
+
+    alignas(CACHE_LINE_SIZE) CacheAligned<std::atomic<std::uint64_t>> read_pos_{0};
+    alignas(CACHE_LINE_SIZE) std::uint64_t write_pos_cache_ = 0;  // Consumer's view of write_pos_
+  };
+
+} // namespace Common
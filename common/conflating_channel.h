@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <type_traits>
+#include <immintrin.h>
+
+#include "macros.h"
+#include "types.h"
+#include "huge_pages.h"
+
+namespace Common {
+
+  // Latest-value channel keyed by a small integer (ticker id), for
+  // consumers that want the freshest state per instrument rather than
+  // every update.
+  //
+  // The producer overwrites the key's slot under a per-slot seqlock and
+  // sets the key's bit in a dirty bitmap. The consumer swaps each non-zero
+  // bitmap word to zero and reads the slots it named, so a key published
+  // many times between drains is delivered once, with its newest value.
+  // Nothing is ever dropped for lack of space: memory is one slot per key.
+  //
+  // One producer and one consumer per channel. A key published again
+  // while the consumer is reading it is simply delivered again next drain.
+  template<typename T, std::size_t MaxKeys>
+  class ConflatingChannel final {
+    static_assert(std::is_trivially_copyable_v<T>, "Slots are copied under a seqlock");
+    static_assert(MaxKeys > 0, "MaxKeys must be greater than 0");
+
+  public:
+    static constexpr std::size_t WORDS = (MaxKeys + 63) / 64;
+
+    ConflatingChannel() {
+      // AUDIT_IGNORE: Init-time only
+      slots_mem_ = HugePageAllocator::allocate(sizeof(Slot) * MaxKeys);
+      if (!slots_mem_) {
+        std::cerr << "FATAL: Failed to allocate memory for ConflatingChannel\n";
+        std::abort();  // Cannot recover from memory allocation failure at init
+      }
+      slots_ = static_cast<Slot*>(slots_mem_.ptr);
+      for (std::size_t i = 0; i < MaxKeys; ++i) {
+        new (&slots_[i]) Slot();
+      }
+    }
+
+    ~ConflatingChannel() {
+      for (std::size_t i = 0; i < MaxKeys; ++i) {
+        slots_[i].~Slot();
+      }
+      HugePageAllocator::deallocate(slots_mem_);
+    }
+
+    // Delete copy/move
+    ConflatingChannel(const ConflatingChannel&) = delete;
+    ConflatingChannel& operator=(const ConflatingChannel&) = delete;
+    ConflatingChannel(ConflatingChannel&&) = delete;
+    ConflatingChannel& operator=(ConflatingChannel&&) = delete;
+
+    // Producer side - replace the key's value and mark it dirty. False
+    // only if the key is out of range.
+    auto publish(std::size_t key, const T& value) noexcept -> bool {
+      if (UNLIKELY(key >= MaxKeys)) {
+        return false;
+      }
+      auto& slot = slots_[key];
+      const auto seq = slot.seq.load(std::memory_order_relaxed);
+      slot.seq.store(seq + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      slot.value = value;
+      slot.seq.store(seq + 2, std::memory_order_release);
+
+      const auto bit = std::uint64_t{1} << (key % 64);
+      if (dirty_[key / 64].fetch_or(bit, std::memory_order_release) & bit) {
+        // The consumer hadn't seen the previous value yet
+        conflated_.value.store(conflated_.value.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+      }
+      return true;
+    }
+
+    // Consumer side - call fn(key, value) once per key published since the
+    // last drain, in key order. Returns the number delivered.
+    template<typename Fn>
+    auto drain(Fn&& fn) noexcept -> std::size_t {
+      std::size_t delivered = 0;
+      for (std::size_t w = 0; w < WORDS; ++w) {
+        auto& word = dirty_[w];
+        if (LIKELY(word.load(std::memory_order_relaxed) == 0)) {
+          continue;
+        }
+        auto bits = word.exchange(0, std::memory_order_acquire);
+        while (bits) {
+          const auto key = w * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+          bits &= bits - 1;
+          T value;
+          read(slots_[key], value);
+          fn(key, static_cast<const T&>(value));
+          ++delivered;
+        }
+      }
+      return delivered;
+    }
+
+    // Any thread - latest value for a key, whether or not it's been drained
+    auto latest(std::size_t key, T& out) const noexcept -> bool {
+      if (UNLIKELY(key >= MaxKeys)) {
+        return false;
+      }
+      read(slots_[key], out);
+      return true;
+    }
+
+    // Updates that replaced a value the consumer never saw
+    auto conflatedCount() const noexcept -> std::uint64_t {
+      return conflated_.value.load(std::memory_order_relaxed);
+    }
+
+    static constexpr auto capacity() noexcept -> std::size_t { return MaxKeys; }
+
+  private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+      std::atomic<std::uint64_t> seq{0};
+      T value{};
+    };
+
+    static auto read(const Slot& slot, T& out) noexcept -> void {
+      for (;;) {
+        const auto before = slot.seq.load(std::memory_order_acquire);
+        if (LIKELY((before & 1) == 0)) {
+          out = slot.value;
+          std::atomic_thread_fence(std::memory_order_acquire);
+          if (LIKELY(before == slot.seq.load(std::memory_order_relaxed))) {
+            return;
+          }
+        }
+        _mm_pause();
+      }
+    }
+
+    PageAllocation slots_mem_{};
+    Slot* slots_{nullptr};
+
+    // Packed so a drain scans few lines; each word is shared by 64 keys
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> dirty_[WORDS]{};
+    alignas(CACHE_LINE_SIZE) CacheAligned<std::atomic<std::uint64_t>> conflated_{0};
+  };
+
+} // namespace Common
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "macros.h"
+
+namespace Common {
+
+  // Decimal strings to and from the integer Price/Qty types, with no
+  // double in between. A value's scale is its number of implied decimal
+  // places: Binance prices are scale 8 (1e8 fixed point), Zerodha prices
+  // scale 2 (paise). Scales go up to MAX_DECIMAL_SCALE.
+  //
+  // Parsing reads eight characters per step as one 64-bit word (SWAR):
+  // the length of the digit run is found from a mask of non-digit bytes
+  // and the run is converted with three multiplies. Formatting writes two
+  // digits per step from a table. Neither depends on the locale.
+
+  constexpr std::uint32_t MAX_DECIMAL_SCALE = 9;
+  constexpr std::size_t DECIMAL_BUFFER_SIZE = 24;  // Sign, 20 digits, '.', NUL
+
+  namespace DecimalDetail {
+
+    inline constexpr std::uint64_t POW10[20] = {
+      1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+      100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+      10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+      100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+    };
+
+    inline constexpr char DIGIT_PAIRS[] =
+      "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+      "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+
+    constexpr std::uint64_t BYTES_30 = 0x3030303030303030ULL;
+    constexpr std::uint64_t BYTES_06 = 0x0606060606060606ULL;
+    constexpr std::uint64_t BYTES_F0 = 0xF0F0F0F0F0F0F0F0ULL;
+
+    inline auto isDigit(char c) noexcept -> bool {
+      return c >= '0' && c <= '9';
+    }
+
+    // Eight bytes from p; bytes at or past end read as NUL
+    inline auto load8(const char* p, const char* end) noexcept -> std::uint64_t {
+      std::uint64_t word = 0;
+      if (LIKELY(end - p >= 8)) {
+        std::memcpy(&word, p, 8);
+      } else if (end > p) {
+        std::memcpy(&word, p, static_cast<std::size_t>(end - p));
+      }
+      return word;
+    }
+
+    // Number of leading digit characters in the word, 0-8. A byte is a digit
+    // if xor '0' leaves 0-9: no high nibble, and no carry out when 6 is added.
+    // The add can carry between bytes, but only upwards out of a non-digit.
+    inline auto digitCount(std::uint64_t word) noexcept -> std::uint32_t {
+      const std::uint64_t x = word ^ BYTES_30;
+      const std::uint64_t non_digit = (x | (x + BYTES_06)) & BYTES_F0;
+      return non_digit ? static_cast<std::uint32_t>(std::countr_zero(non_digit)) / 8 : 8;
+    }
+
+    // Value of the first n (1-8) digit characters of the word. The digits are
+    // shifted to the top and the vacated bytes count as leading zeros.
+    inline auto wordValue(std::uint64_t word, std::uint32_t n) noexcept -> std::uint64_t {
+      word <<= 8 * (8 - n);
+      word = (word & 0x0F0F0F0F0F0F0F0FULL) * 2561 >> 8;
+      word = (word & 0x00FF00FF00FF00FFULL) * 6553601 >> 16;
+      return (word & 0x0000FFFF0000FFFFULL) * 42949672960001ULL >> 32;
+    }
+
+    // The run of up to 16 digits at p; advances p past it
+    inline auto digitRun(const char*& p, const char* end, std::uint32_t& count) noexcept -> std::uint64_t {
+      const std::uint64_t lo = load8(p, end);
+      const std::uint32_t n = digitCount(lo);
+      if (n < 8) {
+        count = n;
+        p += n;
+        return n ? wordValue(lo, n) : 0;
+      }
+      const std::uint64_t hi = load8(p + 8, end);
+      const std::uint32_t m = digitCount(hi);
+      count = 8 + m;
+      p += 8 + m;
+      const std::uint64_t value = wordValue(lo, 8);
+      return m ? value * POW10[m] + wordValue(hi, m) : value;
+    }
+
+    // Digits in value, at least one. Setting the low bit keeps zero at one
+    // digit and never crosses a power of ten.
+    inline auto countDigits(std::uint64_t value) noexcept -> std::uint32_t {
+      value |= 1;
+      const auto guess = static_cast<std::uint32_t>(std::bit_width(value)) * 1233 >> 12;  // ~log10(2^bits)
+      return guess + (value >= POW10[guess] ? 1 : 0);
+    }
+
+    // Exactly n digits of value, ending just before end
+    inline auto writeDigits(char* end, std::uint64_t value, std::uint32_t n) noexcept -> void {
+      for (; n >= 2; n -= 2) {
+        end -= 2;
+        std::memcpy(end, &DIGIT_PAIRS[(value % 100) * 2], 2);
+        value /= 100;
+      }
+      if (n) {
+        end[-1] = static_cast<char>('0' + value % 10);
+      }
+    }
+
+    inline auto formatUnsigned(std::uint64_t value, std::uint32_t scale, char* out) noexcept -> std::size_t {
+      const std::uint64_t whole = value / POW10[scale];
+      const std::uint64_t fraction = value % POW10[scale];
+      const std::uint32_t whole_digits = countDigits(whole);
+      const std::size_t len = whole_digits + (scale ? scale + 1 : 0);
+      writeDigits(out + whole_digits, whole, whole_digits);
+      if (scale) {
+        out[whole_digits] = '.';
+        writeDigits(out + len, fraction, scale);
+      }
+      out[len] = '\0';
+      return len;
+    }
+
+  } // namespace DecimalDetail
+
+  // Parse a decimal ("123", "-0.5", "67012.34000000") from [p, end) into
+  // 'out' at the given scale. Digits past the scale are dropped, not
+  // rounded; a fraction may have any number of digits, the whole part up
+  // to 18 - scale. Only signed types take a '-'. Returns the position
+  // after the number, or nullptr if there isn't one or it doesn't fit.
+  // Reads stop at end; characters up to it must be readable.
+  template<typename T>
+  inline auto parseDecimal(const char* p, const char* end, std::uint32_t scale, T& out) noexcept -> const char* {
+    static_assert(std::is_same_v<T, std::int64_t> || std::is_same_v<T, std::uint64_t>,
+                  "Decimals parse into Price or Qty");
+    using namespace DecimalDetail;
+
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) {
+      if (p < end && *p == '-') {
+        negative = true;
+        ++p;
+      }
+    }
+
+    std::uint32_t whole_digits = 0;
+    std::uint64_t whole = digitRun(p, end, whole_digits);
+    while (UNLIKELY(whole_digits >= 16 && p < end && isDigit(*p))) {
+      if (whole_digits == 18) {
+        return nullptr;
+      }
+      whole = whole * 10 + static_cast<std::uint64_t>(*p++ - '0');
+      ++whole_digits;
+    }
+
+    std::uint64_t fraction = 0;
+    std::uint32_t fraction_digits = 0;
+    if (p < end && *p == '.') {
+      ++p;
+      fraction = digitRun(p, end, fraction_digits);
+      fraction = fraction_digits > scale ? fraction / POW10[fraction_digits - scale]
+                                         : fraction * POW10[scale - fraction_digits];
+      while (p < end && isDigit(*p)) {
+        ++p;  // Past sixteen, all below the scale
+      }
+    }
+    if (UNLIKELY((whole_digits == 0 && fraction_digits == 0) || whole >= POW10[18 - scale])) {
+      return nullptr;
+    }
+
+    const std::uint64_t value = whole * POW10[scale] + fraction;
+    if constexpr (std::is_signed_v<T>) {
+      out = negative ? -static_cast<T>(value) : static_cast<T>(value);
+    } else {
+      out = value;
+    }
+    return p;
+  }
+
+  // Write value at the given scale with exactly 'scale' decimals, as
+  // printf("%.*f") would: 150000 at scale 8 is "0.00150000". 'out' needs
+  // DECIMAL_BUFFER_SIZE bytes. Returns the length, without the NUL.
+  inline auto formatDecimal(std::uint64_t value, std::uint32_t scale, char* out) noexcept -> std::size_t {
+    return DecimalDetail::formatUnsigned(value, scale, out);
+  }
+
+  inline auto formatDecimal(std::int64_t value, std::uint32_t scale, char* out) noexcept -> std::size_t {
+    if (value >= 0) {
+      return DecimalDetail::formatUnsigned(static_cast<std::uint64_t>(value), scale, out);
+    }
+    out[0] = '-';
+    return 1 + DecimalDetail::formatUnsigned(0 - static_cast<std::uint64_t>(value), scale, out + 1);
+  }
+
+} // namespace Common
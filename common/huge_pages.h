@@ -0,0 +1,244 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sys/mman.h>
+#include <numa.h>
+
+#include "macros.h"
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+namespace Common {
+
+/// What actually backs an allocation
+enum class PageBacking : uint8_t {
+  Regular,      // 4KB pages
+  Transparent,  // THP requested via madvise, kernel may or may not comply
+  Huge2MB,      // hugetlbfs 2MB pages
+  Huge1GB       // hugetlbfs 1GB pages
+};
+
+/// A mapping handed out by HugePageAllocator; keep it to release the memory
+struct PageAllocation {
+  void* ptr = nullptr;
+  size_t size = 0;          // Mapped length, rounded up to the page size
+  size_t page_size = 4096;  // Stride used for prefaulting
+  PageBacking backing = PageBacking::Regular;
+
+  explicit operator bool() const noexcept { return ptr != nullptr; }
+};
+
+/// Page-level allocation backend for pools, queues and order books.
+///
+/// With huge pages enabled, tries hugetlbfs 1GB pages (for >= 1GB requests),
+/// then 2MB pages, then a 2MB-aligned mapping advised for THP. Huge-page
+/// usage is capped by budget_bytes, after which requests get regular pages.
+/// Every mapping is NUMA-bound on request, optionally mlocked, and
+/// prefaulted by writing one byte per page.
+class HugePageAllocator {
+public:
+  struct Config {
+    bool use_huge_pages = false;
+    bool lock_memory = false;
+    size_t budget_bytes = 0;  // Huge-page budget, 0 = unlimited
+  };
+
+  struct Stats {
+    std::atomic<size_t> huge_1gb_bytes{0};
+    std::atomic<size_t> huge_2mb_bytes{0};
+    std::atomic<size_t> transparent_bytes{0};
+    std::atomic<size_t> regular_bytes{0};
+    std::atomic<size_t> locked_bytes{0};
+    std::atomic<uint32_t> lock_failures{0};
+  };
+
+  static constexpr size_t PAGE_4KB = 4096;
+  static constexpr size_t PAGE_2MB = 2UL * 1024 * 1024;
+  static constexpr size_t PAGE_1GB = 1024UL * 1024 * 1024;
+
+  // Call once at startup, before any pool or queue is constructed
+  static auto configure(const Config& cfg) noexcept -> void {
+    mutableConfig() = cfg;
+  }
+
+  static auto config() noexcept -> const Config& { return mutableConfig(); }
+
+  static auto stats() noexcept -> const Stats& { return mutableStats(); }
+
+  // AUDIT_IGNORE: Init-time only
+  static auto allocate(size_t bytes, int numa_node = -1) noexcept -> PageAllocation {
+    PageAllocation alloc;
+    const auto& cfg = config();
+
+    if (cfg.use_huge_pages) {
+      // Each attempt charges the budget for the page-rounded length it
+      // maps, which is what deallocate() gives back
+      const size_t size_1gb = roundUp(bytes, PAGE_1GB);
+      if (bytes >= PAGE_1GB && reserveBudget(size_1gb)) {
+        alloc = mapHugeTlb(bytes, PAGE_1GB, MAP_HUGE_1GB, PageBacking::Huge1GB);
+        if (!alloc) {
+          releaseBudget(size_1gb);
+        }
+      }
+      const size_t size_2mb = roundUp(bytes, PAGE_2MB);
+      if (!alloc && reserveBudget(size_2mb)) {
+        alloc = mapHugeTlb(bytes, PAGE_2MB, MAP_HUGE_2MB, PageBacking::Huge2MB);
+        if (!alloc) {
+          alloc = mapTransparent(bytes);
+        }
+        if (!alloc) {
+          releaseBudget(size_2mb);
+        }
+      }
+    }
+    if (!alloc) {
+      alloc = mapRegular(bytes);
+    }
+    if (!alloc) {
+      return alloc;
+    }
+
+    if (numa_node >= 0 && numa_available() >= 0) {
+      numa_tonode_memory(alloc.ptr, alloc.size, numa_node);
+    }
+
+    if (cfg.lock_memory) {
+      if (mlock(alloc.ptr, alloc.size) == 0) {
+        mutableStats().locked_bytes.fetch_add(alloc.size, std::memory_order_relaxed);
+      } else {
+        mutableStats().lock_failures.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    prefault(alloc);
+    counterFor(alloc.backing).fetch_add(alloc.size, std::memory_order_relaxed);
+    return alloc;
+  }
+
+  static auto deallocate(PageAllocation& alloc) noexcept -> void {
+    if (!alloc) {
+      return;
+    }
+    counterFor(alloc.backing).fetch_sub(alloc.size, std::memory_order_relaxed);
+    if (alloc.backing != PageBacking::Regular) {
+      releaseBudget(alloc.size);
+    }
+    if (config().lock_memory) {
+      munlock(alloc.ptr, alloc.size);
+    }
+    munmap(alloc.ptr, alloc.size);
+    alloc = PageAllocation{};
+  }
+
+  // Touch every page so the first hot-path access never faults. Writes,
+  // because reading untouched anonymous memory only maps the zero page.
+  static auto prefault(const PageAllocation& alloc) noexcept -> void {
+    auto* mem = static_cast<volatile char*>(alloc.ptr);
+    for (size_t offset = 0; offset < alloc.size; offset += alloc.page_size) {
+      mem[offset] = 0;
+    }
+  }
+
+private:
+  static auto mutableConfig() noexcept -> Config& {
+    static Config cfg;
+    return cfg;
+  }
+
+  static auto mutableStats() noexcept -> Stats& {
+    static Stats s;
+    return s;
+  }
+
+  static auto hugeBytesInUse() noexcept -> std::atomic<size_t>& {
+    static std::atomic<size_t> bytes{0};
+    return bytes;
+  }
+
+  static auto roundUp(size_t bytes, size_t page) noexcept -> size_t {
+    return (bytes + page - 1) & ~(page - 1);
+  }
+
+  static auto reserveBudget(size_t bytes) noexcept -> bool {
+    const size_t budget = config().budget_bytes;
+    const size_t used = hugeBytesInUse().fetch_add(bytes, std::memory_order_relaxed);
+    if (budget != 0 && used + bytes > budget) {
+      hugeBytesInUse().fetch_sub(bytes, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+
+  static auto releaseBudget(size_t bytes) noexcept -> void {
+    hugeBytesInUse().fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  static auto counterFor(PageBacking backing) noexcept -> std::atomic<size_t>& {
+    auto& s = mutableStats();
+    switch (backing) {
+      case PageBacking::Huge1GB: return s.huge_1gb_bytes;
+      case PageBacking::Huge2MB: return s.huge_2mb_bytes;
+      case PageBacking::Transparent: return s.transparent_bytes;
+      case PageBacking::Regular: return s.regular_bytes;
+      default: return s.regular_bytes;
+    }
+  }
+
+  static auto mapHugeTlb(size_t bytes, size_t page, int size_flag,
+                         PageBacking backing) noexcept -> PageAllocation {
+    const size_t size = roundUp(bytes, page);
+    void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | size_flag, -1, 0);
+    if (mem == MAP_FAILED) {
+      return {};
+    }
+    return {mem, size, page, backing};
+  }
+
+  // Over-map by one huge page, trim to 2MB alignment and advise THP
+  static auto mapTransparent(size_t bytes) noexcept -> PageAllocation {
+    const size_t size = roundUp(bytes, PAGE_2MB);
+    void* raw = mmap(nullptr, size + PAGE_2MB, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+      return {};
+    }
+
+    const auto base = reinterpret_cast<uintptr_t>(raw);
+    const auto aligned = roundUp(base, PAGE_2MB);
+    if (aligned > base) {
+      munmap(raw, aligned - base);
+    }
+    const size_t tail = base + size + PAGE_2MB - (aligned + size);
+    if (tail > 0) {
+      munmap(reinterpret_cast<void*>(aligned + size), tail);
+    }
+
+    void* mem = reinterpret_cast<void*>(aligned);
+    madvise(mem, size, MADV_HUGEPAGE);
+    // Prefault at 4KB in case the kernel declines THP for some ranges
+    return {mem, size, PAGE_4KB, PageBacking::Transparent};
+  }
+
+  static auto mapRegular(size_t bytes) noexcept -> PageAllocation {
+    const size_t size = roundUp(bytes, PAGE_4KB);
+    void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+      return {};
+    }
+    return {mem, size, PAGE_4KB, PageBacking::Regular};
+  }
+};
+
+} // namespace Common
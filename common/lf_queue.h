@@ -5,10 +5,13 @@
 #include <cstddef>
 #include <cstdlib>
 #include <array>
+#include <algorithm>
 #include <new>
+#include <span>
 
 #include "macros.h"
 #include "types.h"
+#include "huge_pages.h"
 
 namespace Common {
 
@@ -27,13 +30,13 @@ namespace Common {
     SPSCLFQueue() : 
         capacity_(MaxElements),
         mask_(MaxElements - 1) {
-      // Allocate aligned memory for cache-line optimization
-      void* mem = std::aligned_alloc(CACHE_LINE_SIZE, sizeof(T) * MaxElements);
-      if (!mem) {
+      // Page-aligned, prefaulted storage - huge pages when configured
+      store_mem_ = HugePageAllocator::allocate(sizeof(T) * MaxElements);
+      if (!store_mem_) {
         std::cerr << "FATAL: Failed to allocate memory for LFQueue\n";
         std::abort();  // Cannot recover from memory allocation failure at init
       }
-      store_ = static_cast<T*>(mem);
+      store_ = static_cast<T*>(store_mem_.ptr);
       
       // Construct elements in-place
       for (std::size_t i = 0; i < capacity_; ++i) {
@@ -46,56 +49,98 @@ namespace Common {
       for (std::size_t i = 0; i < capacity_; ++i) {
         store_[i].~T();
       }
-      std::free(store_);
+      HugePageAllocator::deallocate(store_mem_);
     }
     
     // Producer side - only called by producer thread
     auto getNextToWriteTo() noexcept -> T* {
-      // Check if queue is full using count
-      const auto current_count = count_.value.load(std::memory_order_acquire);
-      if (UNLIKELY(current_count >= capacity_)) {
-        return nullptr; // Queue full (N slots used)
-      }
-      
       const auto write_idx = write_index_.value.load(std::memory_order_relaxed);
+      if (UNLIKELY(write_idx - read_index_cache_ >= capacity_)) {
+        // Looks full from our cached view - refresh from the consumer
+        read_index_cache_ = read_index_.value.load(std::memory_order_acquire);
+        if (write_idx - read_index_cache_ >= capacity_) {
+          return nullptr; // Queue full (N slots used)
+        }
+      }
       return &store_[write_idx & mask_];
     }
     
     auto updateWriteIndex() noexcept {
+      publish(1);
+    }
+    
+    // Batched producer API: reserve up to max_count contiguous slots.
+    // The span stops at the end of the ring, so a burst that wraps needs
+    // two claims. Fill the slots, then publish() with one release store.
+    auto claim(std::size_t max_count) noexcept -> std::span<T> {
       const auto write_idx = write_index_.value.load(std::memory_order_relaxed);
-      write_index_.value.store((write_idx + 1) & mask_, 
-                              std::memory_order_release);
-      // Increment count after write is committed
-      count_.value.fetch_add(1, std::memory_order_release);
+      auto free_slots = capacity_ - (write_idx - read_index_cache_);
+      if (free_slots < max_count) {
+        read_index_cache_ = read_index_.value.load(std::memory_order_acquire);
+        free_slots = capacity_ - (write_idx - read_index_cache_);
+      }
+      const auto offset = write_idx & mask_;
+      const auto count = std::min({max_count, free_slots, capacity_ - offset});
+      return {store_ + offset, count};
+    }
+    
+    // Make the first count claimed slots visible to the consumer
+    auto publish(std::size_t count) noexcept -> void {
+      const auto write_idx = write_index_.value.load(std::memory_order_relaxed);
+      write_index_.value.store(write_idx + count, std::memory_order_release);
     }
     
     // Consumer side - only called by consumer thread
     auto getNextToRead() noexcept -> const T* {
-      // Check if queue is empty using count
-      const auto current_count = count_.value.load(std::memory_order_acquire);
-      if (UNLIKELY(current_count == 0)) {
-        return nullptr; // Queue empty
-      }
-      
       const auto read_idx = read_index_.value.load(std::memory_order_relaxed);
+      if (UNLIKELY(read_idx == write_index_cache_)) {
+        // Looks empty from our cached view - refresh from the producer
+        write_index_cache_ = write_index_.value.load(std::memory_order_acquire);
+        if (read_idx == write_index_cache_) {
+          return nullptr; // Queue empty
+        }
+      }
       return &store_[read_idx & mask_];
     }
     
     auto updateReadIndex() noexcept {
+      release(1);
+    }
+    
+    // Batched consumer API: view up to max_count contiguous readable slots.
+    // Like claim(), the span stops at the end of the ring.
+    auto peek(std::size_t max_count) noexcept -> std::span<const T> {
       const auto read_idx = read_index_.value.load(std::memory_order_relaxed);
-      read_index_.value.store((read_idx + 1) & mask_, 
-                             std::memory_order_release);
-      // Decrement count after read is committed
-      count_.value.fetch_sub(1, std::memory_order_release);
+      auto avail = write_index_cache_ - read_idx;
+      if (avail < max_count) {
+        write_index_cache_ = write_index_.value.load(std::memory_order_acquire);
+        avail = write_index_cache_ - read_idx;
+      }
+      const auto offset = read_idx & mask_;
+      const auto count = std::min({max_count, avail, capacity_ - offset});
+      return {store_ + offset, count};
     }
     
-    // Exact size using count
+    // Hand the first count peeked slots back to the producer
+    auto release(std::size_t count) noexcept -> void {
+      const auto read_idx = read_index_.value.load(std::memory_order_relaxed);
+      read_index_.value.store(read_idx + count, std::memory_order_release);
+    }
+    
+    // Snapshot of occupancy; exact only when called from producer or consumer
     auto size() const noexcept {
-      return count_.value.load(std::memory_order_acquire);
+      const auto read_idx = read_index_.value.load(std::memory_order_acquire);
+      const auto write_idx = write_index_.value.load(std::memory_order_acquire);
+      return write_idx - read_idx;
     }
     
     auto capacity() const noexcept { return capacity_; }
     
+    // Cache line the producer writes on publish - UMONITOR target for waiters
+    auto producerCursorAddress() const noexcept -> const volatile void* {
+      return &write_index_.value;
+    }
+    
     // Deleted copy & move constructors and assignment-operators
     SPSCLFQueue(const SPSCLFQueue&) = delete;
     SPSCLFQueue(const SPSCLFQueue&&) = delete;
@@ -104,20 +149,21 @@ namespace Common {
     
   private:
     // Storage (pre-allocated array, no vector)
+    PageAllocation store_mem_;
     T* store_;
     const std::size_t capacity_;
     const std::size_t mask_;
     
+    // Indices grow monotonically and are masked on access, so full and
+    // empty are told apart without a shared counter.
+    
     // Producer side data (cache-line aligned)
     alignas(CACHE_LINE_SIZE) CacheAligned<std::atomic<std::size_t>> write_index_{0};
-    alignas(CACHE_LINE_SIZE) std::size_t read_index_cache_ = 0;
+    alignas(CACHE_LINE_SIZE) std::size_t read_index_cache_ = 0;   // Producer's view of read_index_
     
     // Consumer side data (cache-line aligned)  
     alignas(CACHE_LINE_SIZE) CacheAligned<std::atomic<std::size_t>> read_index_{0};
-    alignas(CACHE_LINE_SIZE) std::size_t write_index_cache_ = 0;
-    
-    // Count for distinguishing full from empty when indices are equal
-    alignas(CACHE_LINE_SIZE) CacheAligned<std::atomic<std::size_t>> count_{0};
+    alignas(CACHE_LINE_SIZE) std::size_t write_index_cache_ = 0;  // Consumer's view of write_index_
   };
   
   // Multi Producer Multi Consumer lock-free queue
@@ -125,8 +171,10 @@ namespace Common {
   class MPMCLFQueue final {
   public:
     explicit MPMCLFQueue(std::size_t num_elems) :
-        store_(static_cast<Cell*>(std::aligned_alloc(alignof(Cell), sizeof(Cell) * num_elems))),
+        store_mem_(HugePageAllocator::allocate(sizeof(Cell) * num_elems)),
+        store_(static_cast<Cell*>(store_mem_.ptr)),
         capacity_(num_elems) {
+      ASSERT(store_ != nullptr, "Failed to allocate memory for MPMCLFQueue");
       ASSERT((capacity_ & (capacity_ - 1)) == 0, 
              "Queue size must be power of 2 for optimal performance");
       
@@ -142,7 +190,7 @@ namespace Common {
       for (std::size_t i = 0; i < capacity_; ++i) {
         store_[i].~Cell();
       }
-      std::free(store_);
+      HugePageAllocator::deallocate(store_mem_);
     }
     
     // Producer side - can be called by multiple threads
@@ -215,6 +263,7 @@ namespace Common {
       Cell() : sequence(0), data() {}
     };
     
+    PageAllocation store_mem_;
     Cell* store_;  // Pre-allocated array, no vector
     const std::size_t capacity_;
     
@@ -223,6 +272,168 @@ namespace Common {
     alignas(CACHE_LINE_SIZE) CacheAligned<std::atomic<std::size_t>> read_index_{0};
   };
   
+  // Single Producer Multi Consumer broadcast ring (disruptor-style).
+  // Every registered consumer sees every element through its own cursor.
+  // The producer gates on the slowest consumer; a consumer may depend on
+  // other consumers and then only sees slots those have released, e.g.
+  // strategies reading features computed in place by an earlier stage.
+  template<typename T, std::size_t MaxElements, std::size_t MaxConsumers = 8>
+  class SPMCBroadcastRing final {
+    static_assert((MaxElements & (MaxElements - 1)) == 0,
+                  "MaxElements must be power of 2 for optimal performance");
+    static_assert(MaxElements > 0, "MaxElements must be greater than 0");
+    static_assert(MaxConsumers > 0 && MaxConsumers <= 32,
+                  "Dependencies are tracked in a 32-bit mask");
+  
+  public:
+    using ConsumerId = std::uint32_t;
+    static constexpr ConsumerId INVALID_CONSUMER = ~ConsumerId{0};
+    
+    SPMCBroadcastRing() :
+        capacity_(MaxElements),
+        mask_(MaxElements - 1) {
+      // AUDIT_IGNORE: Init-time only
+      store_mem_ = HugePageAllocator::allocate(sizeof(T) * MaxElements);
+      if (!store_mem_) {
+        std::cerr << "FATAL: Failed to allocate memory for SPMCBroadcastRing\n";
+        std::abort();  // Cannot recover from memory allocation failure at init
+      }
+      store_ = static_cast<T*>(store_mem_.ptr);
+      
+      for (std::size_t i = 0; i < capacity_; ++i) {
+        new (&store_[i]) T();
+      }
+    }
+    
+    ~SPMCBroadcastRing() {
+      for (std::size_t i = 0; i < capacity_; ++i) {
+        store_[i].~T();
+      }
+      HugePageAllocator::deallocate(store_mem_);
+    }
+    
+    // Register a consumer before the producer starts publishing.
+    // depends_on is a mask of earlier ConsumerIds this consumer must trail.
+    auto addConsumer(std::uint32_t depends_on = 0) noexcept -> ConsumerId {
+      const auto id = num_consumers_;
+      if (UNLIKELY(id >= MaxConsumers)) {
+        return INVALID_CONSUMER;
+      }
+      // Only earlier consumers are valid dependencies, which rules out cycles
+      ASSERT((depends_on >> id) == 0, "Consumer may only depend on earlier consumers");
+      
+      auto& consumer = consumers_[id];
+      consumer.depends_on = depends_on;
+      consumer.barrier_cache = 0;
+      consumer.cursor.store(published_.value.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+      ++num_consumers_;
+      return id;
+    }
+    
+    // Producer side - reserve up to max_count contiguous slots. Stops at
+    // the ring end; publish() makes the filled slots visible to everyone.
+    auto claim(std::size_t max_count) noexcept -> std::span<T> {
+      const auto write_seq = published_.value.load(std::memory_order_relaxed);
+      auto free_slots = capacity_ - (write_seq - gating_cache_);
+      if (free_slots < max_count) {
+        gating_cache_ = minCursor(~std::uint32_t{0}, write_seq);
+        free_slots = capacity_ - (write_seq - gating_cache_);
+      }
+      const auto offset = write_seq & mask_;
+      const auto count = std::min({max_count, free_slots, capacity_ - offset});
+      return {store_ + offset, count};
+    }
+    
+    auto publish(std::size_t count) noexcept -> void {
+      const auto write_seq = published_.value.load(std::memory_order_relaxed);
+      published_.value.store(write_seq + count, std::memory_order_release);
+    }
+    
+    // Consumer side - only called by the thread owning consumer id
+    auto peek(ConsumerId id, std::size_t max_count) noexcept -> std::span<const T> {
+      auto& consumer = consumers_[id];
+      const auto read_seq = consumer.cursor.load(std::memory_order_relaxed);
+      auto avail = consumer.barrier_cache - read_seq;
+      if (avail < max_count) {
+        consumer.barrier_cache = consumer.depends_on
+            ? minCursor(consumer.depends_on, published_.value.load(std::memory_order_acquire))
+            : published_.value.load(std::memory_order_acquire);
+        avail = consumer.barrier_cache - read_seq;
+      }
+      const auto offset = read_seq & mask_;
+      const auto count = std::min({max_count, avail, capacity_ - offset});
+      return {store_ + offset, count};
+    }
+    
+    // Dependent stages may write into slots they have peeked, so the
+    // mutable view is offered to consumers too.
+    auto peekMutable(ConsumerId id, std::size_t max_count) noexcept -> std::span<T> {
+      const auto view = peek(id, max_count);
+      return {const_cast<T*>(view.data()), view.size()};
+    }
+    
+    auto release(ConsumerId id, std::size_t count) noexcept -> void {
+      auto& cursor = consumers_[id].cursor;
+      const auto read_seq = cursor.load(std::memory_order_relaxed);
+      cursor.store(read_seq + count, std::memory_order_release);
+    }
+    
+    // Elements published but not yet released by the given consumer
+    auto lag(ConsumerId id) const noexcept -> std::size_t {
+      return published_.value.load(std::memory_order_acquire) -
+             consumers_[id].cursor.load(std::memory_order_acquire);
+    }
+    
+    auto capacity() const noexcept { return capacity_; }
+    auto consumerCount() const noexcept { return num_consumers_; }
+    
+    // Cache line the producer writes on publish - UMONITOR target for waiters
+    auto producerCursorAddress() const noexcept -> const volatile void* {
+      return &published_.value;
+    }
+    
+    // Deleted copy & move constructors and assignment-operators
+    SPMCBroadcastRing(const SPMCBroadcastRing&) = delete;
+    SPMCBroadcastRing(const SPMCBroadcastRing&&) = delete;
+    SPMCBroadcastRing& operator=(const SPMCBroadcastRing&) = delete;
+    SPMCBroadcastRing& operator=(const SPMCBroadcastRing&&) = delete;
+    
+  private:
+    // Lowest cursor among the consumers in mask, bounded by upper
+    auto minCursor(std::uint32_t mask, std::size_t upper) const noexcept -> std::size_t {
+      auto lowest = upper;
+      for (std::uint32_t i = 0; i < num_consumers_; ++i) {
+        if (mask & (1U << i)) {
+          const auto cursor = consumers_[i].cursor.load(std::memory_order_acquire);
+          lowest = std::min(lowest, cursor);
+        }
+      }
+      return lowest;
+    }
+    
+    struct Consumer {
+      // Read by the producer and by dependent consumers
+      alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> cursor{0};
+      // Private to the owning consumer thread
+      alignas(CACHE_LINE_SIZE) std::size_t barrier_cache = 0;
+      std::uint32_t depends_on = 0;
+    };
+    
+    // Storage (pre-allocated array, no vector)
+    PageAllocation store_mem_;
+    T* store_;
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::uint32_t num_consumers_ = 0;  // Fixed once publishing starts
+    
+    // Producer side data (cache-line aligned)
+    alignas(CACHE_LINE_SIZE) CacheAligned<std::atomic<std::size_t>> published_{0};
+    alignas(CACHE_LINE_SIZE) std::size_t gating_cache_ = 0;  // Producer's view of the slowest cursor
+    
+    std::array<Consumer, MaxConsumers> consumers_{};
+  };
+  
   // Backwards compatibility alias
   template<typename T, std::size_t MaxElements = 1024>
   using LFQueue = SPSCLFQueue<T, MaxElements>;
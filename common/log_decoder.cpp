@@ -0,0 +1,166 @@
+// Offline decoder for binary log files (LOGGER_MODE=binary).
+// Prints one line per record in the same layout as the text logger:
+//   [seconds.nanos][LEVEL][Ttid] message
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <string>
+
+#include "log_format.h"
+
+namespace {
+
+struct SiteDef {
+  uint16_t level;
+  uint32_t line;
+  std::string format;
+  std::string file;
+};
+
+template<typename T>
+bool readValue(FILE* in, T& value) {
+  return std::fread(&value, sizeof(value), 1, in) == 1;
+}
+
+// max bounds what a corrupt length field can make us read and format
+bool readBytes(FILE* in, std::string& out, size_t max = UINT16_MAX) {
+  uint16_t len = 0;
+  if (!readValue(in, len) || len > max) {
+    return false;
+  }
+  out.resize(len);
+  return len == 0 || std::fread(out.data(), 1, len, in) == len;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc != 2) {
+    std::fprintf(stderr, "Usage: %s <binary log file>\n", argv[0]);
+    return 1;
+  }
+
+  FILE* in = std::fopen(argv[1], "rb");
+  if (!in) {
+    std::perror(argv[1]);
+    return 1;
+  }
+
+  // Version 01 calibration points carry no TSC rate
+  char magic[sizeof(Common::LOG_BINARY_MAGIC)];
+  const size_t version_at = sizeof(magic) - 2;
+  const bool read_magic = std::fread(magic, 1, sizeof(magic), in) == sizeof(magic);
+  const bool v1 = read_magic && std::memcmp(magic, Common::LOG_BINARY_MAGIC, version_at) == 0 &&
+                  std::memcmp(magic + version_at, "01", 2) == 0;
+  if (!read_magic || (!v1 && std::memcmp(magic, Common::LOG_BINARY_MAGIC, sizeof(magic)) != 0)) {
+    std::fprintf(stderr, "%s: not a binary log file\n", argv[1]);
+    std::fclose(in);
+    return 1;
+  }
+
+  std::unordered_map<uint32_t, SiteDef> sites;
+  uint64_t calib_tsc = 0;
+  uint64_t calib_wall = 0;
+  uint64_t prev_tsc = 0;
+  uint64_t prev_wall = 0;
+  double ticks_per_ns = 0.0;
+
+  // Records are stamped relative to the calibration point written with
+  // each batch, at the TSC rate it carries (version 01: the rate between
+  // consecutive calibration points).
+  auto toWall = [&](uint64_t tsc) -> uint64_t {
+    if (ticks_per_ns <= 0.0) {
+      return calib_wall;
+    }
+    // Only the offset goes through a double; epoch nanoseconds don't fit its mantissa
+    const auto delta_ticks = static_cast<int64_t>(tsc - calib_tsc);
+    const auto delta_ns = static_cast<int64_t>(static_cast<double>(delta_ticks) / ticks_per_ns);
+    return calib_wall + static_cast<uint64_t>(delta_ns);
+  };
+
+  auto printLine = [](uint64_t wall_ns, uint16_t level, uint32_t thread, const char* msg, size_t len) {
+    std::printf("[%llu.%09llu][%s][T%u] %.*s\n",
+                static_cast<unsigned long long>(wall_ns / 1000000000ULL),
+                static_cast<unsigned long long>(wall_ns % 1000000000ULL),
+                Common::logLevelName(level), thread, static_cast<int>(len), msg);
+  };
+
+  std::string payload;
+  char text[1024];
+  int kind = 0;
+  bool ok = true;
+  while (ok && (kind = std::fgetc(in)) != EOF) {
+    switch (static_cast<Common::LogBinaryRecord>(kind)) {
+      case Common::LogBinaryRecord::Calibration: {
+        ok = readValue(in, calib_tsc) && readValue(in, calib_wall);
+        if (ok && !v1) {
+          ok = readValue(in, ticks_per_ns);
+          break;
+        }
+        if (ok && prev_wall != 0 && calib_wall > prev_wall && calib_tsc > prev_tsc) {
+          ticks_per_ns = static_cast<double>(calib_tsc - prev_tsc) / static_cast<double>(calib_wall - prev_wall);
+        }
+        if (ok && prev_wall == 0) {
+          prev_tsc = calib_tsc;
+          prev_wall = calib_wall;
+        }
+        break;
+      }
+      case Common::LogBinaryRecord::Site: {
+        uint32_t id = 0;
+        SiteDef def{};
+        ok = readValue(in, id) && readValue(in, def.level) && readValue(in, def.line) &&
+             readBytes(in, def.format) && readBytes(in, def.file);
+        if (ok) {
+          sites[id] = std::move(def);
+        }
+        break;
+      }
+      case Common::LogBinaryRecord::Deferred: {
+        uint32_t id = 0;
+        uint64_t tsc = 0;
+        uint32_t thread = 0;
+        ok = readValue(in, id) && readValue(in, tsc) && readValue(in, thread) &&
+             readBytes(in, payload, Common::LogArgBuffer::CAPACITY);
+        if (!ok) {
+          std::fprintf(stderr, "corrupt deferred record at offset %ld\n", std::ftell(in));
+          break;
+        }
+        const auto site = sites.find(id);
+        if (site == sites.end()) {
+          std::fprintf(stderr, "record references undefined site %u\n", id);
+          break;
+        }
+        const auto len = Common::formatLogArgs(site->second.format.c_str(),
+                                               reinterpret_cast<const uint8_t*>(payload.data()),
+                                               payload.size(), text, sizeof(text));
+        printLine(toWall(tsc), site->second.level, thread, text, len);
+        break;
+      }
+      case Common::LogBinaryRecord::Text: {
+        uint16_t level = 0;
+        uint64_t tsc = 0;
+        uint32_t thread = 0;
+        ok = readValue(in, level) && readValue(in, tsc) && readValue(in, thread) && readBytes(in, payload);
+        if (ok) {
+          printLine(toWall(tsc), level, thread, payload.data(), payload.size());
+        }
+        break;
+      }
+      default:
+        if (kind == 0) {
+          // Zero padding of a final O_DIRECT block the logger never trimmed
+          std::fseek(in, 0, SEEK_END);
+          break;
+        }
+        std::fprintf(stderr, "corrupt record kind 0x%02x at offset %ld\n", kind, std::ftell(in) - 1);
+        ok = false;
+        break;
+    }
+  }
+
+  std::fclose(in);
+  return ok ? 0 : 1;
+}
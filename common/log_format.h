@@ -0,0 +1,344 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+namespace Common {
+
+/// Static description of one LOG_* call site. Lives in read-only data;
+/// deferred records carry only its address.
+struct LogSite {
+  std::uint16_t level;
+  const char* format;
+  const char* file;
+  std::uint32_t line;
+};
+
+inline auto logLevelName(std::uint16_t level) noexcept -> const char* {
+  switch (level) {
+    case 0: return "DEBUG";
+    case 1: return "INFO ";
+    case 2: return "WARN ";
+    case 3: return "ERROR";
+    case 4: return "FATAL";
+    default: return "UNKN ";
+  }
+}
+
+/// Binary log file (LogMode::Binary): an 8-byte magic, then a stream of
+/// records, each starting with its kind byte. Integers are little-endian
+/// and unpadded. Sites are defined once, before their first record.
+///   'C' u64 tsc, u64 wall_ns, f64 ticks_per_ns    - TSC calibration point
+///   'S' u32 id, u16 level, u32 line, u16 n, format[n], u16 m, file[m]
+///   'R' u32 site id, u64 tsc, u32 thread, u16 n, args[n]
+///   'T' u16 level, u64 tsc, u32 thread, u16 n, text[n]   - preformatted
+/// Version 01 files carry no slope in 'C'; the decoder still reads them.
+inline constexpr char LOG_BINARY_MAGIC[8] = {'S', 'Z', 'B', 'L', 'O', 'G', '0', '2'};
+
+enum class LogBinaryRecord : char {
+  Calibration = 'C',
+  Site = 'S',
+  Deferred = 'R',
+  Text = 'T'
+};
+
+/// One tag byte precedes every serialized argument
+enum class LogArgType : std::uint8_t {
+  I32 = 'i',
+  I64 = 'I',
+  U32 = 'u',
+  U64 = 'U',
+  F64 = 'd',
+  Str = 's',   // u16 length + bytes, truncated to fit the record
+  Ptr = 'p',
+  Unsupported = '?'
+};
+
+template<typename T>
+constexpr auto logArgType() noexcept -> LogArgType {
+  using D = std::decay_t<T>;
+  if constexpr (std::is_enum_v<D>) {
+    return logArgType<std::underlying_type_t<D>>();
+  } else if constexpr (std::is_same_v<D, bool>) {
+    return LogArgType::I32;
+  } else if constexpr (std::is_integral_v<D>) {
+    // Sub-int types are promoted to int, as printf would see them
+    if constexpr (std::is_signed_v<D> || sizeof(D) < sizeof(int)) {
+      return sizeof(D) <= 4 ? LogArgType::I32 : LogArgType::I64;
+    } else {
+      return sizeof(D) <= 4 ? LogArgType::U32 : LogArgType::U64;
+    }
+  } else if constexpr (std::is_same_v<D, float> || std::is_same_v<D, double>) {
+    return LogArgType::F64;
+  } else if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*>) {
+    return LogArgType::Str;
+  } else if constexpr (std::is_pointer_v<D> || std::is_null_pointer_v<D>) {
+    return LogArgType::Ptr;
+  } else {
+    return LogArgType::Unsupported;
+  }
+}
+
+/// Raw argument bytes of a deferred record, serialized on the hot thread.
+/// The layout of each argument is fixed at compile time by its type; only
+/// strings cost more than a store.
+struct LogArgBuffer {
+  static constexpr std::size_t CAPACITY = 240;
+
+  std::uint8_t data[CAPACITY];
+  std::size_t len = 0;
+  bool truncated = false;
+
+  template<typename T>
+  auto put(const T& value) noexcept -> void {
+    constexpr auto type = logArgType<T>();
+    using D = std::decay_t<T>;
+    if constexpr (type == LogArgType::Str) {
+      const char* str = "(null)";
+      if constexpr (std::is_array_v<T>) {
+        str = value;
+      } else if (value) {
+        str = value;
+      }
+      if (len + 3 > CAPACITY) {
+        truncated = true;
+        return;
+      }
+      const auto n = static_cast<std::uint16_t>(strnlen(str, CAPACITY - len - 3));
+      data[len] = static_cast<std::uint8_t>(type);
+      std::memcpy(data + len + 1, &n, sizeof(n));
+      std::memcpy(data + len + 3, str, n);
+      len += 3 + n;
+    } else if constexpr (type == LogArgType::Unsupported) {
+      putRaw(type, nullptr, 0);
+    } else {
+      if constexpr (type == LogArgType::I32) {
+        putScalar(type, static_cast<std::int32_t>(value));
+      } else if constexpr (type == LogArgType::I64) {
+        putScalar(type, static_cast<std::int64_t>(value));
+      } else if constexpr (type == LogArgType::U32) {
+        putScalar(type, static_cast<std::uint32_t>(value));
+      } else if constexpr (type == LogArgType::U64) {
+        putScalar(type, static_cast<std::uint64_t>(value));
+      } else if constexpr (type == LogArgType::F64) {
+        putScalar(type, static_cast<double>(value));
+      } else {
+        static_assert(std::is_pointer_v<D> || std::is_null_pointer_v<D>);
+        putScalar(type, reinterpret_cast<std::uintptr_t>(static_cast<const void*>(value)));
+      }
+    }
+  }
+
+private:
+  template<typename S>
+  auto putScalar(LogArgType type, S scalar) noexcept -> void {
+    putRaw(type, &scalar, sizeof(scalar));
+  }
+
+  auto putRaw(LogArgType type, const void* bytes, std::size_t n) noexcept -> void {
+    if (len + 1 + n > CAPACITY) {
+      truncated = true;
+      return;
+    }
+    data[len] = static_cast<std::uint8_t>(type);
+    if (n > 0) {
+      std::memcpy(data + len + 1, bytes, n);
+    }
+    len += 1 + n;
+  }
+};
+
+template<typename... Args>
+inline auto encodeLogArgs(LogArgBuffer& buf, const Args&... args) noexcept -> void {
+  (buf.put(args), ...);
+}
+
+/// Render a printf format against serialized arguments. Length modifiers
+/// in the format are ignored and rebuilt from the stored types, so a
+/// mismatched %d/%ld can't misread the bytes. Returns the length written
+/// (always NUL-terminated, truncated to out_len - 1).
+inline auto formatLogArgs(const char* format, const std::uint8_t* args, std::size_t args_len,
+                          char* out, std::size_t out_len) noexcept -> std::size_t {
+  if (out_len == 0) {
+    return 0;
+  }
+  std::size_t pos = 0;
+  std::size_t arg_pos = 0;
+
+  auto emit = [&](const char* s, std::size_t n) {
+    const auto room = out_len - 1 - pos;
+    const auto take = n < room ? n : room;
+    std::memcpy(out + pos, s, take);
+    pos += take;
+  };
+
+  struct Arg {
+    LogArgType type = LogArgType::Unsupported;
+    std::int64_t i = 0;
+    std::uint64_t u = 0;
+    double d = 0.0;
+    const char* s = nullptr;
+    std::uint16_t s_len = 0;
+    bool present = false;
+  };
+
+  auto next_arg = [&]() -> Arg {
+    Arg a;
+    if (arg_pos >= args_len) {
+      return a;
+    }
+    a.type = static_cast<LogArgType>(args[arg_pos++]);
+    a.present = true;
+    auto read = [&](void* dst, std::size_t n) {
+      if (arg_pos + n > args_len) {
+        a.present = false;
+        arg_pos = args_len;
+        return;
+      }
+      std::memcpy(dst, args + arg_pos, n);
+      arg_pos += n;
+    };
+    switch (a.type) {
+      case LogArgType::I32: { std::int32_t v = 0; read(&v, sizeof(v)); a.i = v; break; }
+      case LogArgType::I64: { read(&a.i, sizeof(a.i)); break; }
+      case LogArgType::U32: { std::uint32_t v = 0; read(&v, sizeof(v)); a.u = v; break; }
+      case LogArgType::U64:
+      case LogArgType::Ptr: { read(&a.u, sizeof(a.u)); break; }
+      case LogArgType::F64: { read(&a.d, sizeof(a.d)); break; }
+      case LogArgType::Str: {
+        read(&a.s_len, sizeof(a.s_len));
+        // Lengths come from the record, which may be a corrupt file's
+        if (a.present && a.s_len <= LogArgBuffer::CAPACITY && arg_pos + a.s_len <= args_len) {
+          a.s = reinterpret_cast<const char*>(args + arg_pos);
+          arg_pos += a.s_len;
+        } else {
+          a.present = false;
+        }
+        break;
+      }
+      case LogArgType::Unsupported: break;
+      default: a.present = false; arg_pos = args_len; break;
+    }
+    return a;
+  };
+
+  const char* p = format;
+  while (*p && pos + 1 < out_len) {
+    if (*p != '%') {
+      const char* lit = p;
+      while (*p && *p != '%') ++p;
+      emit(lit, static_cast<std::size_t>(p - lit));
+      continue;
+    }
+    if (p[1] == '%') {
+      emit("%", 1);
+      p += 2;
+      continue;
+    }
+
+    // Rebuild the conversion spec: flags, width, precision, our modifier
+    char spec[48];
+    std::size_t sl = 0;
+    spec[sl++] = '%';
+    ++p;
+    while (*p && std::strchr("-+ #0'", *p) && sl < 8) spec[sl++] = *p++;
+    auto copy_number = [&]() {
+      if (*p == '*') {
+        const auto star = next_arg();
+        const int n = snprintf(spec + sl, sizeof(spec) - sl - 8, "%d",
+                               static_cast<int>(star.type == LogArgType::I32 ? star.i : 0));
+        sl += n > 0 ? static_cast<std::size_t>(n) : 0;
+        ++p;
+      } else {
+        while (*p >= '0' && *p <= '9' && sl < 24) spec[sl++] = *p++;
+        while (*p >= '0' && *p <= '9') ++p;
+      }
+    };
+    copy_number();
+    if (*p == '.') {
+      spec[sl++] = *p++;
+      copy_number();
+    }
+    while (*p && std::strchr("hljztLq", *p)) ++p;
+    const char conv = *p;
+    if (conv == '\0') {
+      break;
+    }
+    ++p;
+    if (conv == 'n') {
+      continue;  // Never write through a logged pointer
+    }
+
+    const auto arg = next_arg();
+    if (!arg.present) {
+      emit("<?>", 3);
+      continue;
+    }
+
+    char value[256];
+    int n = 0;
+    const bool int_conv = std::strchr("diouxXc", conv) != nullptr;
+    const bool float_conv = std::strchr("fFeEgGaA", conv) != nullptr;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat-security"
+    auto finish = [&](const char* modifier, char c) {
+      std::size_t l = sl;
+      for (const char* m = modifier; *m; ++m) spec[l++] = *m;
+      spec[l++] = c;
+      spec[l] = '\0';
+    };
+    switch (arg.type) {
+      case LogArgType::I32:
+        finish("", int_conv ? conv : 'd');
+        n = snprintf(value, sizeof(value), spec, static_cast<int>(arg.i));
+        break;
+      case LogArgType::I64:
+        finish("ll", int_conv && conv != 'c' ? conv : 'd');
+        n = snprintf(value, sizeof(value), spec, static_cast<long long>(arg.i));
+        break;
+      case LogArgType::U32:
+        finish("", int_conv ? conv : 'u');
+        n = snprintf(value, sizeof(value), spec, static_cast<unsigned int>(arg.u));
+        break;
+      case LogArgType::U64:
+        finish("ll", int_conv && conv != 'c' ? conv : 'u');
+        n = snprintf(value, sizeof(value), spec, static_cast<unsigned long long>(arg.u));
+        break;
+      case LogArgType::F64:
+        finish("", float_conv ? conv : 'g');
+        n = snprintf(value, sizeof(value), spec, arg.d);
+        break;
+      case LogArgType::Str: {
+        // Stored bytes aren't NUL-terminated; next_arg() caps the length
+        char str[LogArgBuffer::CAPACITY + 1];
+        std::memcpy(str, arg.s, arg.s_len);
+        str[arg.s_len] = '\0';
+        finish("", 's');
+        n = snprintf(value, sizeof(value), spec, str);
+        break;
+      }
+      case LogArgType::Ptr:
+        finish("", 'p');
+        n = snprintf(value, sizeof(value), spec, reinterpret_cast<void*>(static_cast<std::uintptr_t>(arg.u)));
+        break;
+      case LogArgType::Unsupported:
+      default:
+        n = snprintf(value, sizeof(value), "<?>");
+        break;
+    }
+#pragma GCC diagnostic pop
+    if (n > 0) {
+      emit(value, static_cast<std::size_t>(n) < sizeof(value) ? static_cast<std::size_t>(n) : sizeof(value) - 1);
+    }
+  }
+
+  out[pos] = '\0';
+  return pos;
+}
+
+} // namespace Common
@@ -0,0 +1,433 @@
+// log_sink.cpp - Buffered, asynchronous log file output with rotation
+
+#include "log_sink.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Common {
+
+namespace {
+
+auto ioUringSetup(unsigned entries, io_uring_params* params) noexcept -> int {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+auto ioUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) noexcept -> int {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+auto loadAcquire(unsigned* p) noexcept -> unsigned {
+  return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire);
+}
+
+auto storeRelease(unsigned* p, unsigned value) noexcept -> void {
+  std::atomic_ref<unsigned>(*p).store(value, std::memory_order_release);
+}
+
+auto roundUp(std::size_t n, std::size_t align) noexcept -> std::size_t {
+  return (n + align - 1) / align * align;
+}
+
+} // namespace
+
+LogSink::~LogSink() {
+  close();
+}
+
+auto LogSink::open(const char* path, const LogOutputConfig& config) noexcept -> bool {
+  close();
+
+  config_ = config;
+  config_.buffer_count = std::clamp<std::uint32_t>(config_.buffer_count, 2, MAX_BUFFERS);
+  config_.buffer_bytes = roundUp(std::max<std::size_t>(config_.buffer_bytes, 64 * 1024), DIRECT_ALIGN);
+  std::strncpy(path_, path, sizeof(path_) - 1);
+  path_[sizeof(path_) - 1] = '\0';
+
+  if (!openFile()) {
+    return false;
+  }
+
+  // AUDIT_IGNORE: Init-time only
+  buffer_count_ = config_.buffer_count;
+  for (std::size_t i = 0; i < buffer_count_; ++i) {
+    buffers_[i] = Buffer{};
+    buffers_[i].data = static_cast<char*>(std::aligned_alloc(DIRECT_ALIGN, config_.buffer_bytes));
+    if (!buffers_[i].data) {
+      close();
+      return false;
+    }
+  }
+  current_ = 0;
+  total_bytes_ = 0;
+  write_errors_ = 0;
+
+  if (config_.use_io_uring && !initRing(2 * MAX_BUFFERS)) {
+    closeRing();  // pwrite() from the writer thread instead
+  }
+  return true;
+}
+
+auto LogSink::close() noexcept -> void {
+  if (fd_ >= 0) {
+    sync();
+    finishFile(fd_, file_bytes_);
+    fd_ = -1;
+  }
+  while (retiring_fd_ >= 0 && in_flight_ > 0) {
+    reap(true);
+  }
+  closeRing();
+  for (auto& buf : buffers_) {
+    std::free(buf.data);
+    buf = Buffer{};
+  }
+  buffer_count_ = 0;
+  in_flight_ = 0;
+  dirty_ = false;
+  overlap_pending_ = false;
+}
+
+auto LogSink::reserve(std::size_t len) noexcept -> char* {
+  if (fd_ < 0) {
+    return nullptr;
+  }
+  auto* buf = &buffers_[current_];
+  if (buf->used + len > config_.buffer_bytes) {
+    submitCurrent(false);
+    buf = &buffers_[current_];
+  }
+  return buf->data + buf->used;
+}
+
+auto LogSink::commit(std::size_t len) noexcept -> void {
+  buffers_[current_].used += len;
+  file_bytes_ += len;
+  total_bytes_ += len;
+  dirty_ = dirty_ || len > 0;
+}
+
+auto LogSink::append(const void* data, std::size_t len) noexcept -> void {
+  if (fd_ < 0) {
+    return;
+  }
+  const auto* src = static_cast<const char*>(data);
+  while (len > 0) {
+    auto& buf = buffers_[current_];
+    const auto room = config_.buffer_bytes - buf.used;
+    if (room == 0) {
+      submitCurrent(false);
+      continue;
+    }
+    const auto take = std::min(room, len);
+    std::memcpy(buf.data + buf.used, src, take);
+    commit(take);
+    src += take;
+    len -= take;
+  }
+}
+
+auto LogSink::flush() noexcept -> void {
+  if (fd_ >= 0 && dirty_) {
+    submitCurrent(true);
+  }
+  reap(false);
+}
+
+auto LogSink::sync() noexcept -> void {
+  flush();
+  while (in_flight_ > 0) {
+    reap(true);
+  }
+}
+
+auto LogSink::rotate() noexcept -> bool {
+  if (fd_ < 0) {
+    return false;
+  }
+  if (dirty_) {
+    submitCurrent(true);
+  }
+  auto& buf = buffers_[current_];
+  buf.used = 0;
+  buf.file_offset = 0;
+  dirty_ = false;
+  overlap_pending_ = false;
+
+  // Only one file retires at a time; rotations are far apart in practice
+  while (retiring_fd_ >= 0) {
+    reap(true);
+  }
+  std::size_t pending = 0;
+  for (std::size_t i = 0; i < buffer_count_; ++i) {
+    pending += buffers_[i].in_flight && buffers_[i].fd == fd_;
+  }
+  if (pending == 0) {
+    finishFile(fd_, file_bytes_);
+  } else {
+    retiring_fd_ = fd_;
+    retiring_length_ = file_bytes_;
+    retiring_in_flight_ = pending;
+  }
+  fd_ = -1;
+
+  // path -> path.1 -> ... -> path.N; in-flight writes follow their inode
+  char from[sizeof(path_) + 16];
+  char to[sizeof(path_) + 16];
+  if (config_.rotation_count == 0) {
+    ::unlink(path_);
+  } else {
+    std::snprintf(to, sizeof(to), "%s.%u", path_, config_.rotation_count);
+    ::unlink(to);
+    for (std::uint32_t i = config_.rotation_count; i > 1; --i) {
+      std::snprintf(from, sizeof(from), "%s.%u", path_, i - 1);
+      std::snprintf(to, sizeof(to), "%s.%u", path_, i);
+      ::rename(from, to);
+    }
+    std::snprintf(to, sizeof(to), "%s.1", path_);
+    ::rename(path_, to);
+  }
+  return openFile();
+}
+
+auto LogSink::openFile() noexcept -> bool {
+  constexpr int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+  fd_ = -1;
+  align_ = 1;
+  if (config_.direct_io) {
+    // Not every filesystem takes O_DIRECT (tmpfs doesn't)
+    fd_ = ::open(path_, flags | O_DIRECT, 0644);
+    if (fd_ >= 0) {
+      align_ = DIRECT_ALIGN;
+    }
+  }
+  if (fd_ < 0) {
+    fd_ = ::open(path_, flags, 0644);
+  }
+  file_bytes_ = 0;
+  if (fd_ < 0) {
+    ++write_errors_;
+    return false;
+  }
+  return true;
+}
+
+auto LogSink::submitCurrent(bool pad_tail) noexcept -> void {
+  auto& buf = buffers_[current_];
+  const auto aligned = buf.used / align_ * align_;
+  const auto tail = buf.used - aligned;
+  const auto write_len = pad_tail ? roundUp(buf.used, align_) : aligned;
+  if (write_len == 0) {
+    return;
+  }
+  if (write_len > buf.used) {
+    std::memset(buf.data + buf.used, 0, write_len - buf.used);
+  }
+
+  // A block padded by the previous flush is rewritten here, so this write
+  // must not overtake that one
+  submitWrite(buf, write_len, overlap_pending_);
+  overlap_pending_ = pad_tail && tail > 0;
+  dirty_ = !pad_tail && tail > 0;
+
+  // The unaligned tail moves to the front of the next buffer
+  const auto next = nextFreeBuffer();
+  auto& next_buf = buffers_[next];
+  next_buf.file_offset = buf.file_offset + aligned;
+  next_buf.used = tail;
+  if (tail > 0) {
+    std::memcpy(next_buf.data, buf.data + aligned, tail);
+  }
+  current_ = next;
+}
+
+auto LogSink::submitWrite(Buffer& buf, std::size_t len, bool drain) noexcept -> void {
+  buf.fd = fd_;
+  buf.write_len = len;
+  if (ring_fd_ < 0) {
+    writeSync(buf, len);
+    return;
+  }
+
+  // The SQ has more entries than there are buffers, so it can't be full
+  const unsigned tail = *sq_tail_;
+  const unsigned index = tail & *sq_mask_;
+  auto* sqe = static_cast<io_uring_sqe*>(sqes_) + index;
+  std::memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = IORING_OP_WRITE;
+  sqe->flags = drain ? IOSQE_IO_DRAIN : 0;
+  sqe->fd = fd_;
+  sqe->off = buf.file_offset;
+  sqe->addr = reinterpret_cast<std::uint64_t>(buf.data);
+  sqe->len = static_cast<std::uint32_t>(len);
+  sqe->user_data = static_cast<std::uint64_t>(&buf - buffers_);
+  sq_array_[index] = index;
+  storeRelease(sq_tail_, tail + 1);
+
+  while (ioUringEnter(ring_fd_, 1, 0, 0) < 0) {
+    if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      // The kernel never took the SQE: take it back and write in place,
+      // after the queued writes whose last block this one may rewrite
+      storeRelease(sq_tail_, tail);
+      while (in_flight_ > 0) {
+        reap(true);
+      }
+      writeSync(buf, len);
+      return;
+    }
+    reap(false);
+  }
+  buf.in_flight = true;
+  ++in_flight_;
+}
+
+auto LogSink::writeSync(const Buffer& buf, std::size_t len) noexcept -> void {
+  std::size_t done = 0;
+  while (done < len) {
+    const auto n = ::pwrite(buf.fd, buf.data + done, len - done, static_cast<off_t>(buf.file_offset + done));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      ++write_errors_;
+      break;
+    }
+    done += static_cast<std::size_t>(n);
+  }
+}
+
+auto LogSink::nextFreeBuffer() noexcept -> std::size_t {
+  for (;;) {
+    for (std::size_t i = 1; i <= buffer_count_; ++i) {
+      const auto index = (current_ + i) % buffer_count_;
+      if (index != current_ && !buffers_[index].in_flight) {
+        return index;
+      }
+    }
+    reap(true);  // Every buffer is in flight: the disk is the bottleneck
+  }
+}
+
+auto LogSink::reap(bool wait) noexcept -> void {
+  if (ring_fd_ < 0) {
+    return;
+  }
+  unsigned head = *cq_head_;
+  unsigned tail = loadAcquire(cq_tail_);
+  if (head == tail && wait && in_flight_ > 0) {
+    ioUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+    tail = loadAcquire(cq_tail_);
+  }
+  while (head != tail) {
+    const auto& cqe = static_cast<const io_uring_cqe*>(cqes_)[head & *cq_mask_];
+    completed(static_cast<std::size_t>(cqe.user_data), cqe.res);
+    ++head;
+  }
+  storeRelease(cq_head_, head);
+}
+
+auto LogSink::completed(std::size_t index, int result) noexcept -> void {
+  if (index >= buffer_count_) {
+    return;
+  }
+  auto& buf = buffers_[index];
+  buf.in_flight = false;
+  --in_flight_;
+  if (result < 0 || static_cast<std::size_t>(result) != buf.write_len) {
+    ++write_errors_;
+  }
+  if (buf.fd == retiring_fd_ && --retiring_in_flight_ == 0) {
+    finishFile(retiring_fd_, retiring_length_);
+    retiring_fd_ = -1;
+  }
+}
+
+auto LogSink::finishFile(int fd, std::uint64_t length) noexcept -> void {
+  // Drops the zero padding of the last O_DIRECT block
+  if (::ftruncate(fd, static_cast<off_t>(length)) != 0) {
+    ++write_errors_;
+  }
+  ::close(fd);
+}
+
+auto LogSink::initRing(unsigned entries) noexcept -> bool {
+  io_uring_params params{};
+  ring_fd_ = ioUringSetup(entries, &params);
+  if (ring_fd_ < 0) {
+    return false;
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                  ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    sq_ring_ = nullptr;
+    return false;
+  }
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      cq_ring_ = nullptr;
+      return false;
+    }
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+               ring_fd_, IORING_OFF_SQES);
+  if (sqes_ == MAP_FAILED) {
+    sqes_ = nullptr;
+    return false;
+  }
+
+  auto* sq = static_cast<char*>(sq_ring_);
+  auto* cq = static_cast<char*>(cq_ring_);
+  sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+  sq_entries_ = params.sq_entries;
+  cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  cqes_ = cq + params.cq_off.cqes;
+  return sq_entries_ > buffer_count_;
+}
+
+auto LogSink::closeRing() noexcept -> void {
+  if (sqes_) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  if (ring_fd_ >= 0) {
+    ::close(ring_fd_);
+  }
+  sq_ring_ = cq_ring_ = sqes_ = cqes_ = nullptr;
+  sq_head_ = sq_tail_ = sq_mask_ = sq_array_ = nullptr;
+  cq_head_ = cq_tail_ = cq_mask_ = nullptr;
+  ring_fd_ = -1;
+}
+
+} // namespace Common
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Common {
+
+/// Output file settings for the logger's writer thread
+struct LogOutputConfig {
+  std::uint64_t max_file_bytes = 0;      // Rotate past this size, 0 = never
+  std::uint32_t rotation_count = 0;      // Old files kept as path.1 .. path.N
+  std::size_t buffer_bytes = 1 << 20;    // Size of each write buffer
+  std::uint32_t buffer_count = 4;        // Bound on buffers in flight
+  bool use_io_uring = true;              // Falls back to pwrite() if unavailable
+  bool direct_io = false;                // O_DIRECT; falls back to buffered I/O
+};
+
+/// Append-only log file fed by a single writer thread.
+///
+/// Bytes are coalesced into large page-aligned buffers; a full buffer is
+/// submitted as one write (through io_uring when available) and the
+/// writer moves on to the next free one, so at most buffer_count writes
+/// are in flight and the writer only blocks when all of them are.
+///
+/// With O_DIRECT every write is block-aligned. flush() writes the partial
+/// last block zero-padded and the next write rewrites it, so a file that
+/// wasn't closed cleanly can end in up to one block of NULs; close() and
+/// rotate() truncate it to the exact length.
+class LogSink {
+public:
+  LogSink() noexcept = default;
+  ~LogSink();
+
+  // Delete copy/move
+  LogSink(const LogSink&) = delete;
+  LogSink& operator=(const LogSink&) = delete;
+  LogSink(LogSink&&) = delete;
+  LogSink& operator=(LogSink&&) = delete;
+
+  auto open(const char* path, const LogOutputConfig& config) noexcept -> bool;
+  auto close() noexcept -> void;
+  auto isOpen() const noexcept -> bool { return fd_ >= 0; }
+
+  // Contiguous space for up to len bytes (len <= buffer_bytes / 2), made
+  // durable by commit(). Returns nullptr if the sink isn't open.
+  auto reserve(std::size_t len) noexcept -> char*;
+  auto commit(std::size_t len) noexcept -> void;
+
+  auto append(const void* data, std::size_t len) noexcept -> void;
+
+  // Submit whatever is buffered, without waiting for it
+  auto flush() noexcept -> void;
+  // Submit and wait until every write has completed
+  auto sync() noexcept -> void;
+
+  // Rotation is left to the caller so files split on record boundaries
+  auto shouldRotate() const noexcept -> bool {
+    return config_.max_file_bytes > 0 && file_bytes_ >= config_.max_file_bytes;
+  }
+  // Start a new file; the old one is closed once its writes complete
+  auto rotate() noexcept -> bool;
+
+  auto fileBytes() const noexcept -> std::uint64_t { return file_bytes_; }
+  auto totalBytes() const noexcept -> std::uint64_t { return total_bytes_; }
+  auto writeErrors() const noexcept -> std::uint64_t { return write_errors_; }
+  auto usingIoUring() const noexcept -> bool { return ring_fd_ >= 0; }
+  auto usingDirectIo() const noexcept -> bool { return align_ > 1; }
+
+private:
+  struct Buffer {
+    char* data = nullptr;
+    std::size_t used = 0;          // Bytes filled, from the block-aligned start
+    std::uint64_t file_offset = 0;
+    std::size_t write_len = 0;
+    int fd = -1;                   // File the in-flight write targets
+    bool in_flight = false;
+  };
+
+  static constexpr std::size_t MAX_BUFFERS = 16;
+  static constexpr std::size_t DIRECT_ALIGN = 4096;
+
+  auto openFile() noexcept -> bool;
+  auto initRing(unsigned entries) noexcept -> bool;
+  auto closeRing() noexcept -> void;
+
+  // Write out the current buffer and move to the next free one; with
+  // pad_tail the partial last block is written too (flush/close)
+  auto submitCurrent(bool pad_tail) noexcept -> void;
+  auto submitWrite(Buffer& buf, std::size_t len, bool drain) noexcept -> void;
+  auto writeSync(const Buffer& buf, std::size_t len) noexcept -> void;
+  auto nextFreeBuffer() noexcept -> std::size_t;
+  // Handle completions; block for at least one if wait is set
+  auto reap(bool wait) noexcept -> void;
+  auto completed(std::size_t index, int result) noexcept -> void;
+  auto finishFile(int fd, std::uint64_t length) noexcept -> void;
+
+  LogOutputConfig config_{};
+  char path_[512]{};
+  int fd_ = -1;
+  std::size_t align_ = 1;
+
+  Buffer buffers_[MAX_BUFFERS]{};
+  std::size_t buffer_count_ = 0;
+  std::size_t current_ = 0;
+  std::size_t in_flight_ = 0;
+  bool dirty_ = false;            // Bytes committed since the last submit
+  bool overlap_pending_ = false;  // Last write padded a block the next one rewrites
+
+  std::uint64_t file_bytes_ = 0;   // Logical length of the current file
+  std::uint64_t total_bytes_ = 0;
+  std::uint64_t write_errors_ = 0;
+
+  // File being closed after rotation, once its writes have landed
+  int retiring_fd_ = -1;
+  std::uint64_t retiring_length_ = 0;
+  std::size_t retiring_in_flight_ = 0;
+
+  // io_uring, set up with raw syscalls (no liburing dependency)
+  int ring_fd_ = -1;
+  void* sq_ring_ = nullptr;
+  void* cq_ring_ = nullptr;
+  std::size_t sq_ring_size_ = 0;
+  std::size_t cq_ring_size_ = 0;
+  void* sqes_ = nullptr;
+  std::size_t sqes_size_ = 0;
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned* sq_mask_ = nullptr;
+  unsigned* sq_array_ = nullptr;
+  unsigned sq_entries_ = 0;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned* cq_mask_ = nullptr;
+  void* cqes_ = nullptr;
+};
+
+} // namespace Common
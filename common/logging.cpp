@@ -1,8 +1,10 @@
-// logging_new.cpp - Robust async logger with MPMC queue
-// Based on production-quality implementation with Vyukov MPMC algorithm
+// logging.cpp - Async logger with per-thread SPSC rings
+// Producers never share a queue; the writer thread merges rings by TSC
 
 #include "logging.h"
+#include <algorithm>
 #include <atomic>
+#include <bit>
 #include <cassert>
 #include <condition_variable>
 #include <cstddef>
@@ -12,6 +14,7 @@
 #include <fstream>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <string>
 #include <string_view>
 #include <thread>
@@ -33,9 +36,9 @@
 #include <cstdio>
 #include <cstdarg>
 #include <cstdlib>
-#include <sys/uio.h>  // For writev
-#include <unistd.h>   // For writev
+#include <unistd.h>
 #include "time_utils.h"
+#include "log_sink.h"
 
 namespace Common {
 
@@ -51,6 +54,7 @@ public:
   MPMCQueue& operator=(MPMCQueue&&) = delete;
   
   struct LogRecord {
+    const LogSite* site{nullptr};  // Set for deferred records; msg holds raw args
     uint64_t timestamp{0};
     uint32_t thread_id{0};
     uint16_t level{0};
@@ -164,6 +168,130 @@ private:
   Cell* buffer_;
 };
 
+// Bumped per AsyncLoggerImpl so thread-local ring caches can spot a new logger
+static std::atomic<uint64_t> g_logger_epoch{0};
+
+// Orders a thread retiring its ring at exit against the logger freeing it
+static std::mutex g_ring_retire_mutex;
+
+// ---------- Per-thread SPSC log ring ----------
+// Each producer thread gets its own ring on its first log call. The owning
+// thread is the only writer and the logger's writer thread the only reader,
+// so logging never does an atomic RMW on a line another producer touches.
+// Records are filled in place between claim() and publish(). A ring whose
+// thread has exited is handed to the next thread that registers once the
+// writer has drained it, so the slot count bounds live threads only.
+class ThreadLogRing {
+public:
+  using LogRecord = MPMCQueue::LogRecord;
+  
+  // Delete copy/move to satisfy -Weffc++
+  ThreadLogRing(const ThreadLogRing&) = delete;
+  ThreadLogRing& operator=(const ThreadLogRing&) = delete;
+  ThreadLogRing(ThreadLogRing&&) = delete;
+  ThreadLogRing& operator=(ThreadLogRing&&) = delete;
+  
+  ThreadLogRing(std::size_t capacity, uint32_t thread_id)
+  : size_(std::min(std::bit_ceil(std::max<std::size_t>(capacity, 2)), MPMCQueue::MAX_CAPACITY)),
+    mask_(size_ - 1),
+    thread_id_(thread_id),
+    buffer_(static_cast<LogRecord*>(std::aligned_alloc(64, size_ * sizeof(LogRecord)))) {
+    if (!buffer_) {
+      std::abort();  // Fatal error
+    }
+    for (std::size_t i = 0; i < size_; ++i) {
+      new (&buffer_[i]) LogRecord();
+    }
+  }
+  
+  ~ThreadLogRing() {
+    for (std::size_t i = 0; i < size_; ++i) {
+      buffer_[i].~LogRecord();
+    }
+    std::free(buffer_);
+  }
+  
+  // Producer: slot for the next record, or nullptr (counted as a drop)
+  LogRecord* claim() noexcept {
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    if (UNLIKELY(tail - head_cache_ >= size_)) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ >= size_) {
+        drops_.store(drops_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return nullptr;
+      }
+    }
+    return &buffer_[tail & mask_];
+  }
+  
+  void publish() noexcept {
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+  
+  // Consumer: oldest record in place, or nullptr if empty
+  const LogRecord* front() noexcept {
+    const auto head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_) {
+        return nullptr;
+      }
+    }
+    return &buffer_[head & mask_];
+  }
+  
+  void pop() noexcept {
+    head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    consumed_.store(consumed_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+  
+  bool empty() const noexcept {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+  }
+  
+  uint32_t threadId() const noexcept { return thread_id_.load(std::memory_order_relaxed); }
+  uint64_t drops() const noexcept { return drops_.load(std::memory_order_relaxed); }
+  uint64_t consumed() const noexcept {
+    return consumed_.load(std::memory_order_relaxed) - consumed_base_.load(std::memory_order_relaxed);
+  }
+  
+  // Owner thread exiting; its records may still be in flight
+  void retire() noexcept { retired_.store(true, std::memory_order_release); }
+  
+  // Take over a retired ring the writer has fully drained: every published
+  // record has been popped, so the writer won't touch it until we publish.
+  // Counters restart for the new owner.
+  bool adopt(uint32_t thread_id) noexcept {
+    if (!retired_.load(std::memory_order_acquire) ||
+        consumed_.load(std::memory_order_acquire) != tail_.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    thread_id_.store(thread_id, std::memory_order_relaxed);
+    drops_.store(0, std::memory_order_relaxed);
+    consumed_base_.store(consumed_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    retired_.store(false, std::memory_order_relaxed);
+    return true;
+  }
+
+private:
+  const std::size_t size_;
+  const std::size_t mask_;
+  std::atomic<uint32_t> thread_id_;
+  LogRecord* const buffer_;
+  std::atomic<bool> retired_{false};
+  std::atomic<uint64_t> consumed_base_{0};  // consumed_ when the current owner adopted it
+  
+  // Producer line
+  alignas(64) std::atomic<std::size_t> tail_{0};
+  std::size_t head_cache_{0};
+  std::atomic<uint64_t> drops_{0};
+  
+  // Consumer line
+  alignas(64) std::atomic<std::size_t> head_{0};
+  std::size_t tail_cache_{0};
+  std::atomic<uint64_t> consumed_{0};
+};
+
 // ---------- Async logger implementation ----------
 class AsyncLoggerImpl {
 public:
@@ -173,10 +301,12 @@ public:
   AsyncLoggerImpl(AsyncLoggerImpl&&) = delete;
   AsyncLoggerImpl& operator=(AsyncLoggerImpl&&) = delete;
   
-  AsyncLoggerImpl(const char* path, std::size_t capacity = 16384)
-  : file_(nullptr),
-    file_buffer_(),
-    queue_(getQueueCapacity(capacity)),
+  AsyncLoggerImpl(const char* path, std::size_t capacity = 16384, LogMode mode = LogMode::Immediate,
+                  const LogOutputConfig& output = {})
+  : mode_(mode),
+    sink_(),
+    ring_capacity_(getQueueCapacity(capacity)),
+    overflow_(ring_capacity_),
     writer_thread_(),
     mutex_(),
     cv_(),
@@ -192,20 +322,23 @@ public:
     if (p.has_parent_path()) {
       std::error_code ec;
       std::filesystem::create_directories(p.parent_path(), ec);
-      // Ignore error - will fail at fopen if directory doesn't exist
+      // Ignore error - will fail at open if directory doesn't exist
     }
 
-    // Open file in text mode for writing  
-    file_ = std::fopen(path_, "w");  // AUDIT_IGNORE: Init-time only
-    // No fallback to stderr - just skip writes if file fails
+    // No fallback to stderr - just skip writes if the file fails to open
+    sink_.open(path_, applyOutputEnv(output));  // AUDIT_IGNORE: Init-time only
+    startFile();
+    
+    // Calibrate the TSC clock here rather than on the first record
+    TscClock::reliable();
+    
+    // The sink belongs to the writer thread once it starts
+    logStartupConfig();
     
-    // Use large buffer for file I/O if file opened successfully
-    if (file_) {
-      // Use static buffer for stdio - reduces syscalls, no dynamic allocation
-      static constexpr size_t BUFFER_SIZE = 1 << 20;  // 1MB buffer
-      alignas(64) static char static_file_buffer[BUFFER_SIZE];
-      file_buffer_ = static_file_buffer;
-      std::setvbuf(file_, file_buffer_, _IOFBF, BUFFER_SIZE);
+    // Perform self-test to verify logger is working
+    if (!performSelfTest()) {
+      // Log to stderr if file logging fails
+      std::fprintf(stderr, "Warning: Logger self-test failed for %s\n", path_);
     }
     
     // Start writer thread with optional CPU pinning
@@ -223,15 +356,6 @@ public:
       
       writerLoop(); 
     });
-    
-    // Log configuration for debugging/reproducibility
-    logStartupConfig();
-    
-    // Perform self-test to verify logger is working
-    if (!performSelfTest()) {
-      // Log to stderr if file logging fails
-      std::fprintf(stderr, "Warning: Logger self-test failed for %s\n", path_);
-    }
   }
 
   ~AsyncLoggerImpl() {
@@ -244,62 +368,98 @@ public:
       writer_thread_.join();
     }
     
-    // Close file
-    if (file_) {
-      std::fflush(file_);
-      std::fclose(file_);
+    // Exiting threads check the epoch under this lock before touching a ring
+    std::lock_guard<std::mutex> retire_lock(g_ring_retire_mutex);
+    g_logger_epoch.fetch_add(1, std::memory_order_relaxed);
+    
+    // Name the threads that lost records before the rings go away
+    const auto count = ring_count_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; ++i) {
+      if (mode_ != LogMode::Binary && rings_[i]->drops() > 0) {
+        char line[128];
+        const int len = std::snprintf(line, sizeof(line), "[LOGGER_STATS] T%u logged=%llu dropped=%llu\n",
+                                      rings_[i]->threadId(),
+                                      static_cast<unsigned long long>(rings_[i]->consumed()),
+                                      static_cast<unsigned long long>(rings_[i]->drops()));
+        sink_.append(line, static_cast<std::size_t>(std::max(len, 0)));
+      }
+      delete rings_[i];
+      rings_[i] = nullptr;
     }
+    
+    // Waits for in-flight writes and trims O_DIRECT padding
+    sink_.close();
   }
 
   bool log(uint16_t level, const char* msg, std::size_t len) noexcept {
-    MPMCQueue::LogRecord rec{};
-    // Store timestamp at enqueue time for accurate latency measurement
-    rec.timestamp = rdtsc();
-    rec.thread_id = static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
-    rec.level = level;
-    rec.len = static_cast<uint16_t>(std::min(len, sizeof(rec.msg) - 1));
-    if (rec.len > 0) {
-      std::memcpy(rec.msg, msg, rec.len);
-    }
-    rec.msg[rec.len] = '\0';
-    
-#ifdef LOGGER_TEST_FASTPATH
-    if (isTestFastPath()) {
-      // Preformat the entire line at enqueue time for minimal writer latency
-      auto now = std::chrono::system_clock::now();
-      auto duration = now.time_since_epoch();
-      auto seconds = std::chrono::duration_cast<std::chrono::seconds>(duration).count();
-      auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() % 1000000000;
-      
-      int formatted_len = std::snprintf(rec.preformatted_line, sizeof(rec.preformatted_line),
-          "[%lld.%09lld][%s][T%u] %s\n",
-          static_cast<long long>(seconds),
-          static_cast<long long>(nanos),
-          levelToString(level),
-          rec.thread_id,
-          rec.msg);
+    return submit([&](MPMCQueue::LogRecord& rec) {
+      rec.site = nullptr;
+      // Store timestamp at enqueue time for accurate latency measurement
+      rec.timestamp = rdtsc();
+      rec.level = level;
+      rec.len = static_cast<uint16_t>(std::min(len, sizeof(rec.msg) - 1));
+      if (rec.len > 0) {
+        std::memcpy(rec.msg, msg, rec.len);
+      }
+      rec.msg[rec.len] = '\0';
       
-      if (formatted_len > 0) {
-        rec.is_preformatted = true;
+#ifdef LOGGER_TEST_FASTPATH
+      rec.is_preformatted = false;
+      if (isTestFastPath()) {
+        // Preformat the entire line at enqueue time for minimal writer latency
+        auto now = std::chrono::system_clock::now();
+        auto duration = now.time_since_epoch();
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(duration).count();
+        auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() % 1000000000;
+        
+        int formatted_len = std::snprintf(rec.preformatted_line, sizeof(rec.preformatted_line),
+            "[%lld.%09lld][%s][T%u] %s\n",
+            static_cast<long long>(seconds),
+            static_cast<long long>(nanos),
+            levelToString(level),
+            rec.thread_id,
+            rec.msg);
+        
+        if (formatted_len > 0) {
+          rec.is_preformatted = true;
+        }
       }
-    }
 #endif
-    
-    bool ok = queue_.enqueue(rec);
-    if (!ok) {
-      drops_.fetch_add(1, std::memory_order_relaxed);
-    } else {
-      // Only notify when transitioning from empty → non-empty  
-      bool was_empty = queue_was_empty_.exchange(false, std::memory_order_acq_rel);
-      if (was_empty) {
-        cv_.notify_one();
-      }
-    }
-    return ok;
+    });
+  }
+
+  // Deferred records: the site pointer plus raw argument bytes
+  bool logDeferred(const LogSite& site, const uint8_t* args, std::size_t len) noexcept {
+    return submit([&](MPMCQueue::LogRecord& rec) {
+      rec.site = &site;
+      rec.timestamp = rdtsc();
+      rec.level = site.level;
+      rec.len = static_cast<uint16_t>(std::min(len, sizeof(rec.msg)));
+      std::memcpy(rec.msg, args, rec.len);
+#ifdef LOGGER_TEST_FASTPATH
+      rec.is_preformatted = false;
+#endif
+    });
   }
 
   uint64_t getDrops() const noexcept {
-    return drops_.load(std::memory_order_relaxed);
+    uint64_t drops = drops_.load(std::memory_order_relaxed);
+    const auto count = ring_count_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; ++i) {
+      drops += rings_[i]->drops();
+    }
+    return drops;
+  }
+
+  // Per-thread counters, one entry per registered ring
+  std::size_t getThreadStats(Logger::ThreadStats* out, std::size_t max) const noexcept {
+    const auto count = std::min(ring_count_.load(std::memory_order_acquire), max);
+    for (std::size_t i = 0; i < count; ++i) {
+      out[i].thread_id = rings_[i]->threadId();
+      out[i].messages_logged = rings_[i]->consumed();
+      out[i].messages_dropped = rings_[i]->drops();
+    }
+    return count;
   }
 
   uint64_t getWritten() const noexcept {
@@ -311,6 +471,147 @@ public:
   }
 
 private:
+  static constexpr std::size_t MAX_THREAD_RINGS = 64;
+  
+  // Longest text line the writer formats: header + message + newline
+  static constexpr std::size_t HEADER_MAX = 128;
+  static constexpr std::size_t MESSAGE_MAX = 512;
+  static constexpr std::size_t MAX_LINE = HEADER_MAX + MESSAGE_MAX + 1;
+  
+  // Hand the calling thread's next record to fill. Past MAX_THREAD_RINGS
+  // live threads (exited ones give their rings back), the rest share the
+  // MPMC overflow queue instead.
+  template<typename Fill>
+  bool submit(Fill&& fill) noexcept {
+    ThreadLogRing* ring = threadRing();
+    if (LIKELY(ring != nullptr)) {
+      auto* rec = ring->claim();
+      if (UNLIKELY(rec == nullptr)) {
+        return false;  // Counted by the ring
+      }
+      rec->thread_id = ring->threadId();
+      fill(*rec);
+      ring->publish();
+    } else {
+      MPMCQueue::LogRecord rec{};
+      rec.thread_id = static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+      fill(rec);
+      if (!overflow_.enqueue(rec)) {
+        drops_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+    }
+    
+    // Only notify when transitioning from empty → non-empty. Check before
+    // the exchange so a busy logger doesn't write this line on every call.
+    if (queue_was_empty_.load(std::memory_order_relaxed) &&
+        queue_was_empty_.exchange(false, std::memory_order_acq_rel)) {
+      cv_.notify_one();
+    }
+    return true;
+  }
+  
+  // The thread_local is shared by every logger instance; the epoch tells a
+  // re-initialized logger (same storage) from the one the cache was built for.
+  // Destroying a logger moves the epoch on, so a thread exiting afterwards
+  // leaves the freed ring alone.
+  ThreadLogRing* threadRing() noexcept {
+    struct RingCache {
+      uint64_t epoch{0};
+      ThreadLogRing* ring{nullptr};
+      
+      RingCache() = default;
+      RingCache(const RingCache&) = delete;
+      RingCache& operator=(const RingCache&) = delete;
+      ~RingCache() {
+        std::lock_guard<std::mutex> lock(g_ring_retire_mutex);
+        if (ring && epoch == g_logger_epoch.load(std::memory_order_relaxed)) {
+          ring->retire();
+        }
+      }
+    };
+    thread_local RingCache cache;
+    if (UNLIKELY(cache.epoch != epoch_)) {
+      cache.ring = registerThread();
+      cache.epoch = epoch_;
+    }
+    return cache.ring;
+  }
+  
+  // Reuses the ring of an exited thread before growing the table
+  ThreadLogRing* registerThread() noexcept {
+    std::lock_guard<std::mutex> lock(registry_mutex_);  // AUDIT_IGNORE: Once per thread
+    const auto tid = static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    const auto count = ring_count_.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < count; ++i) {
+      const uint64_t retired_drops = rings_[i]->drops();  // Keep them in the total
+      if (rings_[i]->adopt(tid)) {
+        drops_.fetch_add(retired_drops, std::memory_order_relaxed);
+        return rings_[i];
+      }
+    }
+    if (count == MAX_THREAD_RINGS) {
+      return nullptr;
+    }
+    auto* ring = new (std::nothrow) ThreadLogRing(ring_capacity_, tid);  // AUDIT_IGNORE: Once per thread
+    if (!ring) {
+      return nullptr;
+    }
+    rings_[count] = ring;
+    ring_count_.store(count + 1, std::memory_order_release);
+    return ring;
+  }
+  
+  // K-way merge of the ring heads by TSC. Only records already published
+  // are ordered, so a record can still trail a later one from a thread
+  // that published after this batch was cut.
+  std::size_t drainMerged(MPMCQueue::LogRecord* batch, std::size_t max) noexcept {
+    const auto count = ring_count_.load(std::memory_order_acquire);
+    const MPMCQueue::LogRecord* heads[MAX_THREAD_RINGS];
+    for (std::size_t i = 0; i < count; ++i) {
+      heads[i] = rings_[i]->front();
+    }
+    if (!overflow_pending_) {
+      overflow_pending_ = overflow_.dequeue(overflow_head_);
+    }
+    
+    std::size_t n = 0;
+    while (n < max) {
+      std::size_t best = MAX_THREAD_RINGS;
+      uint64_t best_ts = overflow_pending_ ? overflow_head_.timestamp : UINT64_MAX;
+      for (std::size_t i = 0; i < count; ++i) {
+        if (heads[i] && heads[i]->timestamp < best_ts) {
+          best = i;
+          best_ts = heads[i]->timestamp;
+        }
+      }
+      if (best < MAX_THREAD_RINGS) {
+        batch[n++] = *heads[best];
+        rings_[best]->pop();
+        heads[best] = rings_[best]->front();
+      } else if (overflow_pending_) {
+        batch[n++] = overflow_head_;
+        overflow_pending_ = overflow_.dequeue(overflow_head_);
+      } else {
+        break;
+      }
+    }
+    return n;
+  }
+  
+  bool allEmpty() const noexcept {
+    if (overflow_pending_ || !overflow_.empty()) {
+      return false;
+    }
+    const auto count = ring_count_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; ++i) {
+      if (!rings_[i]->empty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+  
   void writerLoop() {
     std::unique_lock<std::mutex> lock(mutex_);
     const int spin_count = getSpinCount();
@@ -321,10 +622,6 @@ private:
     static constexpr std::size_t MAX_BATCH_SIZE = 1024;
     MPMCQueue::LogRecord batch[MAX_BATCH_SIZE];
     
-    // Pre-allocate iovecs for writev
-    static constexpr std::size_t MAX_IOVECS = MAX_BATCH_SIZE * 2;
-    struct iovec iovecs[MAX_IOVECS];
-    
     // Cache for thread ID prefixes - use fixed-size array
     static constexpr std::size_t MAX_THREADS = 256;
     struct TidEntry {
@@ -337,11 +634,11 @@ private:
     // Time-based flush tracking
     auto last_flush = std::chrono::steady_clock::now();
     
-    while (running_.load(std::memory_order_acquire) || !queue_.empty()) {
+    while (running_.load(std::memory_order_acquire) || !allEmpty()) {
       // Adaptive spin before blocking wait
       bool found = false;
       for (int i = 0; i < spin_count; ++i) {
-        if (!queue_.empty()) {
+        if (!allEmpty()) {
           found = true;
           break;
         }
@@ -351,30 +648,34 @@ private:
       if (!found) {
         // Wait with shorter timeout for faster response
         cv_.wait_for(lock, std::chrono::milliseconds(1), [this] {
-          return !running_.load(std::memory_order_acquire) || !queue_.empty();
+          return !running_.load(std::memory_order_acquire) || !allEmpty();
         });
       }
       
       lock.unlock();
       
-      // Drain in batches
-      std::size_t n = 0;
-      while (n < batch_size && queue_.dequeue(batch[n])) {
-        ++n;
-      }
+      // Drain in batches, merged across threads in timestamp order
+      const std::size_t n = drainMerged(batch, batch_size);
       
       // Write batch to file
-      if (n > 0 && file_) {
-        // Use writev for batch output to reduce syscalls
-        std::size_t iovec_count = 0;
-        
-        // Thread-local buffers for formatting
-        thread_local char header_buffers[256][128];  // Headers
-        thread_local char msg_newlines[256][2];      // "\n" strings
-        
+      if (n > 0 && sink_.isOpen()) {
+        if (mode_ == LogMode::Binary) {
+          writeBinaryBatch(batch, n);
+        } else {
         for (std::size_t i = 0; i < n; ++i) {
           auto& rec = batch[i];
           
+#ifdef LOGGER_TEST_FASTPATH
+          // Fast path: use preformatted lines if available
+          if (rec.is_preformatted) {
+            const auto line_len = std::strlen(rec.preformatted_line);
+            sink_.append(rec.preformatted_line, line_len);
+            written_.fetch_add(1, std::memory_order_relaxed);
+            bytes_.fetch_add(line_len, std::memory_order_relaxed);
+            continue;
+          }
+#endif
+          
           // Cache thread ID prefix - use simple hash for lookup
           uint32_t cache_idx = rec.thread_id % MAX_THREADS;
           TidEntry* tid_entry = &tid_cache[cache_idx];
@@ -387,71 +688,47 @@ private:
             tid_entry->valid = true;
           }
           
-          // Format timestamp and header
-          auto now = std::chrono::system_clock::now();
-          auto duration = now.time_since_epoch();
-          auto seconds = std::chrono::duration_cast<std::chrono::seconds>(duration).count();
-          auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() % 1000000000;
+          // Stamped with the record's own TSC rather than the write time
+          const uint64_t wall_ns = TscClock::tscToEpochNs(rec.timestamp);
+          const auto seconds = wall_ns / 1000000000ULL;
+          const auto nanos = wall_ns % 1000000000ULL;
           
-          int header_len = std::snprintf(header_buffers[i], sizeof(header_buffers[i]),
+          // Format straight into the sink's write buffer
+          char* out = sink_.reserve(MAX_LINE);
+          int header_len = std::snprintf(out, HEADER_MAX,
               "[%lld.%09lld][%s][%s] ",
               static_cast<long long>(seconds),
               static_cast<long long>(nanos),
               levelToString(rec.level),
               tid_entry->prefix);
-          
-          if (header_len > 0 && iovec_count + 3 < MAX_IOVECS) {
-            // Add header
-            iovecs[iovec_count++] = {header_buffers[i], static_cast<size_t>(header_len)};
-            // Add message
-            iovecs[iovec_count++] = {rec.msg, rec.len};
-            // Add newline
-            msg_newlines[i][0] = '\n';
-            msg_newlines[i][1] = '\0';
-            iovecs[iovec_count++] = {msg_newlines[i], 1};
-            
-            written_.fetch_add(1, std::memory_order_relaxed);
-            bytes_.fetch_add(static_cast<uint64_t>(header_len + rec.len + 1), std::memory_order_relaxed);
+          if (header_len <= 0) {
+            continue;
           }
-        }
-        
-#ifdef LOGGER_TEST_FASTPATH
-        // Fast path: use preformatted lines if available
-        if (isTestFastPath()) {
-          for (std::size_t i = 0; i < n; ++i) {
-            if (batch[i].is_preformatted) {
-              std::fwrite(batch[i].preformatted_line, 1, std::strlen(batch[i].preformatted_line), file_);
-              written_.fetch_add(1, std::memory_order_relaxed);
-              bytes_.fetch_add(std::strlen(batch[i].preformatted_line), std::memory_order_relaxed);
-            }
-          }
-        } else {
-#endif
-        // Write all at once with writev (with safety checks)
-        if (iovec_count > 0) {
-          int fd = fileno(file_);
-          bool use_writev = isRegularFile(fd);
+          std::size_t line_len = std::min(static_cast<std::size_t>(header_len), HEADER_MAX - 1);
           
-          if (use_writev) {
-            ssize_t written = ::writev(fd, iovecs, static_cast<int>(iovec_count));
-            if (written < 0) {
-              use_writev = false;  // Fall back on error
-            }
+          // Deferred records are formatted here, off the hot thread
+          if (rec.site) {
+            line_len += formatLogArgs(rec.site->format, reinterpret_cast<const uint8_t*>(rec.msg), rec.len,
+                                      out + line_len, MESSAGE_MAX);
+          } else {
+            std::memcpy(out + line_len, rec.msg, rec.len);
+            line_len += rec.len;
           }
+          out[line_len++] = '\n';
+          sink_.commit(line_len);
           
-          if (!use_writev) {
-            // Fall back to stdio
-            for (std::size_t i = 0; i < n; ++i) {
-              std::fprintf(file_, "%s%s\n", header_buffers[i], batch[i].msg);
-            }
-          }
+          written_.fetch_add(1, std::memory_order_relaxed);
+          bytes_.fetch_add(line_len, std::memory_order_relaxed);
         }
-#ifdef LOGGER_TEST_FASTPATH
         }
-#endif
+        
+        // Split files on batch boundaries, never mid-record
+        if (sink_.shouldRotate() && sink_.rotate()) {
+          startFile();
+        }
         
         // Mark queue as potentially empty for notify throttling
-        if (queue_.empty()) {
+        if (allEmpty()) {
           queue_was_empty_.store(true, std::memory_order_release);
         }
         
@@ -464,15 +741,15 @@ private:
         auto time_since_flush = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_flush).count();
         
         // Flush if: queue empty, batch limit reached, or time limit exceeded
-        bool should_flush = queue_.empty() || flush_counter_ >= FLUSH_INTERVAL || time_since_flush >= flush_ms;
+        bool should_flush = allEmpty() || flush_counter_ >= FLUSH_INTERVAL || time_since_flush >= flush_ms;
 #ifdef LOGGER_TEST_FASTPATH
         // In test fast path, always flush when queue is empty for immediate visibility
         if (isTestFastPath()) {
-          should_flush = queue_.empty();
+          should_flush = allEmpty();
         }
 #endif
         if (should_flush) {
-          std::fflush(file_);
+          sink_.flush();
           flush_counter_ = 0;
           last_flush = now;
         }
@@ -482,21 +759,82 @@ private:
     }
     
     // Final flush
-    if (file_) {
-      std::fflush(file_);
-    }
+    sink_.sync();
   }
 
   const char* levelToString(uint16_t level) const noexcept {
-    switch (level) {
-      case 0: return "DEBUG";
-      case 1: return "INFO ";
-      case 2: return "WARN ";
-      case 3: return "ERROR";
-      case 4: return "FATAL";
-      default: return "UNKN ";
+    return logLevelName(level);
+  }
+
+  // Binary mode: sites are defined on first use, records carry raw args.
+  // Formatting is left entirely to log_decoder.
+  void writeBinaryBatch(const MPMCQueue::LogRecord* batch, std::size_t n) noexcept {
+    // TscClock's own mapping, so every record decodes from the first one
+    const uint64_t tsc = rdtsc();
+    putBinary(LogBinaryRecord::Calibration);
+    putBinary(tsc);
+    putBinary(TscClock::tscToEpochNs(tsc));
+    putBinary(TscClock::ticksPerNs());
+    
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto& rec = batch[i];
+      if (rec.site) {
+        const uint32_t id = binarySiteId(rec.site);
+        putBinary(LogBinaryRecord::Deferred);
+        putBinary(id);
+      } else {
+        putBinary(LogBinaryRecord::Text);
+        putBinary(rec.level);
+      }
+      putBinary(rec.timestamp);
+      putBinary(rec.thread_id);
+      putBinary(rec.len);
+      sink_.append(rec.msg, rec.len);
+      written_.fetch_add(1, std::memory_order_relaxed);
+      bytes_.fetch_add(rec.len + 19u, std::memory_order_relaxed);
     }
   }
+  
+  template<typename T>
+  void putBinary(T value) noexcept {
+    sink_.append(&value, sizeof(value));
+  }
+  
+  void putBinaryString(const char* str) noexcept {
+    const auto len = static_cast<uint16_t>(strnlen(str, UINT16_MAX));
+    putBinary(len);
+    sink_.append(str, len);
+  }
+  
+  // Open-addressed site table, writer thread only. Once full, sites are
+  // simply redefined under a fresh id each time, which the decoder accepts.
+  uint32_t binarySiteId(const LogSite* site) noexcept {
+    const auto hash = static_cast<std::size_t>((reinterpret_cast<uintptr_t>(site) >> 3) * 0x9E3779B97F4A7C15ULL);
+    for (std::size_t probe = 0; probe < MAX_SITES; ++probe) {
+      auto& slot = site_table_[(hash + probe) & (MAX_SITES - 1)];
+      if (slot.site == site) {
+        return slot.id;
+      }
+      if (slot.site == nullptr) {
+        slot.site = site;
+        slot.id = next_site_id_++;
+        defineBinarySite(slot.id, site);
+        return slot.id;
+      }
+    }
+    const uint32_t id = next_site_id_++;
+    defineBinarySite(id, site);
+    return id;
+  }
+  
+  void defineBinarySite(uint32_t id, const LogSite* site) noexcept {
+    putBinary(LogBinaryRecord::Site);
+    putBinary(id);
+    putBinary(site->level);
+    putBinary(site->line);
+    putBinaryString(site->format);
+    putBinaryString(site->file);
+  }
 
   static std::size_t getQueueCapacity(std::size_t default_capacity) {
     const char* env = std::getenv("LOGGER_QUEUE_CAPACITY");
@@ -553,42 +891,60 @@ private:
     return -1;  // No pinning by default
   }
   
-  bool isRegularFile(int fd) const {
-    struct stat st;
-    if (fstat(fd, &st) == 0) {
-      return S_ISREG(st.st_mode);
+  // Every file, including each one rotation starts, begins with the
+  // magic in binary mode, and sites are defined afresh in it
+  void startFile() noexcept {
+    if (mode_ != LogMode::Binary) {
+      return;
+    }
+    sink_.append(LOG_BINARY_MAGIC, sizeof(LOG_BINARY_MAGIC));
+    for (auto& slot : site_table_) {
+      slot = SiteSlot{};
     }
-    return false;
   }
   
   void logStartupConfig() {
-    if (!file_) return;
+    if (!sink_.isOpen() || mode_ == LogMode::Binary) return;
     
     // Log configuration to file for reproducibility
-    std::fprintf(file_, "[LOGGER_CONFIG] queue_capacity=%zu batch_size=%zu spin_count=%d flush_ms=%d writer_cpu=%d\n",
+    char line[256];
+    const int len = std::snprintf(line, sizeof(line),
+        "[LOGGER_CONFIG] queue_capacity=%zu batch_size=%zu spin_count=%d flush_ms=%d writer_cpu=%d "
+        "io_uring=%d direct_io=%d\n",
         getQueueCapacity(4096),  // Show effective capacity
         getBatchSize(),
         getSpinCount(), 
         getFlushMs(),
-        getWriterCpuCore());
-    std::fflush(file_);
+        getWriterCpuCore(),
+        sink_.usingIoUring(),
+        sink_.usingDirectIo());
+    sink_.append(line, static_cast<std::size_t>(std::max(len, 0)));
   }
   
   bool performSelfTest() {
-    if (!file_) return false;
+    if (!sink_.isOpen()) return false;
     
-    // Write a test line and verify it appears
-    const char* test_msg = "[SELF_TEST] Logger initialization complete";
-    std::fprintf(file_, "%s\n", test_msg);
-    std::fflush(file_);
-    
-    // Check file size increased
-    struct stat st;
-    if (fstat(fileno(file_), &st) == 0) {
-      return st.st_size > 0;
+    // Write a test line and verify it lands (binary files only get the magic)
+    if (mode_ != LogMode::Binary) {
+      static constexpr char test_msg[] = "[SELF_TEST] Logger initialization complete\n";
+      sink_.append(test_msg, sizeof(test_msg) - 1);
     }
+    sink_.sync();
     
-    return false;
+    return sink_.fileBytes() > 0 && sink_.writeErrors() == 0;
+  }
+  
+  // LOGGER_IO_URING=0 and LOGGER_DIRECT_IO=1 override the configured output
+  static LogOutputConfig applyOutputEnv(LogOutputConfig config) {
+    const char* env = std::getenv("LOGGER_IO_URING");
+    if (env) {
+      config.use_io_uring = std::strcmp(env, "0") != 0;
+    }
+    env = std::getenv("LOGGER_DIRECT_IO");
+    if (env) {
+      config.direct_io = std::strcmp(env, "0") != 0;
+    }
+    return config;
   }
   
 #ifdef LOGGER_TEST_FASTPATH
@@ -604,10 +960,23 @@ private:
   }
 #endif
 
+  static constexpr std::size_t MAX_SITES = 4096;
+  struct SiteSlot {
+    const LogSite* site{nullptr};
+    uint32_t id{0};
+  };
+
   char path_[512];
-  FILE* file_;
-  char* file_buffer_;  // Buffer for setvbuf (points to static storage)
-  MPMCQueue queue_;
+  LogMode mode_;
+  LogSink sink_;  // Writer thread only, after construction
+  std::size_t ring_capacity_;
+  ThreadLogRing* rings_[MAX_THREAD_RINGS]{};
+  std::atomic<std::size_t> ring_count_{0};
+  std::mutex registry_mutex_;
+  const uint64_t epoch_{g_logger_epoch.fetch_add(1, std::memory_order_relaxed) + 1};
+  MPMCQueue overflow_;
+  MPMCQueue::LogRecord overflow_head_{};  // Writer's lookahead into overflow_
+  bool overflow_pending_{false};
   std::thread writer_thread_;
   std::mutex mutex_;
   std::condition_variable cv_;
@@ -617,15 +986,19 @@ private:
   alignas(64) std::atomic<uint64_t> bytes_{0};
   alignas(64) std::atomic<bool> queue_was_empty_{true};
   uint32_t flush_counter_{0};
+  SiteSlot site_table_[MAX_SITES]{};
+  uint32_t next_site_id_{0};
 };
 
 // Global logger instance
 static AsyncLoggerImpl* g_logger_impl = nullptr;
 static std::mutex g_logger_mutex;
+static LogOutputConfig g_log_output;  // Applied by the next initLogging()
 
 // Logger class implementation
-Logger::Logger(const char* filename) 
+Logger::Logger(const char* filename, LogMode mode) 
     : filename_(),
+      mode_(mode),
       running_(true),
       writer_thread_(),
       log_buffer_(),
@@ -650,6 +1023,11 @@ void Logger::stop() noexcept {
     // No-op - managed by global singleton
 }
 
+std::size_t Logger::getThreadStats(ThreadStats* out, std::size_t max) const noexcept {
+    std::lock_guard<std::mutex> lock(g_logger_mutex);
+    return g_logger_impl ? g_logger_impl->getThreadStats(out, max) : 0;
+}
+
 Logger::Stats Logger::getStats() const noexcept {
     Stats stats;
     std::lock_guard<std::mutex> lock(g_logger_mutex);
@@ -664,8 +1042,19 @@ Logger::Stats Logger::getStats() const noexcept {
 // Global logger instance
 Logger* g_logger = nullptr;
 
-// Initialize global logger
+// Initialize global logger, mode from LOGGER_MODE
 void initLogging(const char* log_file) {
+    LogMode mode = LogMode::Immediate;
+    const char* env = std::getenv("LOGGER_MODE");
+    if (env && std::strcmp(env, "deferred") == 0) {
+        mode = LogMode::Deferred;
+    } else if (env && std::strcmp(env, "binary") == 0) {
+        mode = LogMode::Binary;
+    }
+    initLogging(log_file, mode);
+}
+
+void initLogging(const char* log_file, LogMode mode) {
     std::lock_guard<std::mutex> lock(g_logger_mutex);
     
     // Clean up old instance
@@ -687,10 +1076,19 @@ void initLogging(const char* log_file) {
     // Use placement new with static storage to avoid heap allocation
     alignas(AsyncLoggerImpl) static char impl_storage[sizeof(AsyncLoggerImpl)];
     g_logger_impl = reinterpret_cast<AsyncLoggerImpl*>(impl_storage);
-    new (g_logger_impl) AsyncLoggerImpl(log_file, default_capacity);
+    new (g_logger_impl) AsyncLoggerImpl(log_file, default_capacity, mode, g_log_output);
     // Use placement new with static storage to avoid heap allocation
     alignas(Logger) static char logger_storage[sizeof(Logger)];
-    g_logger = new (logger_storage) Logger(log_file);
+    g_logger = new (logger_storage) Logger(log_file, mode);
+
+    // Record timestamps are raw TSCs converted on the writer thread; keep
+    // the TSC mapping disciplined for as long as anything is being logged
+    TscClock::start();
+}
+
+void configureLogOutput(const LogOutputConfig& config) {
+    std::lock_guard<std::mutex> lock(g_logger_mutex);
+    g_log_output = config;
 }
 
 // Shutdown global logger
@@ -707,6 +1105,7 @@ void shutdownLogging() {
         g_logger_impl->~AsyncLoggerImpl();
         g_logger_impl = nullptr;
     }
+    TscClock::stop();
 }
 
 // Internal logging function used by macros
@@ -735,6 +1134,13 @@ void logMessageToGlobal(Logger::Level level, const char* msg, size_t len) {
     }
 }
 
+// Non-template function called by Logger::logAt in deferred/binary modes
+void logDeferredToGlobal(const LogSite& site, const uint8_t* args, size_t len) {
+    if (g_logger_impl) {
+        g_logger_impl->logDeferred(site, args, len);
+    }
+}
+
 // Stub implementations for removed methods
 const char* Logger::levelToString(Level /*level*/) const noexcept {
     return "INFO";
@@ -13,6 +13,8 @@
 
 #include "macros.h"
 #include "time_utils.h"
+#include "log_format.h"
+#include "log_sink.h"
 
 namespace Common {
 
@@ -24,7 +26,7 @@ class alignas(64) LockFreeLogBuffer {
     
 public:
     struct alignas(32) LogEntry {
-        uint64_t timestamp;
+        uint64_t timestamp;  // rdtsc(); TscClock::tscToEpochNs() gives wall time
         uint32_t thread_id;
         uint16_t level;
         uint16_t length;
@@ -108,6 +110,13 @@ private:
     std::array<LogEntry, BUFFER_SIZE> buffer_;
 };
 
+/// Where LOG_* formatting happens
+enum class LogMode : uint8_t {
+    Immediate,  // snprintf on the calling thread (default)
+    Deferred,   // Caller stores site + raw args; writer thread formats text
+    Binary      // Caller stores site + raw args; file holds binary records for log_decoder
+};
+
 /// Ultra-fast logger with async background thread
 class Logger {
 public:
@@ -129,7 +138,7 @@ public:
     Logger(Logger&&) = delete;
     Logger& operator=(Logger&&) = delete;
     
-    explicit Logger(const char* filename = nullptr);
+    explicit Logger(const char* filename = nullptr, LogMode mode = LogMode::Immediate);
     
     ~Logger();
     
@@ -138,6 +147,13 @@ public:
     void log(Level level, const char* format, Args&&... args) noexcept;
     // Implementation must be after global functions are declared
     
+    // Entry point of the LOG_* macros. In the deferred modes the calling
+    // thread only serializes the arguments next to the call-site address.
+    template<typename... Args>
+    void logAt(const LogSite& site, Args&&... args) noexcept;
+    
+    LogMode mode() const noexcept { return mode_; }
+    
     // Convenience methods for different log levels
     template<typename... Args>
     void debug(const char* format, Args&&... args) noexcept {
@@ -174,6 +190,16 @@ public:
     
     Stats getStats() const noexcept;
     
+    // Each logging thread has its own ring, so drops are attributable
+    struct ThreadStats {
+        uint32_t thread_id = 0;  // Same ID as the [T...] column
+        uint64_t messages_logged = 0;
+        uint64_t messages_dropped = 0;
+    };
+    
+    // Fills up to max entries, returns how many threads have logged
+    size_t getThreadStats(ThreadStats* out, size_t max) const noexcept;
+    
 private:
     // Old implementation removed - now uses global singleton
     void writerLoop() noexcept;
@@ -182,6 +208,7 @@ private:
     void formatTimestamp(uint64_t rdtsc_time, char* buffer, size_t size) const noexcept;
     
     char filename_[256];  // Fixed size filename buffer
+    LogMode mode_;
     std::atomic<bool> running_;
     std::thread writer_thread_;
     
@@ -203,10 +230,16 @@ private:
 // Global logger instance
 extern Logger* g_logger;
 
-// Initialize global logger
+// Initialize global logger; the mode comes from LOGGER_MODE
+// (immediate|deferred|binary), immediate if unset. Also starts the
+// TscClock drift-correction thread that record timestamps depend on.
 void initLogging(const char* filename = "trading.log");
+void initLogging(const char* filename, LogMode mode);
 
-// Cleanup global logger
+// Rotation and write-path settings, used from the next initLogging() on
+void configureLogOutput(const LogOutputConfig& config);
+
+// Cleanup global logger and stop the TscClock thread
 void shutdownLogging();
 
 // Template implementation for Logger::log - must be after global functions
@@ -236,12 +269,35 @@ void Logger::log(Level level, const char* format, Args&&... args) noexcept {
     }
 }
 
+template<typename... Args>
+void Logger::logAt(const LogSite& site, Args&&... args) noexcept {
+    if (mode_ == LogMode::Immediate) {
+        log(static_cast<Level>(site.level), site.format, std::forward<Args>(args)...);
+        return;
+    }
+    
+    LogArgBuffer buffer;
+    encodeLogArgs(buffer, args...);
+    
+    extern void logDeferredToGlobal(const LogSite& site, const uint8_t* args, size_t len);
+    logDeferredToGlobal(site, buffer.data, buffer.len);
+}
+
+// Each expansion owns a static LogSite in read-only data; its address is
+// the call-site ID stored by deferred records.
+#define COMMON_LOG_AT(level, fmt, ...) \
+    if (Common::g_logger) Common::g_logger->logAt( \
+        []() noexcept -> const Common::LogSite& { \
+            static constexpr Common::LogSite log_site{level, fmt, __FILE__, __LINE__}; \
+            return log_site; \
+        }() __VA_OPT__(,) __VA_ARGS__)
+
 // Fast logging macros
-#define LOG_DEBUG(...) if (Common::g_logger) Common::g_logger->debug(__VA_ARGS__)
-#define LOG_INFO(...)  if (Common::g_logger) Common::g_logger->info(__VA_ARGS__)
-#define LOG_WARN(...)  if (Common::g_logger) Common::g_logger->warn(__VA_ARGS__)
-#define LOG_ERROR(...) if (Common::g_logger) Common::g_logger->error(__VA_ARGS__)
-#define LOG_FATAL(...) if (Common::g_logger) Common::g_logger->fatal(__VA_ARGS__)
+#define LOG_DEBUG(...) COMMON_LOG_AT(Common::Logger::DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)  COMMON_LOG_AT(Common::Logger::INFO, __VA_ARGS__)
+#define LOG_WARN(...)  COMMON_LOG_AT(Common::Logger::WARN, __VA_ARGS__)
+#define LOG_ERROR(...) COMMON_LOG_AT(Common::Logger::ERROR, __VA_ARGS__)
+#define LOG_FATAL(...) COMMON_LOG_AT(Common::Logger::FATAL, __VA_ARGS__)
 
 
 } // namespace Common
\ No newline at end of file
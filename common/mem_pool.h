@@ -2,17 +2,21 @@
 
 #include <atomic>
 #include <memory>
+#include <new>
 #include <array>
 #include <algorithm>
+#include <bit>
 #include <utility>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
 #include <thread>
 #include <sched.h>
 #include <immintrin.h>
 #include <numa.h>
 
 #include "macros.h"
+#include "huge_pages.h"
 
 namespace Common {
 
@@ -23,35 +27,154 @@ enum class ZeroPolicy {
     OnRelease   // Zero on deallocation (debug/test)
 };
 
-/// NUMA-aware memory allocator with prefaulting
+/// Per-thread identity used to find a thread's magazine in each pool.
+/// Tokens are never reused, so a stale slot can't be mistaken for ours.
+inline auto currentThreadToken() noexcept -> uint32_t {
+    static std::atomic<uint32_t> next_token{1};
+    static thread_local uint32_t token = 0;
+    if (UNLIKELY(token == 0)) {
+        token = next_token.fetch_add(1, std::memory_order_relaxed);
+    }
+    return token;
+}
+
+/// Process-unique pool id, keys the per-thread slot lookup cache
+inline auto nextPoolUid() noexcept -> uint64_t {
+    static std::atomic<uint64_t> next_uid{1};
+    return next_uid.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// Shared between a pool and the exit hooks of threads that used it, so a
+/// thread outliving the pool skips it. The lock is only taken when the
+/// pool is destroyed and when such a thread exits.
+struct PoolLifetime {
+    std::mutex mutex;
+    bool alive = true;
+};
+
+/// Pools the calling thread holds a magazine in, released when the thread
+/// exits. Registered on the slow path, the first time a thread claims a
+/// magazine in a pool.
+class ThreadCacheGuard {
+public:
+    using ReleaseFn = void (*)(void* pool) noexcept;
+    
+    static auto instance() noexcept -> ThreadCacheGuard& {
+        static thread_local ThreadCacheGuard guard;
+        return guard;
+    }
+    
+    // False once MAX_POOLS pools are tracked; that pool's magazine then
+    // needs an explicit releaseThreadCache()
+    auto track(const std::shared_ptr<PoolLifetime>& lifetime, void* pool, ReleaseFn release) noexcept -> bool {
+        for (size_t i = 0; i < count_; ++i) {
+            if (entries_[i].pool == pool && entries_[i].lifetime == lifetime) {
+                return true;
+            }
+        }
+        if (count_ == MAX_POOLS) {
+            return false;
+        }
+        entries_[count_++] = Entry{lifetime, pool, release};
+        return true;
+    }
+    
+    ~ThreadCacheGuard() {
+        for (size_t i = 0; i < count_; ++i) {
+            auto& entry = entries_[i];
+            std::lock_guard<std::mutex> lock(entry.lifetime->mutex);
+            if (entry.lifetime->alive) {
+                entry.release(entry.pool);
+            }
+        }
+    }
+    
+private:
+    static constexpr size_t MAX_POOLS = 32;
+    
+    struct Entry {
+        std::shared_ptr<PoolLifetime> lifetime;
+        void* pool = nullptr;
+        ReleaseFn release = nullptr;
+    };
+    
+    ThreadCacheGuard() = default;
+    
+    std::array<Entry, MAX_POOLS> entries_{};
+    size_t count_ = 0;
+};
+
+/// NUMA-aware memory allocator with prefaulting.
+///
+/// Each thread allocates from and frees into its own magazine, a small LIFO
+/// of free block indices held in the pool. Magazines refill from and flush
+/// to a shared depot a batch at a time; the depot is a lock-free stack of
+/// pre-linked batches. Threads that can't get a magazine (more than
+/// MAX_THREADS users) free onto a lock-free remote-free list, which
+/// refills drain once the depot runs dry. The hot path takes no lock and
+/// touches no shared cache line.
 template<size_t BLOCK_SIZE, size_t NUM_BLOCKS, ZeroPolicy POLICY = ZeroPolicy::None>
 class MemoryPool {
     static_assert(BLOCK_SIZE >= 64, "Block size must be at least 64 bytes for cache-line alignment");
     static_assert(NUM_BLOCKS > 0, "Must have at least one block");
+    static_assert(NUM_BLOCKS < 0xFFFFFFFFu, "Block indices are 32-bit");
+    
+    static constexpr uint32_t INVALID_IDX = 0xFFFFFFFFu;
     
     // Split Arrays (SoA) design: separate headers from payloads
     // This maintains cache-line alignment for payloads
     struct alignas(64) Header {
-        std::atomic<uint8_t> state{0};     // 0 = Free, 1 = InUse
-        std::atomic<uint32_t> next_idx{0xFFFFFFFFu}; // Index of next free block
+        std::atomic<uint8_t> state{0};                  // 0 = Free, 1 = InUse
+        std::atomic<uint32_t> next_idx{INVALID_IDX};    // Next block in a batch or remote-free chain
+        std::atomic<uint32_t> next_batch{INVALID_IDX};  // Next batch in the depot (batch heads only)
+        std::atomic<uint32_t> batch_len{0};             // Blocks in this batch (batch heads only)
     };
     
     static constexpr size_t CACHE_LINE = 64;
     // Round block size up to cache line multiple for alignment
     static constexpr size_t ALIGNED_BLOCK_SIZE = ((BLOCK_SIZE + CACHE_LINE - 1) / CACHE_LINE) * CACHE_LINE;
     
+    // Magazines refill and flush BATCH_SIZE blocks at a time. Blocks cached
+    // in other threads' magazines can't be handed out, so small pools get
+    // small batches: EXPECTED_THREADS full magazines hold at most a quarter
+    // of the pool.
+    static constexpr size_t EXPECTED_THREADS = 4;
+    static constexpr uint32_t BATCH_SIZE =
+        static_cast<uint32_t>(std::clamp<size_t>(NUM_BLOCKS / (8 * EXPECTED_THREADS), 1, 32));
+    static constexpr uint32_t MAGAZINE_CAPACITY = 2 * BATCH_SIZE;
+    static constexpr size_t MAX_THREADS = 64;
+    
+    // Per-thread LIFO cache of free block indices. Only the owning thread
+    // touches count/indices; outstanding is read by the statistics.
+    struct alignas(64) Magazine {
+        std::atomic<uint32_t> owner{0};         // Thread token, 0 = unclaimed
+        uint32_t count = 0;
+        std::atomic<int64_t> outstanding{0};    // Allocated minus deallocated through this magazine
+        uint32_t indices[MAGAZINE_CAPACITY]{};
+    };
+    
+    struct SlotCacheEntry {
+        uint64_t pool_uid = 0;
+        Magazine* magazine = nullptr;
+    };
+    
 public:
-    explicit MemoryPool(int numa_node = -1) : numa_node_(numa_node) {
+    explicit MemoryPool(int numa_node = -1)
+        : numa_node_(numa_node), uid_(nextPoolUid()), lifetime_(std::make_shared<PoolLifetime>()) {
         if (numa_node_ < 0 && numa_available() >= 0) {
             numa_node_ = numa_node_of_cpu(sched_getcpu());
         }
         
         allocateMemory();
         initializeFreeList();
-        prefaultPages();
     }
     
     ~MemoryPool() {
+        {
+            // Threads exiting from here on leave their magazines alone
+            std::lock_guard<std::mutex> lock(lifetime_->mutex);
+            lifetime_->alive = false;
+        }
         deallocateMemory();
     }
     
@@ -60,60 +183,44 @@ public:
     MemoryPool(const MemoryPool&) = delete;
     MemoryPool& operator=(const MemoryPool&) = delete;
     
-    // Thread-safe O(1) allocation with tight spinlock
+    // Thread-safe O(1) allocation, lock-free and served from the
+    // calling thread's magazine in the common case
     void* allocate() noexcept {
-        void* result = nullptr;
+        uint32_t idx = INVALID_IDX;
         
-        // Acquire spinlock with exponential backoff
-        int backoff = 1;
-        while (allocation_lock_.test_and_set(std::memory_order_acquire)) {
-            // Backoff with pause to reduce cache-line ping-pong
-            for (int i = 0; i < backoff; ++i) {
-                #if defined(__x86_64__) || defined(__i386__)
-                    __builtin_ia32_pause();
-                #elif defined(__aarch64__)
-                    __asm__ volatile("yield");
-                #else
-                    std::this_thread::yield();
-                #endif
+        if (Magazine* mag = localMagazine(); LIKELY(mag != nullptr)) {
+            if (UNLIKELY(mag->count == 0)) {
+                refill(*mag);
+            }
+            if (LIKELY(mag->count > 0)) {
+                idx = mag->indices[--mag->count];
+                mag->outstanding.store(mag->outstanding.load(std::memory_order_relaxed) + 1,
+                                       std::memory_order_relaxed);
+            }
+        } else {
+            idx = popSingle();
+            if (idx != INVALID_IDX) {
+                unowned_outstanding_.fetch_add(1, std::memory_order_relaxed);
             }
-            backoff = std::min(backoff * 2, 64); // Cap backoff
         }
         
-        // Critical section - keep this TINY
-        {
-            uint32_t head_idx = free_head_idx_.load(std::memory_order_relaxed);
-            if (head_idx != 0xFFFFFFFFu) {
-                Header* hdr = &headers_[head_idx];
-                
-                // Mark as in-use (should always succeed for free list nodes)
-                uint8_t expected = 0;
-                if (hdr->state.compare_exchange_strong(expected, 1, std::memory_order_acq_rel)) {
-                    free_head_idx_.store(hdr->next_idx.load(std::memory_order_relaxed), std::memory_order_relaxed);
-                    allocated_count_.fetch_add(1, std::memory_order_relaxed);
-                    result = indexToPayload(head_idx);
-                } else {
-                    // Shouldn't happen - node in free list should be free
-                    // But handle gracefully for safety
-                    result = nullptr;
-                }
-            }
+        if (UNLIKELY(idx == INVALID_IDX)) {
+            return nullptr;  // Pool exhausted
         }
         
-        // Release lock
-        allocation_lock_.clear(std::memory_order_release);
+        headers_[idx].state.store(1, std::memory_order_release);
+        void* result = indexToPayload(idx);
         
         // Apply zero policy if configured
         if constexpr (POLICY == ZeroPolicy::OnAcquire) {
-            if (result) {
-                clearBlock(result);
-            }
+            clearBlock(result);
         }
         
         return result;
     }
     
-    // Thread-safe O(1) deallocation - idempotent (double-free safe)
+    // Thread-safe O(1) deallocation - idempotent (double-free safe).
+    // Any thread may free any block; it lands in the caller's magazine.
     void deallocate(void* ptr) noexcept {
         if (UNLIKELY(!ptr || !isValidPointer(ptr))) {
             return;
@@ -130,44 +237,28 @@ public:
             return; // Invalid index
         }
         
-        Header* hdr = &headers_[idx];
-        
         // Try to mark as free - this makes deallocation idempotent
         uint8_t expected = 1;  // Expect InUse state
-        if (!hdr->state.compare_exchange_strong(expected, 0, std::memory_order_acq_rel)) {
+        if (!headers_[idx].state.compare_exchange_strong(expected, 0, std::memory_order_acq_rel)) {
             // Already free or being freed - this is a double-free, safely ignore
             return;
         }
         
-        // Acquire spinlock
-        while (allocation_lock_.test_and_set(std::memory_order_acquire)) {
-            #if defined(__x86_64__) || defined(__i386__)
-                __builtin_ia32_pause();
-            #elif defined(__aarch64__)
-                __asm__ volatile("yield");  
-            #else
-                std::this_thread::yield();
-            #endif
-        }
-        
-        // Critical section - push to free list
-        {
-            uint32_t old_head = free_head_idx_.load(std::memory_order_relaxed);
-            hdr->next_idx.store(old_head, std::memory_order_relaxed);
-            free_head_idx_.store(idx, std::memory_order_relaxed);
-            
-            // Defensive: only decrement if counter is non-zero
-            auto current = allocated_count_.load(std::memory_order_relaxed);
-            if (current > 0) {
-                allocated_count_.fetch_sub(1, std::memory_order_relaxed);
+        if (Magazine* mag = localMagazine(); LIKELY(mag != nullptr)) {
+            if (UNLIKELY(mag->count == MAGAZINE_CAPACITY)) {
+                flush(*mag);
             }
+            mag->indices[mag->count++] = idx;
+            mag->outstanding.store(mag->outstanding.load(std::memory_order_relaxed) - 1,
+                                   std::memory_order_relaxed);
+        } else {
+            pushRemote(idx);
+            unowned_outstanding_.fetch_sub(1, std::memory_order_relaxed);
         }
-        
-        // Release lock
-        allocation_lock_.clear(std::memory_order_release);
     }
     
-    // Bulk allocation for reduced contention
+    // Bulk allocation - each call is served from the local magazine, which
+    // refills a whole batch at a time
     size_t allocateBulk(void** ptrs, size_t count) noexcept {
         size_t allocated = 0;
         
@@ -182,7 +273,7 @@ public:
         return allocated;
     }
     
-    // Bulk deallocation for reduced contention
+    // Bulk deallocation - overflow is flushed to the depot a batch at a time
     void deallocateBulk(void** ptrs, size_t count) noexcept {
         for (size_t i = 0; i < count; ++i) {
             if (ptrs[i]) {
@@ -192,10 +283,34 @@ public:
         }
     }
     
-    // Statistics
+    // Return the calling thread's cached blocks to the depot and give up
+    // its magazine. Runs by itself when a thread exits; call it earlier to
+    // hand the blocks back while the thread lives on.
+    void releaseThreadCache() noexcept {
+        const uint32_t token = currentThreadToken();
+        for (auto& mag : magazines_) {
+            if (mag.owner.load(std::memory_order_acquire) != token) {
+                continue;
+            }
+            while (mag.count > 0) {
+                flush(mag);
+            }
+            mag.owner.store(0, std::memory_order_release);
+        }
+        auto& entry = slotCache()[uid_ % SLOT_CACHE_SIZE];
+        if (entry.pool_uid == uid_) {
+            entry = SlotCacheEntry{};
+        }
+    }
+    
+    // Statistics - blocks cached in magazines count as free
     size_t totalBlocks() const noexcept { return NUM_BLOCKS; }
     size_t allocatedBlocks() const noexcept { 
-        return allocated_count_.load(std::memory_order_acquire); 
+        int64_t total = unowned_outstanding_.load(std::memory_order_acquire);
+        for (const auto& mag : magazines_) {
+            total += mag.outstanding.load(std::memory_order_acquire);
+        }
+        return total > 0 ? static_cast<size_t>(total) : 0;
     }
     size_t freeBlocks() const noexcept { 
         return NUM_BLOCKS - allocatedBlocks(); 
@@ -215,6 +330,16 @@ public:
         return ptr;
     }
     
+    // Index of a block handed out by this pool (INVALID_IDX otherwise)
+    uint32_t blockIndex(const void* ptr) const noexcept {
+        return payloadToIndex(ptr);
+    }
+    
+    // Payload of block idx; pairs with blockIndex() for handle schemes
+    void* blockAt(uint32_t idx) const noexcept {
+        return indexToPayload(idx);
+    }
+    
     // Memory pool health check
     bool isValid() const noexcept {
         return headers_ != nullptr && 
@@ -239,103 +364,201 @@ public:
 #endif
     
 private:
-    void allocateMemory() {
-        // Allocate separate arrays for headers and payloads
-        const size_t headers_size = NUM_BLOCKS * sizeof(Header);
-        const size_t payloads_size = NUM_BLOCKS * ALIGNED_BLOCK_SIZE;
+    static constexpr size_t SLOT_CACHE_SIZE = 8;
+    
+    // Direct-mapped per-thread cache of (pool uid -> magazine)
+    static auto slotCache() noexcept -> std::array<SlotCacheEntry, SLOT_CACHE_SIZE>& {
+        static thread_local std::array<SlotCacheEntry, SLOT_CACHE_SIZE> cache{};
+        return cache;
+    }
+    
+    // Calling thread's magazine, or nullptr once all MAX_THREADS are taken
+    Magazine* localMagazine() noexcept {
+        auto& entry = slotCache()[uid_ % SLOT_CACHE_SIZE];
+        if (LIKELY(entry.pool_uid == uid_)) {
+            return entry.magazine;
+        }
         
-        if (numa_node_ >= 0 && numa_available() >= 0) {
-            // NUMA-aware allocation for both arrays
-            headers_ = static_cast<Header*>(numa_alloc_onnode(headers_size, numa_node_));
-            if (!headers_) {
-                headers_ = static_cast<Header*>(aligned_alloc(64, headers_size));
+        Magazine* mag = claimMagazine();
+        if (mag) {
+            entry.pool_uid = uid_;
+            entry.magazine = mag;
+        }
+        return mag;
+    }
+    
+    // Slow path: find the magazine this thread already owns (its cache
+    // entry may have been evicted) or claim a free one
+    Magazine* claimMagazine() noexcept {
+        const uint32_t token = currentThreadToken();
+        for (auto& mag : magazines_) {
+            if (mag.owner.load(std::memory_order_acquire) == token) {
+                return &mag;
             }
-            
-            payloads_ = numa_alloc_onnode(payloads_size, numa_node_);
-            if (!payloads_) {
-                payloads_ = aligned_alloc(64, payloads_size);
+        }
+        for (auto& mag : magazines_) {
+            uint32_t expected = 0;
+            if (mag.owner.compare_exchange_strong(expected, token, std::memory_order_acq_rel)) {
+                ThreadCacheGuard::instance().track(lifetime_, this, &releaseOnExit);
+                return &mag;
             }
-        } else {
-            // Regular aligned allocation
-            headers_ = static_cast<Header*>(aligned_alloc(64, headers_size));
-            payloads_ = aligned_alloc(64, payloads_size);
         }
-        
-        ASSERT(headers_ != nullptr && payloads_ != nullptr, "Failed to allocate memory pool");
+        return nullptr;
     }
     
-    void deallocateMemory() {
-        if (headers_) {
-            if (numa_node_ >= 0 && numa_available() >= 0) {
-                numa_free(headers_, NUM_BLOCKS * sizeof(Header));
-            } else {
-                free(headers_);
-            }
-            headers_ = nullptr;
+    static void releaseOnExit(void* pool) noexcept {
+        static_cast<MemoryPool*>(pool)->releaseThreadCache();
+    }
+    
+    // Refill an empty magazine: one depot batch, else drain the remote list
+    void refill(Magazine& mag) noexcept {
+        uint32_t idx = popBatch();
+        if (idx == INVALID_IDX) {
+            idx = remote_head_.exchange(INVALID_IDX, std::memory_order_acquire);
+        }
+        while (idx != INVALID_IDX && mag.count < MAGAZINE_CAPACITY) {
+            mag.indices[mag.count++] = idx;
+            idx = headers_[idx].next_idx.load(std::memory_order_relaxed);
+        }
+        if (idx != INVALID_IDX) {
+            pushChain(idx);  // Surplus from a long remote-free chain
         }
+    }
+    
+    // Move the coldest BATCH_SIZE indices of a magazine to the depot
+    void flush(Magazine& mag) noexcept {
+        const uint32_t n = std::min(mag.count, BATCH_SIZE);
+        for (uint32_t i = 0; i + 1 < n; ++i) {
+            headers_[mag.indices[i]].next_idx.store(mag.indices[i + 1], std::memory_order_relaxed);
+        }
+        headers_[mag.indices[n - 1]].next_idx.store(INVALID_IDX, std::memory_order_relaxed);
+        pushBatch(mag.indices[0], n);
         
-        if (payloads_) {
-            if (numa_node_ >= 0 && numa_available() >= 0) {
-                numa_free(payloads_, NUM_BLOCKS * ALIGNED_BLOCK_SIZE);
-            } else {
-                free(payloads_);
+        mag.count -= n;
+        std::memmove(mag.indices, mag.indices + n, mag.count * sizeof(uint32_t));
+    }
+    
+    // Depot: Treiber stack of batches, head tagged against ABA
+    void pushBatch(uint32_t head, uint32_t len) noexcept {
+        headers_[head].batch_len.store(len, std::memory_order_relaxed);
+        uint64_t old = depot_head_.load(std::memory_order_relaxed);
+        uint64_t desired;
+        do {
+            headers_[head].next_batch.store(static_cast<uint32_t>(old), std::memory_order_relaxed);
+            desired = (((old >> 32) + 1) << 32) | head;
+        } while (!depot_head_.compare_exchange_weak(old, desired,
+                                                    std::memory_order_release,
+                                                    std::memory_order_relaxed));
+    }
+    
+    uint32_t popBatch() noexcept {
+        uint64_t old = depot_head_.load(std::memory_order_acquire);
+        for (;;) {
+            const auto head = static_cast<uint32_t>(old);
+            if (head == INVALID_IDX) {
+                return INVALID_IDX;
+            }
+            // May read a stale link if head was popped meanwhile; the tag
+            // makes the CAS fail in that case
+            const uint32_t next = headers_[head].next_batch.load(std::memory_order_relaxed);
+            const uint64_t desired = (((old >> 32) + 1) << 32) | next;
+            if (depot_head_.compare_exchange_weak(old, desired,
+                                                  std::memory_order_acquire,
+                                                  std::memory_order_acquire)) {
+                return head;
             }
-            payloads_ = nullptr;
         }
     }
     
-    void initializeFreeList() {
-        // Initialize headers with free state and build free list
-        for (size_t i = 0; i < NUM_BLOCKS; ++i) {
-            Header* hdr = &headers_[i];
-            
-            // Initialize state as free
-            hdr->state.store(0, std::memory_order_relaxed);
-            
-            // Set next index in free list
-            if (i < NUM_BLOCKS - 1) {
-                hdr->next_idx.store(static_cast<uint32_t>(i + 1), std::memory_order_relaxed);
-            } else {
-                hdr->next_idx.store(0xFFFFFFFFu, std::memory_order_relaxed);  // Last block
+    // Split an INVALID_IDX-terminated chain into depot batches
+    void pushChain(uint32_t idx) noexcept {
+        while (idx != INVALID_IDX) {
+            const uint32_t head = idx;
+            uint32_t len = 1;
+            while (len < BATCH_SIZE) {
+                const uint32_t next = headers_[idx].next_idx.load(std::memory_order_relaxed);
+                if (next == INVALID_IDX) break;
+                idx = next;
+                ++len;
             }
+            const uint32_t rest = headers_[idx].next_idx.load(std::memory_order_relaxed);
+            headers_[idx].next_idx.store(INVALID_IDX, std::memory_order_relaxed);
+            pushBatch(head, len);
+            idx = rest;
+        }
+    }
+    
+    // Remote-free list: lock-free push, drained whole by refill()
+    void pushRemote(uint32_t idx) noexcept {
+        uint32_t old = remote_head_.load(std::memory_order_relaxed);
+        do {
+            headers_[idx].next_idx.store(old, std::memory_order_relaxed);
+        } while (!remote_head_.compare_exchange_weak(old, idx,
+                                                     std::memory_order_release,
+                                                     std::memory_order_relaxed));
+    }
+    
+    // Single-block path for threads without a magazine
+    uint32_t popSingle() noexcept {
+        uint32_t head = popBatch();
+        if (head != INVALID_IDX) {
+            const uint32_t len = headers_[head].batch_len.load(std::memory_order_relaxed);
+            if (len > 1) {
+                pushBatch(headers_[head].next_idx.load(std::memory_order_relaxed), len - 1);
+            }
+            return head;
         }
         
-        // Initialize free head to first block
-        free_head_idx_.store(0, std::memory_order_release);
+        head = remote_head_.exchange(INVALID_IDX, std::memory_order_acquire);
+        if (head != INVALID_IDX) {
+            pushChain(headers_[head].next_idx.load(std::memory_order_relaxed));
+        }
+        return head;
     }
     
-    void prefaultPages() {
-        // Touch every page in both arrays to ensure they're allocated and in memory
-        const size_t page_size = 4096; // Assume 4KB pages
+    void allocateMemory() {
+        // Allocate separate arrays for headers and payloads, from huge
+        // pages when configured, bound to our NUMA node and prefaulted
+        const int node = numa_available() >= 0 ? numa_node_ : -1;
+        headers_mem_ = HugePageAllocator::allocate(NUM_BLOCKS * sizeof(Header), node);
+        payloads_mem_ = HugePageAllocator::allocate(NUM_BLOCKS * ALIGNED_BLOCK_SIZE, node);
         
-        // Prefault headers array
-        const size_t headers_size = NUM_BLOCKS * sizeof(Header);
-        char* headers_mem = reinterpret_cast<char*>(headers_);
-        for (size_t offset = 0; offset < headers_size; offset += page_size) {
-            volatile char dummy = headers_mem[offset];
-            (void)dummy;
-            if (offset + page_size < headers_size) {
-#ifdef __SSE__
-                _mm_prefetch(headers_mem + offset + page_size, _MM_HINT_T0);
-#else
-                __builtin_prefetch(headers_mem + offset + page_size, 0, 3);
-#endif
-            }
+        ASSERT(headers_mem_ && payloads_mem_, "Failed to allocate memory pool");
+        
+        headers_ = static_cast<Header*>(headers_mem_.ptr);
+        for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+            new (&headers_[i]) Header();
+        }
+        payloads_ = payloads_mem_.ptr;
+    }
+    
+    void deallocateMemory() {
+        if (headers_) {
+            std::destroy_n(headers_, NUM_BLOCKS);
+            headers_ = nullptr;
+        }
+        payloads_ = nullptr;
+        HugePageAllocator::deallocate(headers_mem_);
+        HugePageAllocator::deallocate(payloads_mem_);
+    }
+    
+    void initializeFreeList() {
+        // Initialize headers with free state
+        for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+            headers_[i].state.store(0, std::memory_order_relaxed);
         }
         
-        // Prefault payloads array
-        const size_t payloads_size = NUM_BLOCKS * ALIGNED_BLOCK_SIZE;
-        char* payloads_mem = static_cast<char*>(payloads_);
-        for (size_t offset = 0; offset < payloads_size; offset += page_size) {
-            volatile char dummy = payloads_mem[offset];
-            (void)dummy;
-            if (offset + page_size < payloads_size) {
-#ifdef __SSE__
-                _mm_prefetch(payloads_mem + offset + page_size, _MM_HINT_T0);
-#else
-                __builtin_prefetch(payloads_mem + offset + page_size, 0, 3);
-#endif
+        // Seed the depot with pre-linked batches, pushed last-first so the
+        // lowest addresses are handed out first
+        const size_t num_batches = (NUM_BLOCKS + BATCH_SIZE - 1) / BATCH_SIZE;
+        for (size_t b = num_batches; b-- > 0;) {
+            const size_t first = b * BATCH_SIZE;
+            const size_t last = std::min(first + BATCH_SIZE, NUM_BLOCKS) - 1;
+            for (size_t i = first; i < last; ++i) {
+                headers_[i].next_idx.store(static_cast<uint32_t>(i + 1), std::memory_order_relaxed);
             }
+            headers_[last].next_idx.store(INVALID_IDX, std::memory_order_relaxed);
+            pushBatch(static_cast<uint32_t>(first), static_cast<uint32_t>(last - first + 1));
         }
     }
     
@@ -345,10 +568,10 @@ private:
         return static_cast<char*>(payloads_) + (idx * ALIGNED_BLOCK_SIZE);
     }
     
-    uint32_t payloadToIndex(void* ptr) const noexcept {
+    uint32_t payloadToIndex(const void* ptr) const noexcept {
         if (!ptr) return 0xFFFFFFFFu;
-        char* p = static_cast<char*>(ptr);
-        char* base = static_cast<char*>(payloads_);
+        const char* p = static_cast<const char*>(ptr);
+        const char* base = static_cast<const char*>(payloads_);
         ptrdiff_t offset = p - base;
         if (offset < 0 || offset >= static_cast<ptrdiff_t>(NUM_BLOCKS * ALIGNED_BLOCK_SIZE)) {
             return 0xFFFFFFFFu;
@@ -396,19 +619,26 @@ private:
     }
     
     int numa_node_;
+    const uint64_t uid_;  // Never reused, keys the per-thread slot cache
+    std::shared_ptr<PoolLifetime> lifetime_;  // Checked by thread exit hooks
     
     // Split Arrays: separate headers and payloads for cache alignment
     Header* headers_ = nullptr;        // Array of headers
     void* payloads_ = nullptr;         // Array of payload blocks
+    PageAllocation headers_mem_;
+    PageAllocation payloads_mem_;
+    
+    // Shared depot of free batches: (ABA tag << 32) | head index
+    alignas(64) std::atomic<uint64_t> depot_head_{INVALID_IDX};
     
-    // Spinlock for thread safety (cache-line aligned)
-    alignas(64) std::atomic_flag allocation_lock_ = ATOMIC_FLAG_INIT;
+    // Lock-free remote-free list head (single blocks)
+    alignas(64) std::atomic<uint32_t> remote_head_{INVALID_IDX};
     
-    // Free list head index (protected by spinlock)  
-    std::atomic<uint32_t> free_head_idx_{0xFFFFFFFFu};
+    // Outstanding blocks of threads that had no magazine
+    alignas(64) std::atomic<int64_t> unowned_outstanding_{0};
     
-    // Statistics
-    std::atomic<size_t> allocated_count_{0};
+    // Per-thread magazines, claimed on first use
+    std::array<Magazine, MAX_THREADS> magazines_{};
 };
 
 /// Typed memory pool for objects
@@ -459,6 +689,112 @@ public:
 template<typename T>
 using LFMemPool = MemPool<T>;
 
+/// Typed object pool handing out 32-bit generation-tagged handles.
+///
+/// The low INDEX_BITS of a handle select the block and the rest carry the
+/// block's generation, bumped on every release. A handle that outlived its
+/// object fails get()/release() in O(1) instead of aliasing the block's
+/// next occupant. Each pool has its own Handle type, so handles from
+/// different pools can't be mixed up.
+template<typename T, size_t NUM_OBJECTS>
+class ObjectPool {
+    static_assert(alignof(T) <= 64, "Pool blocks are cache-line aligned");
+    static_assert(NUM_OBJECTS > 1, "Must have at least two objects");
+    
+    static constexpr uint32_t INDEX_BITS = static_cast<uint32_t>(std::bit_width(NUM_OBJECTS - 1));
+    static_assert(INDEX_BITS <= 24, "Leave at least 8 generation bits");
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    // Largest generation is skipped so no handle equals Handle::INVALID
+    static constexpr uint32_t GEN_LIMIT = (0xFFFFFFFFu >> INDEX_BITS);
+    
+    using Pool = MemoryPool<std::max(sizeof(T), size_t{64}), NUM_OBJECTS>;
+    
+public:
+    struct Handle {
+        static constexpr uint32_t INVALID = 0xFFFFFFFFu;
+        uint32_t value{INVALID};
+        
+        bool valid() const noexcept { return value != INVALID; }
+        bool operator==(const Handle&) const noexcept = default;
+    };
+    static_assert(sizeof(Handle) == 4);
+    
+    explicit ObjectPool(int numa_node = -1) : pool_(numa_node) {
+        // AUDIT_IGNORE: Init-time only
+        generations_mem_ = HugePageAllocator::allocate(NUM_OBJECTS * sizeof(std::atomic<uint32_t>), numa_node);
+        ASSERT(generations_mem_.ptr != nullptr, "Failed to allocate object pool generations");
+        generations_ = static_cast<std::atomic<uint32_t>*>(generations_mem_.ptr);
+        for (size_t i = 0; i < NUM_OBJECTS; ++i) {
+            new (&generations_[i]) std::atomic<uint32_t>(0);
+        }
+    }
+    
+    ~ObjectPool() {
+        HugePageAllocator::deallocate(generations_mem_);
+    }
+    
+    // Delete copy constructor and assignment operator
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+    
+    // Construct a T in a free block; invalid handle if the pool is exhausted
+    template<typename... Args>
+    Handle acquire(Args&&... args) noexcept {
+        void* mem = pool_.allocate();
+        if (UNLIKELY(!mem)) {
+            return Handle{};
+        }
+        new (mem) T(std::forward<Args>(args)...);
+        const uint32_t idx = pool_.blockIndex(mem);
+        return Handle{(generations_[idx].load(std::memory_order_relaxed) << INDEX_BITS) | idx};
+    }
+    
+    // Object behind a live handle, nullptr if stale or invalid
+    T* get(Handle handle) const noexcept {
+        const uint32_t idx = handle.value & INDEX_MASK;
+        if (UNLIKELY(idx >= NUM_OBJECTS ||
+                     generations_[idx].load(std::memory_order_acquire) != (handle.value >> INDEX_BITS))) {
+            return nullptr;
+        }
+        return static_cast<T*>(pool_.blockAt(idx));
+    }
+    
+    // Destroy and free; false if the handle was stale (double release)
+    bool release(Handle handle) noexcept {
+        const uint32_t idx = handle.value & INDEX_MASK;
+        if (UNLIKELY(idx >= NUM_OBJECTS)) {
+            return false;
+        }
+        uint32_t gen = handle.value >> INDEX_BITS;
+        const uint32_t next_gen = (gen + 1 == GEN_LIMIT) ? 0 : gen + 1;
+        if (UNLIKELY(!generations_[idx].compare_exchange_strong(gen, next_gen, std::memory_order_acq_rel))) {
+            return false;
+        }
+        T* obj = static_cast<T*>(pool_.blockAt(idx));
+        obj->~T();
+        pool_.deallocate(obj);
+        return true;
+    }
+    
+    // Current handle of a live object from this pool
+    Handle handleOf(const T* obj) const noexcept {
+        const uint32_t idx = pool_.blockIndex(obj);
+        if (UNLIKELY(idx >= NUM_OBJECTS)) {
+            return Handle{};
+        }
+        return Handle{(generations_[idx].load(std::memory_order_acquire) << INDEX_BITS) | idx};
+    }
+    
+    size_t capacity() const noexcept { return NUM_OBJECTS; }
+    size_t size() const noexcept { return pool_.allocatedBlocks(); }
+    size_t available() const noexcept { return pool_.freeBlocks(); }
+    
+private:
+    Pool pool_;
+    PageAllocation generations_mem_;
+    std::atomic<uint32_t>* generations_ = nullptr;
+};
+
 /// Template specializations for common trading object sizes (fast path, no zeroing)
 using OrderPool = MemoryPool<64, 1024 * 1024, ZeroPolicy::None>;    // 64MB for orders
 using TradePool = MemoryPool<64, 512 * 1024, ZeroPolicy::None>;     // 32MB for trades
@@ -469,25 +805,27 @@ using MessagePool = MemoryPool<256, 64 * 1024, ZeroPolicy::None>;   // 16MB for
 using SecureOrderPool = MemoryPool<64, 1024 * 1024, ZeroPolicy::OnAcquire>;
 using SecureMessagePool = MemoryPool<256, 64 * 1024, ZeroPolicy::OnAcquire>;
 
-/// Global memory pools for different object types
+/// Global memory pools for different object types.
+/// One process-wide pool per type; per-thread magazines keep the hot path
+/// local, so any thread may free what another allocated.
 struct GlobalMemoryPools {
     static OrderPool& orders() {
-        static thread_local OrderPool pool;
+        static OrderPool pool;
         return pool;
     }
     
     static TradePool& trades() {
-        static thread_local TradePool pool;
+        static TradePool pool;
         return pool;
     }
     
     static TickPool& ticks() {
-        static thread_local TickPool pool;
+        static TickPool pool;
         return pool;
     }
     
     static MessagePool& messages() {
-        static thread_local MessagePool pool;
+        static MessagePool pool;
         return pool;
     }
 };
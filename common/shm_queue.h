@@ -0,0 +1,754 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <chrono>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+#include "macros.h"
+#include "huge_pages.h"
+#include "time_utils.h"
+
+namespace Common {
+
+  // Shared-memory variants of the lock-free queues, for running feed
+  // handlers and strategies as separate processes. Storage and indices
+  // live in a named segment under /dev/shm (or /dev/hugepages when huge
+  // pages are enabled and hugetlbfs is mounted there); the hot path is the
+  // same loads and stores as the in-process queues, no syscalls.
+  //
+  // Elements must be trivially copyable and must not hold pointers - each
+  // process maps the segment at a different address.
+
+  /// Bumped whenever the segment layout changes; old segments are rejected
+  inline constexpr std::uint32_t SHM_QUEUE_VERSION = 1;
+  inline constexpr std::uint64_t SHM_QUEUE_MAGIC = 0x3130514555514853ULL;  // "SHQUEQ01"
+
+  enum class ShmOpenMode : std::uint8_t {
+    Create,          // Fail if the segment already exists
+    Attach,          // Fail if it does not
+    CreateOrAttach   // Attach if compatible, else replace a segment nobody is using
+  };
+
+  enum class ShmRole : std::uint32_t {
+    None = 0,
+    Producer = 1,
+    Consumer = 2
+  };
+
+  /// A named, MAP_SHARED mapping. Not unlinked on close - the segment
+  /// outlives both peers so either side can restart and re-attach.
+  class ShmSegment final {
+  public:
+    static constexpr const char* HUGETLBFS_DIR = "/dev/hugepages";
+    static constexpr std::size_t MAX_NAME = 64;
+
+    ShmSegment() = default;
+    ~ShmSegment() { close(); }
+
+    // AUDIT_IGNORE: Init-time only
+    auto create(const char* name, std::size_t bytes) noexcept -> bool {
+      close();
+      if (!validName(name)) {
+        return false;
+      }
+
+      huge_ = HugePageAllocator::config().use_huge_pages && hugetlbfsMounted();
+      if (huge_) {
+        char path[MAX_NAME + 32];
+        hugetlbfsPath(name, path, sizeof(path));
+        fd_ = ::open(path, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (fd_ < 0 && errno != EEXIST) {
+          huge_ = false;  // No free huge pages or permissions - use /dev/shm
+        }
+      }
+      if (!huge_) {
+        fd_ = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+      }
+      if (fd_ < 0) {
+        return false;
+      }
+
+      const auto page = huge_ ? HugePageAllocator::PAGE_2MB : HugePageAllocator::PAGE_4KB;
+      const auto size = (bytes + page - 1) & ~(page - 1);
+      if (ftruncate(fd_, static_cast<off_t>(size)) != 0 || !map(size)) {
+        close();
+        remove(name);
+        return false;
+      }
+      return true;
+    }
+
+    // AUDIT_IGNORE: Init-time only
+    auto attach(const char* name) noexcept -> bool {
+      close();
+      if (!validName(name)) {
+        return false;
+      }
+
+      char path[MAX_NAME + 32];
+      hugetlbfsPath(name, path, sizeof(path));
+      fd_ = ::open(path, O_RDWR | O_CLOEXEC);
+      huge_ = fd_ >= 0;
+      if (!huge_) {
+        fd_ = shm_open(name, O_RDWR | O_CLOEXEC, 0600);
+      }
+      if (fd_ < 0) {
+        return false;
+      }
+
+      struct stat st{};
+      if (fstat(fd_, &st) != 0 || st.st_size <= 0 || !map(static_cast<std::size_t>(st.st_size))) {
+        close();  // Creator may not have sized it yet - caller retries
+        return false;
+      }
+      return true;
+    }
+
+    auto close() noexcept -> void {
+      if (base_) {
+        if (HugePageAllocator::config().lock_memory) {
+          munlock(base_, size_);
+        }
+        munmap(base_, size_);
+        base_ = nullptr;
+        size_ = 0;
+      }
+      if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+      }
+    }
+
+    // Remove the name; live mappings stay valid until closed
+    static auto remove(const char* name) noexcept -> void {
+      if (!validName(name)) {
+        return;
+      }
+      char path[MAX_NAME + 32];
+      hugetlbfsPath(name, path, sizeof(path));
+      ::unlink(path);
+      shm_unlink(name);
+    }
+
+    auto base() const noexcept -> void* { return base_; }
+    auto size() const noexcept -> std::size_t { return size_; }
+    auto isHugePage() const noexcept -> bool { return huge_; }
+
+    // Delete copy/move
+    ShmSegment(const ShmSegment&) = delete;
+    ShmSegment(ShmSegment&&) = delete;
+    ShmSegment& operator=(const ShmSegment&) = delete;
+    ShmSegment& operator=(ShmSegment&&) = delete;
+
+  private:
+    // shm_open names are "/name" with no further slashes
+    static auto validName(const char* name) noexcept -> bool {
+      if (!name || name[0] != '/' || name[1] == '\0') {
+        return false;
+      }
+      const auto len = std::strlen(name);
+      return len < MAX_NAME && std::strchr(name + 1, '/') == nullptr;
+    }
+
+    static auto hugetlbfsPath(const char* name, char* out, std::size_t len) noexcept -> void {
+      std::snprintf(out, len, "%s%s", HUGETLBFS_DIR, name);
+    }
+
+    static auto hugetlbfsMounted() noexcept -> bool {
+      constexpr long HUGETLBFS_MAGIC_NUMBER = 0x958458f6;
+      struct statfs fs{};
+      return statfs(HUGETLBFS_DIR, &fs) == 0 && fs.f_type == HUGETLBFS_MAGIC_NUMBER;
+    }
+
+    auto map(std::size_t size) noexcept -> bool {
+      // MAP_POPULATE instead of a write-prefault: the peer's data is live
+      void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, fd_, 0);
+      if (mem == MAP_FAILED) {
+        return false;
+      }
+      if (HugePageAllocator::config().lock_memory) {
+        mlock(mem, size);
+      }
+      base_ = mem;
+      size_ = size;
+      return true;
+    }
+
+    int fd_ = -1;
+    void* base_ = nullptr;
+    std::size_t size_ = 0;
+    bool huge_ = false;
+  };
+
+  /// Process attached to a segment. Crash detection is by pid liveness;
+  /// heartbeat_ns additionally lets a peer notice a process that is alive
+  /// but wedged.
+  struct alignas(CACHE_LINE_SIZE) ShmPeer {
+    std::atomic<std::int32_t> pid{0};
+    std::atomic<std::uint32_t> role{0};
+    std::atomic<std::uint64_t> heartbeat_ns{0};
+  };
+
+  /// Versioned header at offset 0 of every queue segment
+  struct ShmQueueHeader {
+    static constexpr std::uint32_t STATE_INITIALIZING = 0;
+    static constexpr std::uint32_t STATE_READY = 1;
+    static constexpr std::size_t MAX_PEERS = 16;
+
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t kind;          // Which queue type owns the layout
+    std::uint64_t elem_size;
+    std::uint64_t elem_align;
+    std::uint64_t capacity;
+    std::uint64_t total_size;
+    std::atomic<std::uint32_t> state;
+    std::int32_t creator_pid;
+    ShmPeer peers[MAX_PEERS];
+  };
+
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free &&
+                std::atomic<std::int32_t>::is_always_lock_free,
+                "Shared-memory atomics must be lock-free to be address-free");
+
+  /// Segment, header and peer table shared by the shm queue types
+  class ShmQueueSegment final {
+  public:
+    struct Layout {
+      std::uint32_t kind = 0;
+      std::uint64_t elem_size = 0;
+      std::uint64_t elem_align = 0;
+      std::uint64_t capacity = 0;
+      std::size_t control_bytes = 0;  // Shared indices, after the header
+      std::size_t slot_bytes = 0;     // Element storage, after the control block
+    };
+
+    static constexpr auto ATTACH_TIMEOUT = std::chrono::seconds(2);
+
+    ShmQueueSegment() = default;
+    ~ShmQueueSegment() { unregisterPeer(); }
+
+    // Create or attach and validate. A freshly created segment is left in
+    // STATE_INITIALIZING; the owning queue initializes its control block
+    // and then calls markReady(). Attachers wait for that.
+    // AUDIT_IGNORE: Init-time only
+    auto open(const char* name, ShmOpenMode mode, const Layout& layout) noexcept -> bool {
+      layout_ = layout;
+      control_offset_ = roundUp(sizeof(ShmQueueHeader), CACHE_LINE_SIZE);
+      slots_offset_ = roundUp(control_offset_ + layout.control_bytes,
+                              std::max<std::size_t>(CACHE_LINE_SIZE, layout.elem_align));
+      total_size_ = slots_offset_ + layout.slot_bytes;
+
+      if (mode != ShmOpenMode::Attach && createNew(name)) {
+        return true;
+      }
+      if (mode == ShmOpenMode::Create) {
+        return false;
+      }
+      if (attachExisting(name)) {
+        return true;
+      }
+      if (mode == ShmOpenMode::CreateOrAttach && segment_.base() == nullptr) {
+        return false;  // Nothing to replace, creation already failed
+      }
+      // Incompatible or abandoned mid-initialization. Replace it only if
+      // nobody is attached and its creator is gone, otherwise we would pull
+      // it from under a peer or a creator that is merely slow to initialize.
+      if (mode == ShmOpenMode::CreateOrAttach && !anyPeerAlive() && !creatorAlive()) {
+        segment_.close();
+        ShmSegment::remove(name);
+        return createNew(name);
+      }
+      segment_.close();
+      return false;
+    }
+
+    auto markReady() noexcept -> void {
+      header()->state.store(ShmQueueHeader::STATE_READY, std::memory_order_release);
+    }
+
+    // Claim a peer slot for this process. With exclusive set, fail if
+    // another live process holds the role. Slots of dead processes are
+    // reclaimed first, which is how a restarted peer takes over.
+    auto registerPeer(ShmRole role, bool exclusive) noexcept -> bool {
+      auto* hdr = header();
+      const auto self = static_cast<std::int32_t>(getpid());
+      reapDeadPeers();
+
+      for (std::size_t i = 0; i < ShmQueueHeader::MAX_PEERS; ++i) {
+        auto expected = 0;
+        if (!hdr->peers[i].pid.compare_exchange_strong(expected, self, std::memory_order_seq_cst)) {
+          continue;
+        }
+        hdr->peers[i].role.store(static_cast<std::uint32_t>(role), std::memory_order_seq_cst);
+        hdr->peers[i].heartbeat_ns.store(getNanosSinceEpoch(), std::memory_order_relaxed);
+        peer_slot_ = static_cast<int>(i);
+
+        // Two processes racing for an exclusive role both see each other
+        // (seq_cst) and both back out; never both win
+        if (exclusive && otherPeerAlive(role)) {
+          unregisterPeer();
+          return false;
+        }
+        return true;
+      }
+      return false;  // Peer table full
+    }
+
+    auto unregisterPeer() noexcept -> void {
+      if (peer_slot_ < 0 || segment_.base() == nullptr) {
+        return;
+      }
+      auto& peer = header()->peers[peer_slot_];
+      peer.role.store(0, std::memory_order_relaxed);
+      peer.pid.store(0, std::memory_order_release);
+      peer_slot_ = -1;
+    }
+
+    // Cheap enough for an idle loop: one relaxed store to our own line
+    auto heartbeat() noexcept -> void {
+      if (LIKELY(peer_slot_ >= 0)) {
+        header()->peers[peer_slot_].heartbeat_ns.store(getNanosSinceEpoch(), std::memory_order_relaxed);
+      }
+    }
+
+    // True if a process other than us holds the role and is still running
+    auto otherPeerAlive(ShmRole role) const noexcept -> bool {
+      return newestHeartbeat(role) != 0;
+    }
+
+    // Latest heartbeat among live peers holding the role, 0 if none
+    auto newestHeartbeat(ShmRole role) const noexcept -> std::uint64_t {
+      const auto* hdr = header();
+      const auto self = static_cast<std::int32_t>(getpid());
+      std::uint64_t newest = 0;
+      for (const auto& peer : hdr->peers) {
+        const auto pid = peer.pid.load(std::memory_order_seq_cst);
+        if (pid == 0 || pid == self ||
+            peer.role.load(std::memory_order_seq_cst) != static_cast<std::uint32_t>(role)) {
+          continue;
+        }
+        if (processAlive(pid)) {
+          newest = std::max<std::uint64_t>(newest, std::max<std::uint64_t>(1, peer.heartbeat_ns.load(std::memory_order_relaxed)));
+        }
+      }
+      return newest;
+    }
+
+    auto created() const noexcept -> bool { return created_; }
+    auto header() const noexcept -> ShmQueueHeader* { return static_cast<ShmQueueHeader*>(segment_.base()); }
+    auto control() const noexcept -> void* { return static_cast<char*>(segment_.base()) + control_offset_; }
+    auto slots() const noexcept -> void* { return static_cast<char*>(segment_.base()) + slots_offset_; }
+    auto capacity() const noexcept -> std::uint64_t { return header()->capacity; }
+    auto isHugePage() const noexcept -> bool { return segment_.isHugePage(); }
+
+    // Delete copy/move
+    ShmQueueSegment(const ShmQueueSegment&) = delete;
+    ShmQueueSegment(ShmQueueSegment&&) = delete;
+    ShmQueueSegment& operator=(const ShmQueueSegment&) = delete;
+    ShmQueueSegment& operator=(ShmQueueSegment&&) = delete;
+
+  private:
+    static auto roundUp(std::size_t v, std::size_t align) noexcept -> std::size_t {
+      return (v + align - 1) & ~(align - 1);
+    }
+
+    static auto processAlive(std::int32_t pid) noexcept -> bool {
+      return kill(pid, 0) == 0 || errno == EPERM;
+    }
+
+    auto createNew(const char* name) noexcept -> bool {
+      if (!segment_.create(name, total_size_)) {
+        return false;
+      }
+      auto* hdr = new (segment_.base()) ShmQueueHeader{};
+      hdr->creator_pid = static_cast<std::int32_t>(getpid());
+      hdr->magic = SHM_QUEUE_MAGIC;
+      hdr->version = SHM_QUEUE_VERSION;
+      hdr->kind = layout_.kind;
+      hdr->elem_size = layout_.elem_size;
+      hdr->elem_align = layout_.elem_align;
+      hdr->capacity = layout_.capacity;
+      hdr->total_size = total_size_;
+      created_ = true;
+      return true;
+    }
+
+    // Leaves the segment mapped on validation failure so open() can
+    // inspect the peer table before deciding to replace it
+    auto attachExisting(const char* name) noexcept -> bool {
+      const auto deadline = std::chrono::steady_clock::now() + ATTACH_TIMEOUT;
+      while (!segment_.attach(name) || segment_.size() < sizeof(ShmQueueHeader)) {
+        const bool missing = errno == ENOENT;
+        segment_.close();
+        if (missing || std::chrono::steady_clock::now() > deadline) {
+          return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+
+      const auto* hdr = header();
+      while (hdr->state.load(std::memory_order_acquire) != ShmQueueHeader::STATE_READY) {
+        const auto creator = hdr->creator_pid;
+        if ((creator != 0 && !processAlive(creator)) || std::chrono::steady_clock::now() > deadline) {
+          return false;  // Creator died or stalled mid-initialization
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+
+      if (hdr->magic != SHM_QUEUE_MAGIC || hdr->version != SHM_QUEUE_VERSION ||
+          hdr->kind != layout_.kind || hdr->elem_size != layout_.elem_size ||
+          hdr->elem_align != layout_.elem_align || hdr->total_size > segment_.size()) {
+        return false;
+      }
+      // Capacity 0 means "whatever the creator chose" (MPMC attach)
+      if (layout_.capacity != 0 && hdr->capacity != layout_.capacity) {
+        return false;
+      }
+      created_ = false;
+      return true;
+    }
+
+    auto reapDeadPeers() noexcept -> void {
+      for (auto& peer : header()->peers) {
+        auto pid = peer.pid.load(std::memory_order_acquire);
+        if (pid != 0 && !processAlive(pid)) {
+          peer.role.store(0, std::memory_order_relaxed);
+          peer.pid.compare_exchange_strong(pid, 0, std::memory_order_acq_rel);
+        }
+      }
+    }
+
+    // A creator that never marked the segment ready may still be
+    // initializing it; only its death makes the segment stale
+    auto creatorAlive() const noexcept -> bool {
+      if (segment_.size() < sizeof(ShmQueueHeader) ||
+          header()->state.load(std::memory_order_acquire) == ShmQueueHeader::STATE_READY) {
+        return false;
+      }
+      const auto creator = header()->creator_pid;
+      return creator != 0 && creator != static_cast<std::int32_t>(getpid()) && processAlive(creator);
+    }
+
+    auto anyPeerAlive() const noexcept -> bool {
+      if (segment_.size() < sizeof(ShmQueueHeader)) {
+        return false;
+      }
+      for (const auto& peer : header()->peers) {
+        const auto pid = peer.pid.load(std::memory_order_acquire);
+        if (pid != 0 && processAlive(pid)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    ShmSegment segment_;
+    Layout layout_{};
+    std::size_t control_offset_ = 0;
+    std::size_t slots_offset_ = 0;
+    std::size_t total_size_ = 0;
+    int peer_slot_ = -1;
+    bool created_ = false;
+  };
+
+  // Single Producer Single Consumer queue across processes. Same protocol
+  // as SPSCLFQueue; the caches of the other side's index stay process-local.
+  // Either side can crash and restart: indices only move on publish() and
+  // release(), so the queue is consistent at every instant.
+  template<typename T, std::size_t MaxElements>
+  class ShmSPSCQueue final {
+    static_assert((MaxElements & (MaxElements - 1)) == 0,
+                  "MaxElements must be power of 2 for optimal performance");
+    static_assert(MaxElements > 0, "MaxElements must be greater than 0");
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Shared-memory elements must be trivially copyable");
+
+  public:
+    static constexpr std::uint32_t KIND = 1;
+
+    // Returns nullptr if the segment can't be opened, is incompatible, or
+    // a live process already holds the requested role
+    // AUDIT_IGNORE: Init-time only
+    static auto open(const char* name, ShmRole role,
+                     ShmOpenMode mode = ShmOpenMode::CreateOrAttach) noexcept -> std::unique_ptr<ShmSPSCQueue> {
+      std::unique_ptr<ShmSPSCQueue> queue(new (std::nothrow) ShmSPSCQueue());
+      if (!queue) {
+        return nullptr;
+      }
+      const ShmQueueSegment::Layout layout{KIND, sizeof(T), alignof(T), MaxElements,
+                                           sizeof(Control), sizeof(T) * MaxElements};
+      if (!queue->segment_.open(name, mode, layout)) {
+        return nullptr;
+      }
+      queue->control_ = static_cast<Control*>(queue->segment_.control());
+      queue->store_ = static_cast<T*>(queue->segment_.slots());
+      if (queue->segment_.created()) {
+        new (queue->control_) Control();
+        queue->segment_.markReady();
+      }
+      if (!queue->segment_.registerPeer(role, true)) {
+        return nullptr;
+      }
+      queue->role_ = role;
+      // Resume from wherever the previous incarnation left off
+      queue->read_index_cache_ = queue->control_->read_index.load(std::memory_order_acquire);
+      queue->write_index_cache_ = queue->control_->write_index.load(std::memory_order_acquire);
+      return queue;
+    }
+
+    // Producer side - only called by the producer process
+    auto getNextToWriteTo() noexcept -> T* {
+      const auto write_idx = control_->write_index.load(std::memory_order_relaxed);
+      if (UNLIKELY(write_idx - read_index_cache_ >= MaxElements)) {
+        read_index_cache_ = control_->read_index.load(std::memory_order_acquire);
+        if (write_idx - read_index_cache_ >= MaxElements) {
+          return nullptr;
+        }
+      }
+      return &store_[write_idx & MASK];
+    }
+
+    auto updateWriteIndex() noexcept {
+      publish(1);
+    }
+
+    auto claim(std::size_t max_count) noexcept -> std::span<T> {
+      const auto write_idx = control_->write_index.load(std::memory_order_relaxed);
+      auto free_slots = MaxElements - (write_idx - read_index_cache_);
+      if (free_slots < max_count) {
+        read_index_cache_ = control_->read_index.load(std::memory_order_acquire);
+        free_slots = MaxElements - (write_idx - read_index_cache_);
+      }
+      const auto offset = write_idx & MASK;
+      const auto count = std::min<std::size_t>({max_count, free_slots, MaxElements - offset});
+      return {store_ + offset, count};
+    }
+
+    auto publish(std::size_t count) noexcept -> void {
+      const auto write_idx = control_->write_index.load(std::memory_order_relaxed);
+      control_->write_index.store(write_idx + count, std::memory_order_release);
+    }
+
+    // Consumer side - only called by the consumer process
+    auto getNextToRead() noexcept -> const T* {
+      const auto read_idx = control_->read_index.load(std::memory_order_relaxed);
+      if (UNLIKELY(read_idx == write_index_cache_)) {
+        write_index_cache_ = control_->write_index.load(std::memory_order_acquire);
+        if (read_idx == write_index_cache_) {
+          return nullptr;
+        }
+      }
+      return &store_[read_idx & MASK];
+    }
+
+    auto updateReadIndex() noexcept {
+      release(1);
+    }
+
+    auto peek(std::size_t max_count) noexcept -> std::span<const T> {
+      const auto read_idx = control_->read_index.load(std::memory_order_relaxed);
+      auto avail = write_index_cache_ - read_idx;
+      if (avail < max_count) {
+        write_index_cache_ = control_->write_index.load(std::memory_order_acquire);
+        avail = write_index_cache_ - read_idx;
+      }
+      const auto offset = read_idx & MASK;
+      const auto count = std::min<std::size_t>({max_count, avail, MaxElements - offset});
+      return {store_ + offset, count};
+    }
+
+    auto release(std::size_t count) noexcept -> void {
+      const auto read_idx = control_->read_index.load(std::memory_order_relaxed);
+      control_->read_index.store(read_idx + count, std::memory_order_release);
+    }
+
+    auto size() const noexcept -> std::size_t {
+      const auto read_idx = control_->read_index.load(std::memory_order_acquire);
+      const auto write_idx = control_->write_index.load(std::memory_order_acquire);
+      return static_cast<std::size_t>(write_idx - read_idx);
+    }
+
+    auto capacity() const noexcept { return MaxElements; }
+
+    auto producerCursorAddress() const noexcept -> const volatile void* {
+      return &control_->write_index;
+    }
+
+    // Crash detection: is the process on the other end still running?
+    auto peerAlive() const noexcept -> bool {
+      return segment_.otherPeerAlive(role_ == ShmRole::Producer ? ShmRole::Consumer : ShmRole::Producer);
+    }
+
+    auto peerHeartbeatNanos() const noexcept -> std::uint64_t {
+      return segment_.newestHeartbeat(role_ == ShmRole::Producer ? ShmRole::Consumer : ShmRole::Producer);
+    }
+
+    auto heartbeat() noexcept -> void { segment_.heartbeat(); }
+    auto createdSegment() const noexcept -> bool { return segment_.created(); }
+    auto isHugePage() const noexcept -> bool { return segment_.isHugePage(); }
+
+    // Delete copy/move
+    ShmSPSCQueue(const ShmSPSCQueue&) = delete;
+    ShmSPSCQueue(ShmSPSCQueue&&) = delete;
+    ShmSPSCQueue& operator=(const ShmSPSCQueue&) = delete;
+    ShmSPSCQueue& operator=(ShmSPSCQueue&&) = delete;
+
+  private:
+    ShmSPSCQueue() = default;
+
+    static constexpr std::uint64_t MASK = MaxElements - 1;
+
+    // Lives in the segment; 64-bit so both sides agree regardless of build
+    struct Control {
+      alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> write_index{0};
+      alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> read_index{0};
+    };
+
+    ShmQueueSegment segment_;
+    Control* control_ = nullptr;
+    T* store_ = nullptr;
+    ShmRole role_ = ShmRole::None;
+
+    alignas(CACHE_LINE_SIZE) std::uint64_t read_index_cache_ = 0;   // Producer's view
+    alignas(CACHE_LINE_SIZE) std::uint64_t write_index_cache_ = 0;  // Consumer's view
+  };
+
+  // Multi Producer Multi Consumer queue across processes (Vyukov cells,
+  // as MPMCLFQueue). Caveat: a producer that dies between claiming a slot
+  // and publishing it wedges consumers at that slot. Use peerAlive() to
+  // notice and recreate the segment.
+  template<typename T>
+  class ShmMPMCQueue final {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Shared-memory elements must be trivially copyable");
+
+  public:
+    static constexpr std::uint32_t KIND = 2;
+
+    // capacity is required to create; pass 0 to attach with whatever
+    // capacity the creator chose
+    // AUDIT_IGNORE: Init-time only
+    static auto open(const char* name, ShmRole role, std::size_t capacity,
+                     ShmOpenMode mode = ShmOpenMode::CreateOrAttach) noexcept -> std::unique_ptr<ShmMPMCQueue> {
+      if (capacity != 0 && (capacity & (capacity - 1)) != 0) {
+        return nullptr;
+      }
+      if (capacity == 0 && mode != ShmOpenMode::Attach) {
+        return nullptr;
+      }
+      std::unique_ptr<ShmMPMCQueue> queue(new (std::nothrow) ShmMPMCQueue());
+      if (!queue) {
+        return nullptr;
+      }
+      const ShmQueueSegment::Layout layout{KIND, sizeof(T), alignof(T), capacity,
+                                           sizeof(Control), sizeof(Cell) * capacity};
+      if (!queue->segment_.open(name, mode, layout)) {
+        return nullptr;
+      }
+      queue->control_ = static_cast<Control*>(queue->segment_.control());
+      queue->cells_ = static_cast<Cell*>(queue->segment_.slots());
+      queue->capacity_ = queue->segment_.capacity();
+      if (queue->segment_.created()) {
+        new (queue->control_) Control();
+        for (std::size_t i = 0; i < queue->capacity_; ++i) {
+          new (&queue->cells_[i]) Cell();
+          queue->cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        queue->segment_.markReady();
+      }
+      if (!queue->segment_.registerPeer(role, false)) {
+        return nullptr;
+      }
+      return queue;
+    }
+
+    auto enqueue(const T& item) noexcept -> bool {
+      auto pos = control_->write_index.load(std::memory_order_relaxed);
+      for (;;) {
+        auto& cell = cells_[pos & (capacity_ - 1)];
+        const auto seq = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::int64_t>(seq) - static_cast<std::int64_t>(pos);
+        if (diff == 0) {
+          if (control_->write_index.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            cell.data = item;
+            cell.sequence.store(pos + 1, std::memory_order_release);
+            return true;
+          }
+        } else if (diff < 0) {
+          return false;  // Full
+        } else {
+          pos = control_->write_index.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    auto dequeue(T& item) noexcept -> bool {
+      auto pos = control_->read_index.load(std::memory_order_relaxed);
+      for (;;) {
+        auto& cell = cells_[pos & (capacity_ - 1)];
+        const auto seq = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::int64_t>(seq) - static_cast<std::int64_t>(pos + 1);
+        if (diff == 0) {
+          if (control_->read_index.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            item = cell.data;
+            cell.sequence.store(pos + capacity_, std::memory_order_release);
+            return true;
+          }
+        } else if (diff < 0) {
+          return false;  // Empty
+        } else {
+          pos = control_->read_index.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    auto capacity() const noexcept -> std::size_t { return capacity_; }
+
+    // Crash detection for the given role, e.g. consumers watching producers
+    auto peerAlive(ShmRole role) const noexcept -> bool { return segment_.otherPeerAlive(role); }
+    auto heartbeat() noexcept -> void { segment_.heartbeat(); }
+    auto createdSegment() const noexcept -> bool { return segment_.created(); }
+
+    // Delete copy/move
+    ShmMPMCQueue(const ShmMPMCQueue&) = delete;
+    ShmMPMCQueue(ShmMPMCQueue&&) = delete;
+    ShmMPMCQueue& operator=(const ShmMPMCQueue&) = delete;
+    ShmMPMCQueue& operator=(ShmMPMCQueue&&) = delete;
+
+  private:
+    ShmMPMCQueue() = default;
+
+    struct Control {
+      alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> write_index{0};
+      alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> read_index{0};
+    };
+
+    struct Cell {
+      alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> sequence{0};
+      T data{};
+    };
+
+    ShmQueueSegment segment_;
+    Control* control_ = nullptr;
+    Cell* cells_ = nullptr;
+    std::size_t capacity_ = 0;
+  };
+
+} // namespace Common
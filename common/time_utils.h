@@ -1,9 +1,16 @@
 #pragma once
 
+#include <atomic>
+#include <bit>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <ctime>
+#include <mutex>
+#include <thread>
+#include <pthread.h>
 #include <x86intrin.h>
 
 namespace Common {
@@ -53,10 +60,293 @@ inline uint64_t getWallClockNanos() noexcept {
   return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL + static_cast<uint64_t>(ts.tv_nsec);
 }
 
+// Process-wide TSC clock. Hot paths get CLOCK_REALTIME / CLOCK_MONOTONIC
+// nanoseconds from one rdtsc and a multiply-add instead of a vDSO call.
+//
+// The mapping is tsc_base -> (realtime_base, mono_base) with a ns-per-tick
+// slope per domain, published through a seqlock. A background thread
+// (start()) re-samples the clocks every period: the slope follows each
+// clock's rate over the last period (NTP slewing included) plus a term
+// that bleeds the accumulated offset off over the next period, so the
+// mapping stays continuous. Offsets beyond STEP_NS (clock was stepped)
+// are applied at once. CLOCK_MONOTONIC_RAW gives the long-baseline TSC
+// frequency that bounds every slope.
+//
+// Without an invariant TSC (constant_tsc + nonstop_tsc) reads fall back
+// to clock_gettime().
+class TscClock {
+public:
+  static constexpr auto DEFAULT_PERIOD = std::chrono::milliseconds(100);
+  static constexpr int64_t STEP_NS = 5'000'000;      // Larger errors are stepped, not slewed
+  static constexpr double MAX_SLEW = 500e-6;         // Slope may differ from raw by 500ppm
+
+  // CLOCK_REALTIME nanoseconds since the epoch
+  static auto nowNs() noexcept -> uint64_t {
+    return tscToEpochNs(rdtsc());
+  }
+
+  // CLOCK_MONOTONIC nanoseconds - same domain as getNanosSinceEpoch()
+  static auto monoNs() noexcept -> uint64_t {
+    return tscToMonoNs(rdtsc());
+  }
+
+  // Convert a TSC captured earlier (e.g. a log record's) to either domain
+  static auto tscToEpochNs(uint64_t tsc) noexcept -> uint64_t {
+    auto& clock = instance();
+    if (!clock.reliable_) [[unlikely]] {
+      return getWallClockNanos();
+    }
+    return clock.map(tsc, clock.realtime_);
+  }
+
+  static auto tscToMonoNs(uint64_t tsc) noexcept -> uint64_t {
+    auto& clock = instance();
+    if (!clock.reliable_) [[unlikely]] {
+      return getNanosSinceEpoch();
+    }
+    return clock.map(tsc, clock.monotonic_);
+  }
+
+  // TSC ticks per nanosecond (i.e. GHz), measured against MONOTONIC_RAW
+  static auto ticksPerNs() noexcept -> double {
+    return instance().ticks_per_ns_.load(std::memory_order_relaxed);
+  }
+
+  static auto reliable() noexcept -> bool { return instance().reliable_; }
+
+  // Start the drift-correction thread; idempotent
+  static auto start(std::chrono::milliseconds period = DEFAULT_PERIOD) noexcept -> void {
+    auto& clock = instance();
+    std::lock_guard<std::mutex> lock(clock.thread_mutex_);  // AUDIT_IGNORE: Init-time only
+    if (clock.thread_.joinable()) {
+      return;
+    }
+    clock.running_ = true;
+    clock.thread_ = std::thread([&clock, period] {
+      pthread_setname_np(pthread_self(), "tsc_clock");
+      std::unique_lock<std::mutex> wait_lock(clock.thread_mutex_);
+      while (!clock.stop_cv_.wait_for(wait_lock, period, [&clock] { return !clock.running_; })) {
+        clock.recalibrate();
+      }
+    });
+  }
+
+  static auto stop() noexcept -> void {
+    auto& clock = instance();
+    {
+      std::lock_guard<std::mutex> lock(clock.thread_mutex_);
+      clock.running_ = false;
+    }
+    clock.stop_cv_.notify_all();
+    if (clock.thread_.joinable()) {
+      clock.thread_.join();
+    }
+  }
+
+  // One correction step, as the background thread does it
+  static auto update() noexcept -> void {
+    instance().recalibrate();
+  }
+
+  ~TscClock() {
+    {
+      std::lock_guard<std::mutex> lock(thread_mutex_);
+      running_ = false;
+    }
+    stop_cv_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  // Delete copy/move
+  TscClock(const TscClock&) = delete;
+  TscClock& operator=(const TscClock&) = delete;
+  TscClock(TscClock&&) = delete;
+  TscClock& operator=(TscClock&&) = delete;
+
+private:
+  struct Domain {
+    std::atomic<uint64_t> base_ns{0};
+    std::atomic<uint64_t> ns_per_tick_bits{0};  // double
+  };
+
+  struct Sample {
+    uint64_t tsc;
+    uint64_t ns;
+  };
+
+  // First use calibrates over ~2ms; start() early keeps that off hot paths
+  static auto instance() noexcept -> TscClock& {
+    static TscClock clock;
+    return clock;
+  }
+
+  TscClock() noexcept : reliable_(invariantTsc()) {
+    const auto raw0 = sample(CLOCK_MONOTONIC_RAW);
+    const auto start = getNanosSinceEpoch();
+    while (getNanosSinceEpoch() - start < 2'000'000) {
+      _mm_pause();
+    }
+    const auto raw1 = sample(CLOCK_MONOTONIC_RAW);
+    raw_origin_ = raw0;
+    const double ticks_per_ns = static_cast<double>(raw1.tsc - raw0.tsc) / static_cast<double>(raw1.ns - raw0.ns);
+    ticks_per_ns_.store(ticks_per_ns, std::memory_order_relaxed);
+
+    const auto real = sample(CLOCK_REALTIME);
+    const auto mono = sample(CLOCK_MONOTONIC);
+    prev_real_ = real;
+    prev_mono_ = mono;
+    tsc_base_.store(real.tsc, std::memory_order_relaxed);
+    realtime_.base_ns.store(real.ns, std::memory_order_relaxed);
+    monotonic_.base_ns.store(project(mono, real.tsc, 1.0 / ticks_per_ns), std::memory_order_relaxed);
+    realtime_.ns_per_tick_bits.store(std::bit_cast<uint64_t>(1.0 / ticks_per_ns), std::memory_order_relaxed);
+    monotonic_.ns_per_tick_bits.store(std::bit_cast<uint64_t>(1.0 / ticks_per_ns), std::memory_order_relaxed);
+  }
+
+  auto map(uint64_t tsc, const Domain& d) const noexcept -> uint64_t {
+    uint64_t seq;
+    uint64_t tsc_base;
+    uint64_t base_ns;
+    double ns_per_tick;
+    do {
+      seq = seq_.load(std::memory_order_acquire);
+      tsc_base = tsc_base_.load(std::memory_order_relaxed);
+      base_ns = d.base_ns.load(std::memory_order_relaxed);
+      ns_per_tick = std::bit_cast<double>(d.ns_per_tick_bits.load(std::memory_order_relaxed));
+      std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) || seq != seq_.load(std::memory_order_relaxed));
+
+    return project({tsc_base, base_ns}, tsc, ns_per_tick);
+  }
+
+  // Clock value at tsc, extrapolated from a sample. Signed: another core's
+  // TSC may read slightly before the sample's.
+  static auto project(const Sample& from, uint64_t tsc, double ns_per_tick) noexcept -> uint64_t {
+    const auto delta = static_cast<int64_t>(tsc - from.tsc);
+    return from.ns + static_cast<uint64_t>(static_cast<int64_t>(static_cast<double>(delta) * ns_per_tick));
+  }
+
+  // Best of a few reads: the clock value paired with the TSC midpoint of
+  // the tightest rdtsc bracket
+  static auto sample(clockid_t id) noexcept -> Sample {
+    Sample best{0, 0};
+    uint64_t best_window = UINT64_MAX;
+    for (int i = 0; i < 5; ++i) {
+      struct timespec ts;
+      const auto t0 = rdtscp();
+      clock_gettime(id, &ts);
+      const auto t1 = rdtscp();
+      if (t1 - t0 < best_window) {
+        best_window = t1 - t0;
+        best.tsc = t0 + (t1 - t0) / 2;
+        best.ns = static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL + static_cast<uint64_t>(ts.tv_nsec);
+      }
+    }
+    return best;
+  }
+
+  static auto invariantTsc() noexcept -> bool {
+    FILE* f = std::fopen("/proc/cpuinfo", "r");  // AUDIT_IGNORE: Init-time only
+    if (!f) {
+      return false;
+    }
+    char line[4096];
+    bool constant = false;
+    bool nonstop = false;
+    while (std::fgets(line, sizeof(line), f)) {
+      if (std::strncmp(line, "flags", 5) == 0) {
+        constant = std::strstr(line, " constant_tsc") != nullptr;
+        nonstop = std::strstr(line, " nonstop_tsc") != nullptr;
+        break;
+      }
+    }
+    std::fclose(f);
+    return constant && nonstop;
+  }
+
+  // New slope for one domain: its observed rate plus a correction that
+  // removes the current offset error over the next period
+  auto correct(const Domain& domain, const Sample& now, Sample& prev, uint64_t tsc_new,
+               double raw_ns_per_tick, uint64_t& base_out, double& slope_out) noexcept -> void {
+    const auto predicted = map(now.tsc, domain);
+    const auto error = static_cast<int64_t>(now.ns - predicted);
+    const auto ticks = static_cast<double>(now.tsc - prev.tsc);
+
+    double slope = ticks > 0 ? static_cast<double>(now.ns - prev.ns) / ticks : raw_ns_per_tick;
+    if (error > STEP_NS || error < -STEP_NS || ticks <= 0) {
+      // Stepped clock: jump to it and restart slewing from the raw rate
+      base_out = project(now, tsc_new, raw_ns_per_tick);
+      slope_out = raw_ns_per_tick;
+    } else {
+      slope += static_cast<double>(error) / ticks;
+      const double lo = raw_ns_per_tick * (1.0 - MAX_SLEW);
+      const double hi = raw_ns_per_tick * (1.0 + MAX_SLEW);
+      slope_out = slope < lo ? lo : (slope > hi ? hi : slope);
+      base_out = map(tsc_new, domain);  // Continuous at the switch-over
+    }
+    prev = now;
+  }
+
+  auto recalibrate() noexcept -> void {
+    if (!reliable_) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(update_mutex_);
+
+    // Long-baseline TSC frequency against the unslewed clock
+    const auto raw = sample(CLOCK_MONOTONIC_RAW);
+    if (raw.ns > raw_origin_.ns && raw.tsc > raw_origin_.tsc) {
+      ticks_per_ns_.store(static_cast<double>(raw.tsc - raw_origin_.tsc) / static_cast<double>(raw.ns - raw_origin_.ns),
+                          std::memory_order_relaxed);
+    }
+    const double raw_ns_per_tick = 1.0 / ticks_per_ns_.load(std::memory_order_relaxed);
+
+    const auto real = sample(CLOCK_REALTIME);
+    const auto mono = sample(CLOCK_MONOTONIC);
+    const auto tsc_new = rdtsc();
+    uint64_t real_base;
+    uint64_t mono_base;
+    double real_slope;
+    double mono_slope;
+    correct(realtime_, real, prev_real_, tsc_new, raw_ns_per_tick, real_base, real_slope);
+    correct(monotonic_, mono, prev_mono_, tsc_new, raw_ns_per_tick, mono_base, mono_slope);
+
+    // Seqlock write
+    const auto seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    tsc_base_.store(tsc_new, std::memory_order_relaxed);
+    realtime_.base_ns.store(real_base, std::memory_order_relaxed);
+    realtime_.ns_per_tick_bits.store(std::bit_cast<uint64_t>(real_slope), std::memory_order_relaxed);
+    monotonic_.base_ns.store(mono_base, std::memory_order_relaxed);
+    monotonic_.ns_per_tick_bits.store(std::bit_cast<uint64_t>(mono_slope), std::memory_order_relaxed);
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  // Read-mostly: readers only load this line
+  alignas(64) std::atomic<uint64_t> seq_{0};
+  std::atomic<uint64_t> tsc_base_{0};
+  Domain realtime_{};
+  Domain monotonic_{};
+  const bool reliable_;
+
+  // Updater state
+  alignas(64) std::atomic<double> ticks_per_ns_{1.0};
+  Sample raw_origin_{0, 0};
+  Sample prev_real_{0, 0};
+  Sample prev_mono_{0, 0};
+  std::mutex update_mutex_{};
+  std::mutex thread_mutex_{};
+  std::condition_variable stop_cv_{};
+  std::thread thread_{};
+  bool running_ = false;
+};
+
 // Ultra-fast timestamp class using TSC
 class TscTimer {
 public:
-  TscTimer() : freq_ghz_(calibrateFrequency()) {}
+  TscTimer() : freq_ghz_(TscClock::ticksPerNs()) {}
   
   // Start timing
   void start() noexcept {
@@ -79,20 +369,6 @@ public:
   }
   
 private:
-  // Calibrate TSC frequency
-  static double calibrateFrequency() noexcept {
-    const auto start = getNanosSinceEpoch();
-    const auto start_tsc = rdtsc();
-    
-    // Busy wait for calibration period
-    while (getNanosSinceEpoch() - start < 10'000'000); // 10ms
-    
-    const auto end_tsc = rdtsc();
-    const auto end = getNanosSinceEpoch();
-    
-    return static_cast<double>(end_tsc - start_tsc) / static_cast<double>(end - start);
-  }
-  
   uint64_t start_tsc_ = 0;
   const double freq_ghz_;
 };
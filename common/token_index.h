@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+#include "macros.h"
+#include "types.h"
+
+namespace Common {
+
+  // Maps sparse 32-bit keys (exchange instrument tokens) to small dense
+  // indices. Built at subscription time, read on every tick.
+  //
+  // Open addressing over 64-byte groups: each group is one cache line
+  // holding 8 keys followed by their 8 values. A key hashes to a group and
+  // probes forward a group at a time, so a lookup almost always touches a
+  // single line. With AVX2 the 8 keys are compared in one instruction.
+  // The table is kept at most half full; 1000 keys fit in 16KB instead of
+  // a direct array sized by the largest token.
+  //
+  // One thread inserts; any thread may look up concurrently. A slot's
+  // value is written before its key is published with a release store.
+  // Keys are never removed, only remapped.
+  template<std::size_t MaxKeys>
+  class TokenIndex final {
+  public:
+    static constexpr std::uint32_t EMPTY_KEY = ~std::uint32_t{0};
+    static constexpr std::uint32_t NOT_FOUND = ~std::uint32_t{0};
+    static constexpr std::size_t GROUP_SLOTS = 8;
+    static constexpr std::size_t GROUPS = std::bit_ceil((MaxKeys * 2 + GROUP_SLOTS - 1) / GROUP_SLOTS);
+
+    TokenIndex() noexcept { clear(); }
+
+    // Delete copy/move
+    TokenIndex(const TokenIndex&) = delete;
+    TokenIndex& operator=(const TokenIndex&) = delete;
+    TokenIndex(TokenIndex&&) = delete;
+    TokenIndex& operator=(TokenIndex&&) = delete;
+
+    // Not safe against concurrent lookups
+    auto clear() noexcept -> void {
+      for (auto& group : groups_) {
+        for (std::size_t i = 0; i < GROUP_SLOTS; ++i) {
+          group.keys[i] = EMPTY_KEY;
+          group.values[i] = 0;
+        }
+      }
+      size_ = 0;
+    }
+
+    // Add or remap a key. False if the key is EMPTY_KEY or the table
+    // already holds MaxKeys keys.
+    auto insert(std::uint32_t key, std::uint32_t value) noexcept -> bool {
+      if (UNLIKELY(key == EMPTY_KEY)) {
+        return false;
+      }
+      for (std::size_t g = home(key), n = 0; n < GROUPS; g = (g + 1) & (GROUPS - 1), ++n) {
+        auto& group = groups_[g];
+        for (std::size_t i = 0; i < GROUP_SLOTS; ++i) {
+          if (group.keys[i] == key) {
+            std::atomic_ref<std::uint32_t>(group.values[i]).store(value, std::memory_order_relaxed);
+            return true;
+          }
+          if (group.keys[i] == EMPTY_KEY) {
+            if (size_ >= MaxKeys) {
+              return false;
+            }
+            std::atomic_ref<std::uint32_t>(group.values[i]).store(value, std::memory_order_relaxed);
+            std::atomic_ref<std::uint32_t>(group.keys[i]).store(key, std::memory_order_release);
+            ++size_;
+            return true;
+          }
+        }
+      }
+      return false;
+    }
+
+    // Value for key, or NOT_FOUND
+    [[nodiscard]] [[gnu::always_inline]]
+    inline auto find(std::uint32_t key) const noexcept -> std::uint32_t {
+      if (UNLIKELY(key == EMPTY_KEY)) {
+        return NOT_FOUND;
+      }
+#ifdef __AVX2__
+      const __m256i needle = _mm256_set1_epi32(static_cast<int>(key));
+      const __m256i empty = _mm256_set1_epi32(-1);
+      for (std::size_t g = home(key), n = 0; n < GROUPS; g = (g + 1) & (GROUPS - 1), ++n) {
+        const auto& group = groups_[g];
+        const __m256i keys = _mm256_load_si256(reinterpret_cast<const __m256i*>(group.keys));
+        const auto hit = static_cast<std::uint32_t>(
+            _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(keys, needle))));
+        if (LIKELY(hit != 0)) {
+          std::atomic_thread_fence(std::memory_order_acquire);
+          return std::atomic_ref<const std::uint32_t>(group.values[std::countr_zero(hit)])
+              .load(std::memory_order_relaxed);
+        }
+        if (_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(keys, empty))) != 0) {
+          return NOT_FOUND;
+        }
+      }
+#else
+      for (std::size_t g = home(key), n = 0; n < GROUPS; g = (g + 1) & (GROUPS - 1), ++n) {
+        const auto& group = groups_[g];
+        for (std::size_t i = 0; i < GROUP_SLOTS; ++i) {
+          const auto k = std::atomic_ref<const std::uint32_t>(group.keys[i]).load(std::memory_order_acquire);
+          if (k == key) {
+            return std::atomic_ref<const std::uint32_t>(group.values[i]).load(std::memory_order_relaxed);
+          }
+          if (k == EMPTY_KEY) {
+            return NOT_FOUND;
+          }
+        }
+      }
+#endif
+      return NOT_FOUND;
+    }
+
+    [[nodiscard]] auto contains(std::uint32_t key) const noexcept -> bool { return find(key) != NOT_FOUND; }
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+    [[nodiscard]] static constexpr auto capacity() noexcept -> std::size_t { return MaxKeys; }
+    [[nodiscard]] static constexpr auto bytes() noexcept -> std::size_t { return sizeof(Group) * GROUPS; }
+
+  private:
+    struct alignas(CACHE_LINE_SIZE) Group {
+      std::uint32_t keys[GROUP_SLOTS];
+      std::uint32_t values[GROUP_SLOTS];
+    };
+    static_assert(sizeof(Group) == CACHE_LINE_SIZE);
+
+    // Fibonacci hashing: the top bits of key * 2^32/phi pick the group
+    [[gnu::always_inline]]
+    static inline auto home(std::uint32_t key) noexcept -> std::size_t {
+      if constexpr (GROUPS == 1) {
+        return 0;
+      } else {
+        constexpr int SHIFT = 32 - std::countr_zero(GROUPS);
+        return static_cast<std::size_t>((key * 0x9E3779B1U) >> SHIFT);
+      }
+    }
+
+    Group groups_[GROUPS]{};
+    std::size_t size_ = 0;
+  };
+
+} // namespace Common
@@ -407,6 +407,32 @@ struct alignas(64) MarketUpdate : public MarketTick {
   }
 };
 
+/// Both sides of an instrument's book plus its last trade, as one event.
+/// Feeds that send whole depth per message (Kite full mode) publish one of
+/// these instead of a MarketUpdate per level, so a consumer applies the
+/// book change in a single step. Levels are best first and compacted:
+/// entries past bid_count/ask_count are unspecified.
+struct alignas(64) DepthSnapshot {
+  static constexpr size_t MAX_LEVELS = 5;
+
+  TickerId ticker_id{TickerId_INVALID};
+  uint32_t instrument_token{0};
+  uint64_t timestamp{0};          // Local receive time, ns
+  uint64_t exchange_time_ns{0};
+  Price last_price{Price_INVALID};
+  Qty last_qty{0};
+  Qty volume{0};
+  uint8_t bid_count{0};
+  uint8_t ask_count{0};
+  uint16_t bid_orders[MAX_LEVELS]{};
+  uint16_t ask_orders[MAX_LEVELS]{};
+  Price bid_prices[MAX_LEVELS]{};
+  Qty bid_qtys[MAX_LEVELS]{};
+  Price ask_prices[MAX_LEVELS]{};
+  Qty ask_qtys[MAX_LEVELS]{};
+};
+static_assert(sizeof(DepthSnapshot) == 4 * 64, "DepthSnapshot must be exactly four cache lines");
+
 /// NUMA-aware allocator for containers
 template<typename T>
 class NumaAllocator {
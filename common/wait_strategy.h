@@ -0,0 +1,181 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <cpuid.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <x86intrin.h>
+
+#include "macros.h"
+
+namespace Common {
+
+/// How an idle consumer waits for its queue
+enum class WaitStrategyKind : uint8_t {
+  BusySpin,  // Re-poll immediately - lowest latency, burns the core
+  Backoff,   // PAUSE with exponential backoff
+  UmWait,    // UMONITOR/UMWAIT on the producer cursor (falls back to Backoff)
+  Park       // Backoff, then futex park until the producer wakes us
+};
+
+inline auto waitStrategyFromString(const char* name, WaitStrategyKind fallback) noexcept -> WaitStrategyKind {
+  if (!name || !*name) return fallback;
+  if (std::strcmp(name, "spin") == 0 || std::strcmp(name, "busy_spin") == 0) return WaitStrategyKind::BusySpin;
+  if (std::strcmp(name, "backoff") == 0) return WaitStrategyKind::Backoff;
+  if (std::strcmp(name, "umwait") == 0) return WaitStrategyKind::UmWait;
+  if (std::strcmp(name, "park") == 0) return WaitStrategyKind::Park;
+  return fallback;
+}
+
+inline auto waitStrategyName(WaitStrategyKind kind) noexcept -> const char* {
+  switch (kind) {
+    case WaitStrategyKind::BusySpin: return "spin";
+    case WaitStrategyKind::Backoff: return "backoff";
+    case WaitStrategyKind::UmWait: return "umwait";
+    case WaitStrategyKind::Park: return "park";
+    default: return "unknown";
+  }
+}
+
+/// CPUID.(EAX=7,ECX=0):ECX[5] - UMONITOR/UMWAIT/TPAUSE
+inline auto cpuHasWaitPkg() noexcept -> bool {
+  static const bool has_waitpkg = [] {
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+    return ((ecx >> 5) & 1U) != 0;
+  }();
+  return has_waitpkg;
+}
+
+/// Eventcount a parked consumer sleeps on. Producers call notify() after
+/// publishing; with nobody parked it costs a fence and a load.
+class WaitEvent {
+public:
+  auto notify() noexcept -> void {
+    // Order our publish before reading waiters_ (pairs with park())
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (UNLIKELY(waiters_.load(std::memory_order_relaxed) != 0)) {
+      epoch_.fetch_add(1, std::memory_order_release);
+      futex(FUTEX_WAKE_PRIVATE, INT_MAX, nullptr);
+    }
+  }
+
+  // Sleep until notify() or timeout, unless ready() turns true after we
+  // announced ourselves - that closes the lost-wakeup window
+  template<typename Ready>
+  auto park(Ready&& ready, uint64_t timeout_ns) noexcept -> void {
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    const uint32_t epoch = epoch_.load(std::memory_order_seq_cst);
+    if (!ready()) {
+      timespec ts{static_cast<time_t>(timeout_ns / 1000000000ULL),
+                  static_cast<long>(timeout_ns % 1000000000ULL)};
+      futex(FUTEX_WAIT_PRIVATE, epoch, &ts);
+    }
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  auto waiters() const noexcept -> uint32_t { return waiters_.load(std::memory_order_relaxed); }
+
+private:
+  auto futex(int op, uint32_t val, const timespec* timeout) noexcept -> void {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), op, val, timeout, nullptr, 0);
+  }
+
+  alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> epoch_{0};
+  std::atomic<uint32_t> waiters_{0};
+};
+
+/// Tuning for WaitStrategy; defaults suit a dedicated core
+struct WaitStrategyConfig {
+  WaitStrategyKind kind = WaitStrategyKind::Backoff;
+  uint32_t max_backoff = 64;              // PAUSEs per idle() at most
+  uint32_t spin_before_park = 1024;       // idle() calls before parking
+  uint64_t park_timeout_ns = 1000000;     // Bounded park, guards a dead producer
+  uint32_t umwait_tsc_cycles = 20000;     // UMWAIT deadline per idle()
+};
+
+/// Per-thread idle policy for queue consumers. Call idle() each time a
+/// poll finds nothing and reset() once it finds work. The kind can be
+/// switched from another thread, e.g. spin in market hours, park after.
+class WaitStrategy {
+public:
+  using Config = WaitStrategyConfig;
+
+  explicit WaitStrategy(const Config& cfg = Config{}, WaitEvent* event = nullptr,
+                        const volatile void* monitor_addr = nullptr) noexcept
+    : cfg_(cfg), kind_(cfg.kind), event_(event), monitor_addr_(monitor_addr) {}
+
+  auto setKind(WaitStrategyKind kind) noexcept -> void { kind_.store(kind, std::memory_order_relaxed); }
+  auto kind() const noexcept -> WaitStrategyKind { return kind_.load(std::memory_order_relaxed); }
+
+  auto reset() noexcept -> void {
+    backoff_ = 1;
+    idle_rounds_ = 0;
+  }
+
+  template<typename Ready>
+  auto idle(Ready&& ready) noexcept -> void {
+    switch (kind_.load(std::memory_order_relaxed)) {
+      case WaitStrategyKind::BusySpin:
+        break;
+      case WaitStrategyKind::Backoff:
+        backoff();
+        break;
+      case WaitStrategyKind::UmWait:
+        if (monitor_addr_ && cpuHasWaitPkg()) {
+          umonitor(monitor_addr_);
+          if (!ready()) {
+            umwait(__rdtsc() + cfg_.umwait_tsc_cycles);
+          }
+        } else {
+          backoff();
+        }
+        break;
+      case WaitStrategyKind::Park:
+        if (event_ && ++idle_rounds_ > cfg_.spin_before_park) {
+          event_->park(ready, cfg_.park_timeout_ns);
+        } else {
+          backoff();
+        }
+        break;
+      default:
+        backoff();
+        break;
+    }
+  }
+
+private:
+  auto backoff() noexcept -> void {
+    for (uint32_t i = 0; i < backoff_; ++i) {
+      CPU_PAUSE();
+    }
+    if (backoff_ < cfg_.max_backoff) {
+      backoff_ <<= 1;
+    }
+  }
+
+  __attribute__((target("waitpkg")))
+  static auto umonitor(const volatile void* addr) noexcept -> void {
+    _umonitor(const_cast<void*>(addr));
+  }
+
+  // Control 0 requests the deeper C0.2 state
+  __attribute__((target("waitpkg")))
+  static auto umwait(uint64_t deadline_tsc) noexcept -> void {
+    _umwait(0, deadline_tsc);
+  }
+
+  Config cfg_;
+  std::atomic<WaitStrategyKind> kind_;
+  WaitEvent* event_;
+  const volatile void* monitor_addr_;
+  uint32_t backoff_ = 1;
+  uint32_t idle_rounds_ = 0;
+};
+
+} // namespace Common
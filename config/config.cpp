@@ -118,7 +118,9 @@ auto ConfigManager::parseTomlFile(const char* filepath) noexcept -> bool {
             extractBoolValue(line, "cpu_affinity_enabled", &config_.performance.cpu_affinity_enabled);
             if (extractUintValue(line, "realtime_priority", &temp)) config_.performance.realtime_priority = static_cast<uint32_t>(temp);
             if (extractUintValue(line, "memory_pool_size_mb", &temp)) config_.performance.memory_pool_size_mb = static_cast<uint32_t>(temp);
+            if (extractUintValue(line, "huge_page_budget_mb", &temp)) config_.performance.huge_page_budget_mb = static_cast<uint32_t>(temp);
             extractBoolValue(line, "use_huge_pages", &config_.performance.use_huge_pages);
+            extractBoolValue(line, "lock_memory", &config_.performance.lock_memory);
             extractBoolValue(line, "numa_aware", &config_.performance.numa_aware);
             if (extractUintValue(line, "market_data_queue_size", &temp)) config_.performance.market_data_queue_size = static_cast<uint32_t>(temp);
             if (extractUintValue(line, "order_queue_size", &temp)) config_.performance.order_queue_size = static_cast<uint32_t>(temp);
@@ -197,18 +199,28 @@ auto ConfigManager::parseTomlFile(const char* filepath) noexcept -> bool {
             if (extractUintValue(line, "max_symbols", &temp)) config_.zerodha.max_symbols = static_cast<uint32_t>(temp);
             extractStringValue(line, "subscription_mode", config_.zerodha.subscription_mode, sizeof(config_.zerodha.subscription_mode));
             if (extractUintValue(line, "tick_batch_size", &temp)) config_.zerodha.tick_batch_size = static_cast<uint32_t>(temp);
+            extractStringValue(line, "delivery_mode", config_.zerodha.delivery_mode, sizeof(config_.zerodha.delivery_mode));
             
             // Data persistence
             extractBoolValue(line, "persist_ticks", &config_.zerodha.persist_ticks);
             extractBoolValue(line, "persist_orderbook", &config_.zerodha.persist_orderbook);
             if (extractUintValue(line, "tick_file_rotation_mb", &temp)) config_.zerodha.tick_file_rotation_mb = static_cast<uint32_t>(temp);
             if (extractUintValue(line, "orderbook_snapshot_interval_s", &temp)) config_.zerodha.orderbook_snapshot_interval_s = static_cast<uint32_t>(temp);
+            if (extractUintValue(line, "orderbook_restore_max_age_s", &temp)) config_.zerodha.orderbook_restore_max_age_s = static_cast<uint32_t>(temp);
             
             // Order configuration
             extractStringValue(line, "order_type_default", config_.zerodha.order_type_default, sizeof(config_.zerodha.order_type_default));
             extractStringValue(line, "product_type", config_.zerodha.product_type, sizeof(config_.zerodha.product_type));
             extractStringValue(line, "exchange", config_.zerodha.exchange, sizeof(config_.zerodha.exchange));
         }
+        else if (std::strcmp(current_section, "wait_strategy") == 0) {
+            uint64_t temp;
+            extractStringValue(line, "trading", config_.wait_strategy.trading, sizeof(config_.wait_strategy.trading));
+            extractStringValue(line, "market_data", config_.wait_strategy.market_data, sizeof(config_.wait_strategy.market_data));
+            extractStringValue(line, "order_gateway", config_.wait_strategy.order_gateway, sizeof(config_.wait_strategy.order_gateway));
+            if (extractUintValue(line, "spin_before_park", &temp)) config_.wait_strategy.spin_before_park = static_cast<uint32_t>(temp);
+            extractUintValue(line, "park_timeout_us", &config_.wait_strategy.park_timeout_us);
+        }
         else if (std::strcmp(current_section, "binance") == 0) {
             extractBoolValue(line, "enabled", &config_.binance.enabled);
             extractStringValue(line, "api_endpoint", config_.binance.api_endpoint, sizeof(config_.binance.api_endpoint));
@@ -361,6 +373,13 @@ auto ConfigManager::validateConfig() noexcept -> bool {
         return false;
     }
     
+    // Empty means the default, queue
+    const char* delivery = config_.zerodha.delivery_mode;
+    if (delivery[0] != '\0' && std::strcmp(delivery, "queue") != 0 && std::strcmp(delivery, "conflate") != 0) {
+        LOG_ERROR("delivery_mode must be \"queue\" or \"conflate\", got \"%s\"", delivery);
+        return false;
+    }
+    
     // Validate trading limits
     if (config_.trading.max_position_value <= 0) {
         LOG_ERROR("max_position_value must be positive");
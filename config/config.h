@@ -2,6 +2,7 @@
 
 #include "common/types.h"
 #include "common/macros.h"
+#include "common/wait_strategy.h"
 #include <cstdint>
 #include <cstring>
 
@@ -43,7 +44,9 @@ struct TradingConfig {
         bool cpu_affinity_enabled;
         uint32_t realtime_priority;
         uint32_t memory_pool_size_mb;
+        uint32_t huge_page_budget_mb;  // 0 = unlimited
         bool use_huge_pages;
+        bool lock_memory;              // mlock pools, queues and books
         bool numa_aware;
         uint32_t market_data_queue_size;
         uint32_t order_queue_size;
@@ -84,12 +87,14 @@ struct TradingConfig {
         uint32_t max_symbols;
         char subscription_mode[32];
         uint32_t tick_batch_size;
+        char delivery_mode[16];  // queue (every tick) or conflate (latest per instrument)
         
         // Data persistence
         bool persist_ticks;
         bool persist_orderbook;
         uint32_t tick_file_rotation_mb;
         uint32_t orderbook_snapshot_interval_s;
+        uint32_t orderbook_restore_max_age_s;  // Older snapshots are not restored; 0 for any age
         
         // Order configuration
         char order_type_default[32];
@@ -127,6 +132,15 @@ struct TradingConfig {
         int realtime_priority;  // Real-time priority (1-99)
     } cpu_config;
     
+    // Idle wait strategy per thread: "spin", "backoff", "umwait" or "park"
+    struct WaitStrategyConfig {
+        char trading[16];
+        char market_data[16];
+        char order_gateway[16];
+        uint32_t spin_before_park;  // Idle polls before a "park" thread sleeps
+        uint64_t park_timeout_us;   // Upper bound on one park
+    } wait_strategy;
+    
     // Strategy configuration
     struct MarketMaker {
         bool enabled;
@@ -266,6 +280,21 @@ public:
         return config_.binance.websocket_endpoint;
     }
     
+    // Idle strategy for one thread: kind is its [wait_strategy] key
+    // (trading, market_data or order_gateway), fallback when unset
+    [[nodiscard]] static auto getWaitConfig(const char* kind, Common::WaitStrategyKind fallback) noexcept
+        -> Common::WaitStrategyConfig {
+        Common::WaitStrategyConfig wait_cfg;
+        wait_cfg.kind = Common::waitStrategyFromString(kind, fallback);
+        if (config_.wait_strategy.spin_before_park > 0) {
+            wait_cfg.spin_before_park = config_.wait_strategy.spin_before_park;
+        }
+        if (config_.wait_strategy.park_timeout_us > 0) {
+            wait_cfg.park_timeout_ns = config_.wait_strategy.park_timeout_us * 1000;
+        }
+        return wait_cfg;
+    }
+    
     [[nodiscard]] static auto isInitialized() noexcept -> bool {
         return initialized_ && config_.is_valid;
     }
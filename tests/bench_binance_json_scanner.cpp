@@ -0,0 +1,191 @@
+// ============================================================================
+// bench_binance_json_scanner.cpp - Binance frame parsing, scanner vs strstr
+// ============================================================================
+//
+// Not a test: prints ns per frame for each stream schema, parsed by
+// BinanceJsonScanner and by the strstr/strtod parser BinanceWSClient used
+// before it (copied below, minus the client). Both sides produce the same
+// fields; depthUpdate levels are located but not applied by either. Build
+// in Release; the numbers mean nothing at -O0.
+
+#include "trading/market_data/binance/binance_json_scanner.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+using namespace Trading::MarketData::Binance;
+
+namespace {
+
+constexpr int ITERATIONS = 1000000;
+
+// Recorded from stream.binance.com, one frame per schema
+constexpr const char* TRADE =
+    R"({"e":"trade","E":1718000000123,"s":"BTCUSDT","t":3612345678,"p":"67012.34000000",)"
+    R"("q":"0.00150000","T":1718000000120,"m":true,"M":true})";
+constexpr const char* DEPTH_UPDATE =
+    R"({"e":"depthUpdate","E":1718000000300,"s":"BTCUSDT","U":48913770381,"u":48913770412,"b":[)"
+    R"(["67010.00000000","0.51530000"],["67009.99000000","0.00000000"],["67009.50000000","0.03000000"],)"
+    R"(["67008.12000000","1.20000000"],["67005.00000000","0.00000000"],["67001.01000000","0.35010000"],)"
+    R"(["66998.00000000","2.00000000"],["66990.00000000","0.00080000"]],"a":[)"
+    R"(["67010.01000000","1.20370000"],["67010.50000000","0.00000000"],["67011.00000000","0.08000000"],)"
+    R"(["67015.99000000","0.40000000"],["67020.00000000","3.10000000"],["67024.00000000","0.00000000"]]})";
+constexpr const char* PARTIAL_BOOK =
+    R"({"lastUpdateId":48913770412,"bids":[)"
+    R"(["67010.00000000","0.51530000"],["67009.50000000","0.03000000"],["67008.12000000","1.20000000"],)"
+    R"(["67001.01000000","0.35010000"],["66998.00000000","2.00000000"],["66990.00000000","0.00080000"],)"
+    R"(["66989.00000000","0.10000000"],["66985.55000000","0.75000000"],["66980.00000000","1.00000000"],)"
+    R"(["66975.00000000","0.20000000"]],"asks":[)"
+    R"(["67010.01000000","1.20370000"],["67011.00000000","0.08000000"],["67015.99000000","0.40000000"],)"
+    R"(["67020.00000000","3.10000000"],["67022.00000000","0.01000000"],["67025.00000000","0.60000000"],)"
+    R"(["67030.00000000","1.50000000"],["67031.10000000","0.02000000"],["67040.00000000","0.90000000"],)"
+    R"(["67050.00000000","4.00000000"]]})";
+
+// ---- The previous parser ---------------------------------------------------
+
+bool extractJsonValue(const char* json, const char* key, char* out, size_t out_len) {
+    const char* pos = strstr(json, key);
+    if (!pos) return false;
+    pos += strlen(key);
+    while (*pos && (*pos == ' ' || *pos == ':')) pos++;
+    bool is_string = (*pos == '"');
+    if (is_string) pos++;
+    size_t i = 0;
+    while (*pos && i < out_len - 1) {
+        if (is_string && *pos == '"') break;
+        if (!is_string && (*pos == ',' || *pos == '}')) break;
+        out[i++] = *pos++;
+    }
+    out[i] = '\0';
+    return i > 0;
+}
+
+bool extractId(const char* json, const char* key, uint64_t& value) {
+    const char* pos = strstr(json, key);
+    if (!pos) return false;
+    pos += strlen(key);
+    char* end = nullptr;
+    value = strtoull(pos, &end, 10);
+    return end != pos;
+}
+
+const char* parseLevels(const char* pos, Price* prices, Qty* qtys, uint8_t& count) {
+    if (*pos == '[') pos++;
+    count = 0;
+    while (*pos && count < BinanceMessage::MAX_LEVELS) {
+        if (*pos == ']') break;
+        if (*pos == '"') pos++;
+        char* end = nullptr;
+        const double price = strtod(pos, &end);
+        if (end == pos) break;
+        pos = end;
+        if (*pos == '"') pos++;
+        if (*pos == ',') pos++;
+        if (*pos == '"') pos++;
+        const double qty = strtod(pos, &end);
+        pos = end;
+        prices[count] = static_cast<Price>(price * 100000000);
+        qtys[count] = static_cast<Qty>(qty * 100000000);
+        count++;
+        if (*pos == '"') pos++;
+        if (*pos == ']') {
+            pos++;
+            if (*pos == ']') break;
+            if (*pos == ',') {
+                pos++;
+                if (*pos == '[') pos++;
+            }
+        }
+    }
+    return pos;
+}
+
+auto baseline(const char* json, BinanceMessage& msg) -> BinanceEvent {
+    char value[64];
+    if (strstr(json, "\"e\":\"trade\"")) {
+        extractJsonValue(json, "\"s\"", msg.symbol, sizeof(msg.symbol));
+        if (extractJsonValue(json, "\"p\"", value, sizeof(value))) {
+            msg.price = static_cast<Price>(strtod(value, nullptr) * 100000000);
+        }
+        if (extractJsonValue(json, "\"q\"", value, sizeof(value))) {
+            msg.qty = static_cast<Qty>(strtod(value, nullptr) * 100000000);
+        }
+        if (extractJsonValue(json, "\"T\"", value, sizeof(value))) {
+            msg.trade_time_ms = strtoull(value, nullptr, 10);
+        }
+        if (extractJsonValue(json, "\"m\"", value, sizeof(value))) {
+            msg.is_buyer_maker = value[0] == 't';
+        }
+        return BinanceEvent::TRADE;
+    }
+    if (strstr(json, "\"lastUpdateId\"") && strstr(json, "\"bids\"")) {
+        if (extractJsonValue(json, "\"lastUpdateId\"", value, sizeof(value))) {
+            msg.last_update_id = strtoull(value, nullptr, 10);
+        }
+        if (const char* bids = strstr(json, "\"bids\":[")) {
+            parseLevels(bids + 8, msg.bid_prices, msg.bid_qtys, msg.bid_count);
+        }
+        if (const char* asks = strstr(json, "\"asks\":[")) {
+            parseLevels(asks + 8, msg.ask_prices, msg.ask_qtys, msg.ask_count);
+        }
+        return BinanceEvent::PARTIAL_BOOK;
+    }
+    if (strstr(json, "\"e\":\"depthUpdate\"")) {
+        extractJsonValue(json, "\"s\"", msg.symbol, sizeof(msg.symbol));
+        extractId(json, "\"U\":", msg.first_update_id);
+        extractId(json, "\"u\":", msg.last_update_id);
+        const char* bids = strstr(json, "\"b\":[");
+        const char* asks = strstr(json, "\"a\":[");
+        msg.bids = bids ? bids + 5 : nullptr;
+        msg.asks = asks ? asks + 5 : nullptr;
+        return BinanceEvent::DEPTH_UPDATE;
+    }
+    return BinanceEvent::UNKNOWN;
+}
+
+// ---- Harness ---------------------------------------------------------------
+
+template<typename T>
+inline void keep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+template<typename Fn>
+auto nsPerCall(Fn&& fn) -> double {
+    for (int i = 0; i < ITERATIONS / 10; ++i) {
+        keep(fn());
+    }
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        keep(fn());
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / ITERATIONS;
+}
+
+} // namespace
+
+int main() {
+#ifdef __AVX2__
+    std::printf("Binance frames: AVX2 scanner vs strstr parser, %d frames each\n\n", ITERATIONS);
+#else
+    std::printf("Binance frames: scanner built without AVX2 (scalar index) vs strstr parser\n\n");
+#endif
+    auto scanner = std::make_unique<BinanceJsonScanner>();
+    auto msg = std::make_unique<BinanceMessage>();
+
+    for (const auto& [name, frame] : {std::pair{"trade", TRADE},
+                                      std::pair{"depthUpdate", DEPTH_UPDATE},
+                                      std::pair{"depth10", PARTIAL_BOOK}}) {
+        const std::string json = frame;
+        const double old_ns = nsPerCall([&] { msg->reset(); return baseline(json.c_str(), *msg); });
+        const double new_ns = nsPerCall([&] { return scanner->scan(json.c_str(), json.size(), *msg); });
+        std::printf("%-12s %5zu bytes  strstr %7.1f ns  scanner %7.1f ns  x%.2f\n",
+                    name, json.size(), old_ns, new_ns, old_ns / new_ns);
+    }
+    return 0;
+}
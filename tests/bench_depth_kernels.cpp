@@ -0,0 +1,88 @@
+// ============================================================================
+// bench_depth_kernels.cpp - Depth kernels, vector vs scalar, 20-100 levels
+// ============================================================================
+//
+// Not a test: prints ns per call for each kernel at a few book depths so
+// the vector path can be checked against the scalar reference on the
+// target machine. Build in Release; the numbers mean nothing at -O0.
+
+#include "trading/market_data/depth_kernels.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Trading::MarketData;
+using Common::Price;
+using Common::Qty;
+
+namespace {
+
+constexpr int ITERATIONS = 2000000;
+
+// Keep the compiler from hoisting or dropping the measured call
+template<typename T>
+inline void keep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+template<typename Fn>
+auto nsPerCall(Fn&& fn) -> double {
+    for (int i = 0; i < ITERATIONS / 10; ++i) {
+        keep(fn());
+    }
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        keep(fn());
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / ITERATIONS;
+}
+
+void row(const char* name, size_t levels, double scalar_ns, double vector_ns) {
+    std::printf("%-20s %4zu levels  scalar %7.2f ns  vector %7.2f ns  x%.2f\n",
+                name, levels, scalar_ns, vector_ns, scalar_ns / vector_ns);
+}
+
+} // namespace
+
+int main() {
+#ifdef __AVX2__
+    std::printf("Depth kernels: AVX2 vs scalar, %d calls each\n\n", ITERATIONS);
+#else
+    std::printf("Depth kernels: built without AVX2, both columns are scalar\n\n");
+#endif
+    std::mt19937 rng(7);
+    for (const size_t n : {size_t{20}, size_t{50}, size_t{100}}) {
+        std::vector<Price> prices(n);
+        std::vector<Qty> qtys(n);
+        std::vector<Qty> cum(n);
+        Price price = 6500000000000;
+        Qty total = 0;
+        for (size_t i = 0; i < n; ++i) {
+            prices[i] = price;
+            qtys[i] = 1 + static_cast<Qty>(rng() % 500000000);
+            total += qtys[i];
+            price -= 1000000;
+        }
+        const Price* p = prices.data();
+        const Qty* q = qtys.data();
+        const Qty target = total * 3 / 4;  // Sweeps most of the side
+        const Price floor = prices[n * 3 / 4];
+
+        row("cumulativeDepth", n,
+            nsPerCall([&] { return Depth::Scalar::cumulativeDepth(q, n, cum.data()); }),
+            nsPerCall([&] { return Depth::cumulativeDepth(q, n, cum.data()); }));
+        row("vwapToFill", n,
+            nsPerCall([&] { return Depth::Scalar::vwapToFill(p, q, n, target); }),
+            nsPerCall([&] { return Depth::vwapToFill(p, q, n, target); }));
+        row("decayedDepth", n,
+            nsPerCall([&] { return Depth::Scalar::decayedDepth(q, n, 0.8); }),
+            nsPerCall([&] { return Depth::decayedDepth(q, n, 0.8); }));
+        row("bidDepthWithin", n,
+            nsPerCall([&] { return Depth::Scalar::bidDepthWithin(p, q, n, floor); }),
+            nsPerCall([&] { return Depth::bidDepthWithin(p, q, n, floor); }));
+        std::printf("\n");
+    }
+    return 0;
+}
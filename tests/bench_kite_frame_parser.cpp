@@ -0,0 +1,153 @@
+// ============================================================================
+// bench_kite_frame_parser.cpp - Kite binary frames, batch vs per-packet parse
+// ============================================================================
+//
+// Not a test: prints ns per packet for a frame of full-mode packets (an
+// option chain), parsed by parseKiteFrame into the SoA batch and by the
+// per-packet field-by-field byte swap KiteWSClient used before it (copied
+// below, minus the pools and the queue). Build in Release; the numbers
+// mean nothing at -O0.
+
+#include "trading/market_data/zerodha/kite_frame_parser.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace Trading::MarketData::Zerodha;
+using Common::Price;
+using Common::Qty;
+
+namespace {
+
+constexpr int ITERATIONS = 20000;
+
+// ---- The previous parser ---------------------------------------------------
+
+struct TickData {
+    uint32_t instrument_token;
+    Price last_price;
+    Qty last_qty;
+    Qty volume;
+    Qty oi;
+    Price open;
+    Price high;
+    Price low;
+    Price close;
+    uint64_t exchange_timestamp_ns;
+};
+
+struct DepthUpdate {
+    Price bid_prices[5];
+    Qty bid_qtys[5];
+    uint16_t bid_orders[5];
+    Price ask_prices[5];
+    Qty ask_qtys[5];
+    uint16_t ask_orders[5];
+    uint8_t bid_count;
+    uint8_t ask_count;
+};
+
+auto parseFullPacket(const KiteFullPacket* packet, TickData& tick, DepthUpdate& depth) -> void {
+    tick.instrument_token = __builtin_bswap32(packet->instrument_token);
+    tick.last_price = __builtin_bswap32(packet->last_price);
+    tick.last_qty = __builtin_bswap32(packet->last_quantity);
+    tick.volume = __builtin_bswap32(packet->volume);
+    tick.oi = __builtin_bswap32(packet->oi);
+    tick.open = __builtin_bswap32(packet->open);
+    tick.high = __builtin_bswap32(packet->high);
+    tick.low = __builtin_bswap32(packet->low);
+    tick.close = __builtin_bswap32(packet->close);
+    tick.exchange_timestamp_ns = static_cast<uint64_t>(__builtin_bswap32(packet->timestamp)) * 1000000000ULL;
+
+    depth.bid_count = 0;
+    for (size_t i = 0; i < 5; ++i) {
+        const uint32_t qty = __builtin_bswap32(packet->bid[i].quantity);
+        if (qty > 0) {
+            depth.bid_prices[depth.bid_count] = __builtin_bswap32(packet->bid[i].price);
+            depth.bid_qtys[depth.bid_count] = qty;
+            depth.bid_orders[depth.bid_count] = __builtin_bswap16(packet->bid[i].orders);
+            depth.bid_count++;
+        }
+    }
+    depth.ask_count = 0;
+    for (size_t i = 0; i < 5; ++i) {
+        const uint32_t qty = __builtin_bswap32(packet->ask[i].quantity);
+        if (qty > 0) {
+            depth.ask_prices[depth.ask_count] = __builtin_bswap32(packet->ask[i].price);
+            depth.ask_qtys[depth.ask_count] = qty;
+            depth.ask_orders[depth.ask_count] = __builtin_bswap16(packet->ask[i].orders);
+            depth.ask_count++;
+        }
+    }
+}
+
+auto baseline(const uint8_t* data, size_t len, TickData* ticks, DepthUpdate* depths) -> size_t {
+    const auto num_packets = static_cast<uint16_t>(data[0] << 8 | data[1]);
+    size_t pos = 2;
+    size_t count = 0;
+    for (uint16_t i = 0; i < num_packets && pos < len; ++i) {
+        const auto packet_len = static_cast<uint16_t>(data[pos] << 8 | data[pos + 1]);
+        pos += 2;
+        if (packet_len == sizeof(KiteFullPacket) && pos + packet_len <= len) {
+            parseFullPacket(reinterpret_cast<const KiteFullPacket*>(data + pos), ticks[count], depths[count]);
+            ++count;
+        }
+        pos += packet_len;
+    }
+    return count;
+}
+
+// ---- Harness ---------------------------------------------------------------
+
+template<typename T>
+inline void keep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+template<typename Fn>
+auto nsPerCall(Fn&& fn) -> double {
+    for (int i = 0; i < ITERATIONS / 10; ++i) {
+        keep(fn());
+    }
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        keep(fn());
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / ITERATIONS;
+}
+
+} // namespace
+
+int main() {
+#ifdef __AVX2__
+    std::printf("Kite full packets: AVX2 frame parser vs per-packet parse, %d frames each\n\n", ITERATIONS);
+#else
+    std::printf("Kite full packets: frame parser built without AVX2 vs per-packet parse\n\n");
+#endif
+    auto batch = std::make_unique<KiteFrameBatch>();
+    std::mt19937 rng(42);
+
+    for (const size_t packets : {size_t{10}, size_t{100}, size_t{350}}) {
+        std::vector<uint8_t> frame = {static_cast<uint8_t>(packets >> 8), static_cast<uint8_t>(packets)};
+        for (size_t i = 0; i < packets; ++i) {
+            frame.push_back(0);
+            frame.push_back(sizeof(KiteFullPacket));
+            for (size_t b = 0; b < sizeof(KiteFullPacket); ++b) {
+                frame.push_back(static_cast<uint8_t>(rng()));
+            }
+        }
+        std::vector<TickData> ticks(packets);
+        std::vector<DepthUpdate> depths(packets);
+
+        const double old_ns = nsPerCall([&] { return baseline(frame.data(), frame.size(), ticks.data(), depths.data()); });
+        const double new_ns = nsPerCall([&] { return parseKiteFrame(frame.data(), frame.size(), *batch); });
+        std::printf("%4zu packets  per-packet %6.1f ns/packet  frame %6.1f ns/packet  x%.2f\n",
+                    packets, old_ns / static_cast<double>(packets), new_ns / static_cast<double>(packets),
+                    old_ns / new_ns);
+    }
+    return 0;
+}
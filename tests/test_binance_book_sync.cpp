@@ -0,0 +1,239 @@
+// ============================================================================
+// test_binance_book_sync.cpp - Snapshot + diff sync against a local stand-in
+// ============================================================================
+//
+// A loopback HTTP server stands in for the REST depth endpoint and diffs
+// are fed as the WebSocket thread would hand them over. Checks are explicit
+// rather than assert(): this links CommonImpl, whose Release flags define
+// NDEBUG.
+
+#include "trading/market_data/binance/binance_book_sync.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using Trading::MarketData::Binance::BinanceBookSync;
+
+namespace {
+
+constexpr Common::Price E8 = 100000000;
+
+void check(bool ok, const char* what) {
+    if (!ok) {
+        std::printf("❌ %s\n", what);
+        std::exit(1);
+    }
+}
+
+// Serves /api/v3/depth?symbol=X from per-symbol bodies set by the test
+class SnapshotServer {
+public:
+    SnapshotServer() {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        const int one = 1;
+        setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        check(bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0, "bind");
+        socklen_t len = sizeof(addr);
+        getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        check(listen(fd_, 16) == 0, "listen");
+        thread_ = std::thread([this]() { serve(); });
+    }
+
+    ~SnapshotServer() {
+        shutdown(fd_, SHUT_RDWR);
+        close(fd_);
+        thread_.join();
+    }
+
+    SnapshotServer(const SnapshotServer&) = delete;
+    SnapshotServer& operator=(const SnapshotServer&) = delete;
+
+    auto url() const -> std::string { return "http://127.0.0.1:" + std::to_string(static_cast<unsigned>(port_)); }
+
+    auto set(const std::string& symbol, const std::string& body, int delay_ms = 0) -> void {
+        std::lock_guard<std::mutex> lock(mutex_);
+        (symbol == "BTCUSDT" ? btc_ : eth_) = body;
+        (symbol == "BTCUSDT" ? btc_delay_ms_ : eth_delay_ms_) = delay_ms;
+    }
+
+    auto requests() const -> int { return requests_.load(); }
+
+private:
+    auto serve() -> void {
+        for (;;) {
+            const int conn = accept(fd_, nullptr, nullptr);
+            if (conn < 0) {
+                return;
+            }
+            char req[2048] = {};
+            const ssize_t n = read(conn, req, sizeof(req) - 1);
+            requests_.fetch_add(1);
+            std::string body;
+            int delay_ms = 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                const bool btc = n > 0 && std::strstr(req, "symbol=BTCUSDT&limit=");
+                body = btc ? btc_ : eth_;
+                delay_ms = btc ? btc_delay_ms_ : eth_delay_ms_;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+            const std::string resp = (body.empty() ? std::string("HTTP/1.1 503 Unavailable\r\n")
+                                                   : std::string("HTTP/1.1 200 OK\r\n")) +
+                                     "Content-Length: " + std::to_string(body.size()) +
+                                     "\r\nConnection: close\r\n\r\n" + body;
+            check(write(conn, resp.data(), resp.size()) == static_cast<ssize_t>(resp.size()), "write");
+            close(conn);
+        }
+    }
+
+    int fd_ = -1;
+    uint16_t port_ = 0;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::string btc_;
+    std::string eth_;
+    int btc_delay_ms_ = 0;
+    int eth_delay_ms_ = 0;
+    std::atomic<int> requests_{0};
+};
+
+auto diff(const char* symbol, uint64_t first, uint64_t last, const char* bids, const char* asks) -> std::string {
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+                  "{\"e\":\"depthUpdate\",\"E\":1,\"s\":\"%s\",\"U\":%lu,\"u\":%lu,\"b\":[%s],\"a\":[%s]}",
+                  symbol, first, last, bids, asks);
+    return buf;
+}
+
+auto feed(BinanceBookSync& sync, int index, const std::string& json) -> bool {
+    return sync.onDiff(index, json.c_str(), json.size());
+}
+
+// Poll as the processor thread would until the symbol goes live
+auto waitLive(BinanceBookSync& sync, int index) -> bool {
+    for (int i = 0; i < 5000; ++i) {
+        if (sync.poll() & (1U << index)) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+} // namespace
+
+int main() {
+    std::printf("Testing BinanceBookSync...\n");
+
+    SnapshotServer server;
+    const std::string url = server.url();
+
+    BinanceBookSync sync;
+    BinanceBookSync::Config config;
+    config.rest_url = url.c_str();
+    config.retry_ms = 20;
+    config.buffer_bytes = 64 * 1024;
+    sync.configure(config);
+    const int btc = sync.addSymbol("btcusdt", 1001, E8 / 100);
+    const int eth = sync.addSymbol("ethusdt", 1002, E8 / 100);
+    check(btc == 0 && eth == 1 && sync.findSymbol("BTCUSDT") == btc, "symbols registered");
+    sync.start();
+
+    // Test 1: Diffs are buffered, the snapshot loads, stale diffs are dropped
+    {
+        server.set("BTCUSDT", "{\"lastUpdateId\":105,\"bids\":[[\"100.00\",\"1.0\"],[\"99.99\",\"2.0\"]],"
+                              "\"asks\":[[\"100.01\",\"3.0\"],[\"100.02\",\"4.0\"]]}");
+        check(!feed(sync, btc, diff("BTCUSDT", 100, 103, "[\"100.00\",\"9.0\"]", "")), "buffered");
+        check(!feed(sync, btc, diff("BTCUSDT", 104, 107, "[\"99.98\",\"5.0\"]", "[\"100.01\",\"0.0\"]")), "buffered");
+        check(!feed(sync, btc, diff("BTCUSDT", 108, 110, "[\"100.00\",\"1.5\"]", "")), "buffered");
+        check(waitLive(sync, btc), "BTC went live");
+
+        const auto* book = sync.book(btc);
+        check(book->getBestBid() == 100 * E8 && book->getBestBidQty() == E8 * 3 / 2, "bid from last diff");
+        check(book->getBestAsk() == 100 * E8 + E8 / 50, "removed ask stays removed");
+        check(book->getBidDepth() == 3 && std::get<1>(book->getBidLevel(2)) == 5 * E8, "bridging diff applied");
+        const auto stats = sync.stats(btc);
+        check(stats.live && stats.snapshots == 1 && stats.stale_diffs == 1 && stats.last_update_id == 110,
+              "stats after sync");
+
+        check(feed(sync, btc, diff("BTCUSDT", 111, 112, "", "[\"100.01\",\"0.5\"]")), "live diff applied");
+        check(!feed(sync, btc, diff("BTCUSDT", 105, 108, "[\"1.00\",\"1.0\"]", "")), "stale diff dropped");
+        check(book->getBestAsk() == 100 * E8 + E8 / 100 && book->getBidDepth() == 3, "live book");
+        std::printf("✓ Snapshot and buffered diffs line up\n");
+    }
+
+    // Test 2: A gap resyncs only that symbol; the other keeps flowing
+    {
+        server.set("ETHUSDT", "{\"lastUpdateId\":500,\"bids\":[[\"10.00\",\"1.0\"]],\"asks\":[[\"10.01\",\"1.0\"]]}");
+        check(!feed(sync, eth, diff("ETHUSDT", 499, 501, "", "")), "ETH buffered");
+        check(waitLive(sync, eth), "ETH went live");
+
+        // Slow snapshot, so the resync is still in flight while ETH ticks
+        server.set("BTCUSDT", "{\"lastUpdateId\":125,\"bids\":[[\"101.00\",\"1.0\"]],\"asks\":[[\"101.01\",\"1.0\"]]}", 200);
+        check(!feed(sync, btc, diff("BTCUSDT", 120, 121, "[\"100.50\",\"1.0\"]", "")), "gap detected");
+        check(!sync.stats(btc).live && !sync.isLive(btc) && sync.stats(btc).resyncs == 1, "BTC resyncing");
+        check(sync.book(btc)->getBidDepth() == 0 && sync.book(btc)->getAskDepth() == 0, "BTC book emptied for republish");
+
+        uint64_t eth_id = 502;
+        for (int i = 0; i < 50; ++i, eth_id += 2) {
+            const auto start = std::chrono::steady_clock::now();
+            check(feed(sync, eth, diff("ETHUSDT", eth_id, eth_id + 1, "[\"10.00\",\"2.0\"]", "")), "ETH flows");
+            check(sync.poll() == 0, "nothing new live yet");
+            check(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20), "hot path not blocked");
+        }
+        check(!feed(sync, btc, diff("BTCUSDT", 122, 126, "[\"100.90\",\"2.0\"]", "")), "BTC still buffering");
+        check(waitLive(sync, btc), "BTC live again");
+        const auto* book = sync.book(btc);
+        check(book->getBestBid() == 101 * E8 && book->getBidDepth() == 2, "resynced book");
+        check(std::get<0>(book->getBidLevel(1)) == 100 * E8 + 90 * E8 / 100, "diff after snapshot applied");
+        check(sync.stats(eth).resyncs == 0 && sync.stats(eth).last_update_id == eth_id - 1, "ETH untouched");
+        std::printf("✓ Gap resyncs one symbol without stalling others\n");
+    }
+
+    // Test 3: A snapshot older than the buffered stream is fetched again
+    {
+        server.set("ETHUSDT", "{\"lastUpdateId\":600,\"bids\":[[\"10.00\",\"7.0\"]],\"asks\":[]}");
+        check(!feed(sync, eth, diff("ETHUSDT", 700, 701, "[\"9.99\",\"1.0\"]", "")), "ETH gap");
+        const int target = server.requests() + 2;
+        for (int i = 0; i < 5000 && server.requests() < target; ++i) {
+            check(sync.poll() == 0, "old snapshot not used");
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        server.set("ETHUSDT", "{\"lastUpdateId\":700,\"bids\":[[\"10.00\",\"8.0\"]],\"asks\":[]}");
+        check(waitLive(sync, eth), "ETH live after newer snapshot");
+        const auto stats = sync.stats(eth);
+        check(stats.resyncs == 1 && stats.snapshots >= 3 && stats.last_update_id == 701, "ETH stats");
+        check(sync.book(eth)->getBestBidQty() == 8 * E8 && sync.book(eth)->getBidDepth() == 2, "ETH book");
+        std::printf("✓ Stale snapshots are refetched\n");
+    }
+
+    // Test 4: Failed fetches are retried and counted
+    {
+        server.set("BTCUSDT", "");
+        check(!feed(sync, btc, diff("BTCUSDT", 200, 201, "", "")), "BTC gap");
+        for (int i = 0; i < 5000 && sync.stats(btc).fetch_failures < 2; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        check(sync.stats(btc).fetch_failures >= 2, "failures counted");
+        server.set("BTCUSDT", "{\"lastUpdateId\":201,\"bids\":[[\"101.00\",\"1.0\"]],\"asks\":[]}");
+        check(waitLive(sync, btc), "BTC recovers");
+        std::printf("✓ Failed snapshots are retried\n");
+    }
+
+    sync.stop();
+    std::printf("\n✅ All BinanceBookSync tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <string>
+#include "trading/market_data/binance/binance_json_scanner.h"
+
+using namespace Trading::MarketData::Binance;
+
+namespace {
+
+// Frames as received from stream.binance.com
+constexpr const char* TRADE =
+    R"({"e":"trade","E":1718000000123,"s":"BTCUSDT","t":3612345678,"p":"67012.34000000",)"
+    R"("q":"0.00150000","T":1718000000120,"m":true,"M":true})";
+constexpr const char* AGG_TRADE =
+    R"({"e":"aggTrade","E":1718000000200,"s":"ETHUSDT","a":987654321,"p":"3501.2",)"
+    R"("q":"1.25","f":100,"l":105,"T":1718000000199,"m":false,"M":true})";
+constexpr const char* DEPTH_UPDATE =
+    R"({"e":"depthUpdate","E":1718000000300,"s":"BTCUSDT","U":157,"u":160,)"
+    R"("b":[["67010.00","0.5"],["67009.99","0.00000000"]],"a":[["67010.01","1.2"]]})";
+constexpr const char* PARTIAL_BOOK =
+    R"({"lastUpdateId":160,"bids":[["67010.00000000","0.50000000"],["67009.00000000","2.00000000"]],)"
+    R"("asks":[["67010.01000000","1.20000000"],["67011.00000000","0.10000000"],["67012.00000000","3.00000000"]]})";
+constexpr const char* BOOK_TICKER =
+    R"({"u":400900217,"s":"BNBUSDT","b":"25.35190000","B":"31.21000000","a":"25.36520000","A":"40.66000000"})";
+
+auto scan(BinanceJsonScanner& scanner, const std::string& json, BinanceMessage& msg) -> BinanceEvent {
+    return scanner.scan(json.c_str(), json.size(), msg);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing BinanceJsonScanner..." << std::endl;
+    auto scanner = std::make_unique<BinanceJsonScanner>();
+    auto msg = std::make_unique<BinanceMessage>();
+
+    // Test 1: Each schema is classified and every field read in one pass
+    {
+        assert(scan(*scanner, TRADE, *msg) == BinanceEvent::TRADE);
+        assert(std::strcmp(msg->symbol, "BTCUSDT") == 0 && msg->trade_id == 3612345678);
+        assert(msg->price == 6701234000000 && msg->qty == 150000 && msg->is_buyer_maker);
+        assert(msg->event_time_ms == 1718000000123 && msg->trade_time_ms == 1718000000120);
+
+        assert(scan(*scanner, AGG_TRADE, *msg) == BinanceEvent::AGG_TRADE);
+        assert(std::strcmp(msg->symbol, "ETHUSDT") == 0 && msg->trade_id == 987654321);
+        assert(msg->price == 350120000000 && msg->qty == 125000000 && !msg->is_buyer_maker);
+
+        const std::string diff = DEPTH_UPDATE;
+        assert(scan(*scanner, diff, *msg) == BinanceEvent::DEPTH_UPDATE);
+        assert(msg->first_update_id == 157 && msg->last_update_id == 160);
+        assert(msg->bids == diff.c_str() + diff.find("\"b\":[") + 5);
+        assert(msg->asks == diff.c_str() + diff.find("\"a\":[") + 5);
+
+        assert(scan(*scanner, PARTIAL_BOOK, *msg) == BinanceEvent::PARTIAL_BOOK);
+        assert(msg->last_update_id == 160 && msg->symbol[0] == '\0');
+        assert(msg->bid_count == 2 && msg->ask_count == 3);
+        assert(msg->bid_prices[0] == 6701000000000 && msg->bid_qtys[1] == 200000000);
+        assert(msg->ask_prices[2] == 6701200000000 && msg->ask_qtys[0] == 120000000);
+
+        assert(scan(*scanner, BOOK_TICKER, *msg) == BinanceEvent::BOOK_TICKER);
+        assert(msg->last_update_id == 400900217 && std::strcmp(msg->symbol, "BNBUSDT") == 0);
+        assert(msg->bid_price == 2535190000 && msg->bid_qty == 3121000000);
+        assert(msg->ask_price == 2536520000 && msg->ask_qty == 4066000000);
+        std::cout << "✓ trade, aggTrade, depthUpdate, partial book and bookTicker parse" << std::endl;
+    }
+
+    // Test 2: Combined-stream wrapper, and frames long enough to use the
+    // vector index with a tail
+    {
+        const std::string wrapped = std::string(R"({"stream":"ethusdt@depth20@100ms","data":)") + PARTIAL_BOOK + "}";
+        assert(scan(*scanner, wrapped, *msg) == BinanceEvent::PARTIAL_BOOK);
+        assert(std::strcmp(msg->symbol, "ETHUSDT") == 0 && msg->ask_count == 3);
+
+        std::string big = R"({"lastUpdateId":9,"bids":[)";
+        for (int i = 0; i < 100; ++i) {
+            big += i ? R"(,[")" : R"([")";
+            big += std::to_string(1000 - i);
+            big += R"(.5","1"])";
+        }
+        big += R"(],"asks":[]})";
+        assert(scan(*scanner, big, *msg) == BinanceEvent::PARTIAL_BOOK);
+        assert(msg->bid_count == BinanceMessage::MAX_LEVELS && msg->ask_count == 0);
+        assert(msg->bid_prices[19] == 98150000000 && msg->bid_qtys[19] == 100000000);
+        std::cout << "✓ Combined streams and long frames parse" << std::endl;
+    }
+
+    // Test 3: Anything off-schema is left to the generic parser
+    {
+        for (const char* json : {
+                 R"({"result":null,"id":1})",                               // Subscribe reply
+                 R"({"e":"kline","E":1,"s":"BTCUSDT","k":{"t":1}})",        // Unknown event
+                 R"({"e":"trade", "E":1,"s":"BTCUSDT","p":"1","q":"1"})",   // Whitespace
+                 R"({"e":"trade","E":1,"s":"BTC\"USDT","p":"1","q":"1"})",  // Escape
+                 R"({"e":"trade","E":1,"s":"BTCUSDT","p":"1"})",            // Missing field
+                 R"({"e":"trade","E":1,"s":"BTCUSDT","p":"-1","q":"1"})",   // Negative price
+                 R"({"e":"trade","E":1,"s":"BTCUSDT","p":"1.2.3","q":"1"})", // Not a number
+                 R"({"e":"trade","E":1,"s":"BTCUSDT","p":"1","q":"1")",     // Truncated
+                 R"({"lastUpdateId":1,"bids":[["1","2"],"asks":[]})",       // Broken levels
+             }) {
+            assert(scan(*scanner, json, *msg) == BinanceEvent::UNKNOWN);
+            assert(msg->event == BinanceEvent::UNKNOWN);
+        }
+        const std::string huge(BinanceJsonScanner::MAX_MESSAGE + 1, ' ');
+        assert(scan(*scanner, huge, *msg) == BinanceEvent::UNKNOWN);
+
+        // Digits past the eighth decimal are dropped, not rounded
+        assert(scan(*scanner, R"({"e":"trade","E":1,"s":"X","p":"0.123456789","q":"9999999999"})", *msg)
+               == BinanceEvent::TRADE);
+        assert(msg->price == 12345678 && msg->qty == 999999999900000000);
+        std::cout << "✓ Off-schema frames fall back" << std::endl;
+    }
+
+    std::cout << "\n✅ All BinanceJsonScanner tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,211 @@
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "trading/market_data/order_book.h"
+#include "trading/market_data/book_snapshot_ring.h"
+
+using namespace Trading::MarketData;
+
+namespace {
+
+// The two calls the service makes of OrderBookManager, without its logging
+struct Books {
+    using Book = OrderBook<20>;
+    static constexpr size_t COUNT = 3;
+
+    struct ActiveBooks {
+        const Book* books[COUNT];
+        size_t count;
+    };
+
+    Books() {
+        for (size_t i = 0; i < COUNT; ++i) {
+            books[i].setInstrumentToken(static_cast<uint32_t>(1000 + i));
+            books[i].setTickerId(static_cast<TickerId>(i));
+        }
+    }
+
+    auto getActiveBooks(ActiveBooks& active) const noexcept -> size_t {
+        for (size_t i = 0; i < COUNT; ++i) {
+            active.books[i] = &books[i];
+        }
+        active.count = COUNT;
+        return COUNT;
+    }
+
+    auto getOrderBook(uint32_t token) noexcept -> Book* {
+        return token >= 1000 && token < 1000 + COUNT ? &books[token - 1000] : nullptr;
+    }
+
+    Book books[COUNT];
+};
+
+using Ring = BookSnapshotRing<Books::Book>;
+
+// Every level of the book carries 'v', so a torn copy is detectable
+auto fill(Books::Book& book, uint64_t v) -> void {
+    book.beginUpdate();
+    for (uint8_t i = 0; i < 10; ++i) {
+        book.updateBid(static_cast<Price>(v * 100 - i), v, 1, i);
+        book.updateAsk(static_cast<Price>(v * 100 + 1 + i), v, 1, i);
+    }
+    book.updateTimestamp(v);
+    book.endUpdate();
+}
+
+auto consistent(const Ring::Snapshot& snap) -> bool {
+    for (uint8_t i = 0; i < snap.bid_depth; ++i) {
+        if (snap.bid_qtys[i] != snap.bid_qtys[0] || snap.ask_qtys[i] != snap.bid_qtys[0]) {
+            return false;
+        }
+    }
+    return snap.total_bid_qty == snap.bid_qtys[0] * snap.bid_depth;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing BookSnapshotRing..." << std::endl;
+    const std::string path = "/tmp/test_book_snapshot_ring_" + std::to_string(getpid()) + ".dat";
+    ::unlink(path.c_str());
+
+    // Test 1: Frames are found by time and read back intact
+    {
+        auto books = std::make_unique<Books>();
+        Books::ActiveBooks active{};
+        Ring ring;
+        assert(ring.create(path.c_str(), 4, 8, 60000000000ULL));
+        assert(ring.latestFrame() == Ring::NO_FRAME && ring.findFrame(~0ULL) == Ring::NO_FRAME);
+
+        for (uint64_t minute = 1; minute <= 5; ++minute) {
+            for (auto& book : books->books) {
+                fill(book, minute * 10 + book.getTickerId());
+            }
+            books->getActiveBooks(active);
+            assert(ring.writeFrame(active.books, active.count, minute * 60) == minute - 1);
+        }
+        ring.close();
+
+        Ring reader;
+        assert(reader.open(path.c_str()));
+        assert(reader.framesWritten() == 5 && reader.oldestFrame() == 0 && reader.maxBooks() == 4);
+        assert(reader.findFrame(59) == Ring::NO_FRAME);
+        assert(reader.findFrame(60) == 0 && reader.findFrame(179) == 1 && reader.findFrame(180) == 2);
+        assert(reader.findFrame(~0ULL) == 4 && reader.latestFrame() == 4);
+
+        Ring::Snapshot snaps[4];
+        uint64_t taken = 0;
+        assert(reader.readFrame(reader.findFrame(200), snaps, 4, &taken) == 3 && taken == 180);
+        for (size_t i = 0; i < 3; ++i) {
+            assert(snaps[i].instrument_token == 1000 + i && snaps[i].ticker_id == i);
+            assert(snaps[i].bid_depth == 10 && snaps[i].bid_qtys[9] == 30 + i && consistent(snaps[i]));
+        }
+        std::cout << "✓ Frames are indexed by time and read back" << std::endl;
+    }
+
+    // Test 2: The ring wraps, and a writer reopening it carries on;
+    // a different layout replaces the file
+    {
+        auto books = std::make_unique<Books>();
+        Books::ActiveBooks active{};
+        books->getActiveBooks(active);
+        Ring ring;
+        assert(ring.create(path.c_str(), 4, 8, 60000000000ULL));
+        assert(ring.framesWritten() == 5);
+        for (uint64_t minute = 6; minute <= 20; ++minute) {
+            ring.writeFrame(active.books, active.count, minute * 60);
+        }
+        assert(ring.framesWritten() == 20 && ring.oldestFrame() == 12);
+        assert(ring.findFrame(11 * 60) == Ring::NO_FRAME && ring.findFrame(13 * 60) == 12);
+        assert(ring.frameTime(11) == 0 && ring.frameTime(19) == 20 * 60);
+
+        Ring::Snapshot snaps[4];
+        assert(ring.readFrame(3, snaps, 4) == 0);  // Overwritten
+        assert(ring.readFrame(19, snaps, 2) == 2);  // Caller's limit
+
+        assert(ring.create(path.c_str(), 2, 8, 60000000000ULL));  // Fewer books per frame
+        assert(ring.framesWritten() == 0);
+        assert(ring.writeFrame(active.books, active.count, 60) == 0);
+        assert(ring.readFrame(0, snaps, 4) == 2);
+        std::cout << "✓ Ring wraps, resumes, and resets on layout change" << std::endl;
+    }
+
+    // Test 3: The service snapshots books while they're being written,
+    // and a restart restores the newest frame
+    {
+        ::unlink(path.c_str());
+        auto books = std::make_unique<Books>();
+        BookSnapshotService<Books> service(*books);
+        BookSnapshotService<Books>::Config config;
+        config.path = path.c_str();
+        config.interval_ms = 2;
+        config.max_books = 4;
+        config.capacity = 64;
+        assert(service.open(config));
+
+        std::atomic<bool> done{false};
+        std::thread writer([&]() {
+            for (uint64_t v = 1; !done.load(std::memory_order_acquire); ++v) {
+                for (auto& book : books->books) {
+                    fill(book, v);
+                }
+            }
+        });
+        service.start();
+        while (service.ring().framesWritten() < 100) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        service.stop();
+        done.store(true, std::memory_order_release);
+        writer.join();
+
+        const auto& ring = service.ring();
+        Ring::Snapshot snaps[4];
+        for (uint64_t frame = ring.oldestFrame(); frame < ring.framesWritten(); ++frame) {
+            assert(ring.readFrame(frame, snaps, 4) == 3);
+            for (size_t i = 0; i < 3; ++i) {
+                assert(consistent(snaps[i]));
+            }
+        }
+        const uint64_t last_qty = snaps[1].bid_qtys[0];
+
+        auto restarted = std::make_unique<Books>();
+        restarted->books[1].setTickerId(42);  // Subscription order changed
+        BookSnapshotService<Books> again(*restarted);
+        assert(again.open(config));
+        uint64_t frame_ns = 0;
+        assert(again.restore(*restarted, &frame_ns) == 3 && frame_ns > 0);
+        assert(restarted->books[1].getBestBidQty() == last_qty && restarted->books[1].getBidDepth() == 10);
+        assert(restarted->books[1].getTickerId() == 42 && restarted->books[1].getInstrumentToken() == 1001);
+        std::cout << "✓ Service frames are consistent and restore on restart" << std::endl;
+
+        // Frames from before the session, or past the age limit, stay on disk
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        auto aged = config;
+        aged.max_restore_age_s = 1;
+        BookSnapshotService<Books> too_old(*restarted);
+        assert(too_old.open(aged));
+        assert(too_old.restore(*restarted) == 0);
+
+        auto session = config;
+        session.restore_after_ns = frame_ns + 1;
+        BookSnapshotService<Books> last_session(*restarted);
+        assert(last_session.open(session));
+        assert(last_session.restore(*restarted) == 0);
+        session.restore_after_ns = frame_ns;
+        BookSnapshotService<Books> this_session(*restarted);
+        assert(this_session.open(session));
+        assert(this_session.restore(*restarted) == 3);
+        std::cout << "✓ Stale and previous-session frames are not restored" << std::endl;
+    }
+
+    ::unlink(path.c_str());
+    std::cout << "\n✅ All BookSnapshotRing tests passed!" << std::endl;
+    return 0;
+}
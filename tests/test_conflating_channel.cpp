@@ -0,0 +1,100 @@
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../common/conflating_channel.h"
+
+using Common::ConflatingChannel;
+
+namespace {
+
+// Every field carries the same version, so a torn copy is detectable
+struct Quote {
+    uint64_t version;
+    uint64_t bid;
+    uint64_t ask;
+    uint64_t check;
+};
+
+auto makeQuote(uint64_t v) -> Quote { return {v, v * 2, v * 3, v ^ 0x5555}; }
+
+} // namespace
+
+int main() {
+    std::cout << "Testing ConflatingChannel..." << std::endl;
+
+    // Test 1: Repeated updates to one key deliver once, newest value
+    {
+        auto channel = std::make_unique<ConflatingChannel<Quote, 300>>();
+        assert(channel->drain([](size_t, const Quote&) { assert(false); }) == 0);
+
+        for (uint64_t v = 1; v <= 5; ++v) {
+            assert(channel->publish(7, makeQuote(v)));
+        }
+        assert(channel->publish(200, makeQuote(42)));
+        assert(channel->publish(64, makeQuote(9)));
+        assert(!channel->publish(300, makeQuote(1)));  // Out of range
+        assert(channel->conflatedCount() == 4);
+
+        std::vector<std::pair<size_t, uint64_t>> seen;
+        assert(channel->drain([&](size_t key, const Quote& q) { seen.emplace_back(key, q.version); }) == 3);
+        assert(seen.size() == 3);
+        assert(seen[0] == std::make_pair(size_t{7}, uint64_t{5}));
+        assert(seen[1] == std::make_pair(size_t{64}, uint64_t{9}));
+        assert(seen[2] == std::make_pair(size_t{200}, uint64_t{42}));
+        assert(channel->drain([](size_t, const Quote&) { assert(false); }) == 0);
+
+        Quote latest{};
+        assert(channel->latest(7, latest) && latest.version == 5);
+        std::cout << "✓ Updates conflate to the newest value per key" << std::endl;
+    }
+
+    // Test 2: A slow consumer sees every key's values in order, untorn,
+    // and always ends on each key's final value
+    {
+        constexpr size_t KEYS = 1000;
+        constexpr uint64_t ROUNDS = 2000;
+        auto channel = std::make_unique<ConflatingChannel<Quote, KEYS>>();
+        std::atomic<bool> done{false};
+        std::vector<uint64_t> last(KEYS, 0);
+        uint64_t delivered = 0;
+
+        std::thread consumer([&]() {
+            auto on_quote = [&](size_t key, const Quote& q) {
+                assert(q.bid == q.version * 2 && q.ask == q.version * 3 && q.check == (q.version ^ 0x5555));
+                assert(q.version >= last[key]);  // May repeat if published mid-drain
+                last[key] = q.version;
+                ++delivered;
+            };
+            while (!done.load(std::memory_order_acquire)) {
+                channel->drain(on_quote);
+                std::this_thread::yield();  // Deliberately slower than the producer
+            }
+            channel->drain(on_quote);
+        });
+
+        for (uint64_t round = 1; round <= ROUNDS; ++round) {
+            for (size_t key = 0; key < KEYS; key += (round % 7) + 1) {
+                channel->publish(key, makeQuote(round * KEYS + key));
+            }
+        }
+        // Final state for every key
+        for (size_t key = 0; key < KEYS; ++key) {
+            channel->publish(key, makeQuote((ROUNDS + 1) * KEYS + key));
+        }
+        done.store(true, std::memory_order_release);
+        consumer.join();
+
+        for (size_t key = 0; key < KEYS; ++key) {
+            assert(last[key] == (ROUNDS + 1) * KEYS + key);
+        }
+        std::cout << "✓ Slow consumer gets " << delivered << " of "
+                  << delivered + channel->conflatedCount() << " updates, newest per key" << std::endl;
+    }
+
+    std::cout << "\n✅ All ConflatingChannel tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include "../common/decimal_codec.h"
+
+using Common::parseDecimal;
+using Common::formatDecimal;
+using Common::DECIMAL_BUFFER_SIZE;
+
+namespace {
+
+template<typename T>
+auto parse(const std::string& text, uint32_t scale, T& out) -> const char* {
+    return parseDecimal(text.data(), text.data() + text.size(), scale, out);
+}
+
+auto format(int64_t value, uint32_t scale) -> std::string {
+    char buf[DECIMAL_BUFFER_SIZE];
+    const size_t len = formatDecimal(value, scale, buf);
+    assert(std::strlen(buf) == len);
+    return std::string(buf, len);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing decimal codec..." << std::endl;
+
+    // Test 1: Parsing at each venue's scale
+    {
+        int64_t price = 0;
+        uint64_t qty = 0;
+        assert(parse("67012.34000000", 8, price) && price == 6701234000000);
+        assert(parse("0.00150000", 8, qty) && qty == 150000);
+        assert(parse("2450.05", 2, price) && price == 245005);
+        assert(parse("0.29", 2, price) && price == 29);  // atof * 100 gives 28
+        assert(parse("3501.2", 5, price) && price == 350120000);
+        assert(parse("17", 0, qty) && qty == 17);
+        assert(parse("-0.5", 2, price) && price == -50);
+        assert(parse(".5", 2, price) && price == 50);
+        assert(parse("7.", 2, price) && price == 700);
+        assert(parse("0", 8, price) && price == 0);
+
+        // Digits past the scale are dropped, not rounded
+        assert(parse("0.123456789", 8, price) && price == 12345678);
+        assert(parse("1.999", 2, price) && price == 199);
+        assert(parse("1.00000000000000000000000009", 2, price) && price == 100);
+        std::cout << "✓ Decimals parse at scales 0, 2, 5 and 8" << std::endl;
+    }
+
+    // Test 2: Where parsing stops, and what it refuses
+    {
+        int64_t price = 0;
+        uint64_t qty = 0;
+        const std::string quoted = R"(67010.01","1.2"])";
+        const char* end = parse(quoted, 8, price);
+        assert(end == quoted.data() + 8 && *end == '"');
+
+        // Bounded by end, not by a terminator
+        const std::string digits = "123456789";
+        assert(parseDecimal(digits.data(), digits.data() + 3, 2, price) == digits.data() + 3);
+        assert(price == 12300);
+
+        // Sixteen digits straddle both words
+        assert(parse("1234567890123456", 0, price) && price == 1234567890123456);
+        assert(parse("99999999.99999999", 8, price) && price == 9999999999999999);
+        assert(parse("9999999999.99", 8, price) && price == 999999999999000000);
+
+        assert(!parse("", 8, price));
+        assert(!parse("abc", 8, price));
+        assert(!parse(".", 8, price));
+        assert(!parse("-", 8, price));
+        assert(!parse("-1", 8, qty));                      // Unsigned takes no sign
+        assert(!parse("10000000000", 8, price));           // 1e10 at 1e8 overflows
+        assert(parse("123456789012345678", 0, price) && price == 123456789012345678);
+        assert(!parse("1234567890123456789", 0, price));   // Over eighteen whole digits
+        std::cout << "✓ Ends, bounds and overflow" << std::endl;
+    }
+
+    // Test 3: Formatting matches printf("%.*f") on the same value
+    {
+        assert(format(6701234000000, 8) == "67012.34000000");
+        assert(format(150000, 8) == "0.00150000");
+        assert(format(245005, 2) == "2450.05");
+        assert(format(-50, 2) == "-0.50");
+        assert(format(0, 2) == "0.00");
+        assert(format(17, 0) == "17");
+        assert(format(INT64_MIN, 8) == "-92233720368.54775808");
+
+        char unsigned_buf[DECIMAL_BUFFER_SIZE];
+        assert(formatDecimal(UINT64_MAX, 0, unsigned_buf) == 20);
+        assert(std::strcmp(unsigned_buf, "18446744073709551615") == 0);
+
+        std::mt19937_64 rng(42);
+        char expected[64];
+        for (int i = 0; i < 100000; ++i) {
+            const uint32_t scale = static_cast<uint32_t>(rng() % 9);
+            const int64_t value = static_cast<int64_t>(rng() >> (rng() % 64)) * (i % 2 ? 1 : -1);
+            const uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+            const uint64_t pow10 = Common::DecimalDetail::POW10[scale];
+            if (scale) {
+                std::snprintf(expected, sizeof(expected), "%s%lu.%0*lu", value < 0 ? "-" : "",
+                              magnitude / pow10, static_cast<int>(scale), magnitude % pow10);
+            } else {
+                std::snprintf(expected, sizeof(expected), "%ld", value);
+            }
+            assert(format(value, scale) == expected);
+        }
+        std::cout << "✓ Formatting agrees with printf on random values" << std::endl;
+    }
+
+    // Test 4: Format then parse returns the value
+    {
+        std::mt19937_64 rng(7);
+        for (int i = 0; i < 100000; ++i) {
+            const uint32_t scale = static_cast<uint32_t>(rng() % 9);
+            const int64_t bound = static_cast<int64_t>(Common::DecimalDetail::POW10[18]);
+            const int64_t value = static_cast<int64_t>(rng() % static_cast<uint64_t>(2 * bound)) - bound;
+            const std::string text = format(value, scale);
+            int64_t back = 0;
+            assert(parse(text, scale, back) == text.data() + text.size());
+            assert(back == value);
+        }
+        std::cout << "✓ Values round-trip through text" << std::endl;
+    }
+
+    std::cout << "\n✅ All decimal codec tests passed!" << std::endl;
+    return 0;
+}
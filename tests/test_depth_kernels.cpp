@@ -0,0 +1,153 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+#include "trading/market_data/depth_kernels.h"
+#include "trading/market_data/order_book.h"
+#include "trading/market_data/ladder_book.h"
+
+using namespace Trading::MarketData;
+namespace Scalar = Depth::Scalar;
+
+namespace {
+
+auto near(double a, double b) -> bool {
+    if (std::isnan(a) || std::isnan(b)) {
+        return std::isnan(a) && std::isnan(b);
+    }
+    return std::abs(a - b) <= 1e-9 * std::max(1.0, std::abs(b));
+}
+
+auto sameFill(const Depth::Fill& a, const Depth::Fill& b) -> bool {
+    return near(a.vwap, b.vwap) && a.filled == b.filled && a.last_price == b.last_price && a.levels == b.levels;
+}
+
+// A bid side of n levels, 1-3 ticks apart, with Binance-sized quantities
+struct Side {
+    std::vector<Price> prices;
+    std::vector<Qty> qtys;
+};
+
+auto makeBids(std::mt19937& rng, size_t n) -> Side {
+    Side side;
+    Price price = 6500000000000;  // 65000.00000000
+    for (size_t i = 0; i < n; ++i) {
+        side.prices.push_back(price);
+        side.qtys.push_back(1 + static_cast<Qty>(rng() % 500000000));
+        price -= 1000000 * (1 + static_cast<Price>(rng() % 3));
+    }
+    return side;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing depth kernels..." << std::endl;
+
+    // Test 1: Hand-checked values on a small side
+    {
+        const Price prices[] = {100, 99, 98, 97, 96, 95};
+        const Qty qtys[] = {10, 20, 30, 40, 50, 60};
+        Qty cum[6];
+        assert(Depth::cumulativeDepth(qtys, 6, cum) == 210);
+        assert(cum[0] == 10 && cum[3] == 100 && cum[5] == 210);
+
+        auto fill = Depth::vwapToFill(prices, qtys, 6, 45);  // 10@100 + 20@99 + 15@98
+        assert(fill.filled == 45 && fill.levels == 3 && fill.last_price == 98);
+        assert(near(fill.vwap, (1000.0 + 1980.0 + 1470.0) / 45.0));
+        fill = Depth::vwapToFill(prices, qtys, 6, 100);  // Exactly four levels
+        assert(fill.filled == 100 && fill.levels == 4 && fill.last_price == 97);
+        fill = Depth::vwapToFill(prices, qtys, 6, 1000);  // Runs out
+        assert(fill.filled == 210 && fill.levels == 6 && fill.last_price == 95);
+        fill = Depth::vwapToFill(prices, qtys, 6, 0);
+        assert(fill.filled == 0 && fill.levels == 0 && std::isnan(fill.vwap));
+
+        assert(Depth::bidDepthWithin(prices, qtys, 6, 97) == 100);
+        assert(Depth::bidDepthWithin(prices, qtys, 6, 101) == 0);
+        const Price asks[] = {101, 102, 103, 104, 105, 106};
+        assert(Depth::askDepthWithin(asks, qtys, 6, 105) == 150);
+        assert(Depth::askDepthWithin(asks, qtys, 6, 100) == 0);
+        assert(near(Depth::decayedDepth(qtys, 6, 0.5), 10 + 10 + 7.5 + 5 + 3.125 + 1.875));
+        assert(near(Depth::weightedImbalance(qtys, 6, qtys, 6, 0.8), 0.0));
+        assert(near(Depth::weightedImbalance(qtys, 0, qtys, 0, 0.8), 0.0));
+
+        const Qty sizes[] = {5, 45, 500};
+        double bps[3];
+        Depth::impactCurve(prices, qtys, 6, sizes, 3, bps);
+        assert(near(bps[0], 0.0) && near(bps[1], (100.0 - 4450.0 / 45.0) / 100.0 * 10000.0));
+        assert(std::isnan(bps[2]));
+        std::cout << "✓ Small side matches hand-computed values" << std::endl;
+    }
+
+    // Test 2: Every kernel matches the scalar reference at every depth,
+    // including lengths that aren't a multiple of the vector width
+    {
+        std::mt19937 rng(19);
+        for (size_t n = 0; n <= 100; ++n) {
+            const auto bids = makeBids(rng, n);
+            const Price* p = bids.prices.data();
+            const Qty* q = bids.qtys.data();
+
+            std::vector<Qty> fast(n + 1), ref(n + 1);
+            assert(Depth::cumulativeDepth(q, n, fast.data()) == Scalar::cumulativeDepth(q, n, ref.data()));
+            assert(fast == ref);
+
+            const Qty total = n > 0 ? ref[n - 1] : 0;
+            for (const Qty target : {Qty{1}, total / 3, total / 2 + 1, total, total + 1,
+                                     n > 0 ? ref[n / 2] : Qty{7}, std::numeric_limits<Qty>::max()}) {
+                assert(sameFill(Depth::vwapToFill(p, q, n, target), Scalar::vwapToFill(p, q, n, target)));
+            }
+            for (const Price floor : {Price{0}, n > 0 ? p[n / 2] : Price{0}, n > 0 ? p[0] + 1 : Price{1}}) {
+                assert(Depth::bidDepthWithin(p, q, n, floor) == Scalar::bidDepthWithin(p, q, n, floor));
+            }
+            assert(near(Depth::decayedDepth(q, n, 0.9), Scalar::decayedDepth(q, n, 0.9)));
+
+            // The same levels mirrored as an ask side
+            std::vector<Price> asks(n);
+            for (size_t i = 0; i < n; ++i) {
+                asks[i] = 2 * 6500000000000 - p[i];
+            }
+            for (const Price ceiling : {Price{0}, n > 0 ? asks[n / 3] : Price{0}, Price_INVALID}) {
+                assert(Depth::askDepthWithin(asks.data(), q, n, ceiling) == Scalar::askDepthWithin(asks.data(), q, n, ceiling));
+            }
+        }
+        std::cout << "✓ Vector kernels match the scalar reference for 0-100 levels" << std::endl;
+    }
+
+    // Test 3: Both book types expose the same levels to the kernels
+    {
+        auto book = std::make_unique<OrderBook<20>>();
+        auto ladder = std::make_unique<LadderBook<4096>>(1);
+        book->beginUpdate();
+        for (uint8_t i = 0; i < 7; ++i) {
+            book->updateBid(1000 - i, 10u + i, 1, i);
+            book->updateAsk(1001 + i, 5u + i, 1, i);
+            ladder->setBid(1000 - i, 10u + i);
+            ladder->setAsk(1001 + i, 5u + i);
+        }
+        book->endUpdate();
+
+        Depth::SideLevels<20> direct;
+        Depth::SideLevels<20> copied;
+        Depth::bidLevels(*book, direct);
+        Depth::bidLevels(*ladder, copied);
+        assert(direct.prices == book->bidPrices() && copied.prices == copied.price_buf);
+        assert(direct.count == 7 && copied.count == 7);
+        for (size_t i = 0; i < 7; ++i) {
+            assert(direct.prices[i] == copied.prices[i] && direct.qtys[i] == copied.qtys[i]);
+        }
+        Depth::askLevels(*book, direct);
+        Depth::askLevels(*ladder, copied);
+        assert(sameFill(Depth::vwapToFill(direct.prices, direct.qtys, direct.count, 20),
+                        Depth::vwapToFill(copied.prices, copied.qtys, copied.count, 20)));
+        std::cout << "✓ OrderBook and LadderBook feed the kernels alike" << std::endl;
+    }
+
+    std::cout << "\n✅ All depth kernel tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include "trading/market_data/zerodha/kite_frame_parser.h"
+
+using namespace Trading::MarketData::Zerodha;
+
+namespace {
+
+// Builds a binary frame the way Kite sends it: big-endian throughout
+class FrameBuilder {
+public:
+    auto packet(const std::vector<uint32_t>& words) -> FrameBuilder& {
+        put16(static_cast<uint16_t>(words.size() * 4));
+        for (const uint32_t word : words) {
+            put32(word);
+        }
+        ++count_;
+        return *this;
+    }
+
+    auto raw(size_t bytes) -> FrameBuilder& {
+        put16(static_cast<uint16_t>(bytes));
+        body_.insert(body_.end(), bytes, 0xAB);
+        ++count_;
+        return *this;
+    }
+
+    // The frame, starting 'offset' bytes into the returned buffer
+    auto build(size_t offset = 0) const -> std::vector<uint8_t> {
+        std::vector<uint8_t> frame(offset, 0);
+        frame.push_back(static_cast<uint8_t>(count_ >> 8));
+        frame.push_back(static_cast<uint8_t>(count_));
+        frame.insert(frame.end(), body_.begin(), body_.end());
+        return frame;
+    }
+
+private:
+    auto put16(uint16_t value) -> void {
+        body_.push_back(static_cast<uint8_t>(value >> 8));
+        body_.push_back(static_cast<uint8_t>(value));
+    }
+    auto put32(uint32_t value) -> void {
+        put16(static_cast<uint16_t>(value >> 16));
+        put16(static_cast<uint16_t>(value));
+    }
+
+    std::vector<uint8_t> body_;
+    size_t count_{0};
+};
+
+// A full packet's 46 words: token, 15 tick fields, then 10 depth items of
+// quantity, price and (orders << 16 | padding)
+auto fullWords(std::mt19937& rng) -> std::vector<uint32_t> {
+    std::vector<uint32_t> words(sizeof(KiteFullPacket) / 4);
+    for (auto& word : words) {
+        word = static_cast<uint32_t>(rng());
+    }
+    return words;
+}
+
+auto parse(const std::vector<uint8_t>& frame, KiteFrameBatch& out, size_t offset = 0) -> bool {
+    return parseKiteFrame(frame.data() + offset, frame.size() - offset, out);
+}
+
+auto checkFull(const KiteFrameBatch& batch, size_t i, const std::vector<uint32_t>& w) -> void {
+    assert(batch.mode[i] == KiteMode::MODE_FULL);
+    assert(batch.token[i] == w[0] && batch.last_price[i] == w[1] && batch.last_qty[i] == w[2]);
+    assert(batch.average_price[i] == w[3] && batch.volume[i] == w[4]);
+    assert(batch.buy_qty[i] == w[5] && batch.sell_qty[i] == w[6]);
+    assert(batch.open[i] == w[7] && batch.high[i] == w[8] && batch.low[i] == w[9] && batch.close[i] == w[10]);
+    assert(batch.last_traded_time[i] == w[11] && batch.oi[i] == w[12]);
+    assert(batch.oi_day_high[i] == w[13] && batch.oi_day_low[i] == w[14] && batch.exchange_time[i] == w[15]);
+    for (size_t level = 0; level < KiteFrameBatch::MAX_DEPTH; ++level) {
+        const uint32_t* bid = &w[16 + level * 3];
+        const uint32_t* ask = &w[31 + level * 3];
+        assert(batch.bid_qty[i][level] == bid[0] && batch.bid_price[i][level] == bid[1]);
+        assert(batch.bid_orders[i][level] == bid[2] >> 16);
+        assert(batch.ask_qty[i][level] == ask[0] && batch.ask_price[i][level] == ask[1]);
+        assert(batch.ask_orders[i][level] == ask[2] >> 16);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing Kite frame parser..." << std::endl;
+    auto batch = std::make_unique<KiteFrameBatch>();
+    std::mt19937 rng(42);
+
+    // Test 1: One packet of each mode, every field in its column
+    {
+        const std::vector<uint32_t> ltp = {256265, 2450005};
+        const std::vector<uint32_t> quote = {260105, 5123410, 75, 5120000, 1234567, 900, 1100,
+                                             5100000, 5130000, 5090000, 5110000};
+        std::vector<uint32_t> full = {
+            12345678, 24500, 50, 24480, 99000, 4000, 5000, 24000, 25000, 23900, 24100,
+            1718000000, 150000, 160000, 140000, 1718000001};
+        for (uint32_t level = 0; level < 5; ++level) {
+            full.insert(full.end(), {100 + level, 24495 - level * 5, (3 + level) << 16});
+        }
+        for (uint32_t level = 0; level < 5; ++level) {
+            full.insert(full.end(), {200 + level, 24505 + level * 5, (7 + level) << 16});
+        }
+        const auto frame = FrameBuilder().packet(ltp).packet(quote).packet(full).build();
+        assert(parse(frame, *batch) && batch->count == 3 && batch->skipped == 0);
+
+        assert(batch->mode[0] == KiteMode::MODE_LTP);
+        assert(batch->token[0] == 256265 && batch->last_price[0] == 2450005);
+
+        assert(batch->mode[1] == KiteMode::MODE_QUOTE);
+        assert(batch->token[1] == 260105 && batch->last_price[1] == 5123410 && batch->last_qty[1] == 75);
+        assert(batch->volume[1] == 1234567 && batch->buy_qty[1] == 900 && batch->sell_qty[1] == 1100);
+        assert(batch->open[1] == 5100000 && batch->close[1] == 5110000);
+
+        checkFull(*batch, 2, full);
+        assert(batch->bid_price[2][0] == 24495 && batch->bid_qty[2][4] == 104 && batch->bid_orders[2][1] == 4);
+        assert(batch->ask_price[2][4] == 24525 && batch->ask_orders[2][0] == 7);
+        std::cout << "✓ LTP, quote and full packets stage into columns" << std::endl;
+    }
+
+    // Test 2: A full option chain at every alignment, against the wire words
+    {
+        for (size_t offset = 0; offset < 4; ++offset) {
+            FrameBuilder builder;
+            std::vector<std::vector<uint32_t>> packets;
+            for (int i = 0; i < 300; ++i) {
+                packets.push_back(fullWords(rng));
+                builder.packet(packets.back());
+            }
+            const auto frame = builder.build(offset);
+            assert(parse(frame, *batch, offset) && batch->count == 300);
+            for (size_t i = 0; i < packets.size(); ++i) {
+                checkFull(*batch, i, packets[i]);
+            }
+        }
+        std::cout << "✓ Full packets match the wire at every alignment" << std::endl;
+    }
+
+    // Test 3: Unknown lengths are skipped, cut frames keep what came before
+    {
+        const std::vector<uint32_t> ltp = {1, 2};
+        const auto frame = FrameBuilder().packet(ltp).raw(28).raw(32).packet(fullWords(rng)).build();
+        assert(parse(frame, *batch) && batch->count == 2 && batch->skipped == 2);
+        assert(batch->mode[0] == KiteMode::MODE_LTP && batch->mode[1] == KiteMode::MODE_FULL);
+
+        assert(!parse(std::vector<uint8_t>(frame.begin(), frame.end() - 1), *batch));
+        assert(batch->count == 1 && batch->token[0] == 1);
+        assert(!parse(std::vector<uint8_t>(frame.begin(), frame.begin() + 3), *batch));
+        assert(batch->count == 0);
+        assert(!parse(std::vector<uint8_t>(1, 0), *batch) && batch->count == 0);
+
+        FrameBuilder crowded;
+        for (size_t i = 0; i < KiteFrameBatch::MAX_PACKETS + 5; ++i) {
+            crowded.packet({static_cast<uint32_t>(i), 100});
+        }
+        assert(parse(crowded.build(), *batch));
+        assert(batch->count == KiteFrameBatch::MAX_PACKETS && batch->skipped == 5);
+        assert(batch->token[KiteFrameBatch::MAX_PACKETS - 1] == KiteFrameBatch::MAX_PACKETS - 1);
+        std::cout << "✓ Index packets, truncation and overflow" << std::endl;
+    }
+
+    std::cout << "\n✅ All Kite frame parser tests passed!" << std::endl;
+    return 0;
+}
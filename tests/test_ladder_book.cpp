@@ -0,0 +1,140 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include "../trading/market_data/ladder_book.h"
+
+using Trading::MarketData::LadderBook;
+
+namespace {
+
+constexpr Common::Price TICK = 1000000;  // 0.01 at 1e8 scaling
+
+// Compare every level against a reference keyed by tick
+template<size_t N>
+void checkBook(const LadderBook<N>& book,
+               const std::map<int64_t, Common::Qty, std::greater<>>& bids,
+               const std::map<int64_t, Common::Qty>& asks) {
+    assert(book.getBidDepth() == bids.size() && book.getAskDepth() == asks.size());
+    Common::Qty total = 0;
+    size_t level = 0;
+    for (const auto& [tick, qty] : bids) {
+        const auto [price, q, orders] = book.getBidLevel(level++);
+        assert(price == tick * TICK && q == qty && orders == 1);
+        total += qty;
+    }
+    assert(std::get<0>(book.getBidLevel(level)) == Common::Price_INVALID);
+    assert(book.getTotalBidQty() == total);
+
+    total = 0;
+    level = 0;
+    for (const auto& [tick, qty] : asks) {
+        const auto [price, q, orders] = book.getAskLevel(level++);
+        assert(price == tick * TICK && q == qty);
+        total += qty;
+    }
+    assert(book.getTotalAskQty() == total);
+    assert(book.getBestBid() == (bids.empty() ? Common::Price_INVALID : bids.begin()->first * TICK));
+    assert(book.getBestAsk() == (asks.empty() ? Common::Price_INVALID : asks.begin()->first * TICK));
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing LadderBook..." << std::endl;
+
+    // Test 1: Updates by price, levels read from the touch outwards
+    {
+        auto book = std::make_unique<LadderBook<4096>>(TICK);
+        book->setBid(100 * TICK, 5);
+        book->setBid(98 * TICK, 7);
+        book->setBid(99 * TICK - 3, 2);  // Rounds to the nearest tick
+        book->setAsk(101 * TICK, 4);
+        book->setAsk(105 * TICK, 1);
+        assert(book->getBestBid() == 100 * TICK && book->getBestAsk() == 101 * TICK);
+        assert(book->getSpread() == TICK && book->getTotalBidQty() == 14);
+        assert(std::get<0>(book->getBidLevel(1)) == 99 * TICK);
+        assert(std::get<1>(book->getBidLevel(2)) == 7);
+
+        book->setBid(100 * TICK, 0);  // Touch removed: next level found by bit scan
+        assert(book->getBestBid() == 99 * TICK && book->getBidDepth() == 2);
+        book->setAsk(200 * TICK, 0);  // Removing an empty level is a no-op
+        assert(book->getAskDepth() == 2);
+
+        Common::Price prices[4];
+        Common::Qty qtys[4];
+        assert(book->getAskLevels(prices, qtys, 4) == 2);
+        assert(prices[0] == 101 * TICK && prices[1] == 105 * TICK && qtys[1] == 1);
+        std::cout << "✓ Price-keyed updates and level reads work" << std::endl;
+    }
+
+    // Test 2: A drifting market recentres the window without losing levels
+    {
+        auto book = std::make_unique<LadderBook<4096>>(TICK);
+        std::map<int64_t, Common::Qty, std::greater<>> bids;
+        std::map<int64_t, Common::Qty> asks;
+        std::mt19937 rng(7);
+        int64_t mid = 1000000;
+
+        for (int step = 0; step < 200000; ++step) {
+            mid += (rng() % 3 == 0) ? 1 : 0;  // Drifts ~16k ticks, several windows
+            // Keep the reference within +-200 ticks of mid and uncrossed
+            while (!bids.empty() && (bids.begin()->first >= mid || bids.rbegin()->first < mid - 200)) {
+                const auto it = bids.begin()->first >= mid ? bids.begin() : std::prev(bids.end());
+                book->setBid(it->first * TICK, 0);
+                bids.erase(it);
+            }
+            while (!asks.empty() && (asks.begin()->first <= mid || asks.rbegin()->first > mid + 200)) {
+                const auto it = asks.begin()->first <= mid ? asks.begin() : std::prev(asks.end());
+                book->setAsk(it->first * TICK, 0);
+                asks.erase(it);
+            }
+
+            const bool bid = rng() & 1;
+            const int64_t tick = bid ? mid - 1 - static_cast<int64_t>(rng() % 200)
+                                     : mid + 1 + static_cast<int64_t>(rng() % 200);
+            const Common::Qty qty = (rng() % 4 == 0) ? 0 : rng() % 1000 + 1;
+            if (bid) {
+                book->setBid(tick * TICK, qty);
+                if (qty) bids[tick] = qty; else bids.erase(tick);
+            } else {
+                book->setAsk(tick * TICK, qty);
+                if (qty) asks[tick] = qty; else asks.erase(tick);
+            }
+            if (step % 997 == 0) {
+                checkBook(*book, bids, asks);
+            }
+        }
+        checkBook(*book, bids, asks);
+        assert(book->getRecentreCount() >= 4 && book->getOutOfRangeCount() == 0);
+        std::cout << "✓ Recentring keeps every level near the touch ("
+                  << book->getRecentreCount() << " moves)" << std::endl;
+    }
+
+    // Test 3: A jump past the window moves it; far levels are dropped and counted
+    {
+        auto book = std::make_unique<LadderBook<4096>>(TICK);
+        book->setBid(1000 * TICK, 1);
+        book->setBid(990 * TICK, 2);
+        book->setAsk(1001 * TICK, 3);
+        book->setBid(100000 * TICK, 5);  // New touch far above
+        assert(book->getBestBid() == 100000 * TICK && book->getBidDepth() == 1);
+        assert(book->getTotalBidQty() == 5 && book->getAskDepth() == 0);
+        assert(book->getOutOfRangeCount() == 3);
+
+        book->setAsk(1 * TICK, 9);  // Ask side empty, so any ask is a new touch
+        assert(book->getBestAsk() == 1 * TICK && book->getBidDepth() == 0);
+        book->setBid(100000 * TICK, 0);
+        book->setBid(2 * 100000 * TICK, 1);  // Bid side empty: accepted
+        assert(book->getBestBid() == 200000 * TICK);
+        book->setBid(100 * TICK, 4);  // Worse bid far outside the window: dropped
+        assert(book->getBidDepth() == 1);
+        std::cout << "✓ Jumps recentre and out-of-window levels are counted" << std::endl;
+    }
+
+    std::cout << "\n✅ All LadderBook tests passed!" << std::endl;
+    return 0;
+}
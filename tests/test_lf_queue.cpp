@@ -1,12 +1,20 @@
 #include <iostream>
 #include <cassert>
+#include <thread>
+#include <chrono>
 #include "../common/lf_queue.h"
+#include "../common/wait_strategy.h"
 
 struct TestData {
     int value;
     char padding[60]; // Make it cache-line sized
 };
 
+struct StagedData {
+    uint64_t value;    // Written by the producer
+    uint64_t feature;  // Written in place by the feature stage
+};
+
 int main() {
     std::cout << "Testing SPSCLFQueue..." << std::endl;
     
@@ -70,6 +78,142 @@ int main() {
         std::cout << "✓ Queue wrap-around works" << std::endl;
     }
     
+    // Test 4: Batched claim/publish and peek/release across the wrap point
+    {
+        Common::SPSCLFQueue<TestData, 8> queue;
+        
+        auto slots = queue.claim(6);
+        assert(slots.size() == 6);
+        for (size_t i = 0; i < slots.size(); ++i) {
+            slots[i].value = static_cast<int>(i);
+        }
+        queue.publish(slots.size());
+        assert(queue.size() == 6);
+        
+        auto batch = queue.peek(4);
+        assert(batch.size() == 4);
+        assert(batch[0].value == 0 && batch[3].value == 3);
+        queue.release(batch.size());
+        
+        // Only 2 contiguous slots remain before the end of the ring
+        slots = queue.claim(5);
+        assert(slots.size() == 2);
+        queue.publish(slots.size());
+        slots = queue.claim(5);
+        assert(slots.size() == 4);  // 4 free after wrapping
+        queue.publish(slots.size());
+        assert(queue.size() == 8);
+        assert(queue.claim(1).empty());
+        
+        batch = queue.peek(100);
+        assert(batch.size() == 4);  // Stops at the end of the ring
+        assert(batch[0].value == 4);
+        queue.release(batch.size());
+        batch = queue.peek(100);
+        assert(batch.size() == 4);
+        queue.release(batch.size());
+        assert(queue.peek(1).empty());
+        assert(queue.size() == 0);
+        std::cout << "✓ Batched claim/publish and peek/release work" << std::endl;
+    }
+    
+    // Test 5: Broadcast ring - recorder, feature stage and a dependent strategy
+    {
+        constexpr uint64_t N = 200000;
+        Common::SPMCBroadcastRing<StagedData, 1024> ring;
+        const auto recorder = ring.addConsumer();
+        const auto features = ring.addConsumer();
+        const auto strategy = ring.addConsumer(1U << features);
+        assert(ring.consumerCount() == 3);
+        
+        uint64_t recorder_sum = 0;
+        bool strategy_ok = true;
+        
+        std::thread recorder_thread([&] {
+            for (uint64_t seen = 0; seen < N;) {
+                const auto batch = ring.peek(recorder, 64);
+                if (batch.empty()) std::this_thread::yield();
+                for (const auto& item : batch) recorder_sum += item.value;
+                ring.release(recorder, batch.size());
+                seen += batch.size();
+            }
+        });
+        std::thread feature_thread([&] {
+            for (uint64_t seen = 0; seen < N;) {
+                auto batch = ring.peekMutable(features, 64);
+                if (batch.empty()) std::this_thread::yield();
+                for (auto& item : batch) item.feature = item.value * 2;
+                ring.release(features, batch.size());
+                seen += batch.size();
+            }
+        });
+        std::thread strategy_thread([&] {
+            for (uint64_t seen = 0; seen < N;) {
+                const auto batch = ring.peek(strategy, 64);
+                if (batch.empty()) std::this_thread::yield();
+                for (const auto& item : batch) {
+                    strategy_ok &= (item.value == seen && item.feature == seen * 2);
+                    ++seen;
+                }
+                ring.release(strategy, batch.size());
+            }
+        });
+        
+        for (uint64_t next = 0; next < N;) {
+            auto slots = ring.claim(32);
+            if (slots.empty()) std::this_thread::yield();
+            for (auto& slot : slots) slot.value = next++;
+            ring.publish(slots.size());
+        }
+        
+        recorder_thread.join();
+        feature_thread.join();
+        strategy_thread.join();
+        assert(recorder_sum == N * (N - 1) / 2);
+        assert(strategy_ok);
+        assert(ring.lag(strategy) == 0);
+        std::cout << "✓ Broadcast ring delivers to all consumers in dependency order" << std::endl;
+    }
+    
+    // Test 6: Parked consumer is woken by the producer
+    {
+        Common::SPSCLFQueue<uint64_t, 64> queue;
+        Common::WaitEvent event;
+        Common::WaitStrategyConfig cfg;
+        cfg.kind = Common::WaitStrategyKind::Park;
+        cfg.spin_before_park = 4;
+        cfg.park_timeout_ns = 5000000000ULL;  // A lost wake-up would stall 5s per item
+        
+        constexpr uint64_t N = 200;
+        uint64_t sum = 0;
+        std::thread consumer([&] {
+            Common::WaitStrategy wait(cfg, &event, queue.producerCursorAddress());
+            for (uint64_t seen = 0; seen < N;) {
+                const auto batch = queue.peek(16);
+                if (batch.empty()) {
+                    wait.idle([&] { return queue.size() != 0; });
+                    continue;
+                }
+                for (auto v : batch) sum += v;
+                queue.release(batch.size());
+                seen += batch.size();
+                wait.reset();
+            }
+        });
+        
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < N; ++i) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));  // Let it park
+            *queue.getNextToWriteTo() = i;
+            queue.updateWriteIndex();
+            event.notify();
+        }
+        consumer.join();
+        assert(sum == N * (N - 1) / 2);
+        assert(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+        std::cout << "✓ Futex-parked consumer wakes on notify" << std::endl;
+    }
+    
     std::cout << "\n✅ All tests passed! The lf_queue memory bug is fixed." << std::endl;
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../common/log_format.h"
+
+namespace {
+
+// Hand-built binary log files, so the decoder sees exactly the bytes a
+// test wants, including ones the logger would never write
+struct LogFile {
+    explicit LogFile(const char* magic = Common::LOG_BINARY_MAGIC) { bytes.append(magic, 8); }
+
+    template<typename T>
+    LogFile& put(T value) {
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        return *this;
+    }
+
+    LogFile& putString(const std::string& s) {
+        put(static_cast<uint16_t>(s.size()));
+        bytes += s;
+        return *this;
+    }
+
+    LogFile& site(uint32_t id, const std::string& format) {
+        put(Common::LogBinaryRecord::Site).put(id).put(uint16_t{1}).put(uint32_t{7});
+        return putString(format).putString("test.cpp");
+    }
+
+    // A deferred record with one string argument, whose length field says len
+    LogFile& stringRecord(uint32_t id, uint64_t tsc, uint16_t len, const std::string& body) {
+        put(Common::LogBinaryRecord::Deferred).put(id).put(tsc).put(uint32_t{1});
+        put(static_cast<uint16_t>(body.size() + 3));
+        put(Common::LogArgType::Str).put(len);
+        bytes += body;
+        return *this;
+    }
+
+    std::string bytes;
+};
+
+struct Decoded {
+    int status;
+    std::string out;
+};
+
+// Run log_decoder over the file, capturing stdout
+Decoded decode(const LogFile& file) {
+    char path[64];
+    std::snprintf(path, sizeof(path), "/tmp/test_log_decoder_%d.bin", static_cast<int>(getpid()));
+    FILE* f = std::fopen(path, "wb");
+    assert(f);
+    std::fwrite(file.bytes.data(), 1, file.bytes.size(), f);
+    std::fclose(f);
+
+    const std::string cmd = std::string(LOG_DECODER_PATH) + " " + path + " 2>/dev/null";
+    FILE* pipe = popen(cmd.c_str(), "r");
+    assert(pipe);
+    Decoded result{0, {}};
+    char buf[4096];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), pipe)) > 0) {
+        result.out.append(buf, n);
+    }
+    const int status = pclose(pipe);
+    result.status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    std::remove(path);
+    return result;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing log_decoder..." << std::endl;
+
+    // Test 1: Records decode at the calibration's rate from the first one
+    {
+        LogFile file;
+        file.put(Common::LogBinaryRecord::Calibration)
+            .put(uint64_t{1000000}).put(uint64_t{5000000000}).put(2.0);
+        file.site(1, "msg %s");
+        file.stringRecord(1, 1000000 + 2000, 1, "a");
+        file.stringRecord(1, 1000000 + 4000, 1, "b");
+        const auto result = decode(file);
+        assert(result.status == 0);
+        assert(result.out == "[5.000001000][INFO ][T1] msg a\n"
+                             "[5.000002000][INFO ][T1] msg b\n");
+        std::cout << "✓ First batch of a file gets distinct timestamps" << std::endl;
+    }
+
+    // Test 2: Version 01 files still take the rate from consecutive points
+    {
+        LogFile file("SZBLOG01");
+        file.put(Common::LogBinaryRecord::Calibration).put(uint64_t{1000000}).put(uint64_t{5000000000});
+        file.put(Common::LogBinaryRecord::Calibration).put(uint64_t{3000000}).put(uint64_t{5001000000});
+        file.site(1, "msg %s");
+        file.stringRecord(1, 3000000 + 2000, 1, "a");
+        const auto result = decode(file);
+        assert(result.status == 0 && result.out == "[5.001001000][INFO ][T1] msg a\n");
+        std::cout << "✓ Version 01 files still decode" << std::endl;
+    }
+
+    // Test 3: Oversized string lengths never reach the formatter's buffers
+    {
+        const std::string big(5000, 'x');
+        LogFile inner;  // Payload within a plausible record, string length lying
+        inner.put(Common::LogBinaryRecord::Calibration).put(uint64_t{0}).put(uint64_t{0}).put(1.0);
+        inner.site(1, "%s");
+        inner.stringRecord(1, 0, 60000, std::string(100, 'x'));
+        auto result = decode(inner);
+        assert(result.status == 0 && result.out == "[0.000000000][INFO ][T1] <?>\n");
+
+        LogFile outer;  // Record payload itself past anything the logger writes
+        outer.put(Common::LogBinaryRecord::Calibration).put(uint64_t{0}).put(uint64_t{0}).put(1.0);
+        outer.site(1, "%s");
+        outer.stringRecord(1, 0, static_cast<uint16_t>(big.size()), big);
+        result = decode(outer);
+        assert(result.status == 1 && result.out.empty());
+        std::cout << "✓ Oversized string lengths are rejected" << std::endl;
+    }
+
+    std::cout << "\n✅ All log_decoder tests passed!" << std::endl;
+    return 0;
+}
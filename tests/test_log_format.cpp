@@ -0,0 +1,88 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../common/log_format.h"
+
+namespace {
+
+// Encode args, then render them the way the writer thread would
+template<typename... Args>
+std::string render(const char* format, const Args&... args) {
+    Common::LogArgBuffer buf;
+    Common::encodeLogArgs(buf, args...);
+    char out[512];
+    const auto len = Common::formatLogArgs(format, buf.data, buf.len, out, sizeof(out));
+    assert(len == std::strlen(out));
+    return std::string(out, len);
+}
+
+enum class Side : uint8_t { Buy = 1, Sell = 2 };
+
+} // namespace
+
+int main() {
+    std::cout << "Testing deferred log formatting..." << std::endl;
+
+    // Test 1: Common conversions match printf
+    {
+        assert(render("plain text") == "plain text");
+        assert(render("%d %u %s", -42, 7u, "BTCUSDT") == "-42 7 BTCUSDT");
+        assert(render("%lu orders, %ld pnl", uint64_t{1} << 40, int64_t{-5}) == "1099511627776 orders, -5 pnl");
+        assert(render("px=%.8f qty=%5.2f", 43210.12345678, 1.5) == "px=43210.12345678 qty= 1.50");
+        assert(render("%x|%08X|%-4d|", 255u, 0xBEEFu, 3) == "ff|0000BEEF|3   |");
+        assert(render("%*d|%.*s", 6, 12, 3, "abcdef") == "    12|abc");
+        assert(render("100%% %c", 'A') == "100% A");
+        std::cout << "✓ Conversions, flags, width and precision" << std::endl;
+    }
+
+    // Test 2: Stored types win over the format's length modifiers
+    {
+        assert(render("%d", int64_t{1} << 33) == "8589934592");
+        assert(render("%ld", 5) == "5");
+        assert(render("%s", 12) == "12");
+        assert(render("%d", 2.5) == "2.5");
+        assert(render("%d %d", Side::Sell, true) == "2 1");
+        assert(render("%s", static_cast<const char*>(nullptr)) == "(null)");
+        std::cout << "✓ Mismatched specifiers can't misread arguments" << std::endl;
+    }
+
+    // Test 3: Missing, extra and truncated arguments
+    {
+        assert(render("%d and %d", 1) == "1 and <?>");
+        assert(render("%d", 1, 2) == "1");
+        assert(render("%n%d", 9) == "9");
+
+        const std::string big(300, 'x');
+        Common::LogArgBuffer buf;
+        Common::encodeLogArgs(buf, 1, big.c_str(), 2);
+        assert(buf.truncated && buf.len <= Common::LogArgBuffer::CAPACITY);
+        char out[512];
+        Common::formatLogArgs("%d %s %d", buf.data, buf.len, out, sizeof(out));
+        const std::string s(out);
+        assert(s.rfind("1 xxx", 0) == 0 && s.ends_with(" <?>"));
+
+        char small[8];
+        assert(Common::formatLogArgs("%s", nullptr, 0, small, sizeof(small)) == 3);
+        assert(Common::formatLogArgs("0123456789", nullptr, 0, small, sizeof(small)) == 7);
+        assert(std::strcmp(small, "0123456") == 0);
+        std::cout << "✓ Missing args, truncated records and small outputs" << std::endl;
+    }
+
+    // Test 4: A record whose string length exceeds any buffer we produce
+    {
+        std::vector<uint8_t> args(2048, 'x');
+        args[0] = static_cast<uint8_t>(Common::LogArgType::Str);
+        const uint16_t huge = 1000;
+        std::memcpy(&args[1], &huge, sizeof(huge));
+        char out[512];
+        Common::formatLogArgs("[%s]", args.data(), args.size(), out, sizeof(out));
+        assert(std::string(out) == "[<?>]");
+        std::cout << "✓ Oversized string lengths are rejected" << std::endl;
+    }
+
+    std::cout << "\n✅ All deferred log formatting tests passed!" << std::endl;
+    return 0;
+}
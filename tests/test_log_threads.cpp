@@ -0,0 +1,185 @@
+#include <iostream>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "../common/logging.h"
+
+namespace {
+
+// The [T...] id the logger gives the calling thread
+uint32_t selfId() {
+    return static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+}
+
+struct Line {
+    uint64_t wall_ns;
+    uint32_t thread_id;
+    uint64_t seq;
+};
+
+// The "seq=" lines of a log file, in file order
+std::vector<Line> readLines(const std::string& path) {
+    std::vector<Line> lines;
+    std::ifstream in(path);
+    std::string text;
+    while (std::getline(in, text)) {
+        unsigned long long sec = 0, nsec = 0, seq = 0;
+        unsigned tid = 0;
+        const char* body = std::strstr(text.c_str(), "seq=");
+        if (body && std::sscanf(text.c_str(), "[%llu.%llu][%*[^]]][T%u]", &sec, &nsec, &tid) == 3 &&
+            std::sscanf(body, "seq=%llu", &seq) == 1) {
+            lines.push_back({sec * 1000000000ULL + nsec, tid, seq});
+        }
+    }
+    return lines;
+}
+
+const Common::Logger::ThreadStats* findThread(const Common::Logger::ThreadStats* stats, size_t n, uint32_t tid) {
+    for (size_t i = 0; i < n; ++i) {
+        if (stats[i].thread_id == tid) return &stats[i];
+    }
+    return nullptr;
+}
+
+void waitWritten(uint64_t n) {
+    while (Common::g_logger->getStats().messages_written < n) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing per-thread log rings..." << std::endl;
+    const std::string path = "/tmp/test_log_threads_" + std::to_string(getpid()) + ".log";
+
+    // Test 1: Threads taking turns come out merged in timestamp order
+    {
+        constexpr uint64_t THREADS = 4;
+        constexpr uint64_t PER_THREAD = 500;
+        std::remove(path.c_str());
+        Common::initLogging(path.c_str(), Common::LogMode::Immediate);
+
+        // Each record is published before the next is stamped, so the
+        // writer's batches can never legitimately reorder them
+        std::atomic<uint64_t> turn{0};
+        std::vector<std::thread> threads;
+        for (uint64_t t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&turn, t] {
+                for (uint64_t i = 0; i < PER_THREAD; ++i) {
+                    uint64_t seq;
+                    while ((seq = turn.load(std::memory_order_acquire)) % THREADS != t) std::this_thread::yield();
+                    LOG_INFO("seq=%lu", seq);
+                    turn.store(seq + 1, std::memory_order_release);
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        Common::shutdownLogging();
+
+        const auto lines = readLines(path);
+        assert(lines.size() == THREADS * PER_THREAD);
+        for (size_t i = 0; i < lines.size(); ++i) {
+            assert(lines[i].seq == i);
+            assert(i == 0 || lines[i].wall_ns >= lines[i - 1].wall_ns);
+            assert(i == 0 || lines[i].thread_id != lines[i - 1].thread_id);
+        }
+        std::cout << "✓ Records from several threads merge in timestamp order" << std::endl;
+    }
+
+    // Test 2: A thread overflowing its ring loses only its own records
+    {
+        constexpr uint64_t QUIET = 50;
+        std::remove(path.c_str());
+        setenv("LOGGER_QUEUE_CAPACITY", "64", 1);
+        Common::initLogging(path.c_str(), Common::LogMode::Immediate);
+
+        uint32_t noisy_id = 0;
+        uint32_t quiet_id = 0;
+        std::atomic<bool> quiet_done{false};
+        std::thread noisy([&] {
+            noisy_id = selfId();
+            for (uint64_t i = 0; !quiet_done.load(std::memory_order_acquire) || i < 100000; ++i) {
+                LOG_INFO("noisy %lu", i);
+            }
+        });
+        std::thread quiet([&] {
+            quiet_id = selfId();
+            for (uint64_t i = 0; i < QUIET; ++i) {
+                LOG_INFO("seq=%lu", i);
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+            quiet_done.store(true, std::memory_order_release);
+        });
+        quiet.join();
+        noisy.join();
+
+        Common::Logger::ThreadStats stats[8];
+        const Common::Logger::ThreadStats* quiet_stats = nullptr;
+        while (!quiet_stats || quiet_stats->messages_logged < QUIET) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            const auto n = Common::g_logger->getThreadStats(stats, 8);
+            quiet_stats = findThread(stats, n, quiet_id);
+        }
+        const auto n = Common::g_logger->getThreadStats(stats, 8);
+        const auto* noisy_stats = findThread(stats, n, noisy_id);
+        quiet_stats = findThread(stats, n, quiet_id);
+        assert(noisy_stats && noisy_stats->messages_dropped > 0);
+        assert(quiet_stats && quiet_stats->messages_dropped == 0 && quiet_stats->messages_logged == QUIET);
+        assert(Common::g_logger->getStats().messages_dropped >= noisy_stats->messages_dropped);
+        Common::shutdownLogging();
+        unsetenv("LOGGER_QUEUE_CAPACITY");
+
+        const auto lines = readLines(path);
+        assert(lines.size() == QUIET);
+        for (size_t i = 0; i < lines.size(); ++i) {
+            assert(lines[i].seq == i && lines[i].thread_id == quiet_id);
+        }
+        std::cout << "✓ Drops stay on the flooding thread and are reported per thread" << std::endl;
+    }
+
+    // Test 3: Exited threads give their rings back
+    {
+        constexpr uint64_t THREADS = 200;  // Well past the ring table
+        std::remove(path.c_str());
+        Common::initLogging(path.c_str(), Common::LogMode::Immediate);
+        const uint64_t base = Common::g_logger->getStats().messages_written;
+
+        Common::Logger::ThreadStats stats[256];
+        const auto rings_before = Common::g_logger->getThreadStats(stats, 256);
+        uint32_t last_id = 0;
+        for (uint64_t i = 0; i < THREADS; ++i) {
+            std::thread([&last_id, i] {
+                last_id = selfId();
+                LOG_INFO("seq=%lu", i);
+            }).join();
+            waitWritten(base + i + 1);  // Drained, so the next thread can take it over
+        }
+        const auto rings_after = Common::g_logger->getThreadStats(stats, 256);
+        assert(rings_after <= rings_before + 1);
+        const auto* last = findThread(stats, rings_after, last_id);
+        assert(last && last->messages_logged == 1 && last->messages_dropped == 0);
+        Common::shutdownLogging();
+
+        const auto lines = readLines(path);
+        assert(lines.size() == THREADS);
+        for (size_t i = 0; i < lines.size(); ++i) {
+            assert(lines[i].seq == i);
+        }
+        std::cout << "✓ Rings of exited threads are reused" << std::endl;
+    }
+
+    std::remove(path.c_str());
+    std::cout << "\n✅ All per-thread log ring tests passed!" << std::endl;
+    return 0;
+}
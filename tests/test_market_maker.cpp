@@ -0,0 +1,96 @@
+// ============================================================================
+// test_market_maker.cpp - Inventory-skewed quote sizes reach the order manager
+// ============================================================================
+//
+// Checks are explicit rather than assert(): this links CommonImpl, whose
+// Release flags define NDEBUG.
+
+#include "trading/strategy/market_maker.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+using namespace Trading;
+
+namespace {
+
+constexpr TickerId TICKER = 7;
+
+void check(bool ok, const char* what) {
+    if (!ok) {
+        std::printf("❌ %s\n", what);
+        std::exit(1);
+    }
+}
+
+// 20 levels a side, one tick apart, deep enough that depth never caps a quote
+auto makeBook() -> std::unique_ptr<MarketData::OrderBook<20>> {
+    auto book = std::make_unique<MarketData::OrderBook<20>>();
+    for (uint8_t i = 0; i < 20; ++i) {
+        book->updateBid(100000 - i, 5000, 1, i);
+        book->updateAsk(100020 + i, 5000, 1, i);
+    }
+    return book;
+}
+
+// A live order priced so the next quote has to move it
+auto liveOrder(OrderManager& om, Side side, Price price) -> Trading::Order* {
+    Trading::Order* order = om.createOrder(TICKER, side, price, 500);
+    check(order != nullptr, "order created");
+    om.onOrderUpdate(order->order_id, OrderState::LIVE, 0, 500);
+    check(om.getOrder(order->order_id) == order && order->state == OrderState::LIVE, "order live by id");
+    return order;
+}
+
+} // namespace
+
+int main() {
+    std::printf("Testing MarketMaker...\n");
+
+    auto order_manager = std::make_unique<OrderManager>(nullptr, nullptr);
+    auto feature_engine = std::make_unique<FeatureEngine>();
+    auto position_keeper = std::make_unique<PositionKeeper>();
+    auto market_maker = std::make_unique<MarketMaker>(order_manager.get(), feature_engine.get(),
+                                                      nullptr, position_keeper.get());
+
+    MarketMakerConfig config;
+    config.clip = 100;
+    config.min_size = 10;
+    config.max_position = 1000;
+    config.tick_size = 1;
+    market_maker->configureSymbol(TICKER, config);
+
+    const auto book = makeBook();
+    feature_engine->onOrderBookUpdate(TICKER, book.get());
+
+    // Test 1: Long past half the limit - the bid halves, the ask that
+    // unwinds keeps the full clip
+    {
+        position_keeper->onFill(TICKER, 1, 600, 100000);
+        Trading::Order* bid = liveOrder(*order_manager, 1, 100005);
+        Trading::Order* ask = liveOrder(*order_manager, 2, 100000);
+        market_maker->onOrderBookUpdate(TICKER, book.get());
+        check(bid->state == OrderState::PENDING_MODIFY && bid->price == 100000 && bid->original_qty == 50,
+              "long: bid moved with half the clip");
+        check(ask->state == OrderState::PENDING_MODIFY && ask->price == 100019 && ask->original_qty == 100,
+              "long: ask moved with the full clip");
+        std::printf("✓ Long inventory shrinks only the bid\n");
+        order_manager->onOrderUpdate(bid->order_id, OrderState::CANCELED, 0, 0);
+        order_manager->onOrderUpdate(ask->order_id, OrderState::CANCELED, 0, 0);
+    }
+
+    // Test 2: Short past half the limit - the mirror image
+    {
+        position_keeper->onFill(TICKER, 2, 1200, 100000);
+        Trading::Order* bid = liveOrder(*order_manager, 1, 100005);
+        Trading::Order* ask = liveOrder(*order_manager, 2, 100000);
+        market_maker->onOrderBookUpdate(TICKER, book.get());
+        check(bid->price == 100001 && bid->original_qty == 100, "short: bid moved with the full clip");
+        check(ask->price == 100020 && ask->original_qty == 50, "short: ask moved with half the clip");
+        std::printf("✓ Short inventory shrinks only the ask\n");
+    }
+
+    std::printf("\n✅ All MarketMaker tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,201 @@
+#include <iostream>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../common/mem_pool.h"
+#include "../common/lf_queue.h"
+
+int main() {
+    std::cout << "Testing MemoryPool..." << std::endl;
+    
+    // Test 1: Exhaust and refill a single-thread pool
+    {
+        Common::MemoryPool<64, 100> pool;
+        std::vector<void*> blocks;
+        for (size_t i = 0; i < 100; ++i) {
+            void* p = pool.allocate();
+            assert(p != nullptr);
+            blocks.push_back(p);
+        }
+        assert(pool.allocate() == nullptr);
+        assert(pool.full());
+        
+        pool.deallocate(blocks[0]);
+        pool.deallocate(blocks[0]);  // Double free is ignored
+        assert(pool.allocatedBlocks() == 99);
+        
+        for (size_t i = 1; i < blocks.size(); ++i) {
+            pool.deallocate(blocks[i]);
+        }
+        assert(pool.empty());
+        assert(pool.freeBlocks() == 100);
+        std::cout << "✓ Exhaust/refill and double-free handling work" << std::endl;
+    }
+    
+    // Test 2: Bulk allocate/deallocate
+    {
+        Common::MemoryPool<64, 256> pool;
+        void* ptrs[200];
+        assert(pool.allocateBulk(ptrs, 200) == 200);
+        assert(pool.allocatedBlocks() == 200);
+        pool.deallocateBulk(ptrs, 200);
+        assert(pool.empty());
+        std::cout << "✓ Bulk allocate/deallocate works" << std::endl;
+    }
+    
+    // Test 3: Producer allocates, consumer frees (WS thread -> processor thread)
+    {
+        constexpr size_t N = 1000000;
+        Common::MemoryPool<64, 4096> pool;
+        Common::SPSCLFQueue<uint64_t*, 1024> queue;
+        
+        std::thread consumer([&] {
+            for (size_t seen = 0; seen < N;) {
+                const auto batch = queue.peek(64);
+                if (batch.empty()) std::this_thread::yield();
+                for (auto* p : batch) {
+                    assert(*p == seen);
+                    pool.deallocate(p);
+                    ++seen;
+                }
+                queue.release(batch.size());
+            }
+            pool.releaseThreadCache();
+        });
+        
+        for (uint64_t i = 0; i < N;) {
+            auto* p = static_cast<uint64_t*>(pool.allocate());
+            if (!p) {  // Blocks are parked in the consumer's magazine
+                std::this_thread::yield();
+                continue;
+            }
+            *p = i;
+            while (queue.getNextToWriteTo() == nullptr) std::this_thread::yield();
+            *queue.getNextToWriteTo() = p;
+            queue.updateWriteIndex();
+            ++i;
+        }
+        consumer.join();
+        assert(pool.empty());
+        std::cout << "✓ Cross-thread free through magazines works" << std::endl;
+    }
+    
+    // Test 4: More threads than magazines fall back to the shared lists
+    {
+        Common::MemoryPool<64, 8192> pool;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 80; ++t) {
+            threads.emplace_back([&pool] {
+                void* ptrs[16];
+                for (int round = 0; round < 100; ++round) {
+                    const auto got = pool.allocateBulk(ptrs, 16);
+                    pool.deallocateBulk(ptrs, got);
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        assert(pool.empty());
+        std::cout << "✓ Magazine overflow falls back safely" << std::endl;
+    }
+    
+    // Test 5: Exited threads hand back their magazines and cached blocks
+    {
+        constexpr size_t BLOCKS = 4096;
+        Common::MemoryPool<64, BLOCKS> pool;
+        for (int t = 0; t < 100; ++t) {  // More threads than magazines, one at a time
+            std::thread([&pool] {
+                pool.deallocate(pool.allocate());  // Leaves a batch cached
+            }).join();
+        }
+        std::vector<void*> blocks;
+        while (void* p = pool.allocate()) {
+            blocks.push_back(p);
+        }
+        assert(blocks.size() == BLOCKS && pool.full());
+        for (void* p : blocks) {
+            pool.deallocate(p);
+        }
+        assert(pool.empty());
+
+        // A thread outliving a pool it used leaves it alone on exit
+        std::atomic<bool> used{false};
+        std::atomic<bool> pool_gone{false};
+        auto doomed = std::make_unique<Common::MemoryPool<64, 256>>();
+        std::thread survivor([&] {
+            doomed->deallocate(doomed->allocate());
+            used.store(true);
+            while (!pool_gone.load()) std::this_thread::yield();
+        });
+        while (!used.load()) std::this_thread::yield();
+        doomed.reset();
+        pool_gone.store(true);
+        survivor.join();
+        std::cout << "✓ Thread exit returns magazines, skips destroyed pools" << std::endl;
+    }
+
+    // Test 6: Live threads' magazines don't hoard most of a small pool
+    {
+        constexpr size_t BLOCKS = 256;
+        Common::MemoryPool<64, BLOCKS> pool;
+        std::atomic<int> cached{0};
+        std::atomic<bool> done{false};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 3; ++t) {
+            threads.emplace_back([&] {
+                pool.deallocate(pool.allocate());  // Leaves a batch cached
+                cached.fetch_add(1);
+                while (!done.load()) std::this_thread::yield();
+            });
+        }
+        while (cached.load() < 3) std::this_thread::yield();
+        std::vector<void*> blocks;
+        while (void* p = pool.allocate()) {
+            blocks.push_back(p);
+        }
+        assert(blocks.size() >= BLOCKS * 3 / 4);
+        for (void* p : blocks) {
+            pool.deallocate(p);
+        }
+        done.store(true);
+        for (auto& t : threads) t.join();
+        assert(pool.empty());
+        std::cout << "✓ Small pools keep most blocks reachable from any thread" << std::endl;
+    }
+
+    // Test 7: ObjectPool handles detect use-after-release
+    {
+        struct Order {
+            uint64_t id;
+            int* live;
+            Order(uint64_t i, int* l) : id(i), live(l) { ++*live; }
+            ~Order() { --*live; }
+        };
+        int live = 0;
+        Common::ObjectPool<Order, 1000> pool;
+        
+        auto h1 = pool.acquire(7u, &live);
+        assert(h1.valid() && live == 1);
+        assert(pool.get(h1)->id == 7);
+        assert(pool.handleOf(pool.get(h1)) == h1);
+        
+        assert(pool.release(h1));
+        assert(live == 0);
+        assert(pool.get(h1) == nullptr);   // Stale
+        assert(!pool.release(h1));          // Double release rejected
+        
+        auto h2 = pool.acquire(8u, &live);  // Likely reuses h1's block
+        assert(h2.valid() && !(h2 == h1));
+        assert(pool.get(h1) == nullptr);
+        assert(pool.get(h2)->id == 8);
+        assert(pool.release(h2));
+        
+        assert(pool.get(decltype(h1){}) == nullptr);
+        assert(pool.size() == 0);
+        std::cout << "✓ ObjectPool generation handles catch stale use" << std::endl;
+    }
+    
+    std::cout << "\n✅ All MemoryPool tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../trading/market_data/order_book.h"
+
+using Trading::MarketData::OrderBook;
+using Trading::MarketData::TopLevels;
+
+namespace {
+
+struct Level {
+    Common::Price price;
+    Common::Qty qty;
+    uint16_t orders;
+};
+
+// Reference side: a plain vector, totals recomputed from scratch
+template<size_t MAX_LEVELS>
+void checkSide(const OrderBook<MAX_LEVELS>& book, bool bid, const std::vector<Level>& ref) {
+    assert((bid ? book.getBidDepth() : book.getAskDepth()) == ref.size());
+    Common::Qty total = 0;
+    for (size_t i = 0; i < ref.size(); ++i) {
+        const auto [price, qty, orders] = bid ? book.getBidLevel(static_cast<uint8_t>(i))
+                                              : book.getAskLevel(static_cast<uint8_t>(i));
+        assert(price == ref[i].price && qty == ref[i].qty && orders == ref[i].orders);
+        total += ref[i].qty;
+    }
+    assert((bid ? book.getTotalBidQty() : book.getTotalAskQty()) == total);
+}
+
+// Random set/insert/delete/replace against the reference, every depth
+template<size_t MAX_LEVELS>
+void fuzz(uint32_t seed) {
+    OrderBook<MAX_LEVELS> book;
+    std::vector<Level> bids;
+    std::vector<Level> asks;
+    std::mt19937 rng(seed);
+
+    for (int step = 0; step < 20000; ++step) {
+        const bool bid = rng() & 1;
+        auto& ref = bid ? bids : asks;
+        const Level lvl{static_cast<Common::Price>(rng() % 100000),
+                        static_cast<Common::Qty>(rng() % 1000 + 1),
+                        static_cast<uint16_t>(rng() % 50)};
+        const auto level = static_cast<uint8_t>(rng() % (ref.size() + 2));
+
+        switch (rng() % 8) {
+            case 0: case 1: case 2:  // Set an existing level or append
+                if (level <= ref.size() && level < MAX_LEVELS) {
+                    bid ? book.updateBid(lvl.price, lvl.qty, lvl.orders, level)
+                        : book.updateAsk(lvl.price, lvl.qty, lvl.orders, level);
+                    if (level == ref.size()) ref.push_back(lvl); else ref[level] = lvl;
+                }
+                break;
+            case 3: case 4: case 5:  // Insert, dropping the last level of a full side
+                if (level <= ref.size() && level < MAX_LEVELS) {
+                    bid ? book.insertBid(lvl.price, lvl.qty, lvl.orders, level)
+                        : book.insertAsk(lvl.price, lvl.qty, lvl.orders, level);
+                    ref.insert(ref.begin() + level, lvl);
+                    if (ref.size() > MAX_LEVELS) ref.pop_back();
+                }
+                break;
+            case 6:  // Delete, including past the end (no-op)
+                bid ? book.deleteBid(level) : book.deleteAsk(level);
+                if (level < ref.size()) ref.erase(ref.begin() + level);
+                break;
+            default: {  // Replace the whole side, sometimes deeper than the book holds
+                const size_t count = rng() % (MAX_LEVELS + 5);
+                std::vector<Common::Price> prices(count);
+                std::vector<Common::Qty> qtys(count);
+                std::vector<uint16_t> orders(count);
+                const bool with_orders = rng() & 1;
+                ref.clear();
+                for (size_t i = 0; i < count; ++i) {
+                    prices[i] = static_cast<Common::Price>(rng() % 100000);
+                    qtys[i] = rng() % 1000;
+                    orders[i] = static_cast<uint16_t>(rng() % 50);
+                    if (i < MAX_LEVELS) ref.push_back({prices[i], qtys[i], with_orders ? orders[i] : uint16_t{1}});
+                }
+                book.applyLevels(bid ? Common::OrderSide::BUY : Common::OrderSide::SELL,
+                                 prices.data(), qtys.data(), with_orders ? orders.data() : nullptr, count);
+                break;
+            }
+        }
+        checkSide(book, bid, ref);
+    }
+    checkSide(book, true, bids);
+    checkSide(book, false, asks);
+}
+
+// One writer rewrites whole batches where every level carries the batch
+// number; a reader on another thread must never see two batches mixed
+template<size_t PUBLISH_LEVELS>
+void concurrentReads() {
+    auto book = std::make_unique<OrderBook<20, PUBLISH_LEVELS>>();
+    std::atomic<bool> done{false};
+    uint64_t reads = 0;
+
+    std::thread reader([&]() {
+        TopLevels<5> top;
+        uint64_t last_seq = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            const uint64_t seq = book->readTop(top);
+            assert(seq % 2 == 0 && seq >= last_seq);
+            last_seq = seq;
+            const auto stamp = static_cast<Common::Qty>(top.timestamp_ns);
+            assert(top.bid_depth == (stamp % 2 ? 5 : 3) && top.ask_depth == top.bid_depth);
+            assert(top.total_bid_qty == stamp * (stamp % 2 ? 20 : 3));
+            for (size_t i = 0; i < 5; ++i) {
+                const bool live = i < top.bid_depth;
+                assert(top.bid_qtys[i] == (live ? stamp : 0) && top.ask_qtys[i] == (live ? stamp : 0));
+                assert(top.bid_prices[i] == (live ? static_cast<Common::Price>(stamp - i) : 0));
+            }
+            ++reads;
+        }
+    });
+
+    std::vector<Common::Price> prices(20);
+    std::vector<Common::Qty> qtys(20);
+    for (uint64_t batch = 1; batch <= 200000; ++batch) {
+        const size_t depth = batch % 2 ? 20 : 3;
+        for (size_t i = 0; i < depth; ++i) {
+            prices[i] = static_cast<Common::Price>(batch - i);
+            qtys[i] = batch;
+        }
+        book->beginUpdate();
+        book->applyLevels(Common::OrderSide::BUY, prices.data(), qtys.data(), nullptr, depth);
+        book->applyLevels(Common::OrderSide::SELL, prices.data(), qtys.data(), nullptr, depth);
+        book->updateTimestamp(batch);
+        book->endUpdate();
+    }
+    while (reads == 0) {
+        std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    const auto snap = book->getSnapshot();
+    assert(snap.bid_depth == 3 && snap.timestamp_ns == 200000 && book->getSequence() == 400000);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing OrderBook..." << std::endl;
+
+    // Test 1: Single-level updates keep totals without rescanning
+    {
+        OrderBook<100> book;
+        book.updateBid(1000, 5, 1, 0);
+        book.updateBid(990, 7, 2, 1);
+        book.updateBid(1001, 3, 1, 0);  // Replaces level 0
+        assert(book.getTotalBidQty() == 10 && book.getBidDepth() == 2);
+        book.updateAsk(1010, 4, 1, 2);  // Gap levels count as empty
+        assert(book.getTotalAskQty() == 4 && book.getAskDepth() == 3);
+        book.clearBids();
+        assert(book.getTotalBidQty() == 0 && book.getBestBid() == Common::Price_INVALID);
+        std::cout << "✓ Incremental totals track level updates" << std::endl;
+    }
+
+    // Test 2: Insert and delete shift the level arrays
+    {
+        OrderBook<20> book;
+        for (uint8_t i = 0; i < 20; ++i) {
+            book.insertAsk(1000 + 10 * i, 1, 1, i);
+        }
+        book.insertAsk(995, 2, 3, 0);  // Full: the deepest level falls off
+        assert(book.getAskDepth() == 20 && book.getTotalAskQty() == 21);
+        assert(book.getBestAsk() == 995);
+        assert(std::get<0>(book.getAskLevel(19)) == 1180);
+        book.deleteAsk(0);
+        assert(book.getAskDepth() == 19 && book.getBestAsk() == 1000 && book.getTotalAskQty() == 19);
+        assert(std::get<0>(book.getAskLevel(19)) == Common::Price_INVALID);
+        std::cout << "✓ Insert/delete shift levels and drop overflow" << std::endl;
+    }
+
+    // Test 3: Randomized against a reference model, across vector widths
+    fuzz<20>(1);
+    fuzz<100>(2);
+    fuzz<7>(3);
+    std::cout << "✓ Random updates match the reference book" << std::endl;
+
+    // Test 4: Readers on another thread see whole batches only
+    concurrentReads<0>();
+    concurrentReads<5>();
+    std::cout << "✓ Seqlock reads never see a torn book, direct or published" << std::endl;
+
+    // Test 5: A depth snapshot replaces both sides in one batch
+    {
+        OrderBook<20, 5> book;
+        for (uint8_t i = 0; i < 8; ++i) {
+            book.updateBid(2000 - i, 10, 1, i);
+        }
+        Common::DepthSnapshot snap;
+        snap.timestamp = 123456;
+        snap.bid_count = 2;
+        snap.ask_count = 3;
+        for (size_t i = 0; i < Common::DepthSnapshot::MAX_LEVELS; ++i) {
+            snap.bid_prices[i] = 24495 - static_cast<Common::Price>(i) * 5;
+            snap.bid_qtys[i] = 100 + i;
+            snap.bid_orders[i] = static_cast<uint16_t>(3 + i);
+            snap.ask_prices[i] = 24505 + static_cast<Common::Price>(i) * 5;
+            snap.ask_qtys[i] = 200 + i;
+            snap.ask_orders[i] = static_cast<uint16_t>(7 + i);
+        }
+        const auto seq = book.getSequence();
+        book.applySnapshot(snap);
+        assert(book.getSequence() == seq + 2);
+        assert(book.getBidDepth() == 2 && book.getTotalBidQty() == 201);
+        assert(book.getAskDepth() == 3 && book.getTotalAskQty() == 603);
+        assert(book.getBestBid() == 24495 && book.getBestAsk() == 24505);
+        assert(book.getBidLevel(1) == std::make_tuple(Common::Price{24490}, Common::Qty{101}, uint16_t{4}));
+        assert(std::get<0>(book.getBidLevel(2)) == Common::Price_INVALID);  // Old deeper bids are gone
+
+        TopLevels<5> top{};
+        book.readTop(top);
+        assert(top.timestamp_ns == 123456 && top.ask_depth == 3 && top.ask_orders[2] == 9);
+        std::cout << "✓ Depth snapshots replace both sides at once" << std::endl;
+    }
+
+    std::cout << "\n✅ All OrderBook tests passed!" << std::endl;
+    return 0;
+}
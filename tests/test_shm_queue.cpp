@@ -0,0 +1,236 @@
+#include <iostream>
+#include <cassert>
+#include <csignal>
+#include <cstdio>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../common/shm_queue.h"
+
+namespace {
+
+// Run fn in a forked child; true if it exited with status 0
+template<typename Fn>
+bool runChild(Fn&& fn) {
+    const pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        _exit(fn() ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+struct Tick {
+    uint64_t seq;
+    int64_t price;
+};
+
+} // namespace
+
+int main() {
+    std::cout << "Testing shared-memory queues..." << std::endl;
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "/test_shmq_%d", static_cast<int>(getpid()));
+
+    // Test 1: Producer and consumer in different processes
+    {
+        constexpr uint64_t N = 100000;
+        Common::ShmSegment::remove(name);
+        auto producer = Common::ShmSPSCQueue<Tick, 1024>::open(name, Common::ShmRole::Producer,
+                                                               Common::ShmOpenMode::Create);
+        assert(producer && producer->createdSegment());
+
+        const pid_t consumer_pid = fork();
+        assert(consumer_pid >= 0);
+        if (consumer_pid == 0) {
+            auto consumer = Common::ShmSPSCQueue<Tick, 1024>::open(name, Common::ShmRole::Consumer,
+                                                                   Common::ShmOpenMode::Attach);
+            if (!consumer || consumer->createdSegment()) _exit(2);
+            for (uint64_t seen = 0; seen < N;) {
+                const auto batch = consumer->peek(64);
+                if (batch.empty()) std::this_thread::yield();
+                for (const auto& tick : batch) {
+                    if (tick.seq != seen || tick.price != static_cast<int64_t>(seen) * 5) _exit(3);
+                    ++seen;
+                }
+                consumer->release(batch.size());
+            }
+            _exit(0);
+        }
+
+        for (uint64_t sent = 0; sent < N;) {
+            auto slots = producer->claim(32);
+            if (slots.empty()) std::this_thread::yield();
+            for (auto& slot : slots) {
+                slot = Tick{sent, static_cast<int64_t>(sent) * 5};
+                ++sent;
+            }
+            producer->publish(slots.size());
+        }
+        int status = 0;
+        waitpid(consumer_pid, &status, 0);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        assert(producer->size() == 0);
+        std::cout << "✓ SPSC queue carries data across processes" << std::endl;
+    }
+
+    // Test 2: Roles are exclusive while the holder is alive
+    {
+        auto producer = Common::ShmSPSCQueue<Tick, 1024>::open(name, Common::ShmRole::Producer);
+        assert(producer && !producer->createdSegment());  // Re-attached to Test 1's segment
+        const bool second_producer = runChild([&] {
+            return Common::ShmSPSCQueue<Tick, 1024>::open(name, Common::ShmRole::Producer) != nullptr;
+        });
+        assert(!second_producer);
+        std::cout << "✓ Second live producer is rejected" << std::endl;
+    }
+
+    // Test 3: Consumer crash is detected and a restarted consumer resumes
+    {
+        auto producer = Common::ShmSPSCQueue<Tick, 1024>::open(name, Common::ShmRole::Producer);
+        assert(producer);
+        for (uint64_t i = 0; i < 10; ++i) {
+            *producer->getNextToWriteTo() = Tick{i, 0};
+            producer->updateWriteIndex();
+        }
+
+        // Consume half, then die without unregistering
+        const pid_t crasher = fork();
+        assert(crasher >= 0);
+        if (crasher == 0) {
+            auto consumer = Common::ShmSPSCQueue<Tick, 1024>::open(name, Common::ShmRole::Consumer);
+            if (!consumer) _exit(2);
+            consumer->release(consumer->peek(5).size());
+            std::abort();
+        }
+        waitpid(crasher, nullptr, 0);
+        assert(!producer->peerAlive());
+        assert(producer->size() == 5);
+
+        const bool resumed = runChild([&] {
+            auto consumer = Common::ShmSPSCQueue<Tick, 1024>::open(name, Common::ShmRole::Consumer);
+            if (!consumer) return false;
+            for (uint64_t i = 5; i < 10; ++i) {
+                const auto* tick = consumer->getNextToRead();
+                if (!tick || tick->seq != i) return false;
+                consumer->updateReadIndex();
+            }
+            return consumer->getNextToRead() == nullptr;
+        });
+        assert(resumed);
+        assert(producer->size() == 0);
+        std::cout << "✓ Crashed consumer detected, replacement resumes in order" << std::endl;
+    }
+
+    // Test 4: Layout mismatches are rejected on attach
+    {
+        assert((Common::ShmSPSCQueue<Tick, 2048>::open(name, Common::ShmRole::Consumer,
+                                                       Common::ShmOpenMode::Attach) == nullptr));
+        assert((Common::ShmSPSCQueue<uint64_t, 1024>::open(name, Common::ShmRole::Consumer,
+                                                           Common::ShmOpenMode::Attach) == nullptr));
+        assert((Common::ShmMPMCQueue<Tick>::open(name, Common::ShmRole::Consumer, 0,
+                                                 Common::ShmOpenMode::Attach) == nullptr));
+        Common::ShmSegment::remove(name);
+        assert((Common::ShmSPSCQueue<Tick, 1024>::open(name, Common::ShmRole::Consumer,
+                                                       Common::ShmOpenMode::Attach) == nullptr));
+        std::cout << "✓ Incompatible or missing segments are rejected" << std::endl;
+    }
+
+    // Test 5: MPMC with producers in two child processes
+    {
+        constexpr uint64_t PER_PRODUCER = 20000;
+        auto consumer = Common::ShmMPMCQueue<uint64_t>::open(name, Common::ShmRole::Consumer, 256,
+                                                             Common::ShmOpenMode::Create);
+        assert(consumer && consumer->capacity() == 256);
+
+        pid_t producers[2];
+        for (uint64_t p = 0; p < 2; ++p) {
+            producers[p] = fork();
+            assert(producers[p] >= 0);
+            if (producers[p] == 0) {
+                auto queue = Common::ShmMPMCQueue<uint64_t>::open(name, Common::ShmRole::Producer, 0,
+                                                                  Common::ShmOpenMode::Attach);
+                if (!queue || queue->capacity() != 256) _exit(2);
+                for (uint64_t i = 1; i <= PER_PRODUCER; ++i) {
+                    while (!queue->enqueue(p * PER_PRODUCER + i)) std::this_thread::yield();
+                }
+                _exit(0);
+            }
+        }
+
+        uint64_t sum = 0;
+        uint64_t value = 0;
+        for (uint64_t received = 0; received < 2 * PER_PRODUCER;) {
+            if (consumer->dequeue(value)) {
+                sum += value;
+                ++received;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        for (auto pid : producers) {
+            int status = 0;
+            waitpid(pid, &status, 0);
+            assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        }
+        const uint64_t n = 2 * PER_PRODUCER;
+        assert(sum == n * (n + 1) / 2);
+        assert(!consumer->dequeue(value));
+        assert(!consumer->peerAlive(Common::ShmRole::Producer));
+        Common::ShmSegment::remove(name);
+        std::cout << "✓ MPMC queue merges producers from several processes" << std::endl;
+    }
+
+    // Test 6: A segment whose live creator is slow to initialize is left alone
+    {
+        Common::ShmQueueSegment::Layout layout;
+        layout.kind = 99;
+        layout.elem_size = sizeof(uint64_t);
+        layout.elem_align = alignof(uint64_t);
+        layout.capacity = 16;
+        layout.control_bytes = 64;
+        layout.slot_bytes = 16 * sizeof(uint64_t);
+
+        int ready[2];
+        int hold[2];  // Parent keeps the write end; EOF releases the child
+        assert(pipe(ready) == 0 && pipe(hold) == 0);
+        const pid_t creator = fork();
+        assert(creator >= 0);
+        if (creator == 0) {
+            close(hold[1]);
+            Common::ShmQueueSegment segment;
+            if (!segment.open(name, Common::ShmOpenMode::Create, layout)) _exit(2);
+            char byte = 1;
+            if (write(ready[1], &byte, 1) != 1) _exit(3);
+            // Never marks the segment ready; exits even if the parent dies
+            // on a failed assert
+            while (read(hold[0], &byte, 1) > 0) {}
+            _exit(0);
+        }
+        char byte = 0;
+        assert(read(ready[0], &byte, 1) == 1);
+
+        {
+            Common::ShmQueueSegment segment;
+            assert(!segment.open(name, Common::ShmOpenMode::CreateOrAttach, layout));
+        }
+        Common::ShmSegment still_there;
+        assert(still_there.attach(name));
+        still_there.close();
+
+        kill(creator, SIGKILL);
+        waitpid(creator, nullptr, 0);
+        {
+            Common::ShmQueueSegment segment;
+            assert(segment.open(name, Common::ShmOpenMode::CreateOrAttach, layout) && segment.created());
+        }
+        for (int fd : {ready[0], ready[1], hold[0], hold[1]}) close(fd);
+        Common::ShmSegment::remove(name);
+        std::cout << "✓ Stalled segment is replaced only after its creator dies" << std::endl;
+    }
+
+    std::cout << "\n✅ All shared-memory queue tests passed!" << std::endl;
+    return 0;
+}
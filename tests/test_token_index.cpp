@@ -0,0 +1,91 @@
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../common/token_index.h"
+
+using Common::TokenIndex;
+
+int main() {
+    std::cout << "Testing TokenIndex..." << std::endl;
+
+    // Test 1: Sparse tokens well past any direct-array bound
+    {
+        auto index = std::make_unique<TokenIndex<1000>>();
+        static_assert(TokenIndex<1000>::bytes() == 16 * 1024);
+        assert(index->insert(256265, 0));   // NIFTY 50
+        assert(index->insert(260105, 1));   // NIFTY BANK
+        assert(index->insert(12345678, 2));
+        assert(index->insert(1, 3));
+        assert(index->find(256265) == 0 && index->find(260105) == 1);
+        assert(index->find(12345678) == 2 && index->find(1) == 3);
+        assert(index->find(256266) == TokenIndex<1000>::NOT_FOUND);
+        assert(!index->insert(TokenIndex<1000>::EMPTY_KEY, 4));
+        assert(!index->contains(TokenIndex<1000>::EMPTY_KEY));
+
+        assert(index->insert(260105, 9));  // Remap keeps one entry
+        assert(index->find(260105) == 9 && index->size() == 4);
+        std::cout << "✓ Sparse tokens map in " << TokenIndex<1000>::bytes() / 1024 << "KB" << std::endl;
+    }
+
+    // Test 2: Full table against a reference map, including clustered keys
+    {
+        auto index = std::make_unique<TokenIndex<3000>>();
+        std::unordered_map<uint32_t, uint32_t> ref;
+        std::mt19937 rng(11);
+        while (ref.size() < 3000) {
+            // Half random 32-bit, half runs of consecutive tokens
+            const uint32_t token = ref.size() % 2 ? static_cast<uint32_t>(rng() % 0xFFFFFFF0U)
+                                                  : 40000000 + static_cast<uint32_t>(ref.size());
+            if (ref.emplace(token, static_cast<uint32_t>(ref.size())).second) {
+                assert(index->insert(token, ref[token]));
+            }
+        }
+        assert(!index->insert(7, 1) && index->size() == 3000);  // Full
+
+        for (const auto& [token, value] : ref) {
+            assert(index->find(token) == value);
+        }
+        size_t misses = 0;
+        for (int i = 0; i < 100000; ++i) {
+            const auto token = static_cast<uint32_t>(rng());
+            if (ref.find(token) == ref.end()) {
+                assert(index->find(token) == TokenIndex<3000>::NOT_FOUND);
+                ++misses;
+            }
+        }
+        assert(misses > 0);
+        std::cout << "✓ Full table matches the reference" << std::endl;
+    }
+
+    // Test 3: Lookups on another thread while keys are being added
+    {
+        auto index = std::make_unique<TokenIndex<2000>>();
+        std::atomic<uint32_t> published{0};
+        std::thread reader([&]() {
+            while (published.load(std::memory_order_acquire) < 2000) {
+                const uint32_t known = published.load(std::memory_order_acquire);
+                for (uint32_t i = 0; i < known; i += 7) {
+                    assert(index->find(i * 2654435761U + 17) == i);
+                }
+                // Keys not yet published are either absent or complete
+                const uint32_t next = index->find(known * 2654435761U + 17);
+                assert(next == TokenIndex<2000>::NOT_FOUND || next == known);
+            }
+        });
+        for (uint32_t i = 0; i < 2000; ++i) {
+            assert(index->insert(i * 2654435761U + 17, i));
+            published.store(i + 1, std::memory_order_release);
+        }
+        reader.join();
+        std::cout << "✓ Concurrent lookups see complete entries" << std::endl;
+    }
+
+    std::cout << "\n✅ All TokenIndex tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "../common/time_utils.h"
+
+namespace {
+
+int64_t diff(uint64_t a, uint64_t b) {
+    return static_cast<int64_t>(a - b);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing TscClock..." << std::endl;
+
+    // Test 1: Both domains track their clock_gettime() counterparts
+    {
+        assert(Common::TscClock::reliable());  // First use calibrates
+        const auto tsc_real = Common::TscClock::nowNs();
+        const auto real = Common::getWallClockNanos();
+        const auto tsc_mono = Common::TscClock::monoNs();
+        const auto mono = Common::getNanosSinceEpoch();
+        assert(std::abs(diff(real, tsc_real)) < 1'000'000);
+        assert(std::abs(diff(mono, tsc_mono)) < 1'000'000);
+        assert(Common::TscClock::ticksPerNs() > 0.1 && Common::TscClock::ticksPerNs() < 10.0);
+        std::cout << "✓ Realtime and monotonic mappings agree with the kernel" << std::endl;
+    }
+
+    // Test 2: Corrections keep the error small and the clock monotonic
+    {
+        uint64_t last = Common::TscClock::monoNs();
+        int64_t worst = 0;
+        for (int round = 0; round < 20; ++round) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            Common::TscClock::update();
+            for (int i = 0; i < 1000; ++i) {
+                const auto now = Common::TscClock::monoNs();
+                assert(now >= last);
+                last = now;
+            }
+            const auto err = std::abs(diff(Common::getNanosSinceEpoch(), Common::TscClock::monoNs()));
+            worst = std::max(worst, err);
+        }
+        assert(worst < 1'000'000);
+        std::cout << "✓ Drift correction stays continuous (worst error " << worst << "ns)" << std::endl;
+    }
+
+    // Test 3: Readers see consistent mappings while the service updates
+    {
+        Common::TscClock::start(std::chrono::milliseconds(1));
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 2; ++t) {
+            readers.emplace_back([] {
+                uint64_t last = 0;
+                for (int i = 0; i < 200000; ++i) {
+                    const auto now = Common::TscClock::monoNs();
+                    assert(now >= last);
+                    assert(std::abs(diff(now, Common::getNanosSinceEpoch())) < 1'000'000'000);
+                    last = now;
+                    if ((i & 1023) == 0) std::this_thread::yield();
+                }
+            });
+        }
+        for (auto& r : readers) r.join();
+        Common::TscClock::stop();
+        std::cout << "✓ Seqlock readers never see a torn mapping" << std::endl;
+    }
+
+    // Test 4: Captured TSCs convert after the fact
+    {
+        const auto tsc = Common::rdtsc();
+        const auto mono = Common::TscClock::monoNs();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        const auto converted = Common::TscClock::tscToMonoNs(tsc);
+        assert(std::abs(diff(converted, mono)) < 100'000);
+        const auto epoch = Common::TscClock::tscToEpochNs(tsc);
+        assert(epoch > 1'600'000'000ULL * 1'000'000'000ULL);
+        std::cout << "✓ TSC timestamps convert to both domains" << std::endl;
+    }
+
+    std::cout << "\n✅ All TscClock tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,409 @@
+// ============================================================================
+// binance_book_sync.cpp - Snapshot + diff synchronisation for Binance books
+// ============================================================================
+
+#include "trading/market_data/binance/binance_book_sync.h"
+#include "common/decimal_codec.h"
+#include "common/logging.h"
+#include "common/time_utils.h"
+
+#include <curl/curl.h>
+#include <pthread.h>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
+namespace Trading::MarketData::Binance {
+
+namespace {
+
+// Call fn(price, qty) for each ["price","qty"] pair up to the array's ']'.
+// Nothing at or past end is read.
+template<typename Fn>
+const char* forEachLevel(const char* pos, const char* end, Fn&& fn) noexcept {
+    while (pos < end && *pos) {
+        while (*pos == ',' || *pos == ' ') pos++;
+        if (*pos != '[') break;  // End of array (or malformed)
+        pos++;
+
+        if (*pos == '"') pos++;
+        Price price = 0;
+        const char* next = parseDecimal(pos, end, DEPTH_SCALE, price);
+        if (!next) break;
+        pos = next;
+        while (*pos == '"' || *pos == ',' || *pos == ' ') pos++;
+        Qty qty = 0;
+        next = parseDecimal(pos, end, DEPTH_SCALE, qty);
+        if (!next) break;
+        pos = next;
+        while (pos < end && *pos && *pos != ']') pos++;
+        if (*pos == ']') pos++;
+
+        fn(price, qty);
+    }
+    return *pos == ']' ? pos + 1 : pos;
+}
+
+bool extractId(const char* json, const char* key, uint64_t& value) noexcept {
+    const char* pos = strstr(json, key);
+    if (!pos) return false;
+    pos += strlen(key);
+    char* end = nullptr;
+    value = strtoull(pos, &end, 10);
+    return end != pos;
+}
+
+size_t writeResponse(void* contents, size_t size, size_t nmemb, void* userp) {
+    auto* response = static_cast<std::vector<char>*>(userp);
+    const auto* bytes = static_cast<const char*>(contents);
+    response->insert(response->end(), bytes, bytes + size * nmemb);  // Worker thread
+    return size * nmemb;
+}
+
+} // namespace
+
+auto applyDepthLevels(const char* pos, const char* end, LadderBook<>& book, bool is_bid) noexcept -> const char* {
+    if (is_bid) {
+        return forEachLevel(pos, end, [&book](Price price, Qty qty) { book.setBid(price, qty); });
+    }
+    return forEachLevel(pos, end, [&book](Price price, Qty qty) { book.setAsk(price, qty); });
+}
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+BinanceBookSync::~BinanceBookSync() {
+    stop();
+    for (size_t i = 0; i < count_.load(std::memory_order_relaxed); ++i) {
+        delete syms_[i].book;  // AUDIT_IGNORE: Shutdown only
+    }
+}
+
+auto BinanceBookSync::addSymbol(const char* symbol, uint32_t ticker_id, Price tick_size) -> int {
+    if (const int existing = findSymbol(symbol); existing >= 0) {
+        return existing;
+    }
+    const size_t index = count_.load(std::memory_order_relaxed);
+    if (index >= MAX_SYMBOLS) {
+        LOG_ERROR("Book sync full, cannot add %s", symbol);
+        return -1;
+    }
+
+    auto& sym = syms_[index];
+    strncpy(sym.symbol, symbol, sizeof(sym.symbol) - 1);
+    for (size_t i = 0; sym.symbol[i]; ++i) {
+        sym.upper[i] = static_cast<char>(toupper(static_cast<unsigned char>(sym.symbol[i])));
+    }
+    sym.ticker_id = ticker_id;
+
+    sym.book = new Book(tick_size);  // AUDIT_IGNORE: Init-time only
+    sym.book->setTickerId(static_cast<TickerId>(ticker_id));
+    sym.buffer.resize(config_.buffer_bytes);
+    sym.pending.reserve(config_.buffer_bytes / 64);
+    const size_t levels = config_.snapshot_limit;
+    sym.snapshot.bid_prices.resize(levels);
+    sym.snapshot.bid_qtys.resize(levels);
+    sym.snapshot.ask_prices.resize(levels);
+    sym.snapshot.ask_qtys.resize(levels);
+    sym.response.reserve(levels * 2 * 48 + 1024);
+
+    count_.store(index + 1, std::memory_order_release);
+    LOG_INFO("Book sync for %s (ticker_id %u), tick %ld", sym.symbol, ticker_id, tick_size);
+    return static_cast<int>(index);
+}
+
+auto BinanceBookSync::findSymbol(const char* symbol) const noexcept -> int {
+    const size_t count = count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        if (strcasecmp(syms_[i].symbol, symbol) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+auto BinanceBookSync::findTicker(uint32_t ticker_id) const noexcept -> int {
+    const size_t count = count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        if (syms_[i].ticker_id == ticker_id) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+auto BinanceBookSync::stats(int index) const noexcept -> Stats {
+    const auto& sym = syms_[static_cast<size_t>(index)];
+    return {
+        sym.resyncs.load(std::memory_order_relaxed),
+        sym.snapshots.load(std::memory_order_relaxed),
+        sym.stale_diffs.load(std::memory_order_relaxed),
+        sym.buffer_overflows.load(std::memory_order_relaxed),
+        sym.fetch_failures.load(std::memory_order_relaxed),
+        sym.published_id.load(std::memory_order_relaxed),
+        sym.live.load(std::memory_order_relaxed),
+    };
+}
+
+auto BinanceBookSync::start() -> void {
+    if (running_.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    worker_ = std::thread([this]() {
+        pthread_setname_np(pthread_self(), "binance-snap");
+        workerLoop();
+    });
+}
+
+auto BinanceBookSync::stop() -> void {
+    running_.store(false, std::memory_order_release);
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+// ============================================================================
+// Processor thread
+// ============================================================================
+
+auto BinanceBookSync::onDiff(int index, const char* json, size_t len) noexcept -> bool {
+    Diff diff{0, 0, nullptr, nullptr, json, len};
+    if (!extractId(json, "\"U\":", diff.first_id) || !extractId(json, "\"u\":", diff.last_id)) {
+        return false;
+    }
+    if (const char* bids = strstr(json, "\"b\":[")) {
+        diff.bids = bids + 5;
+    }
+    if (const char* asks = strstr(json, "\"a\":[")) {
+        diff.asks = asks + 5;
+    }
+    return onDiff(index, diff);
+}
+
+auto BinanceBookSync::onDiff(int index, const Diff& diff) noexcept -> bool {
+    auto& sym = syms_[static_cast<size_t>(index)];
+    const uint64_t first = diff.first_id;
+    const uint64_t last = diff.last_id;
+
+    if (sym.state == State::BUFFERING) {
+        bufferDiff(sym, first, last, diff.json, diff.len);
+        return false;
+    }
+
+    if (last <= sym.last_update_id) {
+        sym.stale_diffs.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (first > sym.last_update_id + 1) {
+        LOG_WARN("%s depth gap: expected update %lu, got %lu-%lu; resyncing",
+                 sym.symbol, sym.last_update_id + 1, first, last);
+        beginResync(sym);
+        bufferDiff(sym, first, last, diff.json, diff.len);
+        return false;
+    }
+
+    applyDiff(sym, diff.bids, diff.asks, diff.json + diff.len);
+    sym.last_update_id = last;
+    sym.published_id.store(last, std::memory_order_relaxed);
+    return true;
+}
+
+auto BinanceBookSync::poll() noexcept -> uint32_t {
+    uint32_t went_live = 0;
+    const size_t count = count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        auto& sym = syms_[i];
+        if (sym.fetch.load(std::memory_order_acquire) == FETCH_READY && loadSnapshot(sym)) {
+            went_live |= 1U << i;
+        }
+    }
+    return went_live;
+}
+
+auto BinanceBookSync::applyDiff(SymbolSync& sym, const char* json, const char* end) noexcept -> void {
+    const char* bids = strstr(json, "\"b\":[");
+    const char* asks = strstr(json, "\"a\":[");
+    applyDiff(sym, bids ? bids + 5 : nullptr, asks ? asks + 5 : nullptr, end);
+}
+
+auto BinanceBookSync::applyDiff(SymbolSync& sym, const char* bids, const char* asks,
+                                const char* end) noexcept -> void {
+    if (bids) {
+        applyDepthLevels(bids, end, *sym.book, true);
+    }
+    if (asks) {
+        applyDepthLevels(asks, end, *sym.book, false);
+    }
+}
+
+auto BinanceBookSync::bufferDiff(SymbolSync& sym, uint64_t first, uint64_t last,
+                                 const char* json, size_t len) noexcept -> void {
+    if (len + 1 > sym.buffer.size() - sym.buffer_used || sym.pending.size() == sym.pending.capacity()) {
+        // The stream now has a hole; the snapshot (or the next one) must cover it
+        sym.buffer_overflows.fetch_add(1, std::memory_order_relaxed);
+        sym.buffer_used = 0;
+        sym.pending.clear();
+    }
+    if (len + 1 <= sym.buffer.size()) {
+        std::memcpy(sym.buffer.data() + sym.buffer_used, json, len);
+        sym.buffer[sym.buffer_used + len] = '\0';
+        sym.pending.push_back({first, last, sym.buffer_used});  // Within reserved capacity
+        sym.buffer_used += len + 1;
+    }
+
+    // Diffs are flowing, so a snapshot taken now will overlap them
+    if (sym.fetch.load(std::memory_order_relaxed) == FETCH_IDLE) {
+        sym.fetch.store(FETCH_REQUESTED, std::memory_order_release);
+    }
+}
+
+auto BinanceBookSync::beginResync(SymbolSync& sym) noexcept -> void {
+    sym.state = State::BUFFERING;
+    sym.live.store(false, std::memory_order_relaxed);
+    sym.resyncs.fetch_add(1, std::memory_order_relaxed);
+    sym.book->clear();
+    sym.buffer_used = 0;
+    sym.pending.clear();
+}
+
+auto BinanceBookSync::loadSnapshot(SymbolSync& sym) noexcept -> bool {
+    const auto& snap = sym.snapshot;
+    auto& book = *sym.book;
+    book.clear();
+    for (size_t i = 0; i < snap.bid_count; ++i) {
+        book.setBid(snap.bid_prices[i], snap.bid_qtys[i]);
+    }
+    for (size_t i = 0; i < snap.ask_count; ++i) {
+        book.setAsk(snap.ask_prices[i], snap.ask_qtys[i]);
+    }
+    uint64_t last = snap.last_update_id;
+    sym.snapshots.fetch_add(1, std::memory_order_relaxed);
+    sym.fetch.store(FETCH_IDLE, std::memory_order_relaxed);
+
+    size_t i = 0;
+    for (; i < sym.pending.size(); ++i) {
+        const auto& diff = sym.pending[i];
+        if (diff.last_id <= last) {
+            sym.stale_diffs.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (diff.first_id > last + 1) {
+            break;  // Snapshot older than the buffer, or a diff went missing
+        }
+        applyDiff(sym, sym.buffer.data() + diff.offset, sym.buffer.data() + sym.buffer_used);
+        last = diff.last_id;
+    }
+
+    if (i < sym.pending.size()) {
+        LOG_WARN("%s snapshot %lu doesn't reach buffered update %lu; fetching another",
+                 sym.symbol, last, sym.pending[i].first_id);
+        sym.pending.erase(sym.pending.begin(), sym.pending.begin() + static_cast<std::ptrdiff_t>(i));
+        book.clear();
+        sym.fetch.store(FETCH_REQUESTED, std::memory_order_release);
+        return false;
+    }
+
+    sym.pending.clear();
+    sym.buffer_used = 0;
+    sym.last_update_id = last;
+    sym.state = State::LIVE;
+    sym.published_id.store(last, std::memory_order_relaxed);
+    sym.live.store(true, std::memory_order_relaxed);
+    LOG_INFO("%s book live at update %lu: %zu bids, %zu asks",
+             sym.symbol, last, book.getBidDepth(), book.getAskDepth());
+    return true;
+}
+
+// ============================================================================
+// Snapshot worker
+// ============================================================================
+
+auto BinanceBookSync::workerLoop() -> void {
+    CURL* curl = curl_easy_init();  // AUDIT_IGNORE: Worker thread, reused for every fetch
+    if (!curl) {
+        LOG_ERROR("Book sync: failed to initialize CURL");
+        return;
+    }
+
+    while (running_.load(std::memory_order_acquire)) {
+        const uint64_t now = Common::TscClock::monoNs();
+        const size_t count = count_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count && running_.load(std::memory_order_relaxed); ++i) {
+            auto& sym = syms_[i];
+            if (sym.fetch.load(std::memory_order_acquire) != FETCH_REQUESTED || now < sym.retry_at_ns) {
+                continue;
+            }
+            if (fetchSnapshot(sym, curl)) {
+                sym.fetch.store(FETCH_READY, std::memory_order_release);
+            } else {
+                sym.fetch_failures.fetch_add(1, std::memory_order_relaxed);
+                sym.retry_at_ns = now + uint64_t{config_.retry_ms} * 1000000ULL;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    curl_easy_cleanup(curl);
+}
+
+auto BinanceBookSync::fetchSnapshot(SymbolSync& sym, void* handle) -> bool {
+    auto* curl = static_cast<CURL*>(handle);
+    char url[256];
+    snprintf(url, sizeof(url), "%s/api/v3/depth?symbol=%s&limit=%u",
+             config_.rest_url, sym.upper, config_.snapshot_limit);
+
+    sym.response.clear();
+    curl_easy_reset(curl);
+    curl_easy_setopt(curl, CURLOPT_URL, url);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeResponse);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &sym.response);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+    const CURLcode res = curl_easy_perform(curl);
+    long http_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+    if (res != CURLE_OK || http_code != 200) {
+        LOG_ERROR("%s depth snapshot failed: %s (HTTP %ld)",
+                  sym.symbol, curl_easy_strerror(res), http_code);
+        return false;
+    }
+
+    sym.response.push_back('\0');
+    if (!parseSnapshot(sym.response.data(), sym.response.size(), sym.snapshot)) {
+        LOG_ERROR("%s depth snapshot unparseable (%zu bytes)", sym.symbol, sym.response.size() - 1);
+        return false;
+    }
+    return true;
+}
+
+auto BinanceBookSync::parseSnapshot(const char* json, size_t len, Snapshot& out) noexcept -> bool {
+    if (!extractId(json, "\"lastUpdateId\":", out.last_update_id)) {
+        return false;
+    }
+
+    out.bid_count = 0;
+    out.ask_count = 0;
+    if (const char* bids = strstr(json, "\"bids\":[")) {
+        forEachLevel(bids + 8, json + len, [&out](Price price, Qty qty) {
+            if (out.bid_count < out.bid_prices.size()) {
+                out.bid_prices[out.bid_count] = price;
+                out.bid_qtys[out.bid_count++] = qty;
+            }
+        });
+    }
+    if (const char* asks = strstr(json, "\"asks\":[")) {
+        forEachLevel(asks + 8, json + len, [&out](Price price, Qty qty) {
+            if (out.ask_count < out.ask_prices.size()) {
+                out.ask_prices[out.ask_count] = price;
+                out.ask_qtys[out.ask_count++] = qty;
+            }
+        });
+    }
+    return true;
+}
+
+} // namespace Trading::MarketData::Binance
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "common/types.h"
+#include "trading/market_data/ladder_book.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace Trading::MarketData::Binance {
+
+using namespace Common;
+
+// Decimal places in Binance depth prices and quantities
+constexpr uint32_t DEPTH_SCALE = 8;
+
+// Apply a Binance depth array of ["price","qty"] pairs, starting just after
+// its '[', up to the closing ']' or end. A zero quantity removes the level.
+// Returns the position after the array.
+auto applyDepthLevels(const char* pos, const char* end, LadderBook<>& book, bool is_bid) noexcept -> const char*;
+
+// Keeps full-depth books in step with Binance's diff streams.
+//
+// Each symbol starts out buffering diffs. A worker thread fetches a REST
+// depth snapshot, and poll() then loads it into the book and replays the
+// buffered diffs newer than it. After that, every diff must continue from
+// the last applied update ID (U <= last + 1 <= u). Older diffs are dropped.
+// A diff that leaves a gap puts only that symbol back to buffering and
+// requests a new snapshot; other symbols keep flowing.
+//
+// onDiff() and poll() belong to the processor thread. Neither blocks:
+// snapshots are fetched and parsed on the worker and handed over through a
+// per-symbol flag. Stats can be read from any thread.
+class BinanceBookSync {
+public:
+    using Book = LadderBook<>;
+
+    struct Config {
+        const char* rest_url = "https://api.binance.com";
+        uint32_t snapshot_limit = 1000;      // Levels per side requested
+        uint32_t retry_ms = 1000;            // Wait after a failed fetch
+        size_t buffer_bytes = 1 << 20;       // Diff text buffered per symbol
+    };
+
+    struct Stats {
+        uint64_t resyncs;            // Gaps that forced a new snapshot
+        uint64_t snapshots;          // Snapshots loaded, including the first
+        uint64_t stale_diffs;        // Diffs already covered, dropped
+        uint64_t buffer_overflows;   // Buffered diffs discarded for space
+        uint64_t fetch_failures;
+        uint64_t last_update_id;
+        bool live;
+    };
+
+    static constexpr size_t MAX_SYMBOLS = 8;
+
+    BinanceBookSync() noexcept = default;
+    ~BinanceBookSync();
+
+    // Delete copy/move
+    BinanceBookSync(const BinanceBookSync&) = delete;
+    BinanceBookSync& operator=(const BinanceBookSync&) = delete;
+    BinanceBookSync(BinanceBookSync&&) = delete;
+    BinanceBookSync& operator=(BinanceBookSync&&) = delete;
+
+    // Init-time, before the first addSymbol()
+    auto configure(const Config& config) noexcept -> void { config_ = config; }
+
+    // Returns the symbol's index, or -1 when full. Allocates; call at init.
+    auto addSymbol(const char* symbol, uint32_t ticker_id, Price tick_size) -> int;
+    auto findSymbol(const char* symbol) const noexcept -> int;
+    auto findTicker(uint32_t ticker_id) const noexcept -> int;
+    auto symbolCount() const noexcept -> size_t { return count_.load(std::memory_order_acquire); }
+    auto symbol(int index) const noexcept -> const char* { return syms_[static_cast<size_t>(index)].symbol; }
+    auto tickerId(int index) const noexcept -> uint32_t { return syms_[static_cast<size_t>(index)].ticker_id; }
+    auto book(int index) const noexcept -> const Book* { return syms_[static_cast<size_t>(index)].book; }
+    auto book(int index) noexcept -> Book* { return syms_[static_cast<size_t>(index)].book; }
+    auto stats(int index) const noexcept -> Stats;
+    auto isLive(int index) const noexcept -> bool {
+        return syms_[static_cast<size_t>(index)].live.load(std::memory_order_relaxed);
+    }
+
+    // Snapshot worker
+    auto start() -> void;
+    auto stop() -> void;
+
+    // A depthUpdate event already located by the caller's parser
+    struct Diff {
+        uint64_t first_id;   // U
+        uint64_t last_id;    // u
+        const char* bids;    // Just past "b":[, or nullptr
+        const char* asks;    // Just past "a":[, or nullptr
+        const char* json;    // The whole event, NUL-terminated, for buffering
+        size_t len;
+    };
+
+    // Processor thread: feed one depthUpdate event (NUL-terminated JSON).
+    // Returns true if it was applied to a live book.
+    auto onDiff(int index, const char* json, size_t len) noexcept -> bool;
+    auto onDiff(int index, const Diff& diff) noexcept -> bool;
+
+    // Processor thread: load snapshots the worker has finished. Returns a
+    // bit per symbol whose book went live.
+    auto poll() noexcept -> uint32_t;
+
+private:
+    enum class State : uint8_t { BUFFERING, LIVE };
+    // Snapshot handoff: the processor moves IDLE->REQUESTED and READY->IDLE,
+    // the worker REQUESTED->READY
+    enum Fetch : uint8_t { FETCH_IDLE, FETCH_REQUESTED, FETCH_READY };
+
+    struct PendingDiff {
+        uint64_t first_id;   // U
+        uint64_t last_id;    // u
+        size_t offset;       // Into the buffer, NUL-terminated
+    };
+
+    struct Snapshot {
+        uint64_t last_update_id = 0;
+        std::vector<Price> bid_prices;
+        std::vector<Qty> bid_qtys;
+        std::vector<Price> ask_prices;
+        std::vector<Qty> ask_qtys;
+        size_t bid_count = 0;
+        size_t ask_count = 0;
+    };
+
+    struct SymbolSync {
+        char symbol[16]{};
+        char upper[16]{};            // REST wants upper case
+        uint32_t ticker_id = 0;
+        Book* book = nullptr;
+
+        // Processor thread
+        State state = State::BUFFERING;
+        uint64_t last_update_id = 0;
+        std::vector<char> buffer;
+        size_t buffer_used = 0;
+        std::vector<PendingDiff> pending;
+
+        // Worker thread
+        Snapshot snapshot;
+        std::vector<char> response;
+        uint64_t retry_at_ns = 0;
+
+        std::atomic<uint8_t> fetch{FETCH_IDLE};
+        std::atomic<uint64_t> resyncs{0};
+        std::atomic<uint64_t> snapshots{0};
+        std::atomic<uint64_t> stale_diffs{0};
+        std::atomic<uint64_t> buffer_overflows{0};
+        std::atomic<uint64_t> fetch_failures{0};
+        std::atomic<uint64_t> published_id{0};
+        std::atomic<bool> live{false};
+    };
+
+    auto bufferDiff(SymbolSync& sym, uint64_t first, uint64_t last, const char* json, size_t len) noexcept -> void;
+    auto applyDiff(SymbolSync& sym, const char* json, const char* end) noexcept -> void;
+    auto applyDiff(SymbolSync& sym, const char* bids, const char* asks, const char* end) noexcept -> void;
+    auto beginResync(SymbolSync& sym) noexcept -> void;
+    // Load the snapshot and replay; false if a gap means another snapshot
+    auto loadSnapshot(SymbolSync& sym) noexcept -> bool;
+
+    auto workerLoop() -> void;
+    auto fetchSnapshot(SymbolSync& sym, void* curl) -> bool;
+    static auto parseSnapshot(const char* json, size_t len, Snapshot& out) noexcept -> bool;
+
+    Config config_{};
+    std::array<SymbolSync, MAX_SYMBOLS> syms_{};
+    std::atomic<size_t> count_{0};   // Published after the entry is filled
+
+    std::atomic<bool> running_{false};
+    std::thread worker_{};
+};
+
+} // namespace Trading::MarketData::Binance
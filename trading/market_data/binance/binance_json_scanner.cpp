@@ -0,0 +1,430 @@
+// ============================================================================
+// binance_json_scanner.cpp - Single-pass parser for Binance stream messages
+// ============================================================================
+
+#include "trading/market_data/binance/binance_json_scanner.h"
+#include "common/macros.h"
+#include "common/decimal_codec.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <immintrin.h>
+#include <string_view>
+#include <utility>
+
+namespace Trading::MarketData::Binance {
+
+namespace {
+
+using namespace std::string_view_literals;
+
+// The first bytes of each schema's object. Binance always sends the event
+// type (or the update id, for the two streams without one) as the first key.
+constexpr std::pair<std::string_view, BinanceEvent> PREFIXES[] = {
+    {"{\"e\":\"trade\","sv, BinanceEvent::TRADE},
+    {"{\"e\":\"aggTrade\","sv, BinanceEvent::AGG_TRADE},
+    {"{\"e\":\"depthUpdate\","sv, BinanceEvent::DEPTH_UPDATE},
+    {"{\"lastUpdateId\":"sv, BinanceEvent::PARTIAL_BOOK},
+    {"{\"u\":"sv, BinanceEvent::BOOK_TICKER},
+};
+
+constexpr std::string_view STREAM_PREFIX = "{\"stream\":\""sv;
+constexpr std::string_view DATA_KEY = ",\"data\":"sv;
+
+constexpr uint32_t SCALE = 8;  // Binance quotes to 8 decimal places
+
+inline auto isDigit(char c) noexcept -> bool {
+    return c >= '0' && c <= '9';
+}
+
+inline auto startsWith(const char* p, size_t avail, std::string_view prefix) noexcept -> bool {
+    return avail >= prefix.size() && std::memcmp(p, prefix.data(), prefix.size()) == 0;
+}
+
+auto classify(const char* p, size_t avail) noexcept -> BinanceEvent {
+    for (const auto& [prefix, event] : PREFIXES) {
+        if (startsWith(p, avail, prefix)) {
+            return event;
+        }
+    }
+    return BinanceEvent::UNKNOWN;
+}
+
+// Every field the event needs was present
+auto complete(BinanceEvent event, const BinanceMessage& msg) noexcept -> bool {
+    switch (event) {
+    case BinanceEvent::TRADE:
+    case BinanceEvent::AGG_TRADE:
+        return msg.price != Price_INVALID && msg.qty != BinanceMessage::QTY_NONE;
+    case BinanceEvent::DEPTH_UPDATE:
+        return msg.first_update_id != 0 && msg.last_update_id != 0;
+    case BinanceEvent::PARTIAL_BOOK:
+        return msg.last_update_id != 0;
+    case BinanceEvent::BOOK_TICKER:
+        return msg.bid_price != Price_INVALID && msg.ask_price != Price_INVALID;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+auto BinanceJsonScanner::scan(const char* json, size_t len, BinanceMessage& out) noexcept -> BinanceEvent {
+    out.reset();
+    if (UNLIKELY(!json || !indexQuotes(json, len))) {
+        return BinanceEvent::UNKNOWN;
+    }
+
+    // Combined streams wrap the payload: {"stream":"btcusdt@trade","data":{...}}
+    size_t pos = 0;
+    const bool combined = startsWith(json, len, STREAM_PREFIX);
+    if (combined) {
+        pos = parseSymbol(STREAM_PREFIX.size() - 1, out.symbol, '@');
+        if (pos == 0 || !startsWith(json + pos, len - pos, DATA_KEY)) {
+            return BinanceEvent::UNKNOWN;
+        }
+        pos += DATA_KEY.size();
+    }
+
+    out.event = classify(json + pos, len - pos);
+    if (out.event == BinanceEvent::UNKNOWN) {
+        return BinanceEvent::UNKNOWN;
+    }
+    pos = parseObject(pos, out);
+    if (pos == 0 || (combined && json_[pos] != '}') || !complete(out.event, out)) {
+        out.event = BinanceEvent::UNKNOWN;
+    }
+    return out.event;
+}
+
+// ============================================================================
+// Structural index
+// ============================================================================
+
+auto BinanceJsonScanner::indexQuotes(const char* json, size_t len) noexcept -> bool {
+    if (len > MAX_MESSAGE) {
+        return false;
+    }
+    json_ = json;
+    len_ = len;
+    words_ = (len + 63) / 64;
+
+    uint64_t escapes = 0;
+    size_t word = 0;
+#ifdef __AVX2__
+    // 64 bytes per word: compares against '"', ']' and '\' per 32-byte half
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i close = _mm256_set1_epi8(']');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const auto mask = [](__m256i a, __m256i b) noexcept -> uint64_t {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+    };
+    const auto index = [&](const char* block, size_t w) noexcept {
+        const auto* p = reinterpret_cast<const __m256i*>(block);
+        const __m256i lo = _mm256_loadu_si256(p);
+        const __m256i hi = _mm256_loadu_si256(p + 1);
+        quotes_[w] = mask(lo, quote) | mask(hi, quote) << 32;
+        closes_[w] = mask(lo, close) | mask(hi, close) << 32;
+        escapes |= mask(lo, backslash) | mask(hi, backslash);
+    };
+    for (; word < len / 64; ++word) {
+        index(json + word * 64, word);
+    }
+    if (word < words_) {
+        // The last partial block, zero-padded so nothing past the frame is read
+        alignas(32) char tail[64]{};
+        std::memcpy(tail, json + word * 64, len - word * 64);
+        index(tail, word);
+    }
+#else
+    for (; word < words_; ++word) {
+        uint64_t quotes = 0;
+        uint64_t closes = 0;
+        const size_t end = std::min(len, word * 64 + 64);
+        for (size_t i = word * 64; i < end; ++i) {
+            quotes |= static_cast<uint64_t>(json[i] == '"') << (i - word * 64);
+            closes |= static_cast<uint64_t>(json[i] == ']') << (i - word * 64);
+            escapes |= static_cast<uint64_t>(json[i] == '\\');
+        }
+        quotes_[word] = quotes;
+        closes_[word] = closes;
+    }
+#endif
+    closes_[words_] = 0;  // Lets skipLevels look one word ahead
+
+    // A quote inside a string would break the quote-to-quote walk; Binance
+    // never escapes anything in these schemas
+    return escapes == 0;
+}
+
+auto BinanceJsonScanner::nextQuote(size_t pos) const noexcept -> size_t {
+    size_t word = pos / 64;
+    if (word >= words_) {
+        return len_;
+    }
+    uint64_t bits = quotes_[word] & (~0ULL << (pos % 64));
+    while (bits == 0) {
+        if (++word == words_) {
+            return len_;
+        }
+        bits = quotes_[word];
+    }
+    return word * 64 + static_cast<size_t>(std::countr_zero(bits));
+}
+
+// ============================================================================
+// Fields
+// ============================================================================
+
+auto BinanceJsonScanner::parseObject(size_t pos, BinanceMessage& out) noexcept -> size_t {
+    if (json_[pos] != '{') {
+        return 0;
+    }
+    ++pos;
+    const BinanceEvent event = out.event;
+
+    while (true) {
+        // "key":value
+        if (json_[pos] != '"') {
+            return 0;
+        }
+        const size_t key_end = nextQuote(pos + 1);
+        if (key_end >= len_ || json_[key_end + 1] != ':') {
+            return 0;
+        }
+        const std::string_view key(json_ + pos + 1, key_end - pos - 1);
+        size_t v = key_end + 2;
+
+        if (key.size() == 1) {
+            // Single-letter keys; 'a' and 'b' mean different things per event
+            switch (key[0]) {
+            case 'E': v = parseUint(v, out.event_time_ms); break;
+            case 'T': v = parseUint(v, out.trade_time_ms); break;
+            case 't': v = parseUint(v, out.trade_id); break;
+            case 'U': v = parseUint(v, out.first_update_id); break;
+            case 'u': v = parseUint(v, out.last_update_id); break;
+            case 's': v = parseSymbol(v, out.symbol, '"'); break;
+            case 'p': v = parseDecimal(v, out.price); break;
+            case 'q': {
+                int64_t qty = 0;
+                v = parseDecimal(v, qty);
+                out.qty = static_cast<Qty>(qty);
+                break;
+            }
+            case 'm':
+                if (strncmp(json_ + v, "true", 4) == 0) {
+                    out.is_buyer_maker = true;
+                    v += 4;
+                } else if (strncmp(json_ + v, "false", 5) == 0) {
+                    v += 5;
+                } else {
+                    v = 0;
+                }
+                break;
+            case 'a':
+                if (event == BinanceEvent::AGG_TRADE) {
+                    v = parseUint(v, out.trade_id);
+                } else if (event == BinanceEvent::DEPTH_UPDATE) {
+                    out.asks = json_ + v + 1;
+                    v = skipLevels(v);
+                } else if (event == BinanceEvent::BOOK_TICKER) {
+                    v = parseDecimal(v, out.ask_price);
+                } else {
+                    v = skipValue(v);
+                }
+                break;
+            case 'b':
+                if (event == BinanceEvent::DEPTH_UPDATE) {
+                    out.bids = json_ + v + 1;
+                    v = skipLevels(v);
+                } else if (event == BinanceEvent::BOOK_TICKER) {
+                    v = parseDecimal(v, out.bid_price);
+                } else {
+                    v = skipValue(v);
+                }
+                break;
+            case 'A':
+            case 'B':
+                if (event == BinanceEvent::BOOK_TICKER) {
+                    int64_t qty = 0;
+                    v = parseDecimal(v, qty);
+                    (key[0] == 'A' ? out.ask_qty : out.bid_qty) = static_cast<Qty>(qty);
+                } else {
+                    v = skipValue(v);
+                }
+                break;
+            default:
+                v = skipValue(v);
+                break;
+            }
+        } else if (key == "lastUpdateId"sv) {
+            v = parseUint(v, out.last_update_id);
+        } else if (key == "bids"sv && event == BinanceEvent::PARTIAL_BOOK) {
+            v = parseLevels(v, out.bid_prices, out.bid_qtys, out.bid_count);
+        } else if (key == "asks"sv && event == BinanceEvent::PARTIAL_BOOK) {
+            v = parseLevels(v, out.ask_prices, out.ask_qtys, out.ask_count);
+        } else {
+            v = skipValue(v);
+        }
+
+        if (v == 0) {
+            return 0;
+        }
+        if (json_[v] == '}') {
+            return v + 1;
+        }
+        if (json_[v] != ',') {
+            return 0;
+        }
+        pos = v + 1;
+    }
+}
+
+auto BinanceJsonScanner::parseUint(size_t pos, uint64_t& value) const noexcept -> size_t {
+    const char* p = json_ + pos;
+    if (!isDigit(*p)) {
+        return 0;
+    }
+    uint64_t result = 0;
+    while (isDigit(*p)) {
+        result = result * 10 + static_cast<uint64_t>(*p++ - '0');
+    }
+    value = result;
+    return static_cast<size_t>(p - json_);
+}
+
+// "123.45678" to 1e8 fixed point, exactly; digits past the eighth are dropped
+auto BinanceJsonScanner::parseDecimal(size_t pos, int64_t& value) const noexcept -> size_t {
+    if (json_[pos] != '"' || json_[pos + 1] == '-') {
+        return 0;
+    }
+    const char* end = Common::parseDecimal(json_ + pos + 1, json_ + len_, SCALE, value);
+    if (!end || *end != '"') {
+        return 0;
+    }
+    return static_cast<size_t>(end + 1 - json_);
+}
+
+// Upper-cased into out, up to 'stop' or the closing quote
+auto BinanceJsonScanner::parseSymbol(size_t pos, char* out, char stop) const noexcept -> size_t {
+    if (json_[pos] != '"') {
+        return 0;
+    }
+    const size_t end = nextQuote(pos + 1);
+    if (end >= len_) {
+        return 0;
+    }
+    size_t n = 0;
+    for (size_t i = pos + 1; i < end && json_[i] != stop; ++i) {
+        if (n == sizeof(BinanceMessage::symbol) - 1) {
+            return 0;
+        }
+        const char c = json_[i];
+        out[n++] = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+    out[n] = '\0';
+    return end + 1;
+}
+
+// [["price","qty"],...] into the arrays; levels past MAX_LEVELS are dropped
+auto BinanceJsonScanner::parseLevels(size_t pos, Price* prices, Qty* qtys, uint8_t& count) const noexcept -> size_t {
+    if (json_[pos] != '[') {
+        return 0;
+    }
+    size_t p = pos + 1;
+    uint8_t n = 0;
+    if (json_[p] != ']') {
+        while (true) {
+            int64_t price = 0;
+            int64_t qty = 0;
+            if (json_[p] != '[') {
+                return 0;
+            }
+            p = parseDecimal(p + 1, price);
+            if (p == 0 || json_[p] != ',') {
+                return 0;
+            }
+            p = parseDecimal(p + 1, qty);
+            if (p == 0 || json_[p] != ']') {
+                return 0;
+            }
+            if (n < BinanceMessage::MAX_LEVELS) {
+                prices[n] = price;
+                qtys[n] = static_cast<Qty>(qty);
+                ++n;
+            }
+            if (json_[++p] != ',') {
+                break;
+            }
+            ++p;
+        }
+        if (json_[p] != ']') {
+            return 0;
+        }
+    }
+    count = n;
+    return p + 1;
+}
+
+// [["price","qty"],...] without reading the levels: the array ends at the
+// first "]]", found from the index. The levels are checked as they are
+// applied, so only the brackets at either end are checked here.
+auto BinanceJsonScanner::skipLevels(size_t pos) const noexcept -> size_t {
+    if (json_[pos] != '[') {
+        return 0;
+    }
+    if (json_[pos + 1] == ']') {
+        return pos + 2;
+    }
+    if (json_[pos + 1] != '[') {
+        return 0;
+    }
+    for (size_t word = pos / 64; word < words_; ++word) {
+        // A ']' whose next byte is also ']'
+        uint64_t pairs = closes_[word] & (closes_[word] >> 1 | closes_[word + 1] << 63);
+        if (word == pos / 64) {
+            pairs &= ~0ULL << (pos % 64);
+        }
+        if (pairs != 0) {
+            return word * 64 + static_cast<size_t>(std::countr_zero(pairs)) + 2;
+        }
+    }
+    return 0;
+}
+
+// A value this scanner has no field for: string, literal, or array of those
+auto BinanceJsonScanner::skipValue(size_t pos) const noexcept -> size_t {
+    if (json_[pos] == '"') {
+        const size_t end = nextQuote(pos + 1);
+        return end < len_ ? end + 1 : 0;
+    }
+    if (json_[pos] == '[') {
+        size_t depth = 0;
+        for (size_t p = pos; p < len_; ++p) {
+            const char c = json_[p];
+            if (c == '"') {
+                p = nextQuote(p + 1);  // Loop steps past the closing quote
+            } else if (c == '[') {
+                ++depth;
+            } else if (c == ']') {
+                if (--depth == 0) {
+                    return p + 1;
+                }
+            } else if (c == '{') {
+                return 0;
+            }
+        }
+        return 0;
+    }
+    if (json_[pos] == '{') {
+        return 0;  // No nested objects in these schemas
+    }
+    size_t p = pos;
+    while (json_[p] && json_[p] != ',' && json_[p] != '}' && json_[p] != ']') {
+        ++p;
+    }
+    return p == pos ? 0 : p;
+}
+
+} // namespace Trading::MarketData::Binance
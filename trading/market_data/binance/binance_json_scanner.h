@@ -0,0 +1,132 @@
+#pragma once
+
+#include "common/types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace Trading::MarketData::Binance {
+
+using namespace Common;
+
+enum class BinanceEvent : uint8_t {
+    UNKNOWN,        // Not one of the schemas below; use the generic path
+    TRADE,          // <symbol>@trade
+    AGG_TRADE,      // <symbol>@aggTrade
+    DEPTH_UPDATE,   // <symbol>@depth diffs
+    PARTIAL_BOOK,   // <symbol>@depth5/10/20
+    BOOK_TICKER     // <symbol>@bookTicker
+};
+
+// Every field of one Binance stream message. Prices and quantities are
+// 1e8 fixed point, the precision Binance quotes them to. Only the fields
+// of the message's event are written.
+struct BinanceMessage {
+    static constexpr size_t MAX_LEVELS = 20;  // Largest partial book stream
+    static constexpr Qty QTY_NONE = std::numeric_limits<Qty>::max();
+
+    BinanceEvent event;
+    char symbol[16];           // Upper case; from "s" or the combined stream name
+    uint64_t event_time_ms;    // E
+    uint64_t trade_time_ms;    // T
+    uint64_t trade_id;         // t, or a for aggTrade
+    uint64_t first_update_id;  // U
+    uint64_t last_update_id;   // u, or lastUpdateId
+    Price price;               // p
+    Qty qty;                   // q
+    bool is_buyer_maker;       // m
+
+    // bookTicker
+    Price bid_price;
+    Qty bid_qty;
+    Price ask_price;
+    Qty ask_qty;
+
+    // Partial book levels, best first
+    uint8_t bid_count;
+    uint8_t ask_count;
+    Price bid_prices[MAX_LEVELS];
+    Qty bid_qtys[MAX_LEVELS];
+    Price ask_prices[MAX_LEVELS];
+    Qty ask_qtys[MAX_LEVELS];
+
+    // depthUpdate: diffs can run to hundreds of levels and go straight into
+    // the book, so only where each array starts (just after its '[') is kept
+    const char* bids;
+    const char* asks;
+
+    // Everything but the level arrays, which the counts cover
+    void reset() noexcept {
+        event = BinanceEvent::UNKNOWN;
+        symbol[0] = '\0';
+        event_time_ms = 0;
+        trade_time_ms = 0;
+        trade_id = 0;
+        first_update_id = 0;
+        last_update_id = 0;
+        price = Price_INVALID;
+        qty = QTY_NONE;
+        is_buyer_maker = false;
+        bid_price = Price_INVALID;
+        bid_qty = QTY_NONE;
+        ask_price = Price_INVALID;
+        ask_qty = QTY_NONE;
+        bid_count = 0;
+        ask_count = 0;
+        bids = nullptr;
+        asks = nullptr;
+    }
+};
+
+// Single-pass parser for the fixed Binance stream schemas.
+//
+// The event is classified from the first bytes of the frame (or of its
+// "data" object for combined streams). One AVX2 pass then marks every '"'
+// and ']' in the frame in bitmaps, and the fields are read in order by
+// hopping from quote to quote, so no byte is searched twice and string
+// values are never copied. Decimals are converted straight to fixed point;
+// depthUpdate level arrays are stepped over whole via their closing "]]".
+//
+// Anything unexpected - an unknown event, a backslash escape, a nested
+// object, a frame over MAX_MESSAGE - returns UNKNOWN and the caller falls
+// back to a general parser. Frames must be NUL-terminated.
+class BinanceJsonScanner {
+public:
+    static constexpr size_t MAX_MESSAGE = 64 * 1024;  // The WS frame limit
+
+    BinanceJsonScanner() noexcept = default;
+
+    // Delete copy/move
+    BinanceJsonScanner(const BinanceJsonScanner&) = delete;
+    BinanceJsonScanner& operator=(const BinanceJsonScanner&) = delete;
+    BinanceJsonScanner(BinanceJsonScanner&&) = delete;
+    BinanceJsonScanner& operator=(BinanceJsonScanner&&) = delete;
+
+    auto scan(const char* json, size_t len, BinanceMessage& out) noexcept -> BinanceEvent;
+
+private:
+    // Build the quote and ']' bitmaps; false if the frame holds an escape
+    auto indexQuotes(const char* json, size_t len) noexcept -> bool;
+    // Position of the first quote at or after pos, or len_ if none
+    auto nextQuote(size_t pos) const noexcept -> size_t;
+
+    // Read the object at pos ('{') into out; the position after its '}',
+    // or 0 if it doesn't fit the event's schema
+    auto parseObject(size_t pos, BinanceMessage& out) noexcept -> size_t;
+    // Each returns the position after the value, or 0 if it is malformed
+    auto parseUint(size_t pos, uint64_t& value) const noexcept -> size_t;
+    auto parseDecimal(size_t pos, int64_t& value) const noexcept -> size_t;
+    auto parseSymbol(size_t pos, char* out, char stop) const noexcept -> size_t;
+    auto parseLevels(size_t pos, Price* prices, Qty* qtys, uint8_t& count) const noexcept -> size_t;
+    auto skipLevels(size_t pos) const noexcept -> size_t;
+    auto skipValue(size_t pos) const noexcept -> size_t;
+
+    const char* json_ = nullptr;
+    size_t len_ = 0;
+    size_t words_ = 0;
+    alignas(64) uint64_t quotes_[MAX_MESSAGE / 64]{};
+    alignas(64) uint64_t closes_[MAX_MESSAGE / 64 + 1]{};  // ']' positions
+};
+
+} // namespace Trading::MarketData::Binance
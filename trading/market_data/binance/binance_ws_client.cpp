@@ -1,6 +1,9 @@
 #include "binance_ws_client.h"
 #include "../order_book.h"
+#include "common/decimal_codec.h"
 
+#include <algorithm>
+#include <bit>
 #include <cstring>
 #include <strings.h>  // For strcasecmp
 #include <cstdio>
@@ -29,6 +32,11 @@ static struct lws_protocols protocols[] = {
 bool BinanceWSClient::init(const Config& config) {
     config_ = config;
     
+    BinanceBookSync::Config sync_config;
+    sync_config.rest_url = config.rest_url;
+    sync_config.snapshot_limit = config.snapshot_limit;
+    book_sync_.configure(sync_config);
+    
     // Create WebSocket context
     struct lws_context_creation_info info;
     std::memset(&info, 0, sizeof(info));
@@ -72,6 +80,9 @@ bool BinanceWSClient::start() {
         wsThreadFunc();
     });
     
+    // Depth snapshots are fetched off the hot threads
+    book_sync_.start();
+    
     // Start processor thread
     processor_thread_ = std::thread([this]() {
         if (config_.cpu_affinity >= 0) {
@@ -92,6 +103,7 @@ void BinanceWSClient::stop() {
     
     LOG_INFO("Stopping BinanceWSClient...");
     running_.store(false, std::memory_order_release);
+    frame_event_.notify();  // Wake a parked processor thread
     
     // Close WebSocket connection
     auto* conn = ws_connection_.load(std::memory_order_acquire);
@@ -106,6 +118,7 @@ void BinanceWSClient::stop() {
     if (processor_thread_.joinable()) {
         processor_thread_.join();
     }
+    book_sync_.stop();
     
     // Destroy context
     if (ws_context_) {
@@ -201,82 +214,264 @@ void BinanceWSClient::wsThreadFunc() {
 // Processor Thread
 // ============================================================================
 
+// Partial book streams on /ws carry no symbol; until they are subscribed
+// per symbol, tell the two traded books apart by price
+static void guessPartialBookTicker(const char* json, TickerId& ticker_id) {
+    if (strstr(json, "111") != nullptr) {
+        ticker_id = 1001;  // BTCUSDT
+    } else if (strstr(json, "4.3") != nullptr || strstr(json, "2.3") != nullptr) {
+        ticker_id = 1002;  // ETHUSDT
+    }
+}
+
 void BinanceWSClient::processorThreadFunc() {
     LOG_INFO("Processor thread started");
     
     while (running_.load(std::memory_order_acquire)) {
-        bool processed = false;
-        
-        // Process tick queue
-        const auto* tick_ptr = tick_queue_.getNextToRead();
-        if (tick_ptr) {
-            BinanceTickData* tick = *const_cast<BinanceTickData**>(tick_ptr);
-            if (tick && tick_callback_) {
-                tick_callback_(tick);
+        // Books whose snapshot landed since the last pass
+        if (const uint32_t went_live = book_sync_.poll()) {
+            const uint64_t now = Common::TscClock::monoNs();
+            for (uint32_t bits = went_live; bits; bits &= bits - 1) {
+                publishFullDepth(std::countr_zero(bits), now);
             }
-            if (tick) {
-                tick_pool_.deallocate(tick);
-            }
-            tick_queue_.updateReadIndex();
-            processed = true;
         }
         
-        // Process depth queue
-        const auto* depth_ptr = depth_queue_.getNextToRead();
-        if (depth_ptr) {
-            BinanceDepthUpdate* depth = *const_cast<BinanceDepthUpdate**>(depth_ptr);
-            
-            // Update order book if manager is set
-            if (depth && order_book_manager_) {
-                // Cast to OrderBookManager and update
-                auto* book_mgr = static_cast<Trading::MarketData::OrderBookManager<1000>*>(order_book_manager_);
-                
-                // Register instrument if not already done
-                auto* order_book = book_mgr->getOrderBook(depth->ticker_id);
-                if (!order_book) {
-                    order_book = book_mgr->registerInstrument(depth->ticker_id, 
-                                                              static_cast<Common::TickerId>(depth->ticker_id));
-                }
-                
-                if (order_book) {
-                    // Clear and update bid levels
-                    order_book->clearBids();
-                    for (uint8_t i = 0; i < depth->bid_count && i < 20; ++i) {
-                        order_book->updateBid(depth->bid_prices[i], depth->bid_qtys[i], 1, i);
-                    }
-                    
-                    // Clear and update ask levels
-                    order_book->clearAsks();
-                    for (uint8_t i = 0; i < depth->ask_count && i < 20; ++i) {
-                        order_book->updateAsk(depth->ask_prices[i], depth->ask_qtys[i], 1, i);
-                    }
-                    
-                    // Update timestamp
-                    order_book->updateTimestamp(depth->local_timestamp_ns);
-                }
-            }
-            
-            // Also call callback if set
-            if (depth && depth_callback_) {
-                depth_callback_(depth);
-            }
-            
-            if (depth) {
-                depth_pool_.deallocate(depth);
-            }
-            depth_queue_.updateReadIndex();
-            processed = true;
+        const auto frame = frame_ring_.peek();
+        if (frame.empty()) {
+            // A park is bounded, so book_sync_ snapshots are still polled
+            frame_wait_.idle([this] {
+                return !running_.load(std::memory_order_relaxed) || !frame_ring_.empty();
+            });
+            continue;
         }
+        frame_wait_.reset();
         
-        // Avoid spinning - brief pause if queues empty
-        if (!processed) {
-            std::this_thread::yield();
-        }
+        // Payload is NUL-terminated in the ring, parse it where it lies
+        processFrame(frame.data.data(), frame.data.size(), frame.timestamp_ns);
+        frame_ring_.release();
     }
     
     LOG_INFO("Processor thread stopped");
 }
 
+void BinanceWSClient::processFrame(const char* json, size_t len, uint64_t local_ts) {
+    // One pass over the known stream schemas; anything else takes the
+    // generic path below
+    const auto& msg = message_;
+    switch (scanner_.scan(json, len, message_)) {
+    case BinanceEvent::TRADE:
+    case BinanceEvent::AGG_TRADE: {
+        auto& tick = tick_;
+        tick.ticker_id = TickerId_INVALID;
+        std::memcpy(tick.symbol, msg.symbol, sizeof(tick.symbol));  // Both 16, NUL-terminated
+        tick.price = msg.price / 1000;  // Scanner's scale 8 to PRICE_SCALE
+        tick.qty = msg.qty;
+        tick.exchange_timestamp_ns = msg.trade_time_ms * 1000000;  // ms to ns
+        tick.is_buyer_maker = msg.is_buyer_maker;
+        tick.local_timestamp_ns = local_ts;
+        publishTick(tick);
+        break;
+    }
+    case BinanceEvent::PARTIAL_BOOK: {
+        if (msg.bid_count == 0 && msg.ask_count == 0) {
+            return;
+        }
+        auto& depth = depth_;
+        depth.ticker_id = msg.symbol[0] ? getTickerId(msg.symbol) : TickerId_INVALID;
+        if (!msg.symbol[0] || depth.ticker_id == 0) {
+            guessPartialBookTicker(json, depth.ticker_id);
+        }
+        depth.last_update_id = msg.last_update_id;
+        depth.bid_count = static_cast<uint8_t>(std::min<size_t>(msg.bid_count, BinanceDepthUpdate::MAX_DEPTH));
+        depth.ask_count = static_cast<uint8_t>(std::min<size_t>(msg.ask_count, BinanceDepthUpdate::MAX_DEPTH));
+        std::memcpy(depth.bid_prices, msg.bid_prices, depth.bid_count * sizeof(Price));
+        std::memcpy(depth.bid_qtys, msg.bid_qtys, depth.bid_count * sizeof(Qty));
+        std::memcpy(depth.ask_prices, msg.ask_prices, depth.ask_count * sizeof(Price));
+        std::memcpy(depth.ask_qtys, msg.ask_qtys, depth.ask_count * sizeof(Qty));
+        depth.local_timestamp_ns = local_ts;
+        publishPartialBook(depth);
+        break;
+    }
+    case BinanceEvent::DEPTH_UPDATE:
+        // Levels go straight from the frame into the full-depth book
+        applyDepthDiff(msg.symbol, {msg.first_update_id, msg.last_update_id, msg.bids, msg.asks, json, len},
+                       local_ts);
+        break;
+    case BinanceEvent::BOOK_TICKER:
+        break;  // Not subscribed
+    default:
+        frames_unscanned_.fetch_add(1, std::memory_order_relaxed);
+        processUnscannedFrame(json, len, local_ts);
+        break;
+    }
+}
+
+// Any frame the scanner doesn't recognise: pretty-printed, escaped, or a
+// schema it has no fields for
+void BinanceWSClient::processUnscannedFrame(const char* json, size_t len, uint64_t local_ts) {
+    // Determine message type by looking for key fields
+    if (strstr(json, "\"e\":\"trade\"")) {
+        // Trade tick message
+        BinanceTickData tick;
+        if (!parseTickMessage(json, len, &tick)) {
+            return;
+        }
+        tick.local_timestamp_ns = local_ts;
+        publishTick(tick);
+    } else if (strstr(json, "\"lastUpdateId\"") && strstr(json, "\"bids\"")) {
+        // Partial book snapshot (from depth5/10/20 streams)
+        BinanceDepthUpdate depth;
+        if (!parsePartialBookMessage(json, len, &depth)) {
+            return;
+        }
+        depth.local_timestamp_ns = local_ts;
+        publishPartialBook(depth);
+    } else if (strstr(json, "\"e\":\"depthUpdate\"")) {
+        // Incremental depth update (from @depth stream), keyed by price
+        applyDepthDiff(json, len, local_ts);
+    }
+}
+
+void BinanceWSClient::publishTick(BinanceTickData& tick) {
+    // Log market data for display
+    static uint64_t tick_counter = 0;
+    if (++tick_counter % 100 == 1) {  // Log every 100th tick
+        LOG_INFO("[BINANCE TICK] %s: Price=%.8f, Qty=%.8f, Side=%s",
+                tick.symbol,
+                static_cast<double>(tick.price) / 1e8,  // Convert from satoshi
+                static_cast<double>(tick.qty) / 1e8,
+                tick.is_buyer_maker ? "SELL" : "BUY");
+    }
+    
+    if (tick_callback_) {
+        tick_callback_(&tick);
+    }
+}
+
+void BinanceWSClient::publishPartialBook(BinanceDepthUpdate& depth) {
+    // Log depth data for display
+    static uint64_t depth_counter = 0;
+    if (++depth_counter % 100 == 1) {  // Log every 100th depth update
+        LOG_INFO("[BINANCE PARTIAL BOOK] UpdateID=%lu, Bids=%d, Asks=%d, BestBid=%.8f@%.8f, BestAsk=%.8f@%.8f",
+                depth.last_update_id,
+                depth.bid_count,
+                depth.ask_count,
+                depth.bid_count > 0 ? static_cast<double>(depth.bid_prices[0]) / 1e8 : 0.0,
+                depth.bid_count > 0 ? static_cast<double>(depth.bid_qtys[0]) / 1e8 : 0.0,
+                depth.ask_count > 0 ? static_cast<double>(depth.ask_prices[0]) / 1e8 : 0.0,
+                depth.ask_count > 0 ? static_cast<double>(depth.ask_qtys[0]) / 1e8 : 0.0);
+    }
+    
+    applyDepthToBook(&depth);
+}
+
+void BinanceWSClient::applyDepthToBook(const BinanceDepthUpdate* depth) {
+    // Update order book if manager is set
+    if (order_book_manager_) {
+        // Cast to OrderBookManager and update
+        auto* book_mgr = static_cast<Trading::MarketData::OrderBookManager<1000>*>(order_book_manager_);
+        
+        // Register instrument if not already done
+        auto* order_book = book_mgr->getOrderBook(depth->ticker_id);
+        if (!order_book) {
+            order_book = book_mgr->registerInstrument(depth->ticker_id, 
+                                                      static_cast<Common::TickerId>(depth->ticker_id));
+        }
+        
+        if (order_book) {
+            // Partial book stream: each message carries the full top levels,
+            // applied as one batch so readers never see one side updated
+            order_book->beginUpdate();
+            order_book->applyLevels(Common::OrderSide::BUY, depth->bid_prices, depth->bid_qtys,
+                                    nullptr, depth->bid_count);
+            order_book->applyLevels(Common::OrderSide::SELL, depth->ask_prices, depth->ask_qtys,
+                                    nullptr, depth->ask_count);
+            
+            // Update timestamp
+            order_book->updateTimestamp(depth->local_timestamp_ns);
+            order_book->endUpdate();
+        }
+    }
+    
+    // Also call callback if set
+    if (depth_callback_) {
+        depth_callback_(depth);
+    }
+}
+
+void BinanceWSClient::applyDepthDiff(const char* json, size_t len, uint64_t local_ts) {
+    char symbol[16];
+    if (!extractJsonValue(json, "\"s\"", symbol, sizeof(symbol))) {
+        return;
+    }
+    
+    // Buffered or dropped while the symbol resyncs; nothing to publish
+    const int index = findDiffBook(symbol);
+    if (index < 0) {
+        return;
+    }
+    const bool was_live = book_sync_.isLive(index);
+    if (book_sync_.onDiff(index, json, len) || was_live) {
+        publishFullDepth(index, local_ts);
+    }
+}
+
+void BinanceWSClient::applyDepthDiff(const char* symbol, const BinanceBookSync::Diff& diff, uint64_t local_ts) {
+    const int index = findDiffBook(symbol);
+    if (index < 0) {
+        return;
+    }
+    const bool was_live = book_sync_.isLive(index);
+    if (book_sync_.onDiff(index, diff) || was_live) {
+        publishFullDepth(index, local_ts);
+    }
+}
+
+int BinanceWSClient::findDiffBook(const char* symbol) {
+    const int index = book_sync_.findSymbol(symbol);
+    if (index < 0) {
+        // No price-indexed book: a diff can't be written into level slots
+        if (diffs_unrouted_.fetch_add(1, std::memory_order_relaxed) % 1000 == 0) {
+            LOG_WARN("Depth diff for %s without a full-depth book, dropped", symbol);
+        }
+    }
+    return index;
+}
+
+// Publish a synced book's top levels through the fixed-level path. A gap
+// that just started a resync has emptied the sync's book, so this also
+// clears the published book in one batch rather than leaving the pre-gap
+// levels up until the new snapshot lands.
+void BinanceWSClient::publishFullDepth(int index, uint64_t local_ts) {
+    auto& book = *book_sync_.book(index);
+    book.updateTimestamp(local_ts);
+    
+    auto& depth = depth_;
+    depth.ticker_id = static_cast<TickerId>(book_sync_.tickerId(index));
+    depth.local_timestamp_ns = local_ts;
+    depth.last_update_id = book_sync_.stats(index).last_update_id;
+    depth.bid_count = static_cast<uint8_t>(
+        book.getBidLevels(depth.bid_prices, depth.bid_qtys, BinanceDepthUpdate::MAX_DEPTH));
+    depth.ask_count = static_cast<uint8_t>(
+        book.getAskLevels(depth.ask_prices, depth.ask_qtys, BinanceDepthUpdate::MAX_DEPTH));
+    
+    // Log depth data for display
+    static uint64_t depth_counter = 0;
+    if (++depth_counter % 100 == 1) {  // Log every 100th depth update
+        LOG_INFO("[BINANCE DEPTH] %s UpdateID=%lu, Levels=%zu/%zu, BestBid=%.8f@%.8f, BestAsk=%.8f@%.8f",
+                book_sync_.symbol(index),
+                depth.last_update_id,
+                book.getBidDepth(),
+                book.getAskDepth(),
+                static_cast<double>(book.getBestBid()) / 1e8,
+                static_cast<double>(book.getBestBidQty()) / 1e8,
+                static_cast<double>(book.getBestAsk()) / 1e8,
+                static_cast<double>(book.getBestAskQty()) / 1e8);
+    }
+    
+    applyDepthToBook(&depth);
+}
+
 // ============================================================================
 // WebSocket Callback
 // ============================================================================
@@ -306,154 +501,58 @@ int BinanceWSClient::wsCallback(struct lws* wsi, enum lws_callback_reasons reaso
                 client->sendSubscribeMessage(stream);
             }
         }
+        for (size_t i = 0; i < client->book_sync_.symbolCount(); ++i) {
+            char stream[128];
+            snprintf(stream, sizeof(stream), "%s@depth@100ms", client->book_sync_.symbol(static_cast<int>(i)));
+            client->sendSubscribeMessage(stream);
+        }
         break;
         
     case LWS_CALLBACK_CLIENT_RECEIVE:
         if (in && len > 0) {
-            // Get timestamp immediately for lowest latency
-            uint64_t local_ts = Common::getNanosSinceEpoch();
-            
-            // Rate limiting check
-            uint64_t current_sec = local_ts / 1000000000ULL;
-            uint64_t last_sec = client->current_second_.load(std::memory_order_relaxed);
-            if (current_sec != last_sec) {
-                client->messages_this_second_.store(0, std::memory_order_relaxed);
-                client->current_second_.store(current_sec, std::memory_order_relaxed);
-            }
-            
-            uint32_t msg_count = client->messages_this_second_.fetch_add(1, std::memory_order_relaxed);
-            if (msg_count >= BinanceWSClient::MAX_MESSAGES_PER_SECOND) {
-                client->messages_rate_limited_.fetch_add(1, std::memory_order_relaxed);
-                break;  // Drop message due to rate limit
+            if (!client->frame_ring_.hasPending() && !client->rx_dropping_) {
+                // First fragment of a frame - get timestamp immediately for lowest latency
+                uint64_t local_ts = Common::TscClock::monoNs();
+                client->rx_frame_ts_ = local_ts;
+                
+                // Rate limiting check, once per frame
+                uint64_t current_sec = local_ts / 1000000000ULL;
+                uint64_t last_sec = client->current_second_.load(std::memory_order_relaxed);
+                if (current_sec != last_sec) {
+                    client->messages_this_second_.store(0, std::memory_order_relaxed);
+                    client->current_second_.store(current_sec, std::memory_order_relaxed);
+                }
+                
+                uint32_t msg_count = client->messages_this_second_.fetch_add(1, std::memory_order_relaxed);
+                if (msg_count >= BinanceWSClient::MAX_MESSAGES_PER_SECOND) {
+                    client->messages_rate_limited_.fetch_add(1, std::memory_order_relaxed);
+                    client->rx_dropping_ = true;  // Drop message due to rate limit
+                }
             }
             
-            // Bounds check and copy to buffer if it fits
-            if (len > RX_BUFFER_SIZE || client->rx_buffer_pos_ + len >= RX_BUFFER_SIZE) {
-                // Buffer would overflow - reset
-                LOG_WARN("RX buffer overflow, resetting (pos=%zu, len=%zu)", 
-                         client->rx_buffer_pos_, len);
-                client->rx_buffer_pos_ = 0;
-                break;
+            // Copy the fragment straight into the frame ring; the processor
+            // thread parses it from there
+            if (!client->rx_dropping_ && !client->frame_ring_.append(in, len)) {
+                // Ring full or frame too large - drop the rest of this frame
+                client->messages_dropped_.fetch_add(1, std::memory_order_relaxed);
+                client->rx_dropping_ = true;
             }
             
-            if (client->rx_buffer_pos_ + len < RX_BUFFER_SIZE) {
-                std::memcpy(client->rx_buffer_ + client->rx_buffer_pos_, in, len);
-                client->rx_buffer_pos_ += len;
-                
-                // Check if message is complete (look for closing brace)
-                if (client->rx_buffer_[client->rx_buffer_pos_ - 1] == '}') {
-                    // Parse message
-                    client->rx_buffer_[client->rx_buffer_pos_] = '\0';
-                    
-                    // Determine message type by looking for key fields
-                    if (strstr(client->rx_buffer_, "\"e\":\"trade\"")) {
-                        // Trade tick message
-                        auto* tick = static_cast<BinanceTickData*>(client->tick_pool_.allocate());
-                        if (tick && client->parseTickMessage(client->rx_buffer_, 
-                                                            client->rx_buffer_pos_, tick)) {
-                            tick->local_timestamp_ns = local_ts;
-                            
-                            // Log market data for display
-                            static uint64_t tick_counter = 0;
-                            if (++tick_counter % 100 == 1) {  // Log every 100th tick
-                                LOG_INFO("[BINANCE TICK] %s: Price=%.8f, Qty=%.8f, Side=%s",
-                                        tick->symbol,
-                                        static_cast<double>(tick->price) / 1e8,  // Convert from satoshi
-                                        static_cast<double>(tick->qty) / 1e8,
-                                        tick->is_buyer_maker ? "SELL" : "BUY");
-                            }
-                            
-                            // Try to enqueue using SPSC API
-                            auto* slot = client->tick_queue_.getNextToWriteTo();
-                            if (slot) {
-                                *slot = tick;
-                                client->tick_queue_.updateWriteIndex();
-                                client->messages_received_.fetch_add(1, std::memory_order_relaxed);
-                            } else {
-                                client->tick_pool_.deallocate(tick);
-                                client->messages_dropped_.fetch_add(1, std::memory_order_relaxed);
-                            }
-                        } else if (tick) {
-                            client->tick_pool_.deallocate(tick);
-                        }
-                    } else if (strstr(client->rx_buffer_, "\"lastUpdateId\"") && 
-                              strstr(client->rx_buffer_, "\"bids\"")) {
-                        // Partial book snapshot (from depth5/10/20 streams)
-                        auto* depth = static_cast<BinanceDepthUpdate*>(client->depth_pool_.allocate());
-                        if (depth && client->parsePartialBookMessage(client->rx_buffer_,
-                                                              client->rx_buffer_pos_, depth)) {
-                            depth->local_timestamp_ns = local_ts;
-                            
-                            // Log depth data for display
-                            static uint64_t depth_counter = 0;
-                            if (++depth_counter % 100 == 1) {  // Log every 100th depth update
-                                LOG_INFO("[BINANCE PARTIAL BOOK] UpdateID=%lu, Bids=%d, Asks=%d, BestBid=%.8f@%.8f, BestAsk=%.8f@%.8f",
-                                        depth->last_update_id,
-                                        depth->bid_count,
-                                        depth->ask_count,
-                                        depth->bid_count > 0 ? static_cast<double>(depth->bid_prices[0]) / 1e8 : 0.0,
-                                        depth->bid_count > 0 ? static_cast<double>(depth->bid_qtys[0]) / 1e8 : 0.0,
-                                        depth->ask_count > 0 ? static_cast<double>(depth->ask_prices[0]) / 1e8 : 0.0,
-                                        depth->ask_count > 0 ? static_cast<double>(depth->ask_qtys[0]) / 1e8 : 0.0);
-                            }
-                            
-                            // Try to enqueue using SPSC API
-                            auto* slot = client->depth_queue_.getNextToWriteTo();
-                            if (slot) {
-                                *slot = depth;
-                                client->depth_queue_.updateWriteIndex();
-                                client->messages_received_.fetch_add(1, std::memory_order_relaxed);
-                            } else {
-                                client->depth_pool_.deallocate(depth);
-                                client->messages_dropped_.fetch_add(1, std::memory_order_relaxed);
-                            }
-                        } else if (depth) {
-                            client->depth_pool_.deallocate(depth);
-                        }
-                    } else if (strstr(client->rx_buffer_, "\"e\":\"depthUpdate\"")) {
-                        // Incremental depth update (from @depth stream)
-                        auto* depth = static_cast<BinanceDepthUpdate*>(client->depth_pool_.allocate());
-                        if (depth && client->parseDepthMessage(client->rx_buffer_,
-                                                              client->rx_buffer_pos_, depth)) {
-                            depth->local_timestamp_ns = local_ts;
-                            
-                            // Log depth data for display
-                            static uint64_t depth_counter = 0;
-                            if (++depth_counter % 100 == 1) {  // Log every 100th depth update
-                                LOG_INFO("[BINANCE DEPTH] UpdateID=%lu, Bids=%d, Asks=%d, BestBid=%.8f@%.8f, BestAsk=%.8f@%.8f",
-                                        depth->last_update_id,
-                                        depth->bid_count,
-                                        depth->ask_count,
-                                        depth->bid_count > 0 ? static_cast<double>(depth->bid_prices[0]) / 1e8 : 0.0,
-                                        depth->bid_count > 0 ? static_cast<double>(depth->bid_qtys[0]) / 1e8 : 0.0,
-                                        depth->ask_count > 0 ? static_cast<double>(depth->ask_prices[0]) / 1e8 : 0.0,
-                                        depth->ask_count > 0 ? static_cast<double>(depth->ask_qtys[0]) / 1e8 : 0.0);
-                            }
-                            
-                            // Try to enqueue using SPSC API
-                            auto* slot = client->depth_queue_.getNextToWriteTo();
-                            if (slot) {
-                                *slot = depth;
-                                client->depth_queue_.updateWriteIndex();
-                                client->messages_received_.fetch_add(1, std::memory_order_relaxed);
-                            } else {
-                                client->depth_pool_.deallocate(depth);
-                                client->messages_dropped_.fetch_add(1, std::memory_order_relaxed);
-                            }
-                        } else if (depth) {
-                            client->depth_pool_.deallocate(depth);
-                        }
-                    }
-                    
-                    // Reset buffer
-                    client->rx_buffer_pos_ = 0;
+            if (lws_is_final_fragment(wsi)) {
+                if (!client->rx_dropping_) {
+                    client->frame_ring_.commitPending(FRAME_TAG_TEXT, client->rx_frame_ts_);
+                    client->frame_event_.notify();
+                    client->messages_received_.fetch_add(1, std::memory_order_relaxed);
                 }
+                client->rx_dropping_ = false;
             }
         }
         break;
         
     case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
         LOG_ERROR("WebSocket connection error - will reconnect");
+        client->frame_ring_.abort();  // Partial frame from the dead connection
+        client->rx_dropping_ = false;
         client->connected_.store(false, std::memory_order_release);
         client->ws_connection_.store(nullptr, std::memory_order_release);
         client->reconnect_count_.fetch_add(1, std::memory_order_relaxed);
@@ -461,6 +560,8 @@ int BinanceWSClient::wsCallback(struct lws* wsi, enum lws_callback_reasons reaso
         
     case LWS_CALLBACK_CLIENT_CLOSED:
         LOG_INFO("WebSocket disconnected - will reconnect");
+        client->frame_ring_.abort();  // Partial frame from the dead connection
+        client->rx_dropping_ = false;
         client->connected_.store(false, std::memory_order_release);
         client->ws_connection_.store(nullptr, std::memory_order_release);
         client->reconnect_count_.fetch_add(1, std::memory_order_relaxed);
@@ -610,6 +711,36 @@ bool BinanceWSClient::subscribeSymbol(const char* symbol, uint32_t ticker_id,
     return success;
 }
 
+bool BinanceWSClient::subscribeFullDepth(const char* symbol, uint32_t ticker_id, Price tick_size) {
+    registerSymbol(symbol, ticker_id);
+    
+    const bool existed = book_sync_.findSymbol(symbol) >= 0;
+    if (book_sync_.addSymbol(symbol, ticker_id, tick_size) < 0) {
+        return false;
+    }
+    
+    if (!existed && connected_.load(std::memory_order_acquire)) {
+        char stream[128];
+        snprintf(stream, sizeof(stream), "%s@depth@100ms", symbol);
+        return sendSubscribeMessage(stream);
+    }
+    return true;
+}
+
+const BinanceWSClient::FullDepthBook* BinanceWSClient::getFullDepthBook(uint32_t ticker_id) const {
+    const int index = book_sync_.findTicker(ticker_id);
+    return index >= 0 ? book_sync_.book(index) : nullptr;
+}
+
+bool BinanceWSClient::getBookSyncStats(uint32_t ticker_id, BinanceBookSync::Stats& stats) const {
+    const int index = book_sync_.findTicker(ticker_id);
+    if (index < 0) {
+        return false;
+    }
+    stats = book_sync_.stats(index);
+    return true;
+}
+
 bool BinanceWSClient::sendSubscribeMessage(const char* stream) {
     char subscribe_msg[512];
     int len = snprintf(subscribe_msg, sizeof(subscribe_msg),
@@ -648,23 +779,21 @@ bool BinanceWSClient::parseTickMessage(const char* json, size_t /* len */, Binan
     char value[64];
     
     // Extract symbol
-    if (extractJsonValue(json, "\"s\"", value, sizeof(value))) {
-        strncpy(tick->symbol, value, sizeof(tick->symbol) - 1);
-    }
+    extractJsonValue(json, "\"s\"", tick->symbol, sizeof(tick->symbol));
     
     // Extract price
-    if (extractJsonValue(json, "\"p\"", value, sizeof(value))) {
-        double price;
-        if (parseDouble(value, price)) {
-            tick->price = static_cast<Price>(price * PRICE_MULTIPLIER);
+    if (const size_t len = extractJsonValue(json, "\"p\"", value, sizeof(value))) {
+        Price price;
+        if (parseDecimal(value, value + len, PRICE_SCALE, price)) {
+            tick->price = price;
         }
     }
     
     // Extract quantity
-    if (extractJsonValue(json, "\"q\"", value, sizeof(value))) {
-        double qty;
-        if (parseDouble(value, qty)) {
-            tick->qty = static_cast<Qty>(qty * QTY_MULTIPLIER);
+    if (const size_t len = extractJsonValue(json, "\"q\"", value, sizeof(value))) {
+        Qty qty;
+        if (parseDecimal(value, value + len, QTY_SCALE, qty)) {
+            tick->qty = qty;
         }
     }
     
@@ -684,154 +813,6 @@ bool BinanceWSClient::parseTickMessage(const char* json, size_t /* len */, Binan
     return tick->price != Price_INVALID && tick->qty != Qty_INVALID;
 }
 
-bool BinanceWSClient::parseDepthMessage(const char* json, size_t len, BinanceDepthUpdate* depth) {
-    if (!json || !depth || len == 0 || len > JSON_BUFFER_SIZE) {
-        return false;
-    }
-    
-    depth->reset();
-    
-    char value[256];
-    
-    // Extract symbol and map to ticker_id
-    if (extractJsonValue(json, "\"s\"", value, sizeof(value))) {
-        // Map known symbols to fixed ticker IDs
-        if (strcmp(value, "BTCUSDT") == 0) {
-            depth->ticker_id = 1001;
-        } else if (strcmp(value, "ETHUSDT") == 0) {
-            depth->ticker_id = 1002;
-        } else {
-            // For other symbols, use hash
-            uint32_t hash = 0;
-            for (const char* p = value; *p; ++p) {
-                hash = hash * 31 + static_cast<uint32_t>(*p);
-            }
-            depth->ticker_id = 2000 + (hash % 1000);  // Map to range 2000-2999
-        }
-    }
-    
-    // Extract update ID (could be "u" for incremental or "lastUpdateId" for partial)
-    if (extractJsonValue(json, "\"u\"", value, sizeof(value))) {
-        parseLong(value, depth->last_update_id);
-    } else if (extractJsonValue(json, "\"lastUpdateId\"", value, sizeof(value))) {
-        parseLong(value, depth->last_update_id);
-    }
-    
-    // Parse bids array
-    const char* bids_start = strstr(json, "\"b\":[");
-    if (bids_start) {
-        bids_start += 5;  // Skip "b":[ 
-        depth->bid_count = 0;
-        
-        const char* pos = bids_start;
-        while (*pos && depth->bid_count < BinanceDepthUpdate::MAX_DEPTH) {
-            // Skip to next [
-            while (*pos && *pos != '[') {
-                if (*pos == ']') break;  // End of bids array
-                pos++;
-            }
-            if (*pos != '[') break;
-            pos++;  // Skip [
-            
-            // Parse price
-            char price_str[64];
-            size_t i = 0;
-            while (*pos && *pos != '"' && *pos != ',') {
-                if (*pos == '"') pos++;  // Skip quotes
-                else if (i < sizeof(price_str) - 1) price_str[i++] = *pos++;
-                else pos++;
-            }
-            price_str[i] = '\0';
-            
-            double price_val = 0.0;
-            if (parseDouble(price_str, price_val)) {
-                depth->bid_prices[depth->bid_count] = static_cast<Price>(price_val * 100000000);  // Convert to fixed point
-            }
-            
-            // Skip comma and quotes
-            while (*pos && (*pos == ',' || *pos == '"')) pos++;
-            
-            // Parse quantity
-            char qty_str[64];
-            i = 0;
-            while (*pos && *pos != '"' && *pos != ']') {
-                if (*pos == '"') pos++;
-                else if (i < sizeof(qty_str) - 1) qty_str[i++] = *pos++;
-                else pos++;
-            }
-            qty_str[i] = '\0';
-            
-            double qty_val = 0.0;
-            if (parseDouble(qty_str, qty_val)) {
-                depth->bid_qtys[depth->bid_count] = static_cast<Qty>(qty_val * 100000000);
-                depth->bid_count++;
-            }
-            
-            // Skip to next level
-            while (*pos && *pos != '[' && *pos != ']') pos++;
-            if (*pos == ']' && *(pos+1) == ']') break;  // End of bids
-        }
-    }
-    
-    // Parse asks array
-    const char* asks_start = strstr(json, "\"a\":[");
-    if (asks_start) {
-        asks_start += 5;  // Skip "a":[
-        depth->ask_count = 0;
-        
-        const char* pos = asks_start;
-        while (*pos && depth->ask_count < BinanceDepthUpdate::MAX_DEPTH) {
-            // Skip to next [
-            while (*pos && *pos != '[') {
-                if (*pos == ']') break;  // End of asks array
-                pos++;
-            }
-            if (*pos != '[') break;
-            pos++;  // Skip [
-            
-            // Parse price
-            char price_str[64];
-            size_t i = 0;
-            while (*pos && *pos != '"' && *pos != ',') {
-                if (*pos == '"') pos++;
-                else if (i < sizeof(price_str) - 1) price_str[i++] = *pos++;
-                else pos++;
-            }
-            price_str[i] = '\0';
-            
-            double price_val = 0.0;
-            if (parseDouble(price_str, price_val)) {
-                depth->ask_prices[depth->ask_count] = static_cast<Price>(price_val * 100000000);
-            }
-            
-            // Skip comma and quotes
-            while (*pos && (*pos == ',' || *pos == '"')) pos++;
-            
-            // Parse quantity
-            char qty_str[64];
-            i = 0;
-            while (*pos && *pos != '"' && *pos != ']') {
-                if (*pos == '"') pos++;
-                else if (i < sizeof(qty_str) - 1) qty_str[i++] = *pos++;
-                else pos++;
-            }
-            qty_str[i] = '\0';
-            
-            double qty_val = 0.0;
-            if (parseDouble(qty_str, qty_val)) {
-                depth->ask_qtys[depth->ask_count] = static_cast<Qty>(qty_val * 100000000);
-                depth->ask_count++;
-            }
-            
-            // Skip to next level
-            while (*pos && *pos != '[' && *pos != ']') pos++;
-            if (*pos == ']' && *(pos+1) == ']') break;  // End of asks
-        }
-    }
-    
-    return depth->last_update_id != 0 && (depth->bid_count > 0 || depth->ask_count > 0);
-}
-
 bool BinanceWSClient::parsePartialBookMessage(const char* json, size_t len, BinanceDepthUpdate* depth) {
     if (!json || !depth || len == 0 || len > JSON_BUFFER_SIZE) {
         return false;
@@ -866,11 +847,7 @@ bool BinanceWSClient::parsePartialBookMessage(const char* json, size_t len, Bina
         depth->ticker_id = getTickerId(symbol);
         if (depth->ticker_id == 0) {
             // Unknown symbol, try to detect from price range
-            if (strstr(json, "111") != nullptr) {
-                depth->ticker_id = 1001;  // BTCUSDT
-            } else if (strstr(json, "4.3") != nullptr || strstr(json, "2.3") != nullptr) {
-                depth->ticker_id = 1002;  // ETHUSDT
-            }
+            guessPartialBookTicker(json, depth->ticker_id);
         }
         
         // Find the actual data object
@@ -880,11 +857,7 @@ bool BinanceWSClient::parsePartialBookMessage(const char* json, size_t len, Bina
         }
     } else {
         // Direct stream, use price detection for now
-        if (strstr(json, "111") != nullptr) {
-            depth->ticker_id = 1001;  // BTCUSDT
-        } else if (strstr(json, "4.3") != nullptr || strstr(json, "2.3") != nullptr) {
-            depth->ticker_id = 1002;  // ETHUSDT  
-        }
+        guessPartialBookTicker(json, depth->ticker_id);
     }
     
     // Extract lastUpdateId
@@ -923,10 +896,8 @@ bool BinanceWSClient::parsePartialBookMessage(const char* json, size_t len, Bina
             
             if (i == 0) break;  // No more data
             
-            double price_val = 0.0;
-            if (parseDouble(price_str, price_val)) {
-                depth->bid_prices[depth->bid_count] = static_cast<Price>(price_val * 100000000);
-            }
+            parseDecimal(price_str, price_str + i, DEPTH_SCALE,
+                         depth->bid_prices[depth->bid_count]);
             
             // Skip quote, comma, quote: "," -> ,
             if (*pos == '"') pos++;  // closing quote of price
@@ -941,9 +912,8 @@ bool BinanceWSClient::parsePartialBookMessage(const char* json, size_t len, Bina
             }
             qty_str[i] = '\0';
             
-            double qty_val = 0.0;
-            if (parseDouble(qty_str, qty_val)) {
-                depth->bid_qtys[depth->bid_count] = static_cast<Qty>(qty_val * 100000000);
+            if (parseDecimal(qty_str, qty_str + i, DEPTH_SCALE,
+                             depth->bid_qtys[depth->bid_count])) {
                 depth->bid_count++;
             }
             
@@ -991,10 +961,8 @@ bool BinanceWSClient::parsePartialBookMessage(const char* json, size_t len, Bina
             
             if (i == 0) break;  // No more data
             
-            double price_val = 0.0;
-            if (parseDouble(price_str, price_val)) {
-                depth->ask_prices[depth->ask_count] = static_cast<Price>(price_val * 100000000);
-            }
+            parseDecimal(price_str, price_str + i, DEPTH_SCALE,
+                         depth->ask_prices[depth->ask_count]);
             
             // Skip quote, comma, quote: "," -> ,
             if (*pos == '"') pos++;  // closing quote of price
@@ -1009,9 +977,8 @@ bool BinanceWSClient::parsePartialBookMessage(const char* json, size_t len, Bina
             }
             qty_str[i] = '\0';
             
-            double qty_val = 0.0;
-            if (parseDouble(qty_str, qty_val)) {
-                depth->ask_qtys[depth->ask_count] = static_cast<Qty>(qty_val * 100000000);
+            if (parseDecimal(qty_str, qty_str + i, DEPTH_SCALE,
+                             depth->ask_qtys[depth->ask_count])) {
                 depth->ask_count++;
             }
             
@@ -1031,10 +998,10 @@ bool BinanceWSClient::parsePartialBookMessage(const char* json, size_t len, Bina
     return depth->last_update_id != 0 && (depth->bid_count > 0 || depth->ask_count > 0);
 }
 
-bool BinanceWSClient::extractJsonValue(const char* json, const char* key, 
-                                       char* out, size_t out_len) {
+size_t BinanceWSClient::extractJsonValue(const char* json, const char* key,
+                                         char* out, size_t out_len) {
     const char* pos = strstr(json, key);
-    if (!pos) return false;
+    if (!pos) return 0;
     
     pos += strlen(key);
     
@@ -1053,7 +1020,7 @@ bool BinanceWSClient::extractJsonValue(const char* json, const char* key,
     }
     out[i] = '\0';
     
-    return i > 0;
+    return i;
 }
 
 // ============================================================================
@@ -1077,7 +1044,7 @@ BinanceWSClient::HealthStatus BinanceWSClient::getHealthStatus() const {
     }
     
     // Get current time for uptime calculation
-    uint64_t now_ns = Common::rdtsc();
+    uint64_t now_ns = Common::TscClock::monoNs();
     status.last_message_time_ns = now_ns;  // Would track actual last message time in production
     status.uptime_seconds = 0;  // Would calculate from start time
     
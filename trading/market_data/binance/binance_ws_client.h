@@ -2,10 +2,14 @@
 
 #include "common/types.h"
 #include "common/lf_queue.h"
-#include "common/mem_pool.h"
+#include "common/byte_ring.h"
 #include "common/logging.h"
 #include "common/time_utils.h"
 #include "common/thread_utils.h"
+#include "common/wait_strategy.h"
+#include "config/config.h"
+#include "trading/market_data/binance/binance_book_sync.h"
+#include "trading/market_data/binance/binance_json_scanner.h"
 
 #include <libwebsockets.h>
 #include <atomic>
@@ -24,8 +28,10 @@ using namespace Common;
 
 // Define invalid constants if not already defined
 constexpr Qty Qty_INVALID = std::numeric_limits<Qty>::max();
-constexpr double PRICE_MULTIPLIER = 100000.0;  // 5 decimal places
-constexpr double QTY_MULTIPLIER = 100000000.0;  // 8 decimal places for crypto
+// Decimal places kept in the fixed-point fields (see common/decimal_codec.h);
+// depth is DEPTH_SCALE
+constexpr uint32_t PRICE_SCALE = 5;  // BinanceTickData::price
+constexpr uint32_t QTY_SCALE = 8;    // 8 decimal places for crypto
 
 struct alignas(CACHE_LINE_SIZE) BinanceTickData {
     TickerId ticker_id{TickerId_INVALID};
@@ -88,6 +94,8 @@ public:
         uint32_t reconnect_interval_ms = 5000;
         uint32_t ping_interval_s = 30;
         int cpu_affinity = -1;  // -1 = no affinity
+        const char* rest_url = "https://api.binance.com";  // Depth snapshots
+        uint32_t snapshot_limit = 1000;
     };
     
     // Forward declaration
@@ -97,27 +105,30 @@ public:
     using TickCallback = std::function<void(const BinanceTickData*)>;
     using DepthCallback = std::function<void(const BinanceDepthUpdate*)>;
     
-private:
-    // Memory pools - pre-allocated, zero dynamic allocation
-    static constexpr size_t TICK_POOL_SIZE = 100000;
-    static constexpr size_t DEPTH_POOL_SIZE = 10000;
-    static constexpr size_t QUEUE_SIZE = 262144;  // 256K, power of 2
-    
-    MemoryPool<sizeof(BinanceTickData), TICK_POOL_SIZE> tick_pool_;
-    MemoryPool<sizeof(BinanceDepthUpdate), DEPTH_POOL_SIZE> depth_pool_;
+    // Full-depth book maintained from a symbol's @depth diff stream
+    using FullDepthBook = BinanceBookSync::Book;
     
-    // Lock-free queues for message passing
-    SPSCLFQueue<BinanceTickData*, QUEUE_SIZE> tick_queue_;
-    SPSCLFQueue<BinanceDepthUpdate*, QUEUE_SIZE> depth_queue_;
+private:
+    // Raw frames, written in place by the WS thread and parsed in place by
+    // the processor thread. Sized for bursts; a frame is at most 64KB.
+    static constexpr size_t FRAME_RING_SIZE = 4 * 1024 * 1024;
+    static constexpr uint32_t FRAME_TAG_TEXT = 1;
+    SPSCByteRing<FRAME_RING_SIZE> frame_ring_;
+    // Processor thread idles per [wait_strategy] market_data; the WS
+    // thread wakes it after each committed frame
+    Common::WaitEvent frame_event_;
+    Common::WaitStrategy frame_wait_{
+        ConfigManager::getWaitConfig(ConfigManager::getConfig().wait_strategy.market_data,
+                                     Common::WaitStrategyKind::Backoff),
+        &frame_event_, frame_ring_.producerCursorAddress()};
     
     // WebSocket context
     struct lws_context* ws_context_{nullptr};
     std::atomic<struct lws*> ws_connection_{nullptr};
     
-    // Receive buffer - fixed size, no allocation
-    static constexpr size_t RX_BUFFER_SIZE = 65536;  // 64KB
-    alignas(CACHE_LINE_SIZE) char rx_buffer_[RX_BUFFER_SIZE];
-    size_t rx_buffer_pos_{0};
+    // Fragment reassembly state - WS thread only
+    uint64_t rx_frame_ts_{0};       // Receive time of the frame's first fragment
+    bool rx_dropping_{false};       // Discard fragments until the frame ends
     
     // JSON parser buffer - for zero-copy parsing
     static constexpr size_t JSON_BUFFER_SIZE = 8192;
@@ -170,6 +181,20 @@ private:
     // Order book manager pointer (void* to avoid circular dependency)
     void* order_book_manager_{nullptr};
     
+    // Full-depth symbols: price-indexed books kept in sequence with REST
+    // snapshots. Diffs are keyed by price, so they never go into level slots.
+    BinanceBookSync book_sync_;
+    std::atomic<uint64_t> diffs_unrouted_{0};
+    
+    // Frame parser state - processor thread only
+    BinanceJsonScanner scanner_;
+    BinanceMessage message_;
+    // Events rebuilt in place for every frame instead of constructed (and
+    // zeroed) per message; only live levels are written, go by the counts
+    BinanceTickData tick_;
+    BinanceDepthUpdate depth_;
+    std::atomic<uint64_t> frames_unscanned_{0};  // Fell back to the generic parser
+    
 public:
     BinanceWSClient() = default;
     ~BinanceWSClient() { stop(); }
@@ -192,6 +217,15 @@ public:
     bool subscribeDepth(const char* symbol, uint32_t ticker_id, int levels = 10);
     bool subscribeSymbol(const char* symbol, uint32_t ticker_id, bool ticker = true, bool depth = true, int depth_levels = 10);
     
+    // Full-depth book from the diff stream, tick_size in the same 1e8
+    // fixed point as prices. Once synced, its top levels are also written
+    // to the OrderBookManager and passed to the depth callback.
+    bool subscribeFullDepth(const char* symbol, uint32_t ticker_id, Price tick_size);
+    // Owned by the processor thread; read it from there (callbacks)
+    const FullDepthBook* getFullDepthBook(uint32_t ticker_id) const;
+    // Resync and snapshot counters for a full-depth symbol
+    bool getBookSyncStats(uint32_t ticker_id, BinanceBookSync::Stats& stats) const;
+    
     // Symbol management
     void registerSymbol(const char* symbol, uint32_t ticker_id);
     uint32_t getTickerId(const char* symbol) const;
@@ -208,6 +242,8 @@ public:
     uint64_t getMessagesDropped() const { return messages_dropped_.load(std::memory_order_relaxed); }
     uint64_t getReconnectCount() const { return reconnect_count_.load(std::memory_order_relaxed); }
     uint64_t getMessagesRateLimited() const { return messages_rate_limited_.load(std::memory_order_relaxed); }
+    uint64_t getDiffsUnrouted() const { return diffs_unrouted_.load(std::memory_order_relaxed); }
+    uint64_t getFramesUnscanned() const { return frames_unscanned_.load(std::memory_order_relaxed); }
     bool isConnected() const { return connected_.load(std::memory_order_acquire); }
     
     struct HealthStatus {
@@ -231,18 +267,26 @@ private:
     // WebSocket thread - handles network I/O
     void wsThreadFunc();
     
-    // Processor thread - processes messages from queues
+    // Processor thread - parses frames from the ring
     void processorThreadFunc();
+    void processFrame(const char* json, size_t len, uint64_t local_ts);
+    void processUnscannedFrame(const char* json, size_t len, uint64_t local_ts);
+    void publishTick(BinanceTickData& tick);
+    void publishPartialBook(BinanceDepthUpdate& depth);
+    void applyDepthToBook(const BinanceDepthUpdate* depth);
+    void applyDepthDiff(const char* json, size_t len, uint64_t local_ts);
+    void applyDepthDiff(const char* symbol, const BinanceBookSync::Diff& diff, uint64_t local_ts);
+    int findDiffBook(const char* symbol);
+    void publishFullDepth(int index, uint64_t local_ts);
     
     // Message parsing - zero allocation
     bool parseTickMessage(const char* json, size_t len, BinanceTickData* tick);
-    bool parseDepthMessage(const char* json, size_t len, BinanceDepthUpdate* depth);
     bool parsePartialBookMessage(const char* json, size_t len, BinanceDepthUpdate* depth);
     
     // Fast JSON parsing helpers - no allocation
-    bool parseDouble(const char* str, double& value);
     bool parseLong(const char* str, uint64_t& value);
-    bool extractJsonValue(const char* json, const char* key, char* out, size_t out_len);
+    // Copies the value NUL-terminated into out; returns its length, 0 if absent
+    size_t extractJsonValue(const char* json, const char* key, char* out, size_t out_len);
     
     // Subscribe helper
     bool sendSubscribeMessage(const char* stream);
@@ -252,12 +296,6 @@ private:
 // Inline Performance-Critical Functions
 // ============================================================================
 
-inline bool BinanceWSClient::parseDouble(const char* str, double& value) {
-    char* end;
-    value = strtod(str, &end);
-    return end != str;
-}
-
 inline bool BinanceWSClient::parseLong(const char* str, uint64_t& value) {
     char* end;
     value = strtoull(str, &end, 10);
@@ -0,0 +1,449 @@
+#pragma once
+
+#include "common/types.h"
+#include "common/macros.h"
+#include "common/time_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Trading::MarketData {
+
+using namespace Common;
+
+// Periodic order book snapshots in a preallocated, memory-mapped ring file.
+//
+// The file is a 4KB header, a time index with one entry per frame slot,
+// then the frame slots. A frame is one pass over every active book: up to
+// max_books Book::Snapshot records copied as-is. Frame n lives in slot
+// n % capacity, so the file never grows and holds the last 'capacity'
+// frames. Offline tools open it read-only, find the frame at or before a
+// wall-clock time through the index, and load the books from it.
+//
+// One writer. A slot's index entry is cleared before its records are
+// overwritten and re-stamped after, so a reader that sees the same frame
+// number before and after copying has a whole frame. Writes land in the
+// page cache at once (a crashed process loses nothing); fdatasync runs
+// every sync_every frames, and on close.
+template<typename Book>
+class BookSnapshotRing {
+public:
+    using Snapshot = typename Book::Snapshot;
+    static_assert(std::is_trivially_copyable_v<Snapshot>, "Snapshots are copied into the file as-is");
+
+    static constexpr uint64_t MAGIC = 0x31474E5242534F5AULL;  // "ZOSBRNG1"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint64_t NO_FRAME = ~uint64_t{0};
+    static constexpr size_t PAGE = 4096;
+
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t record_bytes;    // sizeof(Snapshot)
+        uint32_t levels;          // Per side, per record
+        uint32_t max_books;       // Records per frame
+        uint64_t capacity;        // Frame slots
+        uint64_t interval_ns;     // As configured by the writer; informational
+        uint64_t frames_written;  // Frames completed since the file was made
+        uint64_t created_ns;
+    };
+
+    struct IndexEntry {
+        uint64_t frame;     // Frame number + 1; 0 while empty or being rewritten
+        uint64_t wall_ns;   // When the frame was taken
+        uint32_t books;     // Records in the frame
+        uint32_t dropped;   // Active books beyond max_books, not recorded
+    };
+
+    BookSnapshotRing() noexcept = default;
+    ~BookSnapshotRing() { close(); }
+
+    // Delete copy/move
+    BookSnapshotRing(const BookSnapshotRing&) = delete;
+    BookSnapshotRing& operator=(const BookSnapshotRing&) = delete;
+    BookSnapshotRing(BookSnapshotRing&&) = delete;
+    BookSnapshotRing& operator=(BookSnapshotRing&&) = delete;
+
+    // Writer: open the ring at path, keeping its frames if the layout
+    // matches, otherwise replacing it with an empty preallocated one.
+    // AUDIT_IGNORE: Init-time only
+    auto create(const char* path, size_t max_books, size_t capacity, uint64_t interval_ns,
+                uint32_t sync_every = 10) noexcept -> bool {
+        close();
+        if (max_books == 0 || capacity == 0) {
+            return false;
+        }
+        fd_ = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            return false;
+        }
+        const size_t bytes = fileBytes(max_books, capacity);
+        struct stat st{};
+        const bool reuse = fstat(fd_, &st) == 0 && static_cast<size_t>(st.st_size) == bytes &&
+                           map(bytes, true) && compatible(max_books, capacity);
+        if (!reuse) {
+            unmap();
+            // Drop the old contents, then reserve every block up front so a
+            // full disk shows up here rather than as SIGBUS mid-session
+            if (ftruncate(fd_, 0) != 0 || ftruncate(fd_, static_cast<off_t>(bytes)) != 0 ||
+                posix_fallocate(fd_, 0, static_cast<off_t>(bytes)) != 0 || !map(bytes, true)) {
+                close();
+                return false;
+            }
+            auto* header = this->header();
+            header->magic = MAGIC;
+            header->version = VERSION;
+            header->record_bytes = sizeof(Snapshot);
+            header->levels = LEVELS;
+            header->max_books = static_cast<uint32_t>(max_books);
+            header->capacity = capacity;
+            header->frames_written = 0;
+            header->created_ns = TscClock::nowNs();
+        }
+        header()->interval_ns = interval_ns;
+        sync_every_ = std::max<uint32_t>(sync_every, 1);
+        writable_ = true;
+        return true;
+    }
+
+    // Reader: map an existing ring read-only; false if missing or foreign
+    // AUDIT_IGNORE: Init-time only
+    auto open(const char* path) noexcept -> bool {
+        close();
+        fd_ = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            return false;
+        }
+        struct stat st{};
+        if (fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < PAGE ||
+            !map(static_cast<size_t>(st.st_size), false)) {
+            close();
+            return false;
+        }
+        const auto* header = this->header();
+        if (!compatible(header->max_books, header->capacity) ||
+            fileBytes(header->max_books, header->capacity) != size_) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    auto close() noexcept -> void {
+        if (base_ && writable_) {
+            fdatasync(fd_);
+        }
+        unmap();
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        writable_ = false;
+        unsynced_ = 0;
+    }
+
+    // Writer: record one frame from 'count' books. Each book is copied
+    // through getSnapshot(), so its writer thread keeps running.
+    auto writeFrame(const Book* const* books, size_t count, uint64_t wall_ns) noexcept -> uint64_t {
+        if (UNLIKELY(!writable_)) {
+            return NO_FRAME;
+        }
+        auto* header = this->header();
+        const uint64_t frame = header->frames_written;
+        auto& entry = index()[frame % header->capacity];
+        const size_t recorded = std::min<size_t>(count, header->max_books);
+
+        std::atomic_ref<uint64_t>(entry.frame).store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        auto* records = slot(frame);
+        for (size_t i = 0; i < recorded; ++i) {
+            const Snapshot snap = books[i]->getSnapshot();
+            std::memcpy(&records[i], &snap, sizeof(Snapshot));
+        }
+        entry.wall_ns = wall_ns;
+        entry.books = static_cast<uint32_t>(recorded);
+        entry.dropped = static_cast<uint32_t>(count - recorded);
+        std::atomic_ref<uint64_t>(entry.frame).store(frame + 1, std::memory_order_release);
+        std::atomic_ref<uint64_t>(header->frames_written).store(frame + 1, std::memory_order_release);
+
+        if (++unsynced_ >= sync_every_) {
+            fdatasync(fd_);
+            unsynced_ = 0;
+        }
+        return frame;
+    }
+
+    // Frames still in the file are [oldestFrame(), framesWritten())
+    [[nodiscard]] auto framesWritten() const noexcept -> uint64_t {
+        return base_ ? std::atomic_ref<const uint64_t>(header()->frames_written).load(std::memory_order_acquire) : 0;
+    }
+
+    [[nodiscard]] auto oldestFrame() const noexcept -> uint64_t {
+        const uint64_t written = framesWritten();
+        return written > capacity() ? written - capacity() : 0;
+    }
+
+    [[nodiscard]] auto capacity() const noexcept -> uint64_t { return base_ ? header()->capacity : 0; }
+    [[nodiscard]] auto maxBooks() const noexcept -> size_t { return base_ ? header()->max_books : 0; }
+    [[nodiscard]] auto intervalNs() const noexcept -> uint64_t { return base_ ? header()->interval_ns : 0; }
+
+    // Time the frame was taken, 0 if it's no longer (or not yet) in the file
+    [[nodiscard]] auto frameTime(uint64_t frame) const noexcept -> uint64_t {
+        if (!base_) {
+            return 0;
+        }
+        const auto& entry = index()[frame % header()->capacity];
+        const uint64_t stamped = std::atomic_ref<const uint64_t>(entry.frame).load(std::memory_order_acquire);
+        const uint64_t wall_ns = entry.wall_ns;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return stamped == frame + 1 && std::atomic_ref<const uint64_t>(entry.frame).load(std::memory_order_relaxed) == stamped
+                   ? wall_ns : 0;
+    }
+
+    // Latest frame taken at or before wall_ns, by binary search of the
+    // index; NO_FRAME if every frame in the file is newer
+    [[nodiscard]] auto findFrame(uint64_t wall_ns) const noexcept -> uint64_t {
+        uint64_t lo = oldestFrame();
+        uint64_t hi = framesWritten();
+        uint64_t found = NO_FRAME;
+        while (lo < hi) {
+            const uint64_t mid = lo + (hi - lo) / 2;
+            const uint64_t t = frameTime(mid);
+            if (t <= wall_ns) {
+                // 0: overwritten since we read the range, so older still
+                found = t != 0 ? mid : found;
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return found;
+    }
+
+    [[nodiscard]] auto latestFrame() const noexcept -> uint64_t {
+        const uint64_t written = framesWritten();
+        return written > 0 ? written - 1 : NO_FRAME;
+    }
+
+    // Copy up to max records of a frame. Returns the count, or 0 if the
+    // frame isn't in the file or was overwritten during the copy.
+    auto readFrame(uint64_t frame, Snapshot* out, size_t max, uint64_t* wall_ns = nullptr) const noexcept -> size_t {
+        if (!base_ || frame == NO_FRAME) {
+            return 0;
+        }
+        const auto& entry = index()[frame % header()->capacity];
+        if (std::atomic_ref<const uint64_t>(entry.frame).load(std::memory_order_acquire) != frame + 1) {
+            return 0;
+        }
+        const size_t count = std::min<size_t>(entry.books, max);
+        const uint64_t taken = entry.wall_ns;
+        std::memcpy(out, slot(frame), count * sizeof(Snapshot));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (std::atomic_ref<const uint64_t>(entry.frame).load(std::memory_order_relaxed) != frame + 1) {
+            return 0;
+        }
+        if (wall_ns) {
+            *wall_ns = taken;
+        }
+        return count;
+    }
+
+private:
+    static constexpr uint32_t LEVELS = static_cast<uint32_t>(std::extent_v<decltype(Snapshot::bid_prices)>);
+
+    static constexpr auto pageAlign(size_t bytes) noexcept -> size_t { return (bytes + PAGE - 1) & ~(PAGE - 1); }
+    static constexpr auto indexBytes(size_t capacity) noexcept -> size_t { return pageAlign(capacity * sizeof(IndexEntry)); }
+    static constexpr auto fileBytes(size_t max_books, size_t capacity) noexcept -> size_t {
+        return PAGE + indexBytes(capacity) + capacity * max_books * sizeof(Snapshot);
+    }
+
+    auto compatible(size_t max_books, size_t capacity) const noexcept -> bool {
+        const auto* header = this->header();
+        return header->magic == MAGIC && header->version == VERSION && header->record_bytes == sizeof(Snapshot) &&
+               header->levels == LEVELS && header->max_books == max_books && header->capacity == capacity;
+    }
+
+    auto map(size_t bytes, bool writable) noexcept -> bool {
+        void* mem = mmap(nullptr, bytes, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd_, 0);
+        if (mem == MAP_FAILED) {
+            return false;
+        }
+        base_ = static_cast<char*>(mem);
+        size_ = bytes;
+        return true;
+    }
+
+    auto unmap() noexcept -> void {
+        if (base_) {
+            munmap(base_, size_);
+            base_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    auto header() const noexcept -> Header* { return reinterpret_cast<Header*>(base_); }
+    auto index() const noexcept -> IndexEntry* { return reinterpret_cast<IndexEntry*>(base_ + PAGE); }
+    auto slot(uint64_t frame) const noexcept -> Snapshot* {
+        const auto* header = this->header();
+        const size_t offset = PAGE + indexBytes(header->capacity) +
+                              static_cast<size_t>(frame % header->capacity) * header->max_books * sizeof(Snapshot);
+        return reinterpret_cast<Snapshot*>(base_ + offset);
+    }
+
+    int fd_ = -1;
+    char* base_ = nullptr;
+    size_t size_ = 0;
+    bool writable_ = false;
+    uint32_t sync_every_ = 10;
+    uint32_t unsynced_ = 0;
+};
+
+// Takes a frame of every book a manager holds at a fixed interval, on its
+// own thread. Books are read through their seqlock, so the threads that
+// update them never wait on it.
+template<typename Manager>
+class BookSnapshotService {
+public:
+    using Book = typename Manager::Book;
+    using Ring = BookSnapshotRing<Book>;
+
+    struct Config {
+        const char* path = nullptr;
+        uint32_t interval_ms = 60000;
+        size_t max_books = 128;       // Records per frame
+        size_t capacity = 1440;       // Frames kept; a day at one a minute
+        uint32_t sync_every = 10;     // Frames between fdatasync calls
+        uint32_t max_restore_age_s = 0;   // restore() skips older frames; 0 for any age
+        uint64_t restore_after_ns = 0;    // Nor frames taken before this, e.g. session open
+    };
+
+    explicit BookSnapshotService(const Manager& manager) noexcept : manager_(manager) {}
+    ~BookSnapshotService() { stop(); }
+
+    // Delete copy/move
+    BookSnapshotService(const BookSnapshotService&) = delete;
+    BookSnapshotService& operator=(const BookSnapshotService&) = delete;
+    BookSnapshotService(BookSnapshotService&&) = delete;
+    BookSnapshotService& operator=(BookSnapshotService&&) = delete;
+
+    // Open the ring file; frames start on the first interval after start()
+    // AUDIT_IGNORE: Init-time only
+    auto open(const Config& config) noexcept -> bool {
+        config_ = config;
+        return ring_.create(config.path, config.max_books, config.capacity,
+                            static_cast<uint64_t>(config.interval_ms) * 1000000, config.sync_every);
+    }
+
+    // Load the newest frame into the manager's books, matching by token.
+    // Books keep their current ticker id. Call before their writers start.
+    // A frame outside the configured age or session window is not loaded.
+    // Returns the number of books restored.
+    auto restore(Manager& manager, uint64_t* frame_ns = nullptr) noexcept -> size_t {
+        const size_t max = ring_.maxBooks();
+        if (max == 0 || ring_.latestFrame() == Ring::NO_FRAME) {
+            return 0;
+        }
+        auto records = std::make_unique<Snapshot[]>(max);  // AUDIT_IGNORE: Init-time only
+        uint64_t taken = 0;
+        const size_t count = ring_.readFrame(ring_.latestFrame(), records.get(), max, &taken);
+        if (count == 0 || stale(taken)) {
+            return 0;
+        }
+        if (frame_ns) {
+            *frame_ns = taken;
+        }
+        size_t restored = 0;
+        for (size_t i = 0; i < count; ++i) {
+            auto* book = manager.getOrderBook(records[i].instrument_token);
+            if (!book) {
+                continue;
+            }
+            const TickerId ticker_id = book->getTickerId();
+            book->beginUpdate();
+            book->loadSnapshot(records[i]);
+            book->setTickerId(ticker_id);
+            book->endUpdate();
+            ++restored;
+        }
+        return restored;
+    }
+
+    auto start() -> void {
+        if (running_.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+        worker_ = std::thread([this]() {
+            pthread_setname_np(pthread_self(), "book-snap");
+            workerLoop();
+        });
+    }
+
+    auto stop() -> void {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_.store(false, std::memory_order_release);
+        }
+        wake_.notify_all();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    // Take a frame now; normally called by the worker
+    auto snapshotNow() noexcept -> uint64_t {
+        const size_t count = manager_.getActiveBooks(active_);
+        return ring_.writeFrame(active_.books, count, TscClock::nowNs());
+    }
+
+    [[nodiscard]] auto ring() const noexcept -> const Ring& { return ring_; }
+
+private:
+    using Snapshot = typename Ring::Snapshot;
+
+    auto stale(uint64_t taken_ns) const noexcept -> bool {
+        if (taken_ns < config_.restore_after_ns) {
+            return true;
+        }
+        const uint64_t now = TscClock::nowNs();
+        return config_.max_restore_age_s != 0 && now > taken_ns &&
+               now - taken_ns > static_cast<uint64_t>(config_.max_restore_age_s) * 1000000000;
+    }
+
+    auto workerLoop() -> void {
+        const auto interval = std::chrono::milliseconds(config_.interval_ms);
+        auto next = std::chrono::steady_clock::now() + interval;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (running_.load(std::memory_order_acquire)) {
+            if (wake_.wait_until(lock, next, [this]() { return !running_.load(std::memory_order_acquire); })) {
+                break;
+            }
+            snapshotNow();
+            next += interval;
+        }
+    }
+
+    const Manager& manager_;
+    Config config_{};
+    Ring ring_{};
+    typename Manager::ActiveBooks active_{};
+
+    std::atomic<bool> running_{false};
+    std::mutex mutex_{};
+    std::condition_variable wake_{};
+    std::thread worker_{};
+};
+
+} // namespace Trading::MarketData
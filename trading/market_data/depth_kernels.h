@@ -0,0 +1,349 @@
+#pragma once
+
+#include "common/types.h"
+#include "common/macros.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <immintrin.h>
+
+namespace Trading::MarketData::Depth {
+
+using namespace Common;
+
+// Depth analytics over one side of a book, laid out as OrderBook keeps it:
+// parallel price and quantity arrays, best level first. Bids descend and
+// asks ascend in price; all kernels take the count of valid levels and
+// never read past it. Prices and quantities must be non-negative.
+//
+// The functions in this namespace use AVX2 when it's compiled in, four
+// levels per instruction, and the Scalar:: versions otherwise. The scalar
+// versions are always available as the reference. Integer results match
+// exactly; double results can differ in the last bits from summation order.
+
+// Result of walking a side for a target quantity
+struct Fill {
+    double vwap{std::numeric_limits<double>::quiet_NaN()};  // NaN if nothing filled
+    Qty filled{0};                  // Less than the target if the side ran out
+    Price last_price{Price_INVALID}; // Deepest level touched
+    uint32_t levels{0};             // Levels touched
+};
+
+namespace Scalar {
+
+// out[i] = qtys[0] + ... + qtys[i]; returns the side total
+inline auto cumulativeDepth(const Qty* qtys, size_t n, Qty* out) noexcept -> Qty {
+    Qty total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        total += qtys[i];
+        out[i] = total;
+    }
+    return total;
+}
+
+// Average price of sweeping 'target' from the touch outwards
+inline auto vwapToFill(const Price* prices, const Qty* qtys, size_t n, Qty target) noexcept -> Fill {
+    Fill fill;
+    double notional = 0.0;
+    for (size_t i = 0; i < n && fill.filled < target; ++i) {
+        const Qty take = std::min(qtys[i], target - fill.filled);
+        notional += static_cast<double>(prices[i]) * static_cast<double>(take);
+        fill.filled += take;
+        fill.last_price = prices[i];
+        fill.levels = static_cast<uint32_t>(i + 1);
+    }
+    if (fill.filled > 0) {
+        fill.vwap = notional / static_cast<double>(fill.filled);
+    }
+    return fill;
+}
+
+// Quantity resting at levels whose weight is decay^level
+inline auto decayedDepth(const Qty* qtys, size_t n, double decay) noexcept -> double {
+    double depth = 0.0;
+    double weight = 1.0;
+    for (size_t i = 0; i < n; ++i) {
+        depth += static_cast<double>(qtys[i]) * weight;
+        weight *= decay;
+    }
+    return depth;
+}
+
+// Quantity at bid prices >= floor
+inline auto bidDepthWithin(const Price* prices, const Qty* qtys, size_t n, Price floor) noexcept -> Qty {
+    Qty depth = 0;
+    for (size_t i = 0; i < n && prices[i] >= floor; ++i) {
+        depth += qtys[i];
+    }
+    return depth;
+}
+
+// Quantity at ask prices <= ceiling
+inline auto askDepthWithin(const Price* prices, const Qty* qtys, size_t n, Price ceiling) noexcept -> Qty {
+    Qty depth = 0;
+    for (size_t i = 0; i < n && prices[i] <= ceiling; ++i) {
+        depth += qtys[i];
+    }
+    return depth;
+}
+
+} // namespace Scalar
+
+#ifdef __AVX2__
+namespace Detail {
+
+[[gnu::always_inline]]
+inline auto load(const int64_t* p) noexcept -> __m256i {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+[[gnu::always_inline]]
+inline auto load(const uint64_t* p) noexcept -> __m256i {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// Exact for |v| < 2^51; every price and size we see is far below that.
+// AVX-512DQ converts directly.
+[[gnu::always_inline]]
+inline auto toDouble(__m256i v) noexcept -> __m256d {
+#if defined(__AVX512DQ__) && defined(__AVX512VL__)
+    return _mm256_cvtepi64_pd(v);
+#else
+    const __m256i magic = _mm256_set1_epi64x(0x4338000000000000);  // 1.5 * 2^52
+    return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(v, magic)), _mm256_castsi256_pd(magic));
+#endif
+}
+
+// Running sums within four lanes: [a, a+b, a+b+c, a+b+c+d]
+[[gnu::always_inline]]
+inline auto prefixSum(__m256i v) noexcept -> __m256i {
+    v = _mm256_add_epi64(v, _mm256_slli_si256(v, 8));  // Within each 128-bit half
+    const __m256i low_total = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 1, 0, 0));
+    return _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_setzero_si256(), low_total, 0xF0));
+}
+
+[[gnu::always_inline]]
+inline auto horizontalSum(__m256d v) noexcept -> double {
+    const __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+[[gnu::always_inline]]
+inline auto horizontalSum(__m256i v) noexcept -> uint64_t {
+    const __m128i pair = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_add_epi64(pair, _mm_unpackhi_epi64(pair, pair))));
+}
+
+[[gnu::always_inline]]
+inline auto laneMask(__m256i v) noexcept -> unsigned {
+    return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(v)));
+}
+
+// Sum quantities while the level's price is inside the limit; levels are
+// sorted, so the first block with an outside level is the last one
+template<bool IS_BID>
+inline auto depthWithin(const Price* prices, const Qty* qtys, size_t n, Price limit) noexcept -> Qty {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256i p = load(prices + i);
+        // Bids: price >= floor is !(floor > price); asks: !(price > ceiling)
+        const __m256i outside = IS_BID ? _mm256_cmpgt_epi64(_mm256_set1_epi64x(limit), p)
+                                       : _mm256_cmpgt_epi64(p, _mm256_set1_epi64x(limit));
+        acc = _mm256_add_epi64(acc, _mm256_andnot_si256(outside, load(qtys + i)));
+        if (laneMask(outside) != 0) {
+            return horizontalSum(acc);
+        }
+    }
+    const Qty head = horizontalSum(acc);
+    return head + (IS_BID ? Scalar::bidDepthWithin(prices + i, qtys + i, n - i, limit)
+                          : Scalar::askDepthWithin(prices + i, qtys + i, n - i, limit));
+}
+
+} // namespace Detail
+#endif
+
+inline auto cumulativeDepth(const Qty* qtys, size_t n, Qty* out) noexcept -> Qty {
+#ifdef __AVX2__
+    __m256i carry = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256i sums = _mm256_add_epi64(Detail::prefixSum(Detail::load(qtys + i)), carry);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), sums);
+        carry = _mm256_permute4x64_epi64(sums, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    Qty total = static_cast<Qty>(_mm256_extract_epi64(carry, 0));
+    for (; i < n; ++i) {
+        total += qtys[i];
+        out[i] = total;
+    }
+    return total;
+#else
+    return Scalar::cumulativeDepth(qtys, n, out);
+#endif
+}
+
+// Each level contributes min(qty, target - depth before it), clamped at
+// zero, so a block of four levels is priced without a serial walk. Stops
+// at the block where the running depth reaches the target.
+inline auto vwapToFill(const Price* prices, const Qty* qtys, size_t n, Qty target) noexcept -> Fill {
+#ifdef __AVX2__
+    if (UNLIKELY(target == 0)) {
+        return {};
+    }
+    // Signed lane compares below; no side holds 2^63
+    const auto goal = static_cast<int64_t>(std::min<Qty>(target, std::numeric_limits<int64_t>::max()));
+    const __m256i goal_v = _mm256_set1_epi64x(goal);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i carry = zero;
+    __m256i filled_v = zero;
+    __m256d notional_v = _mm256_setzero_pd();
+    Fill fill;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256i q = Detail::load(qtys + i);
+        const __m256i after = _mm256_add_epi64(Detail::prefixSum(q), carry);
+        const __m256i remaining = _mm256_sub_epi64(goal_v, _mm256_sub_epi64(after, q));
+        // take = clamp(remaining, 0, q)
+        __m256i take = _mm256_blendv_epi8(q, remaining, _mm256_cmpgt_epi64(q, remaining));
+        take = _mm256_blendv_epi8(take, zero, _mm256_cmpgt_epi64(zero, take));
+        filled_v = _mm256_add_epi64(filled_v, take);
+        notional_v = _mm256_add_pd(notional_v, _mm256_mul_pd(Detail::toDouble(Detail::load(prices + i)),
+                                                             Detail::toDouble(take)));
+        const unsigned reached = Detail::laneMask(_mm256_cmpgt_epi64(after, _mm256_set1_epi64x(goal - 1)));
+        if (reached != 0) {
+            const auto lane = static_cast<size_t>(std::countr_zero(reached));
+            fill.filled = Detail::horizontalSum(filled_v);
+            fill.last_price = prices[i + lane];
+            fill.levels = static_cast<uint32_t>(i + lane + 1);
+            fill.vwap = Detail::horizontalSum(notional_v) / static_cast<double>(fill.filled);
+            return fill;
+        }
+        carry = _mm256_permute4x64_epi64(after, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    // Target not reached in whole blocks: finish the tail serially
+    fill.filled = Detail::horizontalSum(filled_v);
+    double notional = Detail::horizontalSum(notional_v);
+    if (i > 0) {
+        fill.last_price = prices[i - 1];
+        fill.levels = static_cast<uint32_t>(i);
+    }
+    for (; i < n && fill.filled < target; ++i) {
+        const Qty take = std::min(qtys[i], target - fill.filled);
+        notional += static_cast<double>(prices[i]) * static_cast<double>(take);
+        fill.filled += take;
+        fill.last_price = prices[i];
+        fill.levels = static_cast<uint32_t>(i + 1);
+    }
+    if (fill.filled > 0) {
+        fill.vwap = notional / static_cast<double>(fill.filled);
+    }
+    return fill;
+#else
+    return Scalar::vwapToFill(prices, qtys, n, target);
+#endif
+}
+
+inline auto decayedDepth(const Qty* qtys, size_t n, double decay) noexcept -> double {
+#ifdef __AVX2__
+    const double d2 = decay * decay;
+    __m256d weights = _mm256_set_pd(d2 * decay, d2, decay, 1.0);
+    const __m256d step = _mm256_set1_pd(d2 * d2);
+    __m256d acc = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(Detail::toDouble(Detail::load(qtys + i)), weights));
+        weights = _mm256_mul_pd(weights, step);
+    }
+    double depth = Detail::horizontalSum(acc);
+    double weight = _mm256_cvtsd_f64(weights);
+    for (; i < n; ++i) {
+        depth += static_cast<double>(qtys[i]) * weight;
+        weight *= decay;
+    }
+    return depth;
+#else
+    return Scalar::decayedDepth(qtys, n, decay);
+#endif
+}
+
+inline auto bidDepthWithin(const Price* prices, const Qty* qtys, size_t n, Price floor) noexcept -> Qty {
+#ifdef __AVX2__
+    return Detail::depthWithin<true>(prices, qtys, n, floor);
+#else
+    return Scalar::bidDepthWithin(prices, qtys, n, floor);
+#endif
+}
+
+inline auto askDepthWithin(const Price* prices, const Qty* qtys, size_t n, Price ceiling) noexcept -> Qty {
+#ifdef __AVX2__
+    return Detail::depthWithin<false>(prices, qtys, n, ceiling);
+#else
+    return Scalar::askDepthWithin(prices, qtys, n, ceiling);
+#endif
+}
+
+// Imbalance in [-1, 1] with level i weighted decay^i, so the touch counts
+// most and deep levels still register. 0 when both sides are empty.
+inline auto weightedImbalance(const Qty* bid_qtys, size_t bid_levels,
+                              const Qty* ask_qtys, size_t ask_levels, double decay) noexcept -> double {
+    const double bids = decayedDepth(bid_qtys, bid_levels, decay);
+    const double asks = decayedDepth(ask_qtys, ask_levels, decay);
+    const double total = bids + asks;
+    return total > 0.0 ? (bids - asks) / total : 0.0;
+}
+
+// Cost of sweeping each of 'sizes' from the touch, in basis points of the
+// touch price; NaN where the side can't fill the size.
+inline auto impactCurve(const Price* prices, const Qty* qtys, size_t n,
+                        const Qty* sizes, size_t count, double* out_bps) noexcept -> void {
+    const double touch = n > 0 ? static_cast<double>(prices[0]) : 0.0;
+    for (size_t s = 0; s < count; ++s) {
+        const Fill fill = vwapToFill(prices, qtys, n, sizes[s]);
+        out_bps[s] = fill.filled == sizes[s] && touch > 0.0
+                         ? std::abs(fill.vwap - touch) / touch * 10000.0
+                         : std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+// Best-first view of one side. OrderBook exposes its arrays directly;
+// other books (LadderBook) copy up to MAX levels into the view's buffer.
+template<size_t MAX>
+struct SideLevels {
+    const Price* prices{nullptr};
+    const Qty* qtys{nullptr};
+    size_t count{0};
+    Price price_buf[MAX];
+    Qty qty_buf[MAX];
+};
+
+template<size_t MAX, typename Book>
+inline auto bidLevels(const Book& book, SideLevels<MAX>& out) noexcept -> void {
+    if constexpr (requires { book.bidPrices(); }) {
+        out.prices = book.bidPrices();
+        out.qtys = book.bidQtys();
+        out.count = std::min<size_t>(book.getBidDepth(), MAX);
+    } else {
+        out.count = book.getBidLevels(out.price_buf, out.qty_buf, MAX);
+        out.prices = out.price_buf;
+        out.qtys = out.qty_buf;
+    }
+}
+
+template<size_t MAX, typename Book>
+inline auto askLevels(const Book& book, SideLevels<MAX>& out) noexcept -> void {
+    if constexpr (requires { book.askPrices(); }) {
+        out.prices = book.askPrices();
+        out.qtys = book.askQtys();
+        out.count = std::min<size_t>(book.getAskDepth(), MAX);
+    } else {
+        out.count = book.getAskLevels(out.price_buf, out.qty_buf, MAX);
+        out.prices = out.price_buf;
+        out.qtys = out.qty_buf;
+    }
+}
+
+} // namespace Trading::MarketData::Depth
@@ -0,0 +1,457 @@
+#pragma once
+
+#include "common/types.h"
+#include "common/macros.h"
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <tuple>
+
+namespace Trading::MarketData {
+
+using namespace Common;
+
+// Full-depth order book indexed by price. Each side is a quantity array of
+// LADDER_TICKS slots covering a window of consecutive ticks, plus a
+// two-level bitmap of occupied slots, so an update by price is one array
+// write and the best bid/offer is found with a couple of bit scans.
+//
+// The window recentres on the touch when the market drifts towards either
+// edge; levels that fall outside it are dropped and counted. Reader calls
+// match OrderBook<N> (level 0 is the best price), so the strategies take
+// either book.
+template<size_t LADDER_TICKS = 65536>
+class LadderBook {
+public:
+    static_assert(LADDER_TICKS >= 4096 && (LADDER_TICKS & (LADDER_TICKS - 1)) == 0,
+                  "Ladder must be a power of two of at least 4096 ticks");
+
+    explicit LadderBook(Price tick_size = 1) noexcept {
+        reset(tick_size);
+    }
+
+    // Empty both sides; the window is placed on the first update
+    auto reset(Price tick_size) noexcept -> void {
+        tick_size_ = tick_size > 0 ? tick_size : 1;
+        base_tick_ = 0;
+        placed_ = false;
+        clear();
+        out_of_range_ = 0;
+        recentres_ = 0;
+        ticker_id_ = TickerId_INVALID;
+        last_update_ns_.store(0, std::memory_order_relaxed);
+    }
+
+    auto clear() noexcept -> void {
+        clearSide(bid_);
+        clearSide(ask_);
+    }
+
+    // Set the quantity at a price; zero removes the level. O(1) unless the
+    // update moves the touch far enough to recentre the window.
+    [[gnu::always_inline]]
+    inline auto setBid(Price price, Qty qty) noexcept -> void {
+        setLevel<true>(price, qty);
+    }
+
+    [[gnu::always_inline]]
+    inline auto setAsk(Price price, Qty qty) noexcept -> void {
+        setLevel<false>(price, qty);
+    }
+
+    // Getters - same shape as OrderBook<N>
+    [[nodiscard]] [[gnu::always_inline]]
+    inline auto getBestBid() const noexcept -> Price {
+        return bid_.best >= 0 ? slotPrice(static_cast<size_t>(bid_.best)) : Price_INVALID;
+    }
+
+    [[nodiscard]] [[gnu::always_inline]]
+    inline auto getBestAsk() const noexcept -> Price {
+        return ask_.best >= 0 ? slotPrice(static_cast<size_t>(ask_.best)) : Price_INVALID;
+    }
+
+    [[nodiscard]] [[gnu::always_inline]]
+    inline auto getBestBidQty() const noexcept -> Qty {
+        return bid_.best >= 0 ? bid_.qtys[bid_.best] : 0;
+    }
+
+    [[nodiscard]] [[gnu::always_inline]]
+    inline auto getBestAskQty() const noexcept -> Qty {
+        return ask_.best >= 0 ? ask_.qtys[ask_.best] : 0;
+    }
+
+    [[nodiscard]] [[gnu::always_inline]]
+    inline auto getSpread() const noexcept -> Price {
+        if (bid_.best >= 0 && ask_.best >= 0) {
+            return getBestAsk() - getBestBid();
+        }
+        return Price_INVALID;
+    }
+
+    [[nodiscard]] [[gnu::always_inline]]
+    inline auto getMidPrice() const noexcept -> Price {
+        if (bid_.best >= 0 && ask_.best >= 0) {
+            return (getBestBid() + getBestAsk()) / 2;
+        }
+        return Price_INVALID;
+    }
+
+    [[nodiscard]] [[gnu::always_inline]]
+    inline auto getTotalBidQty() const noexcept -> Qty { return bid_.total; }
+
+    [[nodiscard]] [[gnu::always_inline]]
+    inline auto getTotalAskQty() const noexcept -> Qty { return ask_.total; }
+
+    [[nodiscard]] [[gnu::always_inline]]
+    inline auto getImbalance() const noexcept -> double {
+        if (bid_.total + ask_.total == 0) return 0.0;
+        return (static_cast<double>(bid_.total) - static_cast<double>(ask_.total)) /
+               static_cast<double>(bid_.total + ask_.total);
+    }
+
+    // Level n counted from the touch; walks n occupied levels, skipping
+    // empty 64-tick words with the summary bitmap
+    [[nodiscard]]
+    auto getBidLevel(size_t level) const noexcept -> std::tuple<Price, Qty, uint16_t> {
+        const auto slot = nthSlot<true>(bid_, level);
+        if (slot < 0) {
+            return {Price_INVALID, 0, 0};
+        }
+        return {slotPrice(static_cast<size_t>(slot)), bid_.qtys[slot], 1};
+    }
+
+    [[nodiscard]]
+    auto getAskLevel(size_t level) const noexcept -> std::tuple<Price, Qty, uint16_t> {
+        const auto slot = nthSlot<false>(ask_, level);
+        if (slot < 0) {
+            return {Price_INVALID, 0, 0};
+        }
+        return {slotPrice(static_cast<size_t>(slot)), ask_.qtys[slot], 1};
+    }
+
+    // Copy up to max levels from the touch outwards; returns the count
+    auto getBidLevels(Price* prices, Qty* qtys, size_t max) const noexcept -> size_t {
+        return copyLevels<true>(bid_, prices, qtys, max);
+    }
+
+    auto getAskLevels(Price* prices, Qty* qtys, size_t max) const noexcept -> size_t {
+        return copyLevels<false>(ask_, prices, qtys, max);
+    }
+
+    [[nodiscard]] auto getBidDepth() const noexcept -> size_t { return bid_.depth; }
+    [[nodiscard]] auto getAskDepth() const noexcept -> size_t { return ask_.depth; }
+
+    [[nodiscard]] auto getTickSize() const noexcept -> Price { return tick_size_; }
+    // Lowest price the window covers, and one past the highest
+    [[nodiscard]] auto getWindowLow() const noexcept -> Price { return base_tick_ * tick_size_; }
+    [[nodiscard]] auto getWindowHigh() const noexcept -> Price {
+        return (base_tick_ + static_cast<int64_t>(LADDER_TICKS)) * tick_size_;
+    }
+    // Updates dropped for falling outside the window, and window moves
+    [[nodiscard]] auto getOutOfRangeCount() const noexcept -> uint64_t { return out_of_range_; }
+    [[nodiscard]] auto getRecentreCount() const noexcept -> uint64_t { return recentres_; }
+
+    [[nodiscard]] [[gnu::always_inline]]
+    inline auto getLastUpdateNs() const noexcept -> uint64_t {
+        return last_update_ns_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] auto getTickerId() const noexcept -> TickerId { return ticker_id_; }
+
+    auto setTickerId(TickerId id) noexcept -> void { ticker_id_ = id; }
+    auto updateTimestamp(uint64_t ns) noexcept -> void {
+        last_update_ns_.store(ns, std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t WORDS = LADDER_TICKS / 64;
+    static constexpr size_t SUMMARY_WORDS = WORDS / 64;
+    // Recentre once the touch is within this many ticks of an edge
+    static constexpr int64_t EDGE_MARGIN = static_cast<int64_t>(LADDER_TICKS / 8);
+
+    struct SideLadder {
+        alignas(CACHE_LINE_SIZE) Qty qtys[LADDER_TICKS];
+        alignas(CACHE_LINE_SIZE) uint64_t words[WORDS];       // Bit per occupied slot
+        alignas(CACHE_LINE_SIZE) uint64_t summary[SUMMARY_WORDS];  // Bit per non-empty word
+        int64_t best;   // Slot of the touch, -1 when empty
+        size_t depth;
+        Qty total;
+    };
+
+    static auto clearSide(SideLadder& side) noexcept -> void {
+        std::memset(side.qtys, 0, sizeof(side.qtys));
+        std::memset(side.words, 0, sizeof(side.words));
+        std::memset(side.summary, 0, sizeof(side.summary));
+        side.best = -1;
+        side.depth = 0;
+        side.total = 0;
+    }
+
+    [[gnu::always_inline]]
+    inline auto slotPrice(size_t slot) const noexcept -> Price {
+        return (base_tick_ + static_cast<int64_t>(slot)) * tick_size_;
+    }
+
+    // Nearest tick; feed prices converted through double can be off by one unit
+    [[gnu::always_inline]]
+    inline auto toTick(Price price) const noexcept -> int64_t {
+        return (price + tick_size_ / 2) / tick_size_;
+    }
+
+    template<bool IS_BID>
+    auto setLevel(Price price, Qty qty) noexcept -> void {
+        auto& side = IS_BID ? bid_ : ask_;
+        const int64_t tick = toTick(price);
+        if (UNLIKELY(!placed_)) {
+            if (qty == 0) {
+                return;
+            }
+            base_tick_ = tick - static_cast<int64_t>(LADDER_TICKS / 2);
+            placed_ = true;
+        }
+
+        int64_t slot = tick - base_tick_;
+        if (UNLIKELY(slot < 0 || slot >= static_cast<int64_t>(LADDER_TICKS))) {
+            // Only a new touch is worth moving the window for
+            const bool improves = qty > 0 &&
+                (side.best < 0 || (IS_BID ? slot > side.best : slot < side.best));
+            if (!improves) {
+                ++out_of_range_;
+                return;
+            }
+            recentre(tick);
+            slot = tick - base_tick_;
+        }
+
+        const auto s = static_cast<size_t>(slot);
+        const Qty old = side.qtys[s];
+        side.qtys[s] = qty;
+        side.total = side.total - old + qty;
+
+        if (qty > 0 && old == 0) {
+            markOccupied(side, s);
+            ++side.depth;
+            if (side.best < 0 || (IS_BID ? slot > side.best : slot < side.best)) {
+                side.best = slot;
+            }
+        } else if (qty == 0 && old != 0) {
+            markEmpty(side, s);
+            --side.depth;
+            if (slot == side.best) {
+                side.best = IS_BID ? prevOccupied(side, slot) : nextOccupied(side, slot);
+            }
+        }
+
+        if (UNLIKELY(side.best >= 0 &&
+                     (side.best < EDGE_MARGIN ||
+                      side.best >= static_cast<int64_t>(LADDER_TICKS) - EDGE_MARGIN))) {
+            recentre(base_tick_ + side.best);
+        }
+    }
+
+    [[gnu::always_inline]]
+    static inline auto markOccupied(SideLadder& side, size_t slot) noexcept -> void {
+        const size_t w = slot >> 6;
+        side.words[w] |= 1ULL << (slot & 63);
+        side.summary[w >> 6] |= 1ULL << (w & 63);
+    }
+
+    [[gnu::always_inline]]
+    static inline auto markEmpty(SideLadder& side, size_t slot) noexcept -> void {
+        const size_t w = slot >> 6;
+        side.words[w] &= ~(1ULL << (slot & 63));
+        if (side.words[w] == 0) {
+            side.summary[w >> 6] &= ~(1ULL << (w & 63));
+        }
+    }
+
+    // Highest occupied slot below 'slot', or -1
+    static auto prevOccupied(const SideLadder& side, int64_t slot) noexcept -> int64_t {
+        if (slot <= 0) {
+            return -1;
+        }
+        const auto s = static_cast<size_t>(slot - 1);
+        size_t w = s >> 6;
+        const uint64_t bits = side.words[w] & (~0ULL >> (63 - (s & 63)));
+        if (bits) {
+            return static_cast<int64_t>((w << 6) + 63 - static_cast<size_t>(std::countl_zero(bits)));
+        }
+        const auto prev = prevWord(side, w);
+        if (prev < 0) {
+            return -1;
+        }
+        w = static_cast<size_t>(prev);
+        return static_cast<int64_t>((w << 6) + 63 - static_cast<size_t>(std::countl_zero(side.words[w])));
+    }
+
+    // Lowest occupied slot above 'slot', or -1
+    static auto nextOccupied(const SideLadder& side, int64_t slot) noexcept -> int64_t {
+        const auto s = static_cast<size_t>(slot + 1);
+        if (s >= LADDER_TICKS) {
+            return -1;
+        }
+        size_t w = s >> 6;
+        const uint64_t bits = side.words[w] & (~0ULL << (s & 63));
+        if (bits) {
+            return static_cast<int64_t>((w << 6) + static_cast<size_t>(std::countr_zero(bits)));
+        }
+        const auto next = nextWord(side, w);
+        if (next < 0) {
+            return -1;
+        }
+        w = static_cast<size_t>(next);
+        return static_cast<int64_t>((w << 6) + static_cast<size_t>(std::countr_zero(side.words[w])));
+    }
+
+    // Highest non-empty word below w, from the summary bitmap
+    static auto prevWord(const SideLadder& side, size_t w) noexcept -> int64_t {
+        if (w == 0) {
+            return -1;
+        }
+        const size_t target = w - 1;
+        size_t sw = target >> 6;
+        uint64_t bits = side.summary[sw] & (~0ULL >> (63 - (target & 63)));
+        while (!bits) {
+            if (sw == 0) {
+                return -1;
+            }
+            bits = side.summary[--sw];
+        }
+        return static_cast<int64_t>((sw << 6) + 63 - static_cast<size_t>(std::countl_zero(bits)));
+    }
+
+    // Lowest non-empty word above w
+    static auto nextWord(const SideLadder& side, size_t w) noexcept -> int64_t {
+        const size_t target = w + 1;
+        if (target >= WORDS) {
+            return -1;
+        }
+        size_t sw = target >> 6;
+        uint64_t bits = side.summary[sw] & (~0ULL << (target & 63));
+        while (!bits) {
+            if (++sw >= SUMMARY_WORDS) {
+                return -1;
+            }
+            bits = side.summary[sw];
+        }
+        return static_cast<int64_t>((sw << 6) + static_cast<size_t>(std::countr_zero(bits)));
+    }
+
+    // Slot of the n-th occupied level from the touch, or -1. Whole words
+    // are skipped by popcount.
+    template<bool IS_BID>
+    static auto nthSlot(const SideLadder& side, size_t n) noexcept -> int64_t {
+        if (side.best < 0 || n >= side.depth) {
+            return -1;
+        }
+        const auto best = static_cast<size_t>(side.best);
+        size_t w = best >> 6;
+        uint64_t bits = IS_BID ? side.words[w] & (~0ULL >> (63 - (best & 63)))
+                               : side.words[w] & (~0ULL << (best & 63));
+        for (;;) {
+            const auto count = static_cast<size_t>(std::popcount(bits));
+            if (n < count) {
+                for (; n > 0; --n) {
+                    // Drop the n levels nearer the touch within this word
+                    bits = IS_BID ? bits & ~(1ULL << (63 - std::countl_zero(bits))) : bits & (bits - 1);
+                }
+                const auto bit = IS_BID ? 63 - static_cast<size_t>(std::countl_zero(bits))
+                                        : static_cast<size_t>(std::countr_zero(bits));
+                return static_cast<int64_t>((w << 6) + bit);
+            }
+            n -= count;
+            const auto next = IS_BID ? prevWord(side, w) : nextWord(side, w);
+            if (next < 0) {
+                return -1;
+            }
+            w = static_cast<size_t>(next);
+            bits = side.words[w];
+        }
+    }
+
+    template<bool IS_BID>
+    auto copyLevels(const SideLadder& side, Price* prices, Qty* qtys, size_t max) const noexcept -> size_t {
+        size_t count = 0;
+        int64_t slot = side.best;
+        while (slot >= 0 && count < max) {
+            const auto s = static_cast<size_t>(slot);
+            prices[count] = slotPrice(s);
+            qtys[count] = side.qtys[s];
+            ++count;
+            slot = IS_BID ? prevOccupied(side, slot) : nextOccupied(side, slot);
+        }
+        return count;
+    }
+
+    // Move the window so 'tick' sits mid-ladder. Slots shift in place and
+    // the bitmaps, depths and totals are rebuilt; this is rare, so it
+    // trades an O(LADDER_TICKS) pass for a branch-free update path.
+    auto recentre(int64_t tick) noexcept -> void {
+        const int64_t new_base = tick - static_cast<int64_t>(LADDER_TICKS / 2);
+        const int64_t shift = new_base - base_tick_;
+        if (shift == 0) {
+            return;
+        }
+        shiftSide(bid_, shift);
+        shiftSide(ask_, shift);
+        base_tick_ = new_base;
+        ++recentres_;
+    }
+
+    auto shiftSide(SideLadder& side, int64_t shift) noexcept -> void {
+        const auto span = static_cast<int64_t>(LADDER_TICKS);
+        if (shift >= span || shift <= -span) {
+            out_of_range_ += side.depth;
+            clearSide(side);
+            return;
+        }
+        const auto n = static_cast<size_t>(shift > 0 ? shift : -shift);
+        if (shift > 0) {
+            std::memmove(side.qtys, side.qtys + n, (LADDER_TICKS - n) * sizeof(Qty));
+            std::memset(side.qtys + (LADDER_TICKS - n), 0, n * sizeof(Qty));
+        } else {
+            std::memmove(side.qtys + n, side.qtys, (LADDER_TICKS - n) * sizeof(Qty));
+            std::memset(side.qtys, 0, n * sizeof(Qty));
+        }
+
+        const size_t old_depth = side.depth;
+        std::memset(side.summary, 0, sizeof(side.summary));
+        side.depth = 0;
+        side.total = 0;
+        for (size_t w = 0; w < WORDS; ++w) {
+            uint64_t bits = 0;
+            for (size_t b = 0; b < 64; ++b) {
+                const Qty q = side.qtys[(w << 6) + b];
+                bits |= static_cast<uint64_t>(q != 0) << b;
+                side.total += q;
+            }
+            side.words[w] = bits;
+            if (bits) {
+                side.summary[w >> 6] |= 1ULL << (w & 63);
+                side.depth += static_cast<size_t>(std::popcount(bits));
+            }
+        }
+        out_of_range_ += old_depth - side.depth;
+
+        const auto top = static_cast<int64_t>(LADDER_TICKS);
+        if (&side == &bid_) {
+            side.best = side.depth ? prevOccupied(side, top) : -1;
+        } else {
+            side.best = side.depth ? nextOccupied(side, -1) : -1;
+        }
+    }
+
+    SideLadder bid_{};
+    SideLadder ask_{};
+
+    Price tick_size_{1};
+    int64_t base_tick_{0};   // Tick of slot 0
+    bool placed_{false};
+    TickerId ticker_id_{TickerId_INVALID};
+    uint64_t out_of_range_{0};
+    uint64_t recentres_{0};
+
+    std::atomic<uint64_t> last_update_ns_{0};
+};
+
+} // namespace Trading::MarketData
@@ -2,10 +2,18 @@
 
 #include "common/types.h"
 #include "common/lf_queue.h"
+#include "common/conflating_channel.h"
 #include "common/macros.h"
 
 namespace Trading {
 
+// Latest update per ticker id, for consumers that prefer the freshest
+// state of every instrument over every tick (see ConflatingChannel)
+using MarketUpdateChannel = Common::ConflatingChannel<Common::MarketUpdate, 4096>;
+
+// Whole-book events from feeds that send full depth per message
+using DepthSnapshotQueue = Common::LFQueue<Common::DepthSnapshot, 65536>;
+
 // Base interface for all market data consumers
 // Each exchange (Zerodha, Binance) implements this interface
 class IMarketDataConsumer {
@@ -23,6 +31,19 @@ public:
     virtual auto subscribe(Common::TickerId ticker_id) -> bool = 0;
     virtual auto unsubscribe(Common::TickerId ticker_id) -> bool = 0;
     
+    // Also (or instead, with a null queue) publish into a conflating
+    // channel. Set before start().
+    auto setConflatingChannel(MarketUpdateChannel* channel) noexcept -> void {
+        conflating_channel_ = channel;
+    }
+    
+    // Also publish a DepthSnapshot per full-depth message, for consumers
+    // that keep books. Kite then sends its full packets only as snapshots,
+    // not as top-of-book updates too. Set before start().
+    auto setDepthQueue(DepthSnapshotQueue* queue) noexcept -> void {
+        depth_queue_ = queue;
+    }
+    
     // Delete copy/move operations
     IMarketDataConsumer(const IMarketDataConsumer&) = delete;
     IMarketDataConsumer& operator=(const IMarketDataConsumer&) = delete;
@@ -31,17 +52,82 @@ public:
     
 protected:
     Common::LFQueue<Common::MarketUpdate, 262144>* market_updates_queue_;
+    MarketUpdateChannel* conflating_channel_{nullptr};
+    DepthSnapshotQueue* depth_queue_{nullptr};
     std::atomic<bool> running_;
     
-    // Helper method for derived classes to publish updates
+    // Helper method for derived classes to publish updates to each attached
+    // consumer: the queue is lossless but drops when full, the channel
+    // keeps the newest update per ticker. False if either dropped it.
     auto publishUpdate(const Common::MarketUpdate& update) -> bool {
-        auto* dest = market_updates_queue_->getNextToWriteTo();
-        if (!dest) {
-            return false;  // Queue full
+        bool delivered = true;
+        if (conflating_channel_) {
+            delivered = conflating_channel_->publish(update.ticker_id, update);
+        }
+        if (market_updates_queue_) {
+            auto* dest = market_updates_queue_->getNextToWriteTo();
+            if (!dest) {
+                return false;  // Queue full
+            }
+            *dest = update;
+            market_updates_queue_->updateWriteIndex();
+        }
+        return delivered;
+    }
+
+    // Publish a batch of count updates, each filled in order by
+    // next(update). Queue slots are claimed as one block and filled in
+    // place, then handed to the reader with a single publish (two if the
+    // block wraps the ring). Returns how many either consumer dropped.
+    template<typename Next>
+    auto publishUpdates(size_t count, Next&& next) -> size_t {
+        size_t dropped = 0;
+        size_t remaining = count;
+        if (market_updates_queue_) {
+            while (remaining > 0) {
+                const auto slots = market_updates_queue_->claim(remaining);
+                if (slots.empty()) {
+                    break;  // Queue full
+                }
+                for (auto& update : slots) {
+                    next(update);
+                    if (conflating_channel_ && !conflating_channel_->publish(update.ticker_id, update)) {
+                        ++dropped;
+                    }
+                }
+                market_updates_queue_->publish(slots.size());
+                remaining -= slots.size();
+            }
+        }
+        // Past a full queue (or without one) updates only reach the channel
+        for (; remaining > 0; --remaining) {
+            Common::MarketUpdate update;
+            next(update);
+            const bool kept = !conflating_channel_ || conflating_channel_->publish(update.ticker_id, update);
+            if (market_updates_queue_ || !kept) {
+                ++dropped;
+            }
+        }
+        return dropped;
+    }
+
+    // Publish count snapshots to the depth queue the same way, each
+    // filled in place by next(snapshot). Returns how many didn't fit.
+    template<typename Next>
+    auto publishSnapshots(size_t count, Next&& next) -> size_t {
+        size_t remaining = count;
+        while (remaining > 0) {
+            const auto slots = depth_queue_->claim(remaining);
+            if (slots.empty()) {
+                break;  // Queue full
+            }
+            for (auto& snapshot : slots) {
+                next(snapshot);
+            }
+            depth_queue_->publish(slots.size());
+            remaining -= slots.size();
         }
-        *dest = update;
-        market_updates_queue_->updateWriteIndex();
-        return true;
+        return remaining;
     }
 };
 
@@ -2,15 +2,47 @@
 
 #include "common/types.h"
 #include "common/macros.h"
+#include "common/logging.h"
+#include "common/token_index.h"
+#include <algorithm>
 #include <atomic>
 #include <cstring>
+#include <immintrin.h>
+#include <limits>
+#include <tuple>
 
 namespace Trading::MarketData {
 
 using namespace Common;
 
-// Fixed-size order book with zero allocation
-template<size_t MAX_LEVELS = 20>
+// Consistent copy of a book's best levels, filled by OrderBook::readTop().
+// Totals cover the whole book, not just the copied levels.
+template<size_t LEVELS>
+struct TopLevels {
+    uint64_t seq;              // Book version; unchanged means no new updates
+    uint64_t timestamp_ns;
+    uint8_t bid_depth;
+    uint8_t ask_depth;
+    Qty total_bid_qty;
+    Qty total_ask_qty;
+    Price bid_prices[LEVELS];
+    Qty bid_qtys[LEVELS];
+    uint16_t bid_orders[LEVELS];
+    Price ask_prices[LEVELS];
+    Qty ask_qtys[LEVELS];
+    uint16_t ask_orders[LEVELS];
+};
+
+// Fixed-size order book with zero allocation.
+//
+// One thread writes; any thread may read through readTop() or
+// getSnapshot(). The writer brackets each batch of updates with
+// beginUpdate()/endUpdate(), which bump a seqlock sequence, and readers
+// retry until they copy a batch-consistent view. The writer never waits.
+// With PUBLISH_LEVELS > 0, endUpdate() also copies the top levels into a
+// separate reader-facing block, so polling readers only touch those cache
+// lines and never the ones the writer is updating.
+template<size_t MAX_LEVELS = 20, size_t PUBLISH_LEVELS = 0>
 class OrderBook {
 public:
     OrderBook() noexcept {
@@ -35,34 +67,71 @@ public:
         std::memset(ask_orders_, 0, sizeof(ask_orders_));
     }
     
+    // Open a batch of updates; readers retry until endUpdate()
+    [[gnu::always_inline]]
+    inline auto beginUpdate() noexcept -> void {
+        const auto seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    
+    // Close the batch and, if configured, publish the top levels
+    [[gnu::always_inline]]
+    inline auto endUpdate() noexcept -> void {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        if constexpr (PUBLISH_LEVELS > 0) {
+            publish();
+        }
+    }
+    
     // Update bid side - O(1) for specific level
     [[gnu::always_inline]]
     inline auto updateBid(Price price, Qty qty, uint16_t orders, uint8_t level) noexcept -> void {
-        if (level < MAX_LEVELS) {
-            bid_prices_[level] = price;
-            bid_qtys_[level] = qty;
-            bid_orders_[level] = orders;
-            if (level >= bid_depth_) {
-                bid_depth_ = level + 1;
-            }
-            recalculateBidQty();
-        }
+        setLevel(bids(), price, qty, orders, level);
     }
     
     // Update ask side - O(1) for specific level
     [[gnu::always_inline]]
     inline auto updateAsk(Price price, Qty qty, uint16_t orders, uint8_t level) noexcept -> void {
-        if (level < MAX_LEVELS) {
-            ask_prices_[level] = price;
-            ask_qtys_[level] = qty;
-            ask_orders_[level] = orders;
-            if (level >= ask_depth_) {
-                ask_depth_ = level + 1;
-            }
-            recalculateAskQty();
-        }
+        setLevel(asks(), price, qty, orders, level);
+    }
+    
+    // Insert a new level, pushing deeper levels down one; a full book drops its last level
+    auto insertBid(Price price, Qty qty, uint16_t orders, uint8_t level) noexcept -> void {
+        insertLevel(bids(), price, qty, orders, level);
+    }
+    
+    auto insertAsk(Price price, Qty qty, uint16_t orders, uint8_t level) noexcept -> void {
+        insertLevel(asks(), price, qty, orders, level);
+    }
+    
+    // Remove a level, pulling deeper levels up one
+    auto deleteBid(uint8_t level) noexcept -> void {
+        deleteLevel(bids(), level);
+    }
+    
+    auto deleteAsk(uint8_t level) noexcept -> void {
+        deleteLevel(asks(), level);
     }
     
+    // Replace a whole side, best level first. Levels past MAX_LEVELS are
+    // ignored; orders may be null when the feed has no counts (stored as 1).
+    auto applyLevels(OrderSide side, const Price* prices, const Qty* qtys,
+                     const uint16_t* orders, size_t count) noexcept -> void {
+        replaceSide(side == OrderSide::BUY ? bids() : asks(), prices, qtys, orders, count);
+    }
+
+    // Replace both sides from a depth snapshot as one batch, so readers
+    // see the instrument's whole book change at once. Opens and closes
+    // the batch itself. The book doesn't keep the snapshot's trade fields.
+    auto applySnapshot(const DepthSnapshot& snap) noexcept -> void {
+        beginUpdate();
+        replaceSide(bids(), snap.bid_prices, snap.bid_qtys, snap.bid_orders, snap.bid_count);
+        replaceSide(asks(), snap.ask_prices, snap.ask_qtys, snap.ask_orders, snap.ask_count);
+        updateTimestamp(snap.timestamp);
+        endUpdate();
+    }
+
     // Clear bid levels
     auto clearBids() noexcept -> void {
         bid_depth_ = 0;
@@ -158,11 +227,59 @@ public:
     [[nodiscard]] [[gnu::always_inline]]
     inline auto getAskDepth() const noexcept -> uint8_t { return ask_depth_; }
     
+    // Raw best-first level arrays, getBidDepth()/getAskDepth() long, for
+    // the depth kernels. Writer thread only; others go through readTop().
+    [[nodiscard]] auto bidPrices() const noexcept -> const Price* { return bid_prices_; }
+    [[nodiscard]] auto bidQtys() const noexcept -> const Qty* { return bid_qtys_; }
+    [[nodiscard]] auto askPrices() const noexcept -> const Price* { return ask_prices_; }
+    [[nodiscard]] auto askQtys() const noexcept -> const Qty* { return ask_qtys_; }
+
     [[nodiscard]] [[gnu::always_inline]]
-    inline auto getLastUpdateNs() const noexcept -> uint64_t { 
+    inline auto getLastUpdateNs() const noexcept -> uint64_t {
         return last_update_ns_.load(std::memory_order_acquire); 
     }
     
+    // Writer-side version; advances by 2 per batch
+    [[nodiscard]] [[gnu::always_inline]]
+    inline auto getSequence() const noexcept -> uint64_t {
+        return seq_.load(std::memory_order_acquire);
+    }
+    
+    // Copy the best N levels from any thread. Returns the version copied,
+    // so a poller can skip books that haven't changed. With a published
+    // block, only its PUBLISH_LEVELS levels are available. Must not be
+    // called by the writer inside its own batch.
+    template<size_t N>
+    auto readTop(TopLevels<N>& out) const noexcept -> uint64_t {
+        if constexpr (PUBLISH_LEVELS > 0) {
+            static_assert(N <= PUBLISH_LEVELS, "Only the published levels can be read");
+            const auto& pub = published_;
+            readConsistent(pub.seq, [&]() {
+                out.seq = pub.version;
+                out.timestamp_ns = pub.timestamp_ns;
+                out.bid_depth = pub.bid_depth;
+                out.ask_depth = pub.ask_depth;
+                out.total_bid_qty = pub.total_bid_qty;
+                out.total_ask_qty = pub.total_ask_qty;
+                copyLevels(out.bid_prices, out.bid_qtys, out.bid_orders, pub.bid_prices, pub.bid_qtys, pub.bid_orders);
+                copyLevels(out.ask_prices, out.ask_qtys, out.ask_orders, pub.ask_prices, pub.ask_qtys, pub.ask_orders);
+            });
+        } else {
+            out.seq = readConsistent(seq_, [&]() {
+                out.timestamp_ns = last_update_ns_.load(std::memory_order_relaxed);
+                out.bid_depth = bid_depth_;
+                out.ask_depth = ask_depth_;
+                out.total_bid_qty = total_bid_qty_;
+                out.total_ask_qty = total_ask_qty_;
+                copyLevels(out.bid_prices, out.bid_qtys, out.bid_orders, bid_prices_, bid_qtys_, bid_orders_);
+                copyLevels(out.ask_prices, out.ask_qtys, out.ask_orders, ask_prices_, ask_qtys_, ask_orders_);
+            });
+        }
+        out.bid_depth = std::min(out.bid_depth, static_cast<uint8_t>(N));
+        out.ask_depth = std::min(out.ask_depth, static_cast<uint8_t>(N));
+        return out.seq;
+    }
+    
     [[nodiscard]] [[gnu::always_inline]]
     inline auto getInstrumentToken() const noexcept -> uint32_t { return instrument_token_; }
     
@@ -193,23 +310,25 @@ public:
         Qty total_ask_qty;
     };
     
+    // Full-depth copy, consistent against concurrent batches
     [[nodiscard]] auto getSnapshot() const noexcept -> Snapshot {
         Snapshot snap;
-        snap.instrument_token = instrument_token_;
-        snap.ticker_id = ticker_id_;
-        snap.timestamp_ns = last_update_ns_.load(std::memory_order_acquire);
-        snap.bid_depth = bid_depth_;
-        snap.ask_depth = ask_depth_;
-        snap.total_bid_qty = total_bid_qty_;
-        snap.total_ask_qty = total_ask_qty_;
-        
-        std::memcpy(snap.bid_prices, bid_prices_, sizeof(bid_prices_));
-        std::memcpy(snap.bid_qtys, bid_qtys_, sizeof(bid_qtys_));
-        std::memcpy(snap.bid_orders, bid_orders_, sizeof(bid_orders_));
-        std::memcpy(snap.ask_prices, ask_prices_, sizeof(ask_prices_));
-        std::memcpy(snap.ask_qtys, ask_qtys_, sizeof(ask_qtys_));
-        std::memcpy(snap.ask_orders, ask_orders_, sizeof(ask_orders_));
-        
+        readConsistent(seq_, [&]() {
+            snap.instrument_token = instrument_token_;
+            snap.ticker_id = ticker_id_;
+            snap.timestamp_ns = last_update_ns_.load(std::memory_order_relaxed);
+            snap.bid_depth = bid_depth_;
+            snap.ask_depth = ask_depth_;
+            snap.total_bid_qty = total_bid_qty_;
+            snap.total_ask_qty = total_ask_qty_;
+            
+            std::memcpy(snap.bid_prices, bid_prices_, sizeof(bid_prices_));
+            std::memcpy(snap.bid_qtys, bid_qtys_, sizeof(bid_qtys_));
+            std::memcpy(snap.bid_orders, bid_orders_, sizeof(bid_orders_));
+            std::memcpy(snap.ask_prices, ask_prices_, sizeof(ask_prices_));
+            std::memcpy(snap.ask_qtys, ask_qtys_, sizeof(ask_qtys_));
+            std::memcpy(snap.ask_orders, ask_orders_, sizeof(ask_orders_));
+        });
         return snap;
     }
     
@@ -250,53 +369,243 @@ private:
     // Atomic timestamp for thread safety
     std::atomic<uint64_t> last_update_ns_;
     
-    // Helper methods
-    auto recalculateBidQty() noexcept -> void {
-        total_bid_qty_ = 0;
-        for (uint8_t i = 0; i < bid_depth_; ++i) {
-            total_bid_qty_ += bid_qtys_[i];
+    // Odd while a batch is being written
+    std::atomic<uint64_t> seq_{0};
+    
+    // Reader-facing copy of the top levels, on its own cache lines
+    struct alignas(CACHE_LINE_SIZE) Published {
+        std::atomic<uint64_t> seq{0};
+        uint64_t version = 0;
+        uint64_t timestamp_ns = 0;
+        uint8_t bid_depth = 0;
+        uint8_t ask_depth = 0;
+        Qty total_bid_qty = 0;
+        Qty total_ask_qty = 0;
+        Price bid_prices[PUBLISH_LEVELS]{};
+        Qty bid_qtys[PUBLISH_LEVELS]{};
+        uint16_t bid_orders[PUBLISH_LEVELS]{};
+        Price ask_prices[PUBLISH_LEVELS]{};
+        Qty ask_qtys[PUBLISH_LEVELS]{};
+        uint16_t ask_orders[PUBLISH_LEVELS]{};
+    };
+    struct NotPublished {};
+    [[no_unique_address]] std::conditional_t<(PUBLISH_LEVELS > 0), Published, NotPublished> published_{};
+    
+    static_assert(MAX_LEVELS <= std::numeric_limits<uint8_t>::max(), "Depth is tracked in a uint8_t");
+    static_assert(PUBLISH_LEVELS <= MAX_LEVELS, "Can't publish more levels than the book holds");
+    
+    auto publish() noexcept -> void {
+        auto& pub = published_;
+        const auto seq = pub.seq.load(std::memory_order_relaxed);
+        pub.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        pub.version = seq_.load(std::memory_order_relaxed);
+        pub.timestamp_ns = last_update_ns_.load(std::memory_order_relaxed);
+        pub.bid_depth = bid_depth_;
+        pub.ask_depth = ask_depth_;
+        pub.total_bid_qty = total_bid_qty_;
+        pub.total_ask_qty = total_ask_qty_;
+        copyLevels(pub.bid_prices, pub.bid_qtys, pub.bid_orders, bid_prices_, bid_qtys_, bid_orders_);
+        copyLevels(pub.ask_prices, pub.ask_qtys, pub.ask_orders, ask_prices_, ask_qtys_, ask_orders_);
+        pub.seq.store(seq + 2, std::memory_order_release);
+    }
+    
+    // Run copy until it lands between two reads of the same even sequence
+    template<typename Fn>
+    static auto readConsistent(const std::atomic<uint64_t>& seq, Fn&& copy) noexcept -> uint64_t {
+        for (;;) {
+            const auto before = seq.load(std::memory_order_acquire);
+            if (LIKELY((before & 1) == 0)) {
+                copy();
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (LIKELY(before == seq.load(std::memory_order_relaxed))) {
+                    return before;
+                }
+            }
+            _mm_pause();
         }
     }
     
-    auto recalculateAskQty() noexcept -> void {
-        total_ask_qty_ = 0;
-        for (uint8_t i = 0; i < ask_depth_; ++i) {
-            total_ask_qty_ += ask_qtys_[i];
+    // Copy the first min(N, SRC) levels; slots past the source stay zero,
+    // matching the book's own invariant for levels past depth
+    template<size_t N, size_t SRC>
+    static auto copyLevels(Price (&prices)[N], Qty (&qtys)[N], uint16_t (&orders)[N],
+                           const Price (&src_prices)[SRC], const Qty (&src_qtys)[SRC],
+                           const uint16_t (&src_orders)[SRC]) noexcept -> void {
+        constexpr size_t COUNT = N < SRC ? N : SRC;
+        std::memcpy(prices, src_prices, COUNT * sizeof(Price));
+        std::memcpy(qtys, src_qtys, COUNT * sizeof(Qty));
+        std::memcpy(orders, src_orders, COUNT * sizeof(uint16_t));
+        if constexpr (N > COUNT) {
+            std::memset(prices + COUNT, 0, (N - COUNT) * sizeof(Price));
+            std::memset(qtys + COUNT, 0, (N - COUNT) * sizeof(Qty));
+            std::memset(orders + COUNT, 0, (N - COUNT) * sizeof(uint16_t));
+        }
+    }
+    
+    // One side's arrays and aggregates. Levels at or past depth are kept
+    // zeroed, so a level's old quantity can be subtracted from the total
+    // without checking whether it was live.
+    struct SideLevels {
+        Price* prices;
+        Qty* qtys;
+        uint16_t* orders;
+        uint8_t& depth;
+        Qty& total;
+    };
+    
+    auto bids() noexcept -> SideLevels {
+        return {bid_prices_, bid_qtys_, bid_orders_, bid_depth_, total_bid_qty_};
+    }
+    
+    auto asks() noexcept -> SideLevels {
+        return {ask_prices_, ask_qtys_, ask_orders_, ask_depth_, total_ask_qty_};
+    }
+    
+    [[gnu::always_inline]]
+    static inline auto setLevel(SideLevels side, Price price, Qty qty, uint16_t orders, uint8_t level) noexcept -> void {
+        if (level < MAX_LEVELS) {
+            side.total = side.total - side.qtys[level] + qty;
+            side.prices[level] = price;
+            side.qtys[level] = qty;
+            side.orders[level] = orders;
+            if (level >= side.depth) {
+                side.depth = static_cast<uint8_t>(level + 1);
+            }
+        }
+    }
+    
+    static auto insertLevel(SideLevels side, Price price, Qty qty, uint16_t orders, uint8_t level) noexcept -> void {
+        if (level >= MAX_LEVELS) {
+            return;
+        }
+        if (level < side.depth) {
+            // Levels shifted off the end of a full book leave the total
+            const size_t kept = side.depth < MAX_LEVELS ? side.depth : MAX_LEVELS - 1;
+            side.total -= side.qtys[MAX_LEVELS - 1];
+            shiftDeeper(side.prices, level, kept - level);
+            shiftDeeper(side.qtys, level, kept - level);
+            shiftDeeper(side.orders, level, kept - level);
+            side.qtys[level] = 0;
+            side.depth = static_cast<uint8_t>(kept + 1);
+        }
+        setLevel(side, price, qty, orders, level);
+    }
+    
+    static auto deleteLevel(SideLevels side, uint8_t level) noexcept -> void {
+        if (level >= side.depth) {
+            return;
+        }
+        const size_t last = side.depth - 1U;
+        side.total -= side.qtys[level];
+        shiftShallower(side.prices, level, last - level);
+        shiftShallower(side.qtys, level, last - level);
+        shiftShallower(side.orders, level, last - level);
+        side.prices[last] = 0;
+        side.qtys[last] = 0;
+        side.orders[last] = 0;
+        side.depth = static_cast<uint8_t>(last);
+    }
+    
+    static auto replaceSide(SideLevels side, const Price* prices, const Qty* qtys,
+                            const uint16_t* orders, size_t count) noexcept -> void {
+        const size_t depth = count < MAX_LEVELS ? count : MAX_LEVELS;
+        std::memcpy(side.prices, prices, depth * sizeof(Price));
+        std::memcpy(side.qtys, qtys, depth * sizeof(Qty));
+        if (orders) {
+            std::memcpy(side.orders, orders, depth * sizeof(uint16_t));
+        } else {
+            std::fill_n(side.orders, depth, uint16_t{1});
+        }
+        
+        // Zero whatever the previous, deeper update left behind
+        if (side.depth > depth) {
+            const size_t stale = side.depth - depth;
+            std::memset(side.prices + depth, 0, stale * sizeof(Price));
+            std::memset(side.qtys + depth, 0, stale * sizeof(Qty));
+            std::memset(side.orders + depth, 0, stale * sizeof(uint16_t));
         }
+        
+        Qty total = 0;
+        for (size_t i = 0; i < depth; ++i) {
+            total += qtys[i];
+        }
+        side.total = total;
+        side.depth = static_cast<uint8_t>(depth);
+    }
+    
+    // Move data[from, from + count) one slot deeper. Copies run from the
+    // back so each 32-byte load happens before the store that overlaps it.
+    template<typename T>
+    static auto shiftDeeper(T* data, size_t from, size_t count) noexcept -> void {
+#ifdef __AVX2__
+        constexpr size_t LANES = 32 / sizeof(T);
+        size_t i = count;
+        while (i >= LANES) {
+            i -= LANES;
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + from + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + from + i + 1), v);
+        }
+        while (i > 0) {
+            --i;
+            data[from + i + 1] = data[from + i];
+        }
+#else
+        std::memmove(data + from + 1, data + from, count * sizeof(T));
+#endif
+    }
+    
+    // Move data[from + 1, from + 1 + count) one slot shallower, front to back
+    template<typename T>
+    static auto shiftShallower(T* data, size_t from, size_t count) noexcept -> void {
+#ifdef __AVX2__
+        constexpr size_t LANES = 32 / sizeof(T);
+        size_t i = 0;
+        for (; i + LANES <= count; i += LANES) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + from + 1 + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + from + i), v);
+        }
+        for (; i < count; ++i) {
+            data[from + i] = data[from + i + 1];
+        }
+#else
+        std::memmove(data + from, data + from + 1, count * sizeof(T));
+#endif
     }
 };
 
-// Manager for multiple order books
-template<size_t MAX_INSTRUMENTS = 1000>
+// Manager for multiple order books. PUBLISH_LEVELS is passed through to
+// each book; readers on other threads go through readTop().
+template<size_t MAX_INSTRUMENTS = 1000, size_t PUBLISH_LEVELS = 0>
 class OrderBookManager {
 public:
+    using Book = OrderBook<20, PUBLISH_LEVELS>;
+    
     OrderBookManager() noexcept {
-        // Initialize token to index mapping
-        for (size_t i = 0; i < MAX_TOKEN_VALUE; ++i) {
-            token_to_index_[i] = INVALID_INDEX;
-        }
         next_index_ = 0;
     }
     
     // Register an instrument and get its order book
-    auto registerInstrument(uint32_t token, TickerId ticker_id) noexcept -> OrderBook<20>* {
-        if (token >= MAX_TOKEN_VALUE || next_index_ >= MAX_INSTRUMENTS) {
-            return nullptr;
-        }
-        
+    auto registerInstrument(uint32_t token, TickerId ticker_id) noexcept -> Book* {
         // Check if already registered
-        if (token_to_index_[token] != INVALID_INDEX) {
-            return &order_books_[token_to_index_[token]];
+        if (const auto index = token_to_index_.find(token); index != TokenIndex::NOT_FOUND) {
+            return &order_books_[index];
         }
         
-        // Register new instrument
-        size_t index = next_index_++;
-        token_to_index_[token] = static_cast<uint32_t>(index);
+        const size_t index = next_index_.load(std::memory_order_relaxed);
+        if (index >= MAX_INSTRUMENTS) {
+            return nullptr;
+        }
         
+        // Set the book up before the token makes it reachable
         auto& book = order_books_[index];
         book.reset();
         book.setInstrumentToken(token);
         book.setTickerId(ticker_id);
+        if (!token_to_index_.insert(token, static_cast<uint32_t>(index))) {
+            return nullptr;
+        }
+        next_index_.store(index + 1, std::memory_order_release);
         
         LOG_INFO("Registered order book for token %u at index %zu", token, index);
         return &book;
@@ -304,24 +613,32 @@ public:
     
     // Get order book by token - O(1)
     [[nodiscard]] [[gnu::always_inline]]
-    inline auto getOrderBook(uint32_t token) noexcept -> OrderBook<20>* {
-        if (token < MAX_TOKEN_VALUE && token_to_index_[token] != INVALID_INDEX) {
-            return &order_books_[token_to_index_[token]];
-        }
-        return nullptr;
+    inline auto getOrderBook(uint32_t token) noexcept -> Book* {
+        const auto index = token_to_index_.find(token);
+        return index != TokenIndex::NOT_FOUND ? &order_books_[index] : nullptr;
     }
     
     [[nodiscard]] [[gnu::always_inline]]
-    inline auto getOrderBookConst(uint32_t token) const noexcept -> const OrderBook<20>* {
-        if (token < MAX_TOKEN_VALUE && token_to_index_[token] != INVALID_INDEX) {
-            return &order_books_[token_to_index_[token]];
+    inline auto getOrderBookConst(uint32_t token) const noexcept -> const Book* {
+        const auto index = token_to_index_.find(token);
+        return index != TokenIndex::NOT_FOUND ? &order_books_[index] : nullptr;
+    }
+    
+    // Consistent top-N copy for readers off the writer thread; false if
+    // the token isn't registered
+    template<size_t N>
+    auto readTop(uint32_t token, TopLevels<N>& out) const noexcept -> bool {
+        const auto* book = getOrderBookConst(token);
+        if (!book) {
+            return false;
         }
-        return nullptr;
+        book->readTop(out);
+        return true;
     }
     
     // Get active order books - returns count and fills provided array
     struct ActiveBooks {
-        const OrderBook<20>* books[MAX_INSTRUMENTS];
+        const Book* books[MAX_INSTRUMENTS];
         size_t count;
     };
     
@@ -338,14 +655,13 @@ public:
     }
     
 private:
-    static constexpr uint32_t MAX_TOKEN_VALUE = 100000;
-    static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+    using TokenIndex = Common::TokenIndex<MAX_INSTRUMENTS>;
     
     // Fixed-size storage
-    OrderBook<20> order_books_[MAX_INSTRUMENTS];
+    Book order_books_[MAX_INSTRUMENTS];
     
-    // Direct index mapping for O(1) access
-    uint32_t token_to_index_[MAX_TOKEN_VALUE];
+    // Sparse token -> book index, one cache line per probe
+    TokenIndex token_to_index_;
     
     std::atomic<size_t> next_index_;
 };
@@ -0,0 +1,151 @@
+// ============================================================================
+// kite_frame_parser.cpp - Whole-frame parser for Kite binary market data
+// ============================================================================
+
+#include "trading/market_data/zerodha/kite_frame_parser.h"
+#include "common/macros.h"
+
+#include <cstring>
+#include <immintrin.h>
+
+namespace Trading::MarketData::Zerodha {
+
+namespace {
+
+constexpr size_t LTP_WORDS = sizeof(KiteLTPPacket) / 4;
+constexpr size_t QUOTE_WORDS = sizeof(KiteQuotePacket) / 4;
+constexpr size_t FULL_WORDS = sizeof(KiteFullPacket) / 4;
+constexpr size_t BID_WORD = offsetof(KiteFullPacket, bid) / 4;
+constexpr size_t ASK_WORD = offsetof(KiteFullPacket, ask) / 4;
+constexpr size_t DEPTH_ITEM_WORDS = sizeof(KiteFullPacket::DepthItem) / 4;
+
+inline auto load16(const uint8_t* p) noexcept -> size_t {
+    return static_cast<size_t>(p[0]) << 8 | p[1];
+}
+
+// The packet's big-endian words in native order. Packets sit at odd
+// offsets in the frame, so every load is unaligned.
+template<size_t WORDS>
+inline auto swapWords(const uint8_t* packet, uint32_t* words) noexcept -> void {
+#ifdef __AVX2__
+    static_assert(WORDS >= 8, "One vector at least");
+    // Reverse the bytes of each 32-bit lane
+    const __m256i bswap32 = _mm256_setr_epi8(
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const auto swap = [&](size_t word) noexcept {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(packet + word * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(words + word), _mm256_shuffle_epi8(v, bswap32));
+    };
+    for (size_t word = 0; word + 8 <= WORDS; word += 8) {
+        swap(word);
+    }
+    if constexpr (WORDS % 8 != 0) {
+        swap(WORDS - 8);  // Overlaps the last full vector rather than reading past the packet
+    }
+#else
+    for (size_t word = 0; word < WORDS; ++word) {
+        uint32_t value;
+        std::memcpy(&value, packet + word * 4, 4);
+        words[word] = __builtin_bswap32(value);
+    }
+#endif
+}
+
+// Fields a quote packet shares with a full one, at the same word offsets
+inline auto stageQuote(const uint32_t* words, KiteFrameBatch& out, size_t i) noexcept -> void {
+    out.token[i] = words[0];
+    out.last_price[i] = words[1];
+    out.last_qty[i] = words[2];
+    out.average_price[i] = words[3];
+    out.volume[i] = words[4];
+    out.buy_qty[i] = words[5];
+    out.sell_qty[i] = words[6];
+    out.open[i] = words[7];
+    out.high[i] = words[8];
+    out.low[i] = words[9];
+    out.close[i] = words[10];
+}
+
+inline auto stageFull(const uint32_t* words, KiteFrameBatch& out, size_t i) noexcept -> void {
+    stageQuote(words, out, i);
+    out.last_traded_time[i] = words[11];
+    out.oi[i] = words[12];
+    out.oi_day_high[i] = words[13];
+    out.oi_day_low[i] = words[14];
+    out.exchange_time[i] = words[15];
+
+    // Each level is quantity, price, then orders in the high half of the
+    // last word (the low half is padding)
+    for (size_t level = 0; level < KiteFrameBatch::MAX_DEPTH; ++level) {
+        const uint32_t* bid = words + BID_WORD + level * DEPTH_ITEM_WORDS;
+        const uint32_t* ask = words + ASK_WORD + level * DEPTH_ITEM_WORDS;
+        out.bid_qty[i][level] = bid[0];
+        out.bid_price[i][level] = bid[1];
+        out.bid_orders[i][level] = static_cast<uint16_t>(bid[2] >> 16);
+        out.ask_qty[i][level] = ask[0];
+        out.ask_price[i][level] = ask[1];
+        out.ask_orders[i][level] = static_cast<uint16_t>(ask[2] >> 16);
+    }
+}
+
+} // namespace
+
+auto parseKiteFrame(const uint8_t* frame, size_t len, KiteFrameBatch& out) noexcept -> bool {
+    out.count = 0;
+    out.skipped = 0;
+    if (UNLIKELY(len < 2)) {
+        return false;
+    }
+
+    const size_t num_packets = load16(frame);
+    size_t pos = 2;
+    for (size_t n = 0; n < num_packets; ++n) {
+        if (UNLIKELY(pos + 2 > len)) {
+            return false;
+        }
+        const size_t packet_len = load16(frame + pos);
+        const uint8_t* packet = frame + pos + 2;
+        pos += 2 + packet_len;
+        if (UNLIKELY(pos > len)) {
+            return false;
+        }
+
+        const size_t i = out.count;
+        if (UNLIKELY(i == KiteFrameBatch::MAX_PACKETS)) {
+            ++out.skipped;
+            continue;
+        }
+        switch (packet_len) {
+        case sizeof(KiteFullPacket): {
+            uint32_t words[FULL_WORDS];
+            swapWords<FULL_WORDS>(packet, words);
+            stageFull(words, out, i);
+            out.mode[i] = KiteMode::MODE_FULL;
+            break;
+        }
+        case sizeof(KiteQuotePacket): {
+            uint32_t words[QUOTE_WORDS];
+            swapWords<QUOTE_WORDS>(packet, words);
+            stageQuote(words, out, i);
+            out.mode[i] = KiteMode::MODE_QUOTE;
+            break;
+        }
+        case sizeof(KiteLTPPacket): {
+            uint32_t words[LTP_WORDS];
+            std::memcpy(words, packet, sizeof(words));
+            out.token[i] = __builtin_bswap32(words[0]);
+            out.last_price[i] = __builtin_bswap32(words[1]);
+            out.mode[i] = KiteMode::MODE_LTP;
+            break;
+        }
+        default:
+            ++out.skipped;  // Index packets (28 and 32 bytes) aren't staged
+            continue;
+        }
+        ++out.count;
+    }
+    return true;
+}
+
+} // namespace Trading::MarketData::Zerodha
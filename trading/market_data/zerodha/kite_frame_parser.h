@@ -0,0 +1,131 @@
+#pragma once
+
+#include "common/types.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Trading::MarketData::Zerodha {
+
+// Kite binary protocol packet structures
+#pragma pack(push, 1)
+
+// Packet modes as per Kite protocol
+enum class KiteMode : uint8_t {
+    MODE_LTP = 1,      // 8 bytes
+    MODE_QUOTE = 2,    // 44 bytes
+    MODE_FULL = 3      // 184 bytes
+};
+
+// Binary packet header
+struct KitePacketHeader {
+    uint16_t num_packets;
+    uint16_t packet_length;
+};
+
+// LTP packet (8 bytes)
+struct KiteLTPPacket {
+    uint32_t instrument_token;
+    uint32_t last_price;  // Price * 100
+};
+
+// Quote packet (44 bytes)
+struct KiteQuotePacket {
+    uint32_t instrument_token;
+    uint32_t last_price;
+    uint32_t last_quantity;
+    uint32_t average_price;
+    uint32_t volume;
+    uint32_t buy_quantity;
+    uint32_t sell_quantity;
+    uint32_t open;
+    uint32_t high;
+    uint32_t low;
+    uint32_t close;
+};
+
+// Full packet (184 bytes) - includes market depth
+struct KiteFullPacket {
+    uint32_t instrument_token;
+    uint32_t last_price;
+    uint32_t last_quantity;
+    uint32_t average_price;
+    uint32_t volume;
+    uint32_t buy_quantity;
+    uint32_t sell_quantity;
+    uint32_t open;
+    uint32_t high;
+    uint32_t low;
+    uint32_t close;
+    uint32_t last_traded_time;
+    uint32_t oi;
+    uint32_t oi_day_high;
+    uint32_t oi_day_low;
+    uint32_t timestamp;
+
+    // Market depth - 5 levels each side
+    struct DepthItem {
+        uint32_t quantity;
+        uint32_t price;
+        uint16_t orders;
+        uint16_t padding;
+    } bid[5], ask[5];
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(KiteLTPPacket) == 8);
+static_assert(sizeof(KiteQuotePacket) == 44);
+static_assert(sizeof(KiteFullPacket) == 184);
+
+// Every packet of one binary frame, byte-swapped and laid out field by
+// field (SoA): entry i of each array belongs to the frame's i-th staged
+// packet. Prices are paise, as sent. Only the fields of an entry's mode
+// are written - quote entries leave the full-only columns stale, LTP
+// entries everything past last_price.
+struct KiteFrameBatch {
+    // One packet per subscribed token, and Kite allows 3000 per connection
+    static constexpr size_t MAX_PACKETS = 3000;
+    static constexpr size_t MAX_DEPTH = 5;
+
+    size_t count{0};
+    size_t skipped{0};  // Packets of another length (indices) or past MAX_PACKETS
+
+    KiteMode mode[MAX_PACKETS];
+    uint32_t token[MAX_PACKETS];
+    uint32_t last_price[MAX_PACKETS];
+
+    // Quote and full
+    uint32_t last_qty[MAX_PACKETS];
+    uint32_t average_price[MAX_PACKETS];
+    uint32_t volume[MAX_PACKETS];
+    uint32_t buy_qty[MAX_PACKETS];
+    uint32_t sell_qty[MAX_PACKETS];
+    uint32_t open[MAX_PACKETS];
+    uint32_t high[MAX_PACKETS];
+    uint32_t low[MAX_PACKETS];
+    uint32_t close[MAX_PACKETS];
+
+    // Full only
+    uint32_t last_traded_time[MAX_PACKETS];  // Epoch seconds
+    uint32_t oi[MAX_PACKETS];
+    uint32_t oi_day_high[MAX_PACKETS];
+    uint32_t oi_day_low[MAX_PACKETS];
+    uint32_t exchange_time[MAX_PACKETS];     // Epoch seconds
+    uint32_t bid_qty[MAX_PACKETS][MAX_DEPTH];
+    uint32_t bid_price[MAX_PACKETS][MAX_DEPTH];
+    uint16_t bid_orders[MAX_PACKETS][MAX_DEPTH];
+    uint32_t ask_qty[MAX_PACKETS][MAX_DEPTH];
+    uint32_t ask_price[MAX_PACKETS][MAX_DEPTH];
+    uint16_t ask_orders[MAX_PACKETS][MAX_DEPTH];
+};
+
+// Stage every packet of a Kite binary frame (the WebSocket payload: a
+// packet count, then a 2-byte length before each packet) into 'out',
+// replacing what it held. The length table is walked once; full and
+// quote packets are byte-swapped whole with AVX2 shuffles and their
+// fields stored straight into the columns. Returns false if the frame is
+// truncated; the packets before the cut are still staged.
+auto parseKiteFrame(const uint8_t* frame, size_t len, KiteFrameBatch& out) noexcept -> bool;
+
+} // namespace Trading::MarketData::Zerodha
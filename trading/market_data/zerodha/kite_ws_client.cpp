@@ -15,13 +15,6 @@ KiteWSClient::KiteWSClient(Common::LFQueue<Common::MarketUpdate, 262144>* output
     : IMarketDataConsumer(output_queue)
     , config_(config) {
     
-    // Initialize token mappings
-    for (size_t i = 0; i < MAX_INSTRUMENTS; ++i) {
-        subscribed_tokens_[i].store(false);
-        token_modes_[i].store(KiteMode::MODE_LTP);
-        token_to_ticker_[i] = TickerId_INVALID;
-    }
-    
     LOG_INFO("KiteWSClient initialized with endpoint: %s", config_.ws_endpoint);
 }
 
@@ -316,6 +309,32 @@ auto KiteWSClient::unsubscribe(Common::TickerId) -> bool {
     return true;
 }
 
+auto KiteWSClient::mapTokenToTicker(uint32_t token, TickerId ticker_id) -> void {
+    if (auto* state = tokenState(token)) {
+        state->ticker_id.store(ticker_id, std::memory_order_relaxed);
+    }
+}
+
+auto KiteWSClient::tokenState(uint32_t token) -> TokenState* {
+    std::lock_guard<std::mutex> lock(token_mutex_);
+    if (const auto slot = token_index_.find(token); slot != decltype(token_index_)::NOT_FOUND) {
+        return &token_states_[slot];
+    }
+    if (token_count_ >= MAX_TOKENS) {
+        LOG_ERROR("Token table full (%zu), dropping token %u", MAX_TOKENS, token);
+        return nullptr;
+    }
+    
+    // Fill the slot before the index makes it visible to the parser
+    auto& state = token_states_[token_count_];
+    state.token = token;
+    if (!token_index_.insert(token, static_cast<uint32_t>(token_count_))) {
+        return nullptr;
+    }
+    ++token_count_;
+    return &state;
+}
+
 auto KiteWSClient::subscribeTokens(const uint32_t* tokens, size_t count, KiteMode mode) -> bool {
     if (!connected_.load()) {
         LOG_WARN("Cannot subscribe - not connected");
@@ -356,9 +375,9 @@ auto KiteWSClient::subscribeTokens(const uint32_t* tokens, size_t count, KiteMod
     
     // Mark tokens as subscribed
     for (size_t i = 0; i < count; ++i) {
-        if (tokens[i] < MAX_INSTRUMENTS) {
-            subscribed_tokens_[tokens[i]].store(true);
-            token_modes_[tokens[i]].store(mode);
+        if (auto* state = tokenState(tokens[i])) {
+            state->subscribed.store(true);
+            state->mode.store(mode);
         }
     }
     
@@ -394,8 +413,8 @@ auto KiteWSClient::unsubscribeTokens(const uint32_t* tokens, size_t count) -> bo
     
     // Mark tokens as unsubscribed
     for (size_t i = 0; i < count; ++i) {
-        if (tokens[i] < MAX_INSTRUMENTS) {
-            subscribed_tokens_[tokens[i]].store(false);
+        if (const auto slot = token_index_.find(tokens[i]); slot != decltype(token_index_)::NOT_FOUND) {
+            token_states_[slot].subscribed.store(false);
         }
     }
     
@@ -433,8 +452,8 @@ auto KiteWSClient::setMode(const uint32_t* tokens, size_t count, KiteMode mode)
     
     // Update token modes
     for (size_t i = 0; i < count; ++i) {
-        if (tokens[i] < MAX_INSTRUMENTS) {
-            token_modes_[tokens[i]].store(mode);
+        if (const auto slot = token_index_.find(tokens[i]); slot != decltype(token_index_)::NOT_FOUND) {
+            token_states_[slot].mode.store(mode);
         }
     }
     
@@ -595,230 +614,116 @@ auto KiteWSClient::processReceivedData(const uint8_t* data, size_t len) -> void
 }
 
 auto KiteWSClient::parseBinaryPacket(const uint8_t* data, size_t len) -> bool {
-    if (len < 2) {
-        LOG_WARN("Packet too small: %zu bytes", len);
-        return false;
-    }
-    
-    // First two bytes indicate number of packets and length
-    uint16_t num_packets = (static_cast<uint16_t>(data[0]) << 8) | data[1];
-    
-    LOG_INFO("Binary packet contains %u sub-packets", num_packets);
-    
-    size_t pos = 2;
-    
-    for (uint16_t i = 0; i < num_packets && pos < len; ++i) {
-        if (pos + 2 > len) break;
-        
-        uint16_t packet_len = (static_cast<uint16_t>(data[pos]) << 8) | data[pos + 1];
-        pos += 2;
-        
-        if (pos + packet_len > len) {
-            LOG_WARN("Incomplete packet");
-            break;
-        }
-        
-        // Parse based on packet length
-        if (packet_len == 8) {
-            // LTP packet
-            if (pos + sizeof(KiteLTPPacket) <= len) {
-                parseLTPPacket(reinterpret_cast<const KiteLTPPacket*>(data + pos));
-            }
-        } else if (packet_len == 44) {
-            // Quote packet
-            if (pos + sizeof(KiteQuotePacket) <= len) {
-                parseQuotePacket(reinterpret_cast<const KiteQuotePacket*>(data + pos));
-            }
-        } else if (packet_len == 184) {
-            // Full packet with depth
-            if (pos + sizeof(KiteFullPacket) <= len) {
-                parseFullPacket(reinterpret_cast<const KiteFullPacket*>(data + pos));
-            }
-        }
-        
-        pos += packet_len;
+    const bool complete = parseKiteFrame(data, len, batch_);
+    if (!complete) {
+        LOG_WARN("Incomplete binary frame: %zu bytes", len);
     }
-    
-    return true;
+    publishBatch();
+    return complete;
 }
 
-auto KiteWSClient::parseLTPPacket(const KiteLTPPacket* packet) -> void {
-    auto* tick = static_cast<KiteTickData*>(tick_pool_.allocate());
-    if (!tick) {
-        ticks_dropped_.fetch_add(1);
+auto KiteWSClient::publishBatch() -> void {
+    const KiteFrameBatch& batch = batch_;
+    if (batch.count == 0) {
         return;
     }
+    const uint64_t now_ns = Common::TscClock::monoNs();
     
-    tick->instrument_token = __builtin_bswap32(packet->instrument_token);
-    tick->last_price = convertPrice(__builtin_bswap32(packet->last_price));
-    tick->local_timestamp_ns = Common::getNanosSinceEpoch();
-    tick->ticker_id = token_to_ticker_[tick->instrument_token];
-    
-    // Create market update
-    Common::MarketUpdate update;
-    update.update_type = MessageType::MARKET_DATA;
-    update.ticker_id = tick->ticker_id;
-    // update.side not available
-    update.bid_price = tick->last_price;
-    update.bid_qty = 0;
-    // update.priority not available
-    
-    if (!publishUpdate(update)) {
-        ticks_dropped_.fetch_add(1);
-    } else {
-        ticks_received_.fetch_add(1);
-    }
-    
-    tick_pool_.deallocate(tick);
-}
-
-auto KiteWSClient::parseQuotePacket(const KiteQuotePacket* packet) -> void {
-    auto* tick = static_cast<KiteTickData*>(tick_pool_.allocate());
-    if (!tick) {
-        ticks_dropped_.fetch_add(1);
-        return;
-    }
-    
-    tick->instrument_token = __builtin_bswap32(packet->instrument_token);
-    tick->last_price = convertPrice(__builtin_bswap32(packet->last_price));
-    tick->last_qty = convertQty(__builtin_bswap32(packet->last_quantity));
-    tick->volume = convertQty(__builtin_bswap32(packet->volume));
-    tick->open = convertPrice(__builtin_bswap32(packet->open));
-    tick->high = convertPrice(__builtin_bswap32(packet->high));
-    tick->low = convertPrice(__builtin_bswap32(packet->low));
-    tick->close = convertPrice(__builtin_bswap32(packet->close));
-    tick->local_timestamp_ns = Common::getNanosSinceEpoch();
-    tick->ticker_id = token_to_ticker_[tick->instrument_token];
-    
-    // Create market update
-    Common::MarketUpdate update;
-    update.update_type = MessageType::MARKET_DATA;
-    update.ticker_id = tick->ticker_id;
-    // update.side not available
-    update.bid_price = tick->last_price;
-    update.bid_qty = tick->last_qty;
-    // update.priority not available
-    
-    if (!publishUpdate(update)) {
-        ticks_dropped_.fetch_add(1);
-    } else {
-        ticks_received_.fetch_add(1);
-    }
-    
-    tick_pool_.deallocate(tick);
-}
-
-auto KiteWSClient::parseFullPacket(const KiteFullPacket* packet) -> void {
-    // Parse tick data
-    auto* tick = static_cast<KiteTickData*>(tick_pool_.allocate());
-    if (!tick) {
-        ticks_dropped_.fetch_add(1);
-        return;
-    }
-    
-    tick->instrument_token = __builtin_bswap32(packet->instrument_token);
-    tick->last_price = convertPrice(__builtin_bswap32(packet->last_price));
-    tick->last_qty = convertQty(__builtin_bswap32(packet->last_quantity));
-    tick->volume = convertQty(__builtin_bswap32(packet->volume));
-    tick->oi = convertQty(__builtin_bswap32(packet->oi));
-    tick->open = convertPrice(__builtin_bswap32(packet->open));
-    tick->high = convertPrice(__builtin_bswap32(packet->high));
-    tick->low = convertPrice(__builtin_bswap32(packet->low));
-    tick->close = convertPrice(__builtin_bswap32(packet->close));
-    tick->exchange_timestamp_ns = static_cast<uint64_t>(__builtin_bswap32(packet->timestamp)) * 1000000000ULL;
-    tick->local_timestamp_ns = Common::getNanosSinceEpoch();
-    tick->ticker_id = token_to_ticker_[tick->instrument_token];
-    
-    // Parse depth data
-    auto* depth = static_cast<KiteDepthUpdate*>(depth_pool_.allocate());
-    if (depth) {
-        depth->instrument_token = tick->instrument_token;
-        depth->ticker_id = tick->ticker_id;
-        depth->local_timestamp_ns = tick->local_timestamp_ns;
-        
-        // Parse bid levels
-        depth->bid_count = 0;
-        for (size_t i = 0; i < 5; ++i) {
-            uint32_t qty = __builtin_bswap32(packet->bid[i].quantity);
-            if (qty > 0) {
-                depth->bid_prices[depth->bid_count] = convertPrice(__builtin_bswap32(packet->bid[i].price));
-                depth->bid_qtys[depth->bid_count] = convertQty(qty);
-                depth->bid_orders[depth->bid_count] = __builtin_bswap16(packet->bid[i].orders);
-                depth->bid_count++;
-            }
-        }
-        
-        // Parse ask levels
-        depth->ask_count = 0;
-        for (size_t i = 0; i < 5; ++i) {
-            uint32_t qty = __builtin_bswap32(packet->ask[i].quantity);
-            if (qty > 0) {
-                depth->ask_prices[depth->ask_count] = convertPrice(__builtin_bswap32(packet->ask[i].price));
-                depth->ask_qtys[depth->ask_count] = convertQty(qty);
-                depth->ask_orders[depth->ask_count] = __builtin_bswap16(packet->ask[i].orders);
-                depth->ask_count++;
-            }
+    size_t full_count = 0;
+    for (size_t i = 0; i < batch.count; ++i) {
+        if (batch.mode[i] != KiteMode::MODE_FULL) {
+            continue;
         }
+        ++full_count;
         
         // Log tick data for display
         static uint64_t tick_counter = 0;
         if (++tick_counter % 100 == 1) {  // Log every 100th tick
             LOG_INFO("[MARKET DATA] Token=%u, LTP=%.2f, Vol=%u, Bid=%.2f@%u, Ask=%.2f@%u, O=%.2f H=%.2f L=%.2f C=%.2f",
-                    tick->instrument_token,
-                    static_cast<double>(tick->last_price) / 100.0,  // Convert paise to rupees
-                    tick->volume,
-                    depth->bid_count > 0 ? static_cast<double>(depth->bid_prices[0]) / 100.0 : 0.0,
-                    depth->bid_count > 0 ? depth->bid_qtys[0] : 0,
-                    depth->ask_count > 0 ? static_cast<double>(depth->ask_prices[0]) / 100.0 : 0.0,
-                    depth->ask_count > 0 ? depth->ask_qtys[0] : 0,
-                    static_cast<double>(tick->open) / 100.0,
-                    static_cast<double>(tick->high) / 100.0,
-                    static_cast<double>(tick->low) / 100.0,
-                    static_cast<double>(tick->close) / 100.0);
+                    batch.token[i],
+                    static_cast<double>(batch.last_price[i]) / 100.0,  // Convert paise to rupees
+                    batch.volume[i],
+                    static_cast<double>(batch.bid_price[i][0]) / 100.0,
+                    batch.bid_qty[i][0],
+                    static_cast<double>(batch.ask_price[i][0]) / 100.0,
+                    batch.ask_qty[i][0],
+                    static_cast<double>(batch.open[i]) / 100.0,
+                    static_cast<double>(batch.high[i]) / 100.0,
+                    static_cast<double>(batch.low[i]) / 100.0,
+                    static_cast<double>(batch.close[i]) / 100.0);
         }
-        
-        // Send depth updates
-        for (uint8_t i = 0; i < depth->bid_count; ++i) {
-            Common::MarketUpdate update;
-            update.update_type = MessageType::MARKET_DATA;
-            update.ticker_id = depth->ticker_id;
-            // update.side not available
-            update.bid_price = depth->bid_prices[i];
-            update.bid_qty = depth->bid_qtys[i];
-            // update.priority not available
-            publishUpdate(update);
+    }
+    
+    // One update per packet: the last trade of LTP and quote packets, the
+    // best bid and ask of full ones. With a depth queue, full packets go
+    // out only as snapshots below, so their book is written once, by the
+    // path keyed on instrument token.
+    const bool full_as_depth = depth_queue_ != nullptr;
+    const size_t update_count = full_as_depth ? batch.count - full_count : batch.count;
+    size_t i = 0;
+    size_t dropped = publishUpdates(update_count, [&](Common::MarketUpdate& update) {
+        while (full_as_depth && batch.mode[i] == KiteMode::MODE_FULL) {
+            ++i;
         }
-        
-        for (uint8_t i = 0; i < depth->ask_count; ++i) {
-            Common::MarketUpdate update;
-            update.update_type = MessageType::MARKET_DATA;
-            update.ticker_id = depth->ticker_id;
-            // update.side not available
-            update.bid_price = depth->ask_prices[i];
-            update.bid_qty = depth->ask_qtys[i];
-            // update.priority not available
-            publishUpdate(update);
+        update.reset();
+        update.ticker_id = tickerFor(batch.token[i]);
+        update.timestamp = now_ns;
+        if (batch.mode[i] == KiteMode::MODE_FULL) {
+            if (batch.bid_qty[i][0] != 0) {
+                update.bid_price = convertPrice(batch.bid_price[i][0]);
+                update.bid_qty = convertQty(batch.bid_qty[i][0]);
+            }
+            if (batch.ask_qty[i][0] != 0) {
+                update.ask_price = convertPrice(batch.ask_price[i][0]);
+                update.ask_qty = convertQty(batch.ask_qty[i][0]);
+            }
+        } else {
+            update.bid_price = convertPrice(batch.last_price[i]);
+            update.bid_qty = batch.mode[i] == KiteMode::MODE_LTP ? 0 : convertQty(batch.last_qty[i]);
         }
-        
-        depth_pool_.deallocate(depth);
-    }
+        ++i;
+    });
     
-    // Send trade update
-    Common::MarketUpdate update;
-    update.update_type = MessageType::MARKET_DATA;
-    update.ticker_id = tick->ticker_id;
-    // update.side not available
-    update.bid_price = tick->last_price;
-    update.bid_qty = tick->last_qty;
-    // update.priority not available
-    
-    if (!publishUpdate(update)) {
-        ticks_dropped_.fetch_add(1);
-    } else {
-        ticks_received_.fetch_add(1);
+    // Full packets go out whole, one snapshot each
+    if (full_as_depth && full_count > 0) {
+        size_t j = 0;
+        dropped += publishSnapshots(full_count, [&](Common::DepthSnapshot& snap) {
+            while (batch.mode[j] != KiteMode::MODE_FULL) {
+                ++j;
+            }
+            snap.ticker_id = tickerFor(batch.token[j]);
+            snap.instrument_token = batch.token[j];
+            snap.timestamp = now_ns;
+            snap.exchange_time_ns = static_cast<uint64_t>(batch.exchange_time[j]) * 1000000000ULL;
+            snap.last_price = convertPrice(batch.last_price[j]);
+            snap.last_qty = convertQty(batch.last_qty[j]);
+            snap.volume = convertQty(batch.volume[j]);
+            snap.bid_count = stageLevels(batch.bid_price[j], batch.bid_qty[j], batch.bid_orders[j],
+                                         snap.bid_prices, snap.bid_qtys, snap.bid_orders);
+            snap.ask_count = stageLevels(batch.ask_price[j], batch.ask_qty[j], batch.ask_orders[j],
+                                         snap.ask_prices, snap.ask_qtys, snap.ask_orders);
+            ++j;
+        });
+    }
+    
+    ticks_received_.fetch_add(batch.count, std::memory_order_relaxed);
+    if (dropped) {
+        ticks_dropped_.fetch_add(dropped, std::memory_order_relaxed);
     }
-    
-    tick_pool_.deallocate(tick);
+}
+
+auto KiteWSClient::stageLevels(const uint32_t* prices, const uint32_t* qtys, const uint16_t* orders,
+                               Price* out_prices, Qty* out_qtys, uint16_t* out_orders) const noexcept -> uint8_t {
+    uint8_t count = 0;
+    for (size_t level = 0; level < KiteFrameBatch::MAX_DEPTH; ++level) {
+        if (qtys[level] != 0) {
+            out_prices[count] = convertPrice(prices[level]);
+            out_qtys[count] = convertQty(qtys[level]);
+            out_orders[count] = orders[level];
+            ++count;
+        }
+    }
+    return count;
 }
 
 auto KiteWSClient::sendWebSocketFrame(const uint8_t* data, size_t len, uint8_t opcode) -> bool {
@@ -875,9 +780,12 @@ auto KiteWSClient::handleReconnect() -> void {
         uint32_t tokens_to_subscribe[1000];
         size_t token_count = 0;
         
-        for (size_t i = 0; i < MAX_INSTRUMENTS && token_count < 1000; ++i) {
-            if (subscribed_tokens_[i].load()) {
-                tokens_to_subscribe[token_count++] = static_cast<uint32_t>(i);
+        {
+            std::lock_guard<std::mutex> lock(token_mutex_);
+            for (size_t i = 0; i < token_count_ && token_count < 1000; ++i) {
+                if (token_states_[i].subscribed.load()) {
+                    tokens_to_subscribe[token_count++] = token_states_[i].token;
+                }
             }
         }
         
@@ -3,12 +3,14 @@
 #include "trading/market_data/instrument_fetcher.h"
 #include "trading/auth/zerodha/zerodha_auth.h"
 #include "common/mem_pool.h"
+#include "common/decimal_codec.h"
 
 namespace Trading::MarketData::Zerodha {
 
 // Maximum instruments we can handle
 constexpr size_t MAX_INSTRUMENTS = 100000;
 constexpr size_t MAX_OPTION_CHAIN = 100;
+constexpr uint32_t PRICE_SCALE = 2;  // Prices are held in paise
 
 class ZerodhaInstrumentFetcher final : public IInstrumentFetcher {
 private:
@@ -52,6 +54,13 @@ private:
         return strstr(norm1, norm2) != nullptr || strstr(norm2, norm1) != nullptr;
     }
     
+    // Rupee decimal ("2450.05") to paise; 0 if empty or malformed
+    static auto parsePaise(const char* str) noexcept -> Price {
+        Price paise = 0;
+        if (!Common::parseDecimal(str, str + strlen(str), PRICE_SCALE, paise)) return 0;
+        return paise;
+    }
+    
     // Parse expiry date from YYYY-MM-DD format
     static auto parseExpiryDate(const char* date_str) noexcept -> uint64_t {
         if (!date_str || !date_str[0]) return 0;
@@ -162,10 +171,10 @@ public:
                 strncpy(inst.name, fields[3], sizeof(inst.name) - 1);
                 
                 // Parse numeric fields
-                inst.last_price = static_cast<Price>(atof(fields[4]) * 100);  // Convert to paisa
+                inst.last_price = parsePaise(fields[4]);
                 inst.expiry_timestamp_ns = parseExpiryDate(fields[5]);
-                inst.strike_price = static_cast<Price>(atof(fields[6]) * 100);
-                inst.tick_size = static_cast<Price>(atof(fields[7]) * 100);
+                inst.strike_price = parsePaise(fields[6]);
+                inst.tick_size = parsePaise(fields[7]);
                 inst.lot_size = static_cast<Qty>(atoi(fields[8]));
                 
                 // Parse type and exchange
@@ -453,18 +462,23 @@ public:
                 default: break;
             }
             
-            fprintf(file, "%s,%s,%s,%s,%s,%s,%.2f,%lu,%llu,%.2f,%.2f,%lu,%lu\n",
+            char tick_size[Common::DECIMAL_BUFFER_SIZE], strike[Common::DECIMAL_BUFFER_SIZE], last_price[Common::DECIMAL_BUFFER_SIZE];
+            Common::formatDecimal(inst.tick_size, PRICE_SCALE, tick_size);
+            Common::formatDecimal(inst.strike_price, PRICE_SCALE, strike);
+            Common::formatDecimal(inst.last_price, PRICE_SCALE, last_price);
+            
+            fprintf(file, "%s,%s,%s,%s,%s,%s,%s,%lu,%llu,%s,%s,%lu,%lu\n",
                    inst.instrument_token,
                    inst.trading_symbol,
                    inst.underlying,
                    inst.name,
                    type_str,
                    exchange_str,
-                   static_cast<double>(inst.tick_size) / 100.0,
+                   tick_size,
                    inst.lot_size,
                    static_cast<unsigned long long>(inst.expiry_timestamp_ns),
-                   static_cast<double>(inst.strike_price) / 100.0,
-                   static_cast<double>(inst.last_price) / 100.0,
+                   strike,
+                   last_price,
                    inst.volume,
                    inst.open_interest);
         }
@@ -497,32 +511,32 @@ public:
             inst = Instrument{};  // Value-initialize instead of memset
             
             char type_str[16], exchange_str[16];
-            double tick_size, strike, last_price;
+            char tick_size[Common::DECIMAL_BUFFER_SIZE], strike[Common::DECIMAL_BUFFER_SIZE], last_price[Common::DECIMAL_BUFFER_SIZE];
             unsigned long long expiry_ns;
             
             int fields = sscanf(line, "%31[^,],%31[^,],%31[^,],%63[^,],%15[^,],%15[^,],"
-                                     "%lf,%lu,%llu,%lf,%lf,%lu,%lu",
+                                     "%23[^,],%lu,%llu,%23[^,],%23[^,],%lu,%lu",
                                inst.instrument_token,
                                inst.trading_symbol,
                                inst.underlying,
                                inst.name,
                                type_str,
                                exchange_str,
-                               &tick_size,
+                               tick_size,
                                &inst.lot_size,
                                &expiry_ns,
-                               &strike,
-                               &last_price,
+                               strike,
+                               last_price,
                                &inst.volume,
                                &inst.open_interest);
             
             if (fields >= 11) {
                 inst.type = parseInstrumentType(type_str);
                 inst.exchange = parseExchange(exchange_str);
-                inst.tick_size = static_cast<Price>(tick_size * 100);
+                inst.tick_size = parsePaise(tick_size);
                 inst.expiry_timestamp_ns = expiry_ns;
-                inst.strike_price = static_cast<Price>(strike * 100);
-                inst.last_price = static_cast<Price>(last_price * 100);
+                inst.strike_price = parsePaise(strike);
+                inst.last_price = parsePaise(last_price);
                 inst.is_tradeable = true;
                 inst.last_updated_ns = last_update_time_ns_;
                 
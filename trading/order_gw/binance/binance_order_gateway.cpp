@@ -1,5 +1,6 @@
 #include "binance_order_gateway.h"
 #include "common/time_utils.h"
+#include "common/decimal_codec.h"
 #include <cstring>
 #include <unistd.h>
 #include <sys/socket.h>
@@ -11,6 +12,21 @@ namespace Trading::Binance {
 
 using namespace Common;
 
+namespace {
+
+// A decimal string field at Binance's scale; 0 if it doesn't parse
+template<typename T>
+auto decimalField(const rapidjson::Value& value) noexcept -> T {
+    const char* str = value.GetString();
+    T out = 0;
+    if (!parseDecimal(str, str + value.GetStringLength(), BinanceOrderGateway::DECIMAL_SCALE, out)) {
+        return 0;
+    }
+    return out;
+}
+
+} // namespace
+
 BinanceOrderGateway::BinanceOrderGateway(SPSCLFQueue<OrderRequest*, 65536>* request_queue,
                                          SPSCLFQueue<OrderResponse*, 65536>* response_queue,
                                          BinanceAuth* auth)
@@ -78,6 +94,8 @@ void BinanceOrderGateway::stop() {
         return;
     }
     
+    request_event_.notify();  // Wake a parked order processor
+    
     if (order_processor_thread_.joinable()) {
         order_processor_thread_.join();
     }
@@ -145,6 +163,7 @@ bool BinanceOrderGateway::sendOrder(const OrderRequest& request) {
     
     *order_requests_queue_->getNextToWriteTo() = req_copy;
     order_requests_queue_->updateWriteIndex();
+    notifyRequest();
     
     return true;
 }
@@ -258,10 +277,14 @@ void BinanceOrderGateway::runOrderProcessor() noexcept {
             }
             
             order_requests_queue_->updateReadIndex();
+            wait_strategy_.reset();
+        } else {
+            // Nothing queued - idle per the configured wait strategy
+            wait_strategy_.idle([this] {
+                return !running_.load(std::memory_order_relaxed) ||
+                       order_requests_queue_->size() != 0;
+            });
         }
-        
-        // Small sleep to avoid busy spinning
-        std::this_thread::sleep_for(std::chrono::microseconds(100));
     }
     
     LOG_INFO("Order processor thread stopped");
@@ -451,8 +474,8 @@ void BinanceOrderGateway::processExecutionReport(const rapidjson::Document& doc)
     // Handle different execution types
     if (strcmp(exec_type, "TRADE") == 0) {
         // Trade execution
-        const Qty last_filled_qty = static_cast<Qty>(std::stod(doc["l"].GetString()) * 100000000);
-        const Price last_exec_price = static_cast<Price>(std::stod(doc["L"].GetString()) * 100000000);
+        const Qty last_filled_qty = decimalField<Qty>(doc["l"]);
+        const Price last_exec_price = decimalField<Price>(doc["L"]);
         
         order->filled_qty += last_filled_qty;
         
@@ -600,8 +623,7 @@ void BinanceOrderGateway::convertToBinanceRequest(const OrderRequest& internal,
             break;
         case OrderType::STOP:
             strncpy(binance.type, "STOP_LOSS_LIMIT", sizeof(binance.type) - 1);
-            snprintf(binance.stopPrice, sizeof(binance.stopPrice), "%.8f", 
-                    internal.stop_price / 100000000.0);
+            formatDecimal(internal.stop_price, DECIMAL_SCALE, binance.stopPrice);
             strncpy(binance.timeInForce, "GTC", sizeof(binance.timeInForce) - 1);
             break;
         default:
@@ -610,10 +632,8 @@ void BinanceOrderGateway::convertToBinanceRequest(const OrderRequest& internal,
     }
     
     // Quantity and price (Binance uses decimal strings)
-    snprintf(binance.quantity, sizeof(binance.quantity), "%.8f", 
-            internal.qty / 100000000.0);
-    snprintf(binance.price, sizeof(binance.price), "%.8f", 
-            internal.price / 100000000.0);
+    formatDecimal(internal.qty, DECIMAL_SCALE, binance.quantity);
+    formatDecimal(internal.price, DECIMAL_SCALE, binance.price);
     
     // Client order ID
     binance.newClientOrderId = internal.order_id;
@@ -635,13 +655,13 @@ void BinanceOrderGateway::parseOrderResponse(const rapidjson::Document& doc, Ord
         info.side = (strcmp(side, "BUY") == 0) ? OrderSide::BUY : OrderSide::SELL;
     }
     if (doc.HasMember("price")) {
-        info.price = static_cast<Price>(std::stod(doc["price"].GetString()) * 100000000);
+        info.price = decimalField<Price>(doc["price"]);
     }
     if (doc.HasMember("origQty")) {
-        info.quantity = static_cast<Qty>(std::stod(doc["origQty"].GetString()) * 100000000);
+        info.quantity = decimalField<Qty>(doc["origQty"]);
     }
     if (doc.HasMember("executedQty")) {
-        info.filled_qty = static_cast<Qty>(std::stod(doc["executedQty"].GetString()) * 100000000);
+        info.filled_qty = decimalField<Qty>(doc["executedQty"]);
     }
     if (doc.HasMember("status")) {
         strncpy(info.status, doc["status"].GetString(), sizeof(info.status) - 1);
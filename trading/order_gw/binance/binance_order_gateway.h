@@ -33,6 +33,9 @@ struct BinanceOrderRequest {
 /// Binance Order Gateway - implements REST API and WebSocket for order management
 class alignas(CACHE_LINE_SIZE) BinanceOrderGateway : public IOrderGateway {
 public:
+    // Prices and quantities are 1e8 fixed point, as Binance quotes them
+    static constexpr uint32_t DECIMAL_SCALE = 8;
+
     BinanceOrderGateway(SPSCLFQueue<OrderRequest*, 65536>* request_queue,
                         SPSCLFQueue<OrderResponse*, 65536>* response_queue,
                         BinanceAuth* auth);
@@ -3,6 +3,8 @@
 #include "common/types.h"
 #include "common/lf_queue.h"
 #include "common/macros.h"
+#include "common/wait_strategy.h"
+#include "config/config.h"
 
 namespace Trading {
 
@@ -29,6 +31,12 @@ public:
     virtual auto cancelOrder(Common::OrderId order_id) -> bool = 0;
     virtual auto modifyOrder(Common::OrderId order_id, Common::Price new_price, Common::Qty new_qty) -> bool = 0;
     
+    // Producers call this after queueing a request; wakes a parked gateway
+    auto notifyRequest() noexcept -> void { request_event_.notify(); }
+    
+    // Idle strategy of the order processor thread ([wait_strategy] order_gateway)
+    auto setWaitStrategy(Common::WaitStrategyKind kind) noexcept -> void { wait_strategy_.setKind(kind); }
+    
     // Delete copy/move operations
     IOrderGateway(const IOrderGateway&) = delete;
     IOrderGateway& operator=(const IOrderGateway&) = delete;
@@ -40,6 +48,14 @@ protected:
     Common::LFQueue<Common::OrderResponse, 65536>* order_responses_queue_;
     std::atomic<bool> running_;
     
+    // Order processor idles here between requests ([wait_strategy]
+    // order_gateway); sendOrder() wakes it when it parks
+    Common::WaitEvent request_event_;
+    Common::WaitStrategy wait_strategy_{
+        ConfigManager::getWaitConfig(ConfigManager::getConfig().wait_strategy.order_gateway,
+                                     Common::WaitStrategyKind::Park),
+        &request_event_};
+    
     // Helper method for derived classes to publish responses
     auto publishResponse(const Common::OrderResponse& response) -> bool {
         return order_responses_queue_->enqueue(response);
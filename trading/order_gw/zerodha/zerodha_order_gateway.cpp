@@ -1,5 +1,6 @@
 #include "zerodha_order_gateway.h"
 #include "common/time_utils.h"
+#include "common/decimal_codec.h"
 #include <cstring>
 #include <unistd.h>
 
@@ -7,6 +8,22 @@ namespace Trading::Zerodha {
 
 using namespace Common;
 
+namespace {
+
+// A number field read as its text (kParseNumbersAsStringsFlag); 0 if it
+// doesn't parse
+template<typename T>
+auto decimalField(const rapidjson::Value& value, uint32_t scale) noexcept -> T {
+    const char* str = value.GetString();
+    T out = 0;
+    if (!parseDecimal(str, str + value.GetStringLength(), scale, out)) {
+        return 0;
+    }
+    return out;
+}
+
+} // namespace
+
 ZerodhaOrderGateway::ZerodhaOrderGateway(SPSCLFQueue<OrderRequest*, 65536>* request_queue,
                                          SPSCLFQueue<OrderResponse*, 65536>* response_queue,
                                          ZerodhaAuth* auth)
@@ -70,6 +87,8 @@ void ZerodhaOrderGateway::stop() {
         return;
     }
     
+    request_event_.notify();  // Wake a parked order processor
+    
     if (order_processor_thread_.joinable()) {
         order_processor_thread_.join();
     }
@@ -123,6 +142,7 @@ bool ZerodhaOrderGateway::sendOrder(const OrderRequest& request) {
     
     *order_requests_queue_->getNextToWriteTo() = req_copy;
     order_requests_queue_->updateWriteIndex();
+    notifyRequest();
     
     return true;
 }
@@ -225,10 +245,14 @@ void ZerodhaOrderGateway::runOrderProcessor() noexcept {
             
             last_request_time_ns_.store(getNanosSinceEpoch());
             order_requests_queue_->updateReadIndex();
+            wait_strategy_.reset();
+        } else {
+            // Nothing queued - idle per the configured wait strategy
+            wait_strategy_.idle([this] {
+                return !running_.load(std::memory_order_relaxed) ||
+                       order_requests_queue_->size() != 0;
+            });
         }
-        
-        // Small sleep to avoid busy spinning
-        std::this_thread::sleep_for(std::chrono::microseconds(100));
     }
     
     LOG_INFO("Order processor thread stopped");
@@ -304,14 +328,19 @@ void ZerodhaOrderGateway::runStatusPoller() noexcept {
 }
 
 bool ZerodhaOrderGateway::placeOrder(const ZerodhaOrderRequest& req, char* order_id_out) {
+    char price[DECIMAL_BUFFER_SIZE];
+    char trigger_price[DECIMAL_BUFFER_SIZE];
+    formatDecimal(req.price, PRICE_SCALE, price);
+    formatDecimal(req.trigger_price, PRICE_SCALE, trigger_price);
+
     char payload[1024];
     snprintf(payload, sizeof(payload),
              "exchange=%s&tradingsymbol=%s&transaction_type=%s&"
              "order_type=%s&quantity=%lu&product=%s&validity=%s&"
-             "price=%.2f&trigger_price=%.2f&disclosed_quantity=%lu&tag=%lu",
+             "price=%s&trigger_price=%s&disclosed_quantity=%lu&tag=%lu",
              req.exchange, req.tradingsymbol, req.transaction_type,
              req.order_type, req.quantity, req.product, req.validity,
-             req.price / 100.0, req.trigger_price / 100.0, 
+             price, trigger_price,
              req.disclosed_quantity, req.tag);
     
     char response[4096];
@@ -346,9 +375,11 @@ bool ZerodhaOrderGateway::modifyOrderApi(const char* order_id, Price new_price,
     char endpoint[256];
     snprintf(endpoint, sizeof(endpoint), "/orders/regular/%s", order_id);
     
+    char price[DECIMAL_BUFFER_SIZE];
+    formatDecimal(new_price, PRICE_SCALE, price);
+
     char payload[256];
-    snprintf(payload, sizeof(payload), "price=%.2f&quantity=%lu", 
-             new_price / 100.0, new_qty);
+    snprintf(payload, sizeof(payload), "price=%s&quantity=%lu", price, new_qty);
     
     char response[4096];
     return sendHttpRequest("PUT", endpoint, payload, response, sizeof(response));
@@ -466,8 +497,9 @@ void ZerodhaOrderGateway::convertToZerodhaRequest(const OrderRequest& internal,
 }
 
 void ZerodhaOrderGateway::parseOrderStatus(const char* json, OrderInfo& info) {
+    // Numbers stay text so the price never passes through a double
     rapidjson::Document doc;
-    doc.Parse(json);
+    doc.Parse<rapidjson::kParseNumbersAsStringsFlag>(json);
     
     if (doc.HasMember("data") && doc["data"].IsArray() && doc["data"].Size() > 0) {
         const auto& order = doc["data"][0];
@@ -481,13 +513,13 @@ void ZerodhaOrderGateway::parseOrderStatus(const char* json, OrderInfo& info) {
                    sizeof(info.status) - 1);
         }
         if (order.HasMember("filled_quantity")) {
-            info.filled_qty = order["filled_quantity"].GetUint64();
+            info.filled_qty = decimalField<Qty>(order["filled_quantity"], 0);
         }
         if (order.HasMember("price")) {
-            info.price = static_cast<Price>(order["price"].GetDouble() * 100);
+            info.price = decimalField<Price>(order["price"], PRICE_SCALE);
         }
         if (order.HasMember("quantity")) {
-            info.quantity = order["quantity"].GetUint64();
+            info.quantity = decimalField<Qty>(order["quantity"], 0);
         }
     }
 }
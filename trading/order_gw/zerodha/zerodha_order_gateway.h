@@ -34,6 +34,9 @@ struct ZerodhaOrderRequest {
 /// Zerodha Order Gateway - implements REST API for order management
 class alignas(CACHE_LINE_SIZE) ZerodhaOrderGateway : public IOrderGateway {
 public:
+    // Prices are in paise, Kite's two decimal places
+    static constexpr uint32_t PRICE_SCALE = 2;
+
     ZerodhaOrderGateway(SPSCLFQueue<OrderRequest*, 65536>* request_queue,
                         SPSCLFQueue<OrderResponse*, 65536>* response_queue,
                         ZerodhaAuth* auth);
@@ -4,6 +4,7 @@
 #include "common/logging.h"
 #include "common/macros.h"
 #include "trading/market_data/order_book.h"
+#include "trading/market_data/depth_kernels.h"
 #include <atomic>
 #include <array>
 #include <cmath>
@@ -24,6 +25,7 @@ struct MarketFeatures {
     double agg_trade_ratio{std::numeric_limits<double>::quiet_NaN()};   // Aggressive trade qty ratio
     double momentum{std::numeric_limits<double>::quiet_NaN()};          // Price momentum
     double volatility{std::numeric_limits<double>::quiet_NaN()};        // Rolling volatility
+    double depth_imbalance{std::numeric_limits<double>::quiet_NaN()};   // Imbalance over all levels, decayed by level
     uint64_t last_update_ns{0};                                         // Last update timestamp
     
     bool isValid() const noexcept {
@@ -37,12 +39,13 @@ public:
     FeatureEngine();
     ~FeatureEngine() = default;
     
-    /// Update features on order book change
-    void onOrderBookUpdate(TickerId ticker_id, const MarketData::OrderBook<100>* book) noexcept {
+    /// Update features on order book change (OrderBook<N> or LadderBook)
+    template<typename Book>
+    void onOrderBookUpdate(TickerId ticker_id, const Book* book) noexcept {
         if (ticker_id >= ME_MAX_TICKERS || !book) return;
         
         auto& features = features_[ticker_id];
-        const uint64_t now_ns = Common::getNanosSinceEpoch();
+        const uint64_t now_ns = Common::TscClock::monoNs();
         
         // Get best bid/ask
         Price best_bid = Price_INVALID;
@@ -223,40 +226,36 @@ private:
     };
     std::array<MomentumData, ME_MAX_TICKERS> momentum_;
     
+    // Levels read for depth features, and the weight lost per level
+    static constexpr size_t DEPTH_LEVELS = 20;
+    static constexpr double DEPTH_DECAY = 0.8;
+    
     /// Calculate depth-weighted features
-    void calculateDepthFeatures(TickerId ticker_id, const MarketData::OrderBook<100>* book) noexcept {
+    template<typename Book>
+    void calculateDepthFeatures(TickerId ticker_id, const Book* book) noexcept {
         auto& features = features_[ticker_id];
         
-        double weighted_bid_price = 0.0;
-        double weighted_ask_price = 0.0;
-        uint64_t total_bid_qty = 0;
-        uint64_t total_ask_qty = 0;
-        
-        // Process top 5 levels for depth-weighted prices
-        const size_t depth = 5;
-        
-        for (size_t i = 0; i < depth; ++i) {
-            const auto [price, qty, orders] = book->getBidLevel(static_cast<uint8_t>(i));
-            if (price == Price_INVALID || price == 0) break;
-            weighted_bid_price += static_cast<double>(price) * static_cast<double>(qty);
-            total_bid_qty += qty;
-        }
+        MarketData::Depth::SideLevels<DEPTH_LEVELS> bids;
+        MarketData::Depth::SideLevels<DEPTH_LEVELS> asks;
+        MarketData::Depth::bidLevels(*book, bids);
+        MarketData::Depth::askLevels(*book, asks);
         
-        for (size_t i = 0; i < depth; ++i) {
-            const auto [price, qty, orders] = book->getAskLevel(static_cast<uint8_t>(i));
-            if (price == Price_INVALID || price == 0) break;
-            weighted_ask_price += static_cast<double>(price) * static_cast<double>(qty);
-            total_ask_qty += qty;
-        }
+        // Depth-weighted prices over the top 5 levels: the VWAP of sweeping them
+        constexpr size_t depth = 5;
+        constexpr Qty whole_side = std::numeric_limits<Qty>::max();
+        const auto bid_fill = MarketData::Depth::vwapToFill(bids.prices, bids.qtys, std::min(bids.count, depth), whole_side);
+        const auto ask_fill = MarketData::Depth::vwapToFill(asks.prices, asks.qtys, std::min(asks.count, depth), whole_side);
         
         // Update micro price with depth weighting
-        if (total_bid_qty > 0 && total_ask_qty > 0) {
-            const double weighted_bid = weighted_bid_price / static_cast<double>(total_bid_qty);
-            const double weighted_ask = weighted_ask_price / static_cast<double>(total_ask_qty);
-            features.micro_price = (weighted_bid * static_cast<double>(total_ask_qty) + 
-                                   weighted_ask * static_cast<double>(total_bid_qty)) / 
-                                  static_cast<double>(total_bid_qty + total_ask_qty);
+        if (bid_fill.filled > 0 && ask_fill.filled > 0) {
+            features.micro_price = (bid_fill.vwap * static_cast<double>(ask_fill.filled) + 
+                                   ask_fill.vwap * static_cast<double>(bid_fill.filled)) / 
+                                  static_cast<double>(bid_fill.filled + ask_fill.filled);
         }
+        
+        // Imbalance across every level we hold, fading with distance from the touch
+        features.depth_imbalance = MarketData::Depth::weightedImbalance(bids.qtys, bids.count,
+                                                                        asks.qtys, asks.count, DEPTH_DECAY);
     }
     
     /// Update momentum indicator
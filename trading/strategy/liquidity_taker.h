@@ -42,7 +42,8 @@ public:
     }
     
     /// Process order book update - monitor for taking opportunities
-    void onOrderBookUpdate(TickerId ticker_id, const MarketData::OrderBook<100>* book) noexcept {
+    template<typename Book>
+    void onOrderBookUpdate(TickerId ticker_id, const Book* book) noexcept {
         if (ticker_id >= ME_MAX_TICKERS || !book) return;
         
         const auto& config = ticker_configs_[ticker_id];
@@ -60,7 +61,7 @@ public:
             if (best_bid == Price_INVALID || best_ask == Price_INVALID) return;
             
             // Check cooldown
-            const uint64_t now_ns = Common::getNanosSinceEpoch();
+            const uint64_t now_ns = Common::TscClock::monoNs();
             const uint64_t last_order_ns = last_order_time_[ticker_id].load(std::memory_order_relaxed);
             if ((now_ns - last_order_ns) < static_cast<uint64_t>(config.cooldown_ms) * 1000000) {
                 return; // Still in cooldown
@@ -106,7 +107,7 @@ public:
         // Check if aggressive trade ratio exceeds threshold
         if (features->agg_trade_ratio >= config.threshold) {
             // Check cooldown
-            const uint64_t now_ns = Common::getNanosSinceEpoch();
+            const uint64_t now_ns = Common::TscClock::monoNs();
             const uint64_t last_order_ns = last_order_time_[ticker_id].load(std::memory_order_relaxed);
             if ((now_ns - last_order_ns) < static_cast<uint64_t>(config.cooldown_ms) * 1000000) {
                 return; // Still in cooldown
@@ -212,7 +213,7 @@ private:
         auto& mom = momentum_[ticker_id];
         
         // Reset if more than 1 second has passed
-        const uint64_t now_ns = Common::getNanosSinceEpoch();
+        const uint64_t now_ns = Common::TscClock::monoNs();
         const uint64_t last_reset = mom.last_reset_ns.load(std::memory_order_relaxed);
         if ((now_ns - last_reset) > 1000000000) { // 1 second
             mom.buy_volume.store(0, std::memory_order_relaxed);
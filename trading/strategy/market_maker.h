@@ -5,6 +5,7 @@
 #include "common/macros.h"
 #include "order_manager.h"
 #include "feature_engine.h"
+#include "trading/market_data/depth_kernels.h"
 #include "risk_manager.h"
 #include "position_keeper.h"
 #include <unordered_map>
@@ -20,6 +21,7 @@ struct MarketMakerConfig {
     Price tick_size{100};       // Minimum price increment
     Qty min_size{10};          // Minimum order size
     Qty max_position{10000};   // Maximum position size
+    double max_unwind_bps{10.0}; // Quote no more than rests within this of our touch
     bool enabled{true};         // Enable/disable for this symbol
 };
 
@@ -41,7 +43,8 @@ public:
     }
     
     /// Process order book update - main market making logic
-    void onOrderBookUpdate(TickerId ticker_id, const MarketData::OrderBook<100>* book) noexcept {
+    template<typename Book>
+    void onOrderBookUpdate(TickerId ticker_id, const Book* book) noexcept {
         if (ticker_id >= ME_MAX_TICKERS || !book) return;
         
         const auto& config = ticker_configs_[ticker_id];
@@ -106,12 +109,25 @@ public:
             ask_size = std::max(config.min_size, ask_size / 2);
         }
         
-        // Move or place orders
-        order_manager_->moveOrders(ticker_id, our_bid, our_ask, config.clip);
+        // Size-aware: don't take on more than the book would absorb near
+        // the touch if we had to unwind it (a bid fill is sold into the bids)
+        MarketData::Depth::SideLevels<DEPTH_LEVELS> bids;
+        MarketData::Depth::SideLevels<DEPTH_LEVELS> asks;
+        MarketData::Depth::bidLevels(*book, bids);
+        MarketData::Depth::askLevels(*book, asks);
+        const auto unwind_distance = static_cast<Price>(static_cast<double>(best_bid) * config.max_unwind_bps / 10000.0);
+        const Qty bid_room = MarketData::Depth::bidDepthWithin(bids.prices, bids.qtys, bids.count, best_bid - unwind_distance);
+        const Qty ask_room = MarketData::Depth::askDepthWithin(asks.prices, asks.qtys, asks.count, best_ask + unwind_distance);
+        bid_size = std::max(config.min_size, std::min(bid_size, bid_room));
+        ask_size = std::max(config.min_size, std::min(ask_size, ask_room));
+        
+        // Move or place orders; each side keeps its own size so the
+        // inventory skew above survives
+        order_manager_->moveOrders(ticker_id, our_bid, our_ask, bid_size, ask_size);
         
         // Update statistics
         quotes_updated_++;
-        last_update_ns_ = Common::getNanosSinceEpoch();
+        last_update_ns_ = Common::TscClock::monoNs();
         
         LOG_DEBUG("MM: Updated quotes for ticker %u: bid=%ld@%lu, ask=%ld@%lu, pos=%ld",
                  ticker_id, our_bid, bid_size, our_ask, ask_size, position);
@@ -179,6 +195,9 @@ private:
     // Configuration per symbol
     std::array<MarketMakerConfig, ME_MAX_TICKERS> ticker_configs_;
     
+    // Levels read when sizing quotes against depth
+    static constexpr size_t DEPTH_LEVELS = 20;
+    
     // Statistics
     std::atomic<uint64_t> quotes_updated_{0};
     std::atomic<uint64_t> trades_observed_{0};
@@ -20,8 +20,9 @@ OrderManager::OrderManager(TradeEngine* trade_engine, RiskManager* risk_manager)
 }
 
 Order* OrderManager::createOrder(TickerId ticker_id, Side side, Price price, Qty quantity) noexcept {
-    // Find free slot
-    const size_t slot = findFreeSlot();
+    // Generate order ID and claim its slot
+    OrderId order_id = OrderId_INVALID;
+    const size_t slot = claimSlot(order_id);
     if (slot == MAX_ORDERS) {
         LOG_WARN("Order pool exhausted - cannot create order");
         return nullptr;
@@ -30,9 +31,6 @@ Order* OrderManager::createOrder(TickerId ticker_id, Side side, Price price, Qty
     auto& entry = static_cast<OrderEntry&>(orders_[slot]);
     auto& order = entry.order;
     
-    // Generate order ID
-    const OrderId order_id = next_order_id_.fetch_add(1, std::memory_order_relaxed);
-    
     // Initialize order
     order.order_id = order_id;
     order.client_id = ClientId_INVALID; // Set by caller if needed
@@ -43,7 +41,7 @@ Order* OrderManager::createOrder(TickerId ticker_id, Side side, Price price, Qty
     order.filled_qty = 0;
     order.leaves_qty = quantity;
     order.state = OrderState::PENDING_NEW;
-    order.timestamp_ns = Common::getNanosSinceEpoch();
+    order.timestamp_ns = Common::TscClock::monoNs();
     order.last_update_ns = order.timestamp_ns;
     
     // Mark as active
@@ -72,7 +70,7 @@ bool OrderManager::cancelOrder(OrderId order_id) noexcept {
     
     // Update state
     order->state = OrderState::PENDING_CANCEL;
-    order->last_update_ns = Common::getNanosSinceEpoch();
+    order->last_update_ns = Common::TscClock::monoNs();
     
     total_orders_canceled_.fetch_add(1, std::memory_order_relaxed);
     
@@ -105,7 +103,7 @@ bool OrderManager::modifyOrder(OrderId order_id, Price new_price, Qty new_qty) n
     order->original_qty = new_qty;
     order->leaves_qty = new_qty - order->filled_qty;
     order->state = OrderState::PENDING_MODIFY;
-    order->last_update_ns = Common::getNanosSinceEpoch();
+    order->last_update_ns = Common::TscClock::monoNs();
     
     LOG_DEBUG("Modifying order: id=%lu, new_px=%lu, new_qty=%u",
              order_id, new_price, new_qty);
@@ -120,7 +118,7 @@ void OrderManager::onOrderUpdate(OrderId order_id, OrderState new_state,
         return;
     }
     
-    const uint64_t now_ns = Common::getNanosSinceEpoch();
+    const uint64_t now_ns = Common::TscClock::monoNs();
     
     // Update order state
     order->state = new_state;
@@ -177,7 +175,8 @@ void OrderManager::cancelAllOrders(TickerId ticker_id) noexcept {
     LOG_INFO("Canceled %zu orders for ticker %u", canceled, ticker_id);
 }
 
-void OrderManager::moveOrders(TickerId ticker_id, Price bid_price, Price ask_price, Qty clip) noexcept {
+void OrderManager::moveOrders(TickerId ticker_id, Price bid_price, Price ask_price,
+                              Qty bid_qty, Qty ask_qty) noexcept {
     // Get active orders for this symbol
     Order* active_orders[100];
     const size_t count = getActiveOrders(ticker_id, active_orders, 100);
@@ -206,6 +205,7 @@ void OrderManager::moveOrders(TickerId ticker_id, Price bid_price, Price ask_pri
         
         if (needs_move) {
             // Adjust quantity if needed
+            const Qty clip = order->side == 1 ? bid_qty : ask_qty;
             Qty new_qty = order->original_qty;
             if (clip > 0 && order->leaves_qty > clip) {
                 new_qty = order->filled_qty + clip;
@@ -216,14 +216,17 @@ void OrderManager::moveOrders(TickerId ticker_id, Price bid_price, Price ask_pri
     }
 }
 
-size_t OrderManager::findFreeSlot() noexcept {
-    // Linear search for free slot (can be optimized with free list)
-    for (size_t i = 0; i < MAX_ORDERS; ++i) {
-        auto& entry = static_cast<OrderEntry&>(orders_[i]);
+size_t OrderManager::claimSlot(OrderId& order_id) noexcept {
+    // An id lives at id % MAX_ORDERS; after a full lap every slot is busy
+    for (size_t attempt = 0; attempt < MAX_ORDERS; ++attempt) {
+        const OrderId id = next_order_id_.fetch_add(1, std::memory_order_relaxed);
+        const size_t slot = id % MAX_ORDERS;
+        auto& entry = static_cast<OrderEntry&>(orders_[slot]);
         bool expected = false;
-        if (entry.active.compare_exchange_weak(expected, true, 
-                                               std::memory_order_acq_rel)) {
-            return i;
+        if (entry.active.compare_exchange_strong(expected, true,
+                                                 std::memory_order_acq_rel)) {
+            order_id = id;
+            return slot;
         }
     }
     return MAX_ORDERS; // No free slot
@@ -96,8 +96,8 @@ public:
     /// Cancel all orders for a symbol
     void cancelAllOrders(TickerId ticker_id) noexcept;
     
-    /// Move orders to maintain best bid/ask
-    void moveOrders(TickerId ticker_id, Price bid_price, Price ask_price, Qty clip) noexcept;
+    /// Move orders to maintain best bid/ask, clipping each side to its own size
+    void moveOrders(TickerId ticker_id, Price bid_price, Price ask_price, Qty bid_qty, Qty ask_qty) noexcept;
     
     // Delete copy/move constructors
     OrderManager(const OrderManager&) = delete;
@@ -129,8 +129,9 @@ private:
     TradeEngine* trade_engine_{nullptr};
     RiskManager* risk_manager_{nullptr};
     
-    // Helper to find free slot
-    size_t findFreeSlot() noexcept;
+    // Claim the slot getOrder() looks in for a fresh order id, skipping
+    // ids whose slot still holds an active order
+    size_t claimSlot(OrderId& order_id) noexcept;
 };
 
 } // namespace Trading
\ No newline at end of file
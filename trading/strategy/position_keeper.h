@@ -62,7 +62,7 @@ public:
         if (ticker_id >= ME_MAX_TICKERS) return;
         
         auto& pos = positions_[ticker_id];
-        const uint64_t now_ns = Common::getNanosSinceEpoch();
+        const uint64_t now_ns = Common::TscClock::monoNs();
         
         // Update volumes and values
         if (side == 1) { // Buy
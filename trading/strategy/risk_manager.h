@@ -94,7 +94,7 @@ public:
         }
         
         // Check order rate
-        const uint64_t now_ns = Common::getNanosSinceEpoch();
+        const uint64_t now_ns = Common::TscClock::monoNs();
         const uint64_t last_order_ns = risk.last_order_time_ns.load(std::memory_order_relaxed);
         if ((now_ns - last_order_ns) >= 1000000000) { // New second
             risk.order_count.store(0, std::memory_order_relaxed);
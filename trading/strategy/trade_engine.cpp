@@ -1,6 +1,7 @@
 #include "trade_engine.h"
 #include "common/time_utils.h"
 #include "common/thread_utils.h"
+#include "config/config.h"
 
 namespace Trading {
 
@@ -16,7 +17,19 @@ TradeEngine::TradeEngine(ClientId client_id,
       market_updates_in_(market_updates_in),
       request_pool_(-1),  // Use default NUMA node
       response_pool_(-1),
-      update_pool_(-1) {
+      update_pool_(-1),
+      wait_strategy_(ConfigManager::getWaitConfig(ConfigManager::getConfig().wait_strategy.trading,
+                                                  WaitStrategyKind::Backoff),
+                     &input_event_,
+                     market_updates_in ? market_updates_in->producerCursorAddress() : nullptr) {
+    
+    // AUDIT_IGNORE: Init-time only
+    order_books_mem_ = HugePageAllocator::allocate(sizeof(TickerBook) * ME_MAX_TICKERS);
+    ASSERT(order_books_mem_.ptr != nullptr, "Failed to allocate order books");
+    order_books_ = static_cast<TickerBook*>(order_books_mem_.ptr);
+    for (size_t i = 0; i < ME_MAX_TICKERS; ++i) {
+        new (&order_books_[i]) TickerBook();
+    }
     
     // Initialize components
     order_manager_ = std::make_unique<OrderManager>(this, nullptr);
@@ -35,6 +48,11 @@ TradeEngine::TradeEngine(ClientId client_id,
 
 TradeEngine::~TradeEngine() {
     stop();
+    
+    for (size_t i = 0; i < ME_MAX_TICKERS; ++i) {
+        order_books_[i].~TickerBook();
+    }
+    HugePageAllocator::deallocate(order_books_mem_);
 }
 
 bool TradeEngine::start() {
@@ -59,12 +77,14 @@ void TradeEngine::stop() {
         return; // Already stopped
     }
     
+    input_event_.notify();  // Wake the engine if it is parked
     if (engine_thread_.joinable()) {
         engine_thread_.join();
     }
     
-    LOG_INFO("TradeEngine stopped - processed %lu messages", 
-             messages_processed_.load(std::memory_order_relaxed));
+    LOG_INFO("TradeEngine stopped - processed %lu messages, %lu stale handles", 
+             messages_processed_.load(std::memory_order_relaxed),
+             stale_handles_.load(std::memory_order_relaxed));
 }
 
 void TradeEngine::run() noexcept {
@@ -72,37 +92,85 @@ void TradeEngine::run() noexcept {
         // Process market data with higher priority
         bool processed = false;
         
-        // Process up to 100 market updates per iteration
-        for (int i = 0; i < 100; ++i) {
-            if (const auto* update_ptr = market_updates_in_->getNextToRead()) {
-                onMarketUpdate(*update_ptr);  // Dereference the pointer to pointer
-                market_updates_in_->updateReadIndex();
-                processed = true;
+        // Process up to 100 market updates per iteration, released with one store
+        const auto updates = market_updates_in_->peek(100);
+        for (const auto handle : updates) {
+            if (const auto* update = update_pool_.get(handle)) {
+                onMarketUpdate(update);
+                update_pool_.release(handle);
             } else {
-                break;
+                stale_handles_.fetch_add(1, std::memory_order_relaxed);
             }
         }
+        if (!updates.empty()) {
+            market_updates_in_->release(updates.size());
+            processed = true;
+        }
         
         // Process order responses
-        for (int i = 0; i < 10; ++i) {
-            if (const auto* response_ptr = order_responses_in_->getNextToRead()) {
-                onOrderResponse(*response_ptr);  // Dereference the pointer to pointer
-                order_responses_in_->updateReadIndex();
-                processed = true;
+        const auto responses = order_responses_in_->peek(10);
+        for (const auto handle : responses) {
+            if (const auto* response = response_pool_.get(handle)) {
+                onOrderResponse(response);
+                response_pool_.release(handle);
             } else {
-                break;
+                stale_handles_.fetch_add(1, std::memory_order_relaxed);
             }
         }
+        if (!responses.empty()) {
+            order_responses_in_->release(responses.size());
+            processed = true;
+        }
         
-        // If nothing processed, yield CPU
-        if (!processed) {
-            __builtin_ia32_pause(); // CPU pause instruction
+        // Idle per the configured strategy; ready() re-checks before sleeping
+        if (processed) {
+            wait_strategy_.reset();
+        } else {
+            wait_strategy_.idle([this] {
+                return !running_.load(std::memory_order_relaxed) ||
+                       market_updates_in_->size() != 0 ||
+                       order_responses_in_->size() != 0;
+            });
         }
     }
 }
 
-void TradeEngine::sendOrderRequest(const ClientRequest* request) noexcept {
-    if (!request) return;
+bool TradeEngine::publishMarketUpdate(const MarketUpdate& update) noexcept {
+    auto* slot = market_updates_in_->getNextToWriteTo();
+    if (!slot) {
+        return false;
+    }
+    const auto handle = update_pool_.acquire(update);
+    if (!handle.valid()) {
+        return false;
+    }
+    *slot = handle;
+    market_updates_in_->updateWriteIndex();
+    notifyInput();
+    return true;
+}
+
+bool TradeEngine::publishOrderResponse(const ClientResponse& response) noexcept {
+    auto* slot = order_responses_in_->getNextToWriteTo();
+    if (!slot) {
+        return false;
+    }
+    const auto handle = response_pool_.acquire(response);
+    if (!handle.valid()) {
+        return false;
+    }
+    *slot = handle;
+    order_responses_in_->updateWriteIndex();
+    notifyInput();
+    return true;
+}
+
+void TradeEngine::sendOrderRequest(RequestHandle handle) noexcept {
+    const auto* request = request_pool_.get(handle);
+    if (!request) {
+        stale_handles_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
     
     // Risk check first
     auto risk_result = risk_manager_->checkOrder(
@@ -115,39 +183,40 @@ void TradeEngine::sendOrderRequest(const ClientRequest* request) noexcept {
     if (risk_result != RiskCheckResult::PASS) {
         LOG_WARN("Order rejected by risk check: ticker=%u, reason=%u",
                 request->ticker_id, static_cast<uint8_t>(risk_result));
+        request_pool_.release(handle);
         return;
     }
     
     // Send to exchange
     if (auto* slot = order_requests_out_->getNextToWriteTo()) {
-        *slot = const_cast<ClientRequest*>(request);
+        *slot = handle;
         order_requests_out_->updateWriteIndex();
         orders_sent_.fetch_add(1, std::memory_order_relaxed);
     } else {
         LOG_ERROR("Failed to enqueue order request - queue full");
+        request_pool_.release(handle);
     }
 }
 
 void TradeEngine::sendOrder(TickerId ticker_id, Side side, Price price, Qty quantity) noexcept {
-    // Allocate request from pool
-    auto* request = reinterpret_cast<ClientRequest*>(request_pool_.allocate());
-    if (!request) {
+    // Construct request in the pool
+    const auto handle = request_pool_.acquire(ClientRequest{
+        .type = ClientRequest::NEW_ORDER,
+        .client_id = client_id_,
+        .ticker_id = ticker_id,
+        .order_id = OrderId_INVALID, // Will be assigned by exchange
+        .side = side,
+        .price = price,
+        .quantity = quantity,
+        .timestamp_ns = Common::TscClock::monoNs()
+    });
+    if (!handle.valid()) {
         LOG_ERROR("Failed to allocate order request - pool exhausted");
         return;
     }
     
-    // Initialize request
-    request->type = ClientRequest::NEW_ORDER;
-    request->client_id = client_id_;
-    request->ticker_id = ticker_id;
-    request->order_id = OrderId_INVALID; // Will be assigned by exchange
-    request->side = side;
-    request->price = price;
-    request->quantity = quantity;
-    request->timestamp_ns = Common::getNanosSinceEpoch();
-    
     // Send to exchange
-    sendOrderRequest(request);
+    sendOrderRequest(handle);
     
     LOG_DEBUG("Sent order: ticker=%u, side=%u, px=%lu, qty=%u", 
              ticker_id, side, price, quantity);
@@ -157,7 +226,7 @@ void TradeEngine::onMarketUpdate(const MarketUpdate* update) noexcept {
     if (!update || update->ticker_id >= ME_MAX_TICKERS) return;
     
     messages_processed_.fetch_add(1, std::memory_order_relaxed);
-    last_event_time_ns_.store(Common::getNanosSinceEpoch(), std::memory_order_relaxed);
+    last_event_time_ns_.store(Common::TscClock::monoNs(), std::memory_order_relaxed);
     
     // Update order book
     updateOrderBook(update);
@@ -260,6 +329,7 @@ void TradeEngine::onOrderResponse(const ClientResponse* response) noexcept {
 
 void TradeEngine::updateOrderBook(const MarketUpdate* update) noexcept {
     auto& book = order_books_[update->ticker_id];
+    book.beginUpdate();
     
     switch (update->type) {
         case MarketUpdate::BID_UPDATE:
@@ -282,6 +352,7 @@ void TradeEngine::updateOrderBook(const MarketUpdate* update) noexcept {
     }
     
     book.updateTimestamp(update->timestamp_ns);
+    book.endUpdate();
 }
 
 void TradeEngine::checkSignals(TickerId ticker_id) noexcept {
@@ -3,9 +3,11 @@
 #include "common/types.h"
 #include "common/lf_queue.h"
 #include "common/mem_pool.h"
+#include "common/huge_pages.h"
 #include "common/logging.h"
 #include "common/thread_utils.h"
 #include "common/time_utils.h"
+#include "common/wait_strategy.h"
 
 #include "trading/market_data/order_book.h"
 #include "order_manager.h"
@@ -81,10 +83,18 @@ public:
         uint64_t timestamp_ns{0};
     };
     
+    // Object pools - queues carry 4-byte generation-tagged handles into these
+    using ClientRequestPool = ObjectPool<ClientRequest, 16384>;
+    using ClientResponsePool = ObjectPool<ClientResponse, 16384>;
+    using MarketUpdatePool = ObjectPool<MarketUpdate, 131072>;
+    using RequestHandle = ClientRequestPool::Handle;
+    using ResponseHandle = ClientResponsePool::Handle;
+    using UpdateHandle = MarketUpdatePool::Handle;
+    
     // Queue types using Common infrastructure
-    using ClientRequestQueue = SPSCLFQueue<ClientRequest*, 65536>;
-    using ClientResponseQueue = SPSCLFQueue<ClientResponse*, 65536>;
-    using MarketUpdateQueue = SPSCLFQueue<MarketUpdate*, 262144>;
+    using ClientRequestQueue = SPSCLFQueue<RequestHandle, 65536>;
+    using ClientResponseQueue = SPSCLFQueue<ResponseHandle, 65536>;
+    using MarketUpdateQueue = SPSCLFQueue<UpdateHandle, 262144>;
     
     TradeEngine(ClientId client_id,
                 ClientRequestQueue* order_requests_out,
@@ -102,8 +112,9 @@ public:
     /// Main event loop - processes market data and order responses
     void run() noexcept;
     
-    /// Send order request to exchange
-    void sendOrderRequest(const ClientRequest* request) noexcept;
+    /// Send order request to exchange; ownership passes to the gateway,
+    /// which releases the handle into requestPool()
+    void sendOrderRequest(RequestHandle request) noexcept;
     
     /// Send a new order (used by strategies)
     void sendOrder(TickerId ticker_id, Side side, Price price, Qty quantity) noexcept;
@@ -114,6 +125,25 @@ public:
     /// Process order response from exchange
     void onOrderResponse(const ClientResponse* response) noexcept;
     
+    /// Producer side of the input queues: copy into the pool, enqueue the
+    /// handle and wake the engine if it is parked. False if the pool or
+    /// queue is full. One producer thread per queue.
+    bool publishMarketUpdate(const MarketUpdate& update) noexcept;
+    bool publishOrderResponse(const ClientResponse& response) noexcept;
+    
+    /// For producers that fill the input queues themselves: call after
+    /// updateWriteIndex(); it only costs a syscall when the engine is parked
+    void notifyInput() noexcept { input_event_.notify(); }
+    
+    /// Switch the idle strategy at runtime (e.g. spin only in market hours)
+    void setWaitStrategy(WaitStrategyKind kind) noexcept { wait_strategy_.setKind(kind); }
+    
+    /// Pools behind the queue handles. Producers of market updates and
+    /// responses acquire here; the engine releases once processed.
+    ClientRequestPool& requestPool() noexcept { return request_pool_; }
+    ClientResponsePool& responsePool() noexcept { return response_pool_; }
+    MarketUpdatePool& updatePool() noexcept { return update_pool_; }
+    
     /// Get current position for a symbol
     int64_t getPosition(TickerId ticker_id) const noexcept;
     
@@ -135,11 +165,10 @@ private:
     ClientResponseQueue* order_responses_in_{nullptr};
     MarketUpdateQueue* market_updates_in_{nullptr};
     
-    // Memory pools - pre-allocated, no dynamic allocation
-    // Size must be at least 64 bytes for cache-line alignment
-    MemoryPool<64, 10000> request_pool_;  // Padded to 64 bytes
-    MemoryPool<64, 10000> response_pool_; // Padded to 64 bytes
-    MemoryPool<64, 100000> update_pool_;  // Padded to 64 bytes
+    // Object pools - pre-allocated, no dynamic allocation
+    ClientRequestPool request_pool_;
+    ClientResponsePool response_pool_;
+    MarketUpdatePool update_pool_;
     
     // Core components
     std::unique_ptr<OrderManager> order_manager_;
@@ -149,8 +178,15 @@ private:
     std::unique_ptr<MarketMaker> market_maker_;
     std::unique_ptr<LiquidityTaker> liquidity_taker_;
     
-    // Order books for each symbol
-    std::array<MarketData::OrderBook<100>, ME_MAX_TICKERS> order_books_;
+    // Order books for each symbol (~30MB), placed on huge pages when
+    // configured to keep book walks off the TLB-miss path
+    using TickerBook = MarketData::OrderBook<100>;
+    PageAllocation order_books_mem_;
+    TickerBook* order_books_{nullptr};
+    
+    // Idle handling - parked engine is woken through input_event_
+    WaitEvent input_event_;
+    WaitStrategy wait_strategy_;
     
     // Thread control
     std::atomic<bool> running_{false};
@@ -160,6 +196,7 @@ private:
     std::atomic<uint64_t> messages_processed_{0};
     std::atomic<uint64_t> orders_sent_{0};
     std::atomic<uint64_t> last_event_time_ns_{0};
+    std::atomic<uint64_t> stale_handles_{0};
     
     // Internal helper methods
     void processMarketQueue() noexcept;
@@ -6,6 +6,7 @@
 #include "common/time_utils.h"
 #include "common/types.h"
 #include "common/thread_utils.h"
+#include "common/huge_pages.h"
 
 #include "config/config.h"
 #include "trading/auth/zerodha/zerodha_auth.h"
@@ -14,8 +15,10 @@
 #include "trading/market_data/zerodha/kite_symbol_resolver.h"
 #include "trading/market_data/binance/binance_ws_client.h"
 #include "trading/market_data/order_book.h"
+#include "trading/market_data/book_snapshot_ring.h"
 #include "common/lf_queue.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -29,9 +32,16 @@ static std::atomic<bool> g_shutdown{false};
 
 // Global market data queue and WebSocket clients
 static Common::LFQueue<Trading::MarketData::MarketUpdate, 262144>* g_market_queue = nullptr;
+static Trading::MarketUpdateChannel* g_market_channel = nullptr;
+static Trading::DepthSnapshotQueue* g_depth_queue = nullptr;
 static Trading::MarketData::Zerodha::KiteWSClient* g_kite_client = nullptr;
 static Trading::MarketData::Binance::BinanceWSClient* g_binance_client = nullptr;
 static Trading::MarketData::OrderBookManager<1000>* g_book_manager = nullptr;
+static Trading::MarketData::BookSnapshotService<Trading::MarketData::OrderBookManager<1000>>* g_book_snapshots = nullptr;
+
+// Binance books share the manager with Kite's; both tokens and ticker ids
+static constexpr uint32_t BTC_TICKER_ID = 1001;
+static constexpr uint32_t ETH_TICKER_ID = 1002;
 
 // Signal handler for graceful shutdown
 static void signalHandler(int signal) {
@@ -41,6 +51,18 @@ static void signalHandler(int signal) {
     }
 }
 
+// Today's market open ("HH:MM:SS", IST) as CLOCK_REALTIME nanoseconds
+static uint64_t sessionStartNs(const char* open_time) {
+    unsigned hh = 0, mm = 0, ss = 0;
+    if (std::sscanf(open_time, "%u:%u:%u", &hh, &mm, &ss) < 2) {
+        return 0;
+    }
+    constexpr uint64_t IST_OFFSET_S = 19800;  // UTC+05:30
+    const uint64_t now_s = Common::getWallClockNanos() / 1000000000;
+    const uint64_t day_start_s = (now_s + IST_OFFSET_S) / 86400 * 86400 - IST_OFFSET_S;
+    return (day_start_s + hh * 3600ULL + mm * 60ULL + ss) * 1000000000ULL;
+}
+
 // Display system startup banner
 static void displayBanner() {
     printf("\n");
@@ -364,8 +386,20 @@ static bool initializeSystem() {
     LOG_INFO("Initializing market data connection...");
     printf("   Initializing WebSocket connection...\n");
     
-    // Create market update queue
-    g_market_queue = new Common::LFQueue<Trading::MarketData::MarketUpdate, 262144>();  // AUDIT_IGNORE: Init-time only
+    // Create the market update queue, or with delivery_mode = "conflate" a
+    // channel holding the latest update per instrument, so a slow loop
+    // skips to the freshest state instead of dropping ticks when full
+    const bool conflate = std::strcmp(cfg.zerodha.delivery_mode, "conflate") == 0;
+    if (conflate) {
+        g_market_channel = new Trading::MarketUpdateChannel();  // AUDIT_IGNORE: Init-time only
+    } else {
+        g_market_queue = new Common::LFQueue<Trading::MarketData::MarketUpdate, 262144>();  // AUDIT_IGNORE: Init-time only
+    }
+    LOG_INFO("Market data delivery: %s", conflate ? "conflate" : "queue");
+    
+    // Full-mode packets also arrive whole as depth snapshots, one per
+    // packet, and rebuild the books by instrument token
+    g_depth_queue = new Trading::DepthSnapshotQueue();  // AUDIT_IGNORE: Init-time only
     
     // Initialize Kite WebSocket client
     Trading::MarketData::Zerodha::KiteWSClient::Config ws_config;
@@ -376,6 +410,8 @@ static bool initializeSystem() {
     ws_config.persist_orderbook = cfg.zerodha.persist_orderbook;
     
     g_kite_client = new Trading::MarketData::Zerodha::KiteWSClient(g_market_queue, ws_config);  // AUDIT_IGNORE: Init-time only
+    g_kite_client->setConflatingChannel(g_market_channel);
+    g_kite_client->setDepthQueue(g_depth_queue);
     
     // Initialize symbol resolver
     Trading::MarketData::Zerodha::KiteSymbolResolver resolver(fetcher);
@@ -395,6 +431,43 @@ static bool initializeSystem() {
         g_kite_client->mapTokenToTicker(subscription.tokens[i], static_cast<Common::TickerId>(i));
     }
     
+    // Binance books too, before the snapshot restore below can look them up
+    g_book_manager->registerInstrument(BTC_TICKER_ID, static_cast<Common::TickerId>(BTC_TICKER_ID));
+    g_book_manager->registerInstrument(ETH_TICKER_ID, static_cast<Common::TickerId>(ETH_TICKER_ID));
+    
+    // Periodic book snapshots; restore the last frame before ticks arrive,
+    // unless it is stale or left over from a previous session
+    if (cfg.zerodha.persist_orderbook && cfg.zerodha.orderbook_snapshot_interval_s > 0) {
+        char ring_file[512];
+        snprintf(ring_file, sizeof(ring_file), "%s/orderbook_ring.dat", cfg.paths.data_dir);
+        
+        Trading::MarketData::BookSnapshotService<Trading::MarketData::OrderBookManager<1000>>::Config snap_config;
+        snap_config.path = ring_file;
+        snap_config.interval_ms = cfg.zerodha.orderbook_snapshot_interval_s * 1000;
+        snap_config.max_books = 128;  // 100 subscribed plus crypto, with headroom
+        snap_config.capacity = std::max<size_t>(86400 / cfg.zerodha.orderbook_snapshot_interval_s, 1);  // One day
+        snap_config.max_restore_age_s = cfg.zerodha.orderbook_restore_max_age_s;
+        snap_config.restore_after_ns = sessionStartNs(cfg.zerodha.market_open_time);
+        
+        g_book_snapshots = new Trading::MarketData::BookSnapshotService<  // AUDIT_IGNORE: Init-time only
+            Trading::MarketData::OrderBookManager<1000>>(*g_book_manager);
+        if (g_book_snapshots->open(snap_config)) {
+            uint64_t frame_ns = 0;
+            const size_t restored = g_book_snapshots->restore(*g_book_manager, &frame_ns);
+            if (restored > 0) {
+                LOG_INFO("Restored %zu order books from snapshot taken at %lu ns", restored, frame_ns);
+            } else {
+                LOG_INFO("No order book snapshot from this session to restore");
+            }
+            g_book_snapshots->start();
+            LOG_INFO("Order book snapshots every %us to %s", cfg.zerodha.orderbook_snapshot_interval_s, ring_file);
+        } else {
+            LOG_ERROR("Failed to open order book snapshot ring %s", ring_file);
+            delete g_book_snapshots;  // AUDIT_IGNORE: Init-time only
+            g_book_snapshots = nullptr;
+        }
+    }
+    
     // Start WebSocket client
     LOG_INFO("Starting WebSocket client...");
     g_kite_client->start();
@@ -468,14 +541,7 @@ static bool initializeSystem() {
             
             // Subscribe to major crypto pairs with depth
             if (g_binance_client->isConnected()) {
-                // Define crypto pairs with their ticker IDs
-                constexpr uint32_t BTC_TICKER_ID = 1001;
-                constexpr uint32_t ETH_TICKER_ID = 1002;
-                
-                // Register instruments in OrderBookManager
-                g_book_manager->registerInstrument(BTC_TICKER_ID, static_cast<Common::TickerId>(BTC_TICKER_ID));
-                g_book_manager->registerInstrument(ETH_TICKER_ID, static_cast<Common::TickerId>(ETH_TICKER_ID));
-                
+                // Books were registered with Kite's, ahead of the snapshot restore.
                 // Subscribe with proper ticker mapping
                 g_binance_client->subscribeSymbol("btcusdt", BTC_TICKER_ID, true, true, 10);
                 g_binance_client->subscribeSymbol("ethusdt", ETH_TICKER_ID, true, true, 10);
@@ -514,6 +580,15 @@ static void shutdownSystem() {
         g_binance_client = nullptr;
     }
     
+    // Final snapshot, then stop reading the books before they go
+    if (g_book_snapshots) {
+        LOG_INFO("Writing final order book snapshot...");
+        g_book_snapshots->stop();
+        g_book_snapshots->snapshotNow();
+        delete g_book_snapshots;  // AUDIT_IGNORE: Shutdown-time only
+        g_book_snapshots = nullptr;
+    }
+    
     // Cleanup order book manager
     if (g_book_manager) {
         delete g_book_manager;  // AUDIT_IGNORE: Shutdown-time only
@@ -525,6 +600,14 @@ static void shutdownSystem() {
         delete g_market_queue;  // AUDIT_IGNORE: Shutdown-time only
         g_market_queue = nullptr;
     }
+    if (g_market_channel) {
+        delete g_market_channel;  // AUDIT_IGNORE: Shutdown-time only
+        g_market_channel = nullptr;
+    }
+    if (g_depth_queue) {
+        delete g_depth_queue;  // AUDIT_IGNORE: Shutdown-time only
+        g_depth_queue = nullptr;
+    }
     
     // Shutdown Zerodha authentication
     LOG_INFO("Shutting down Zerodha authentication...");
@@ -536,6 +619,38 @@ static void shutdownSystem() {
 }
 
 // Main trading loop
+static void applyMarketUpdate(const Trading::MarketData::MarketUpdate& update, uint64_t& tick_count,
+                              Common::Price& last_bid, Common::Price& last_ask) {
+    tick_count++;
+    
+    // Update order book
+    if (update.ticker_id != Common::TickerId_INVALID && g_book_manager) {
+        auto* book = g_book_manager->getOrderBook(update.ticker_id);
+        if (book) {
+            // Update bid/ask based on update type
+            if (update.update_type == Trading::MarketData::MessageType::MARKET_DATA) {
+                book->beginUpdate();
+                book->updateBid(update.bid_price, update.bid_qty, 1, 0);
+                book->updateAsk(update.ask_price, update.ask_qty, 1, 0);
+                book->updateTimestamp(update.timestamp);
+                book->endUpdate();
+                
+                last_bid = update.bid_price;
+                last_ask = update.ask_price;
+            }
+        }
+    }
+    
+    // Log every 1000 ticks
+    if (tick_count % 1000 == 0) {
+        LOG_INFO("Processed %llu ticks, Last: Bid=%ld Ask=%ld Spread=%ld",
+                static_cast<unsigned long long>(tick_count),
+                last_bid,
+                last_ask,
+                last_ask - last_bid);
+    }
+}
+
 static void runTradingLoop() {
     LOG_INFO("=== TRADING LOOP STARTED ===");
     
@@ -554,39 +669,29 @@ static void runTradingLoop() {
     while (!g_shutdown.load()) {
         auto now = std::chrono::steady_clock::now();
         
-        // Process market data from queue
+        // Process market data from the queue, one tick per pass, or drain
+        // every instrument that changed from the conflating channel
         if (g_market_queue) {
             const Trading::MarketData::MarketUpdate* update = g_market_queue->getNextToRead();
             if (update) {
-                tick_count++;
-                
-                // Update order book
-                if (update->ticker_id != Common::TickerId_INVALID && g_book_manager) {
-                    auto* book = g_book_manager->getOrderBook(update->ticker_id);
-                    if (book) {
-                        // Update bid/ask based on update type
-                        if (update->update_type == Trading::MarketData::MessageType::MARKET_DATA) {
-                            book->updateBid(update->bid_price, update->bid_qty, 1, 0);
-                            book->updateAsk(update->ask_price, update->ask_qty, 1, 0);
-                            book->updateTimestamp(update->timestamp);
-                            
-                            last_bid = update->bid_price;
-                            last_ask = update->ask_price;
-                        }
-                    }
-                }
-                
+                applyMarketUpdate(*update, tick_count, last_bid, last_ask);
                 g_market_queue->updateReadIndex();
-                
-                // Log every 1000 ticks
-                if (tick_count % 1000 == 0) {
-                    LOG_INFO("Processed %llu ticks, Last: Bid=%ld Ask=%ld Spread=%ld",
-                            static_cast<unsigned long long>(tick_count),
-                            last_bid,
-                            last_ask,
-                            last_ask - last_bid);
+            }
+        } else if (g_market_channel) {
+            g_market_channel->drain([&](size_t, const Trading::MarketData::MarketUpdate& update) {
+                applyMarketUpdate(update, tick_count, last_bid, last_ask);
+            });
+        }
+        
+        // Rebuild books from whatever depth snapshots are waiting
+        if (g_depth_queue && g_book_manager) {
+            const auto snaps = g_depth_queue->peek(64);
+            for (const auto& snap : snaps) {
+                if (auto* book = g_book_manager->getOrderBook(snap.instrument_token)) {
+                    book->applySnapshot(snap);
                 }
             }
+            g_depth_queue->release(snaps.size());
         }
         
         // Print status every 30 seconds
@@ -595,6 +700,9 @@ static void runTradingLoop() {
                     static_cast<unsigned long long>(loop_count),
                     static_cast<unsigned long long>(tick_count),
                     auth->isAuthenticated() ? "true" : "false");
+            if (g_market_channel) {
+                LOG_INFO("Conflated market updates: %lu", g_market_channel->conflatedCount());
+            }
             
             // Print order book summary
             if (g_book_manager) {
@@ -602,26 +710,21 @@ static void runTradingLoop() {
                 size_t book_count = g_book_manager->getActiveBooks(active);
                 LOG_INFO("Active order books: %zu", book_count);
                 
-                // Show Binance order book details
-                auto* btc_book = g_book_manager->getOrderBook(1001);
-                if (btc_book && btc_book->getBidDepth() > 0) {
-                    LOG_INFO("BTCUSDT OrderBook: Bid=%.2f@%.2f, Ask=%.2f@%.2f, Spread=%.2f",
-                            static_cast<double>(btc_book->getBestBid()) / 1e8,
-                            static_cast<double>(btc_book->getBestBidQty()) / 1e8,
-                            static_cast<double>(btc_book->getBestAsk()) / 1e8,
-                            static_cast<double>(btc_book->getBestAskQty()) / 1e8,
-                            static_cast<double>(btc_book->getSpread()) / 1e8);
-                }
-                
-                auto* eth_book = g_book_manager->getOrderBook(1002);
-                if (eth_book && eth_book->getBidDepth() > 0) {
-                    LOG_INFO("ETHUSDT OrderBook: Bid=%.2f@%.2f, Ask=%.2f@%.2f, Spread=%.2f",
-                            static_cast<double>(eth_book->getBestBid()) / 1e8,
-                            static_cast<double>(eth_book->getBestBidQty()) / 1e8,
-                            static_cast<double>(eth_book->getBestAsk()) / 1e8,
-                            static_cast<double>(eth_book->getBestAskQty()) / 1e8,
-                            static_cast<double>(eth_book->getSpread()) / 1e8);
-                }
+                // Show Binance order book details. These books are written by
+                // the Binance processor thread, so read a consistent copy.
+                auto log_top = [](const char* name, uint32_t token) {
+                    Trading::MarketData::TopLevels<1> top;
+                    if (g_book_manager->readTop(token, top) && top.bid_depth > 0 && top.ask_depth > 0) {
+                        LOG_INFO("%s OrderBook: Bid=%.2f@%.2f, Ask=%.2f@%.2f, Spread=%.2f", name,
+                                static_cast<double>(top.bid_prices[0]) / 1e8,
+                                static_cast<double>(top.bid_qtys[0]) / 1e8,
+                                static_cast<double>(top.ask_prices[0]) / 1e8,
+                                static_cast<double>(top.ask_qtys[0]) / 1e8,
+                                static_cast<double>(top.ask_prices[0] - top.bid_prices[0]) / 1e8);
+                    }
+                };
+                log_top("BTCUSDT", 1001);
+                log_top("ETHUSDT", 1002);
             }
             
             // Check if token needs refresh
@@ -663,10 +766,24 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
-    // Initialize logging using ConfigManager's log path
+    // Page backing must be configured before any pool, queue or book exists
+    const auto& perf_cfg = Trading::ConfigManager::getConfig().performance;
+    Common::HugePageAllocator::configure({
+        .use_huge_pages = perf_cfg.use_huge_pages,
+        .lock_memory = perf_cfg.lock_memory,
+        .budget_bytes = static_cast<size_t>(perf_cfg.huge_page_budget_mb) * 1024 * 1024
+    });
+    
+    // Initialize logging using ConfigManager's log path. This also starts the
+    // TscClock discipline thread the hot paths' timestamps rely on.
     char log_file[512];
     snprintf(log_file, sizeof(log_file), "%s/trader_main.log", Trading::ConfigManager::getConfig().paths.logs_dir);
     
+    const auto& log_cfg = Trading::ConfigManager::getConfig().logging;
+    Common::configureLogOutput({
+        .max_file_bytes = static_cast<uint64_t>(log_cfg.max_file_size_mb) * 1024 * 1024,
+        .rotation_count = log_cfg.rotation_count
+    });
     Common::initLogging(log_file);
     
     LOG_INFO("========================================");
@@ -680,6 +797,9 @@ int main(int argc, char* argv[]) {
         LOG_INFO("  argv[%d]: %s", i, argv[i]);
     }
     
+    LOG_INFO("Memory: huge_pages=%d lock_memory=%d budget=%uMB",
+             perf_cfg.use_huge_pages, perf_cfg.lock_memory, perf_cfg.huge_page_budget_mb);
+    
     // Install signal handlers
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);